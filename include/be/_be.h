@@ -53,10 +53,31 @@
 ///         checking.
 #define BE_BEDITOR
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Defined when the compiler supports C++11 \c constexpr functions
+///         and user-defined literals.
+/// \details Visual C++ 2012 supports neither, so code which depends on them
+///         must provide a fallback when this is not defined.
+/// \sa     BE_CONSTEXPR
+#define BE_CONSTEXPR_ENABLED
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  The verbosity levels which are compiled into the program.
+/// \details A #BE_LOG statement whose level is not included in this mask is
+///         removed entirely by the compiler; its stream insertions are never
+///         evaluated and no verbosity check is made at runtime.  Defaults to
+///         \ref be::VErrorsAndWarnings in #NDEBUG builds and \ref be::VAll
+///         otherwise.  May be defined on the
+///         command line, eg. <tt>/DBE_MIN_VERBOSITY=be::VErrors</tt>.
+/// \sa     be::setVerbosity()
+#define BE_MIN_VERBOSITY
+
 #else
 
 #define _USE_MATH_DEFINES
+#include <atomic>
 #include <cmath>
+#include <ostream>
 #include <string>
 
 #if defined(_MSC_VER) && defined(DEBUG) && !defined(new)
@@ -69,6 +90,39 @@
 #undef _CRT_SECURE_NO_WARNINGS
 #endif
 
+#if !defined(_MSC_VER) || _MSC_VER >= 1900
+#define BE_CONSTEXPR_ENABLED
+#endif
+
+#ifndef BE_MIN_VERBOSITY
+#ifdef NDEBUG
+#define BE_MIN_VERBOSITY be::VErrorsAndWarnings
+#else
+#define BE_MIN_VERBOSITY be::VAll
+#endif
+#endif
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Expands to \c constexpr if #BE_CONSTEXPR_ENABLED is defined, or
+///         \c inline otherwise.
+#ifdef BE_CONSTEXPR_ENABLED
+#define BE_CONSTEXPR constexpr
+#else
+#define BE_CONSTEXPR inline
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Declares a variable with thread storage duration.
+/// \details Visual C++ 2012 doesn't support \c thread_local, so the compiler
+///         specific keyword is used instead.  Like \c thread_local, it may
+///         only be applied to variables with static storage duration, and
+///         unlike it, their types must be trivial.
+#ifdef _MSC_VER
+#define BE_THREAD_LOCAL __declspec(thread)
+#else
+#define BE_THREAD_LOCAL __thread
 #endif
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -126,9 +180,29 @@ enum Verbosity
 
 void setVerbosity(int verbosity);
 int getVerbosity();
-bool checkVerbosity(int verbosity);
 std::string getCurrentTimeString();
 const char* getVerbosityLevel(int level);
+void flushLog();
+
+namespace detail {
+
+extern std::atomic<int> current_verbosity;
+
+} // namespace be::detail
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Checks if the provided verbosity level should result in a message
+///         being logged given the current verbosity level.
+/// \details The current verbosity is atomic, so this may be called from any
+///         thread; it is only a relaxed load, an AND, and a comparison.
+/// \param  verbosity The verbosity level to check against the current level.
+/// \return \c true if getVerbosity() & verbosity == verbosity.
+/// \sa     Verbosity
+/// \sa     setVerbosity()
+inline bool checkVerbosity(int verbosity)
+{
+   return (detail::current_verbosity.load(std::memory_order_relaxed) & verbosity) == verbosity;
+}
 
 } // namespace be
 
@@ -143,26 +217,39 @@ const char* getVerbosityLevel(int level);
 ///         message to #BE_LOG_STREAM using the following format:
 ///         <tt>"YYYY-MM-DD HH:MM:SS file.cpp(line) Level: "</tt>
 ///
-///         The expression evaluates to #BE_LOG_STREAM so additional stream
-///         insertion operators can be appended to the line like so:
+///         The expression evaluates to a be::detail::LogRecord, which accepts
+///         anything that can be inserted into a \c std::ostream, so
+///         additional stream insertion operators can be appended to the line
+///         like so:
 ///
 /// \code   BE_LOG(VERBOSITY_NOTICE) << "Something interesting." << BE_LOG_END;
 /// \endcode
+///
+///         The message is complete at the end of the statement; everything
+///         inserted into the stream is written as a single line (plus any
+///         #BE_LOG_NL continuation lines).  While an AsyncLog exists, the
+///         timestamp and prefix are formatted and the line is written by a
+///         background thread.
+///
+///         Levels which are not included in #BE_MIN_VERBOSITY are rejected
+///         at compile time, so the whole statement compiles to nothing.
 /// \sa     be::Verbosity
 /// \sa     BE_LOG_NL
 /// \sa     BE_LOG_END
-#define BE_LOG(level) if (be::checkVerbosity(level))          \
-   BE_LOG_STREAM << be::getCurrentTimeString()                \
-                 << " " << __FILE__ << "(" << __LINE__ << ")" \
-                 << " " << be::getVerbosityLevel(level)       \
-                 << ": "
+#define BE_LOG(level) if ((((level) & (BE_MIN_VERBOSITY)) == (level)) && be::checkVerbosity(level)) \
+   be::detail::LogRecord(level, __FILE__, __LINE__)
 
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  Begins a continuation line for #BE_LOG messages.
-#define BE_LOG_NL std::endl << "                       "
+#define BE_LOG_NL '\n' << "                       "
 
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  Ends a #BE_LOG message
-#define BE_LOG_END std::endl
+/// \details Messages end at the end of the #BE_LOG statement regardless, so
+///         this does nothing, but it makes the end of long messages easier
+///         to see.
+#define BE_LOG_END std::flush
+
+#include "be/detail/log_record.h"
 
 #endif
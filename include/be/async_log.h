@@ -0,0 +1,88 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/async_log.h
+/// \author Benjamin Crist
+///
+/// \brief  be::AsyncLog class header.
+
+#ifndef BE_ASYNC_LOG_H_
+#define BE_ASYNC_LOG_H_
+
+#include "be/_be.h"
+
+#include <thread>
+
+namespace be {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \class  AsyncLog   be/async_log.h "be/async_log.h"
+///
+/// \brief  Moves #BE_LOG output to a background thread while it exists.
+/// \details Each thread which logs a message gets its own lock-free ring
+///         buffer of pending messages.  The thread that submits a message
+///         only formats the text inserted by the caller; the timestamp and
+///         prefix are formatted by the writer thread, which collects
+///         messages from all ring buffers, orders them by time, and writes
+///         them to #BE_LOG_STREAM in batches with a single flush.
+///
+///         If a thread's ring buffer is full, new messages from that thread
+///         are dropped (and the number of dropped messages is logged later),
+///         except for \ref VError messages, which wait for space.
+///
+///         Only one AsyncLog may exist at a time.  When no AsyncLog exists,
+///         messages are written immediately by the thread that logs them.
+///         Since #BE_LOG_STREAM may be redirected to a file, the AsyncLog
+///         should be destroyed before the file is closed; destroying it
+///         writes all pending messages.
+///
+///         In the \ref Binary format, values are stored as they were passed
+///         to #BE_LOG rather than being formatted as text, the time is
+///         stored as a number, and file names and short string literals are
+///         written only once.  This makes logging cheaper for the calling
+///         thread and the writer thread, and makes the log smaller.  Binary
+///         logs can be converted to text with be::LogReader or the
+///         \c logdecode tool.  Messages logged while no AsyncLog exists are
+///         always written as text.
+/// \ingroup logging
+class AsyncLog
+{
+public:
+   /// \brief  Determines how messages are written to #BE_LOG_STREAM.
+   enum Format
+   {
+      Text,    ///< Human-readable text, as written when no AsyncLog exists.
+      Binary   ///< The binary format described in be/detail/log_format.h.
+   };
+
+   explicit AsyncLog(Format format = Text);
+   ~AsyncLog();
+
+private:
+   std::thread writer_;
+
+   AsyncLog(const AsyncLog&);
+   void operator=(const AsyncLog&);
+};
+
+} // namespace be
+
+#endif
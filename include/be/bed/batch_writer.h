@@ -0,0 +1,151 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/bed/batch_writer.h
+/// \author Benjamin Crist
+///
+/// \brief  be::bed::BatchWriter class header.
+
+#ifndef BE_BED_BATCH_WRITER_H_
+#define BE_BED_BATCH_WRITER_H_
+#include "be/_be.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "be/bed/db.h"
+#include "be/bed/stmt.h"
+#include "be/bed/transaction.h"
+
+#define BE_BED_BATCH_WRITER_DEFAULT_CHUNK_SIZE 10000
+
+namespace be {
+namespace bed {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \class  BatchWriter   be/bed/batch_writer.h "be/bed/batch_writer.h"
+///
+/// \brief  Executes a single INSERT (or other) statement for a large number
+///         of rows, committing in chunks.
+/// \details Each row's parameters are bound in order with operator<<(),
+///         bindBlob() or bindNull(), and then next() executes the statement
+///         and resets it for the next row.  insert() does both at once.
+///         Numeric values are bound immediately.  Text and blobs are copied
+///         into an arena that is reused for every row.  They are bound with
+///         SQLITE_STATIC just before the statement is executed, so SQLite
+///         doesn't allocate a copy of each one.
+///
+///         Rows are written in immediate transactions of up to
+///         getChunkSize() rows.  Larger chunks mean fewer commits (and
+///         fsyncs), but longer write locks and a larger journal.  finish()
+///         commits the last chunk.  If the BatchWriter is destroyed first,
+///         the rows written since the last commit are rolled back, just like
+///         an uncommitted Transaction.
+///
+///         When loading many rows into an indexed table, it is usually much
+///         faster to drop the table's indexes, insert the rows, and then
+///         rebuild the indexes than to update the indexes for every row.
+///         dropIndexes() does this.  The indexes are recreated by finish(),
+///         or by the destructor if finish() is never called.  UNIQUE
+///         indexes (including those SQLite creates for PRIMARY KEY and
+///         UNIQUE constraints) are left alone, so uniqueness is enforced
+///         during the load.
+///
+///         A BatchWriter must be destroyed before its Db, just like a Stmt.
+///         No other writes should be made to the Db while a chunk is open.
+/// \ingroup db
+class BatchWriter
+{
+public:
+   BatchWriter(Db& db, const std::string& sql);
+   BatchWriter(Db& db, const std::string& sql, size_t chunk_size);
+   ~BatchWriter();
+
+   void setChunkSize(size_t chunk_size);
+   size_t getChunkSize() const;
+   uint64_t getRowCount() const;
+
+   void dropIndexes(const std::string& table);
+
+   template <typename T> BatchWriter& operator<<(const T& value);
+   BatchWriter& operator<<(const std::string& value);
+   BatchWriter& operator<<(const char* value);
+   BatchWriter& bindBlob(const std::string& value);
+   BatchWriter& bindBlob(const void* value, int length);
+   BatchWriter& bindNull();
+
+   void next();
+
+   template <typename T0> void insert(const T0& a0);
+   template <typename T0, typename T1> void insert(const T0& a0, const T1& a1);
+   template <typename T0, typename T1, typename T2> void insert(const T0& a0, const T1& a1, const T2& a2);
+   template <typename T0, typename T1, typename T2, typename T3> void insert(const T0& a0, const T1& a1, const T2& a2, const T3& a3);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4> void insert(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5> void insert(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6> void insert(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5, const T6& a6);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7> void insert(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5, const T6& a6, const T7& a7);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8> void insert(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5, const T6& a6, const T7& a7, const T8& a8);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8, typename T9> void insert(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5, const T6& a6, const T7& a7, const T8& a8, const T9& a9);
+
+   void commit();
+   void finish();
+
+private:
+   ///////////////////////////////////////////////////////////////////////////
+   /// \brief  A text or blob parameter stored in the arena.
+   struct ArenaValue
+   {
+      int parameter;
+      size_t offset;
+      int length;
+      bool blob;
+   };
+
+   void arenaBind_(const void* value, size_t length, bool blob);
+   void checkBind_(int result);
+   void rebuildIndexes_();
+
+   Db& db_;
+   Stmt stmt_;
+   size_t chunk_size_;
+   size_t chunk_rows_;
+   uint64_t rows_;
+   int parameter_;                     ///< The last parameter bound for the current row.
+
+   std::unique_ptr<Transaction> transaction_;   ///< The current chunk's transaction, if one is open.
+
+   std::vector<char> arena_;           ///< Text and blob data for the current row.
+   std::vector<ArenaValue> arena_values_;
+
+   std::vector<std::string> dropped_indexes_;   ///< CREATE INDEX statements for indexes dropped by dropIndexes().
+
+   BatchWriter(const BatchWriter&);
+   void operator=(const BatchWriter&);
+};
+
+} // namespace be::bed
+} // namespace be
+
+#include "be/bed/batch_writer.inl"
+
+#endif
@@ -0,0 +1,166 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/bed/batch_writer.inl
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of be::bed::BatchWriter template functions.
+
+#if !defined(BE_BED_BATCH_WRITER_H_) && !defined(DOXYGEN)
+#include "be/bed/batch_writer.h"
+#elif !defined(BE_BED_BATCH_WRITER_INL_)
+#define BE_BED_BATCH_WRITER_INL_
+
+#include "be/bed/detail/column_traits.h"
+
+namespace be {
+namespace bed {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds a value to the next parameter of the current row.
+///
+/// \details The bind function is selected at compile time by
+///         detail::ColumnTraits.
+///
+/// \param  value The value to bind.
+/// \return This BatchWriter, to allow chaining.
+template <typename T>
+inline BatchWriter& BatchWriter::operator<<(const T& value)
+{
+   checkBind_(detail::ColumnTraits<T>::bind(stmt_.stmt_, ++parameter_, value));
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds values to parameters 1 through 1 and executes the
+///         statement.
+///
+/// \details Equivalent to <tt>*this << a0 << ...; next();</tt>
+template <typename T0>
+inline void BatchWriter::insert(const T0& a0)
+{
+   *this << a0;
+   next();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds values to parameters 1 through 2 and executes the
+///         statement.
+/// \copydetails insert(const T0&)
+template <typename T0, typename T1>
+inline void BatchWriter::insert(const T0& a0, const T1& a1)
+{
+   *this << a0 << a1;
+   next();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds values to parameters 1 through 3 and executes the
+///         statement.
+/// \copydetails insert(const T0&)
+template <typename T0, typename T1, typename T2>
+inline void BatchWriter::insert(const T0& a0, const T1& a1, const T2& a2)
+{
+   *this << a0 << a1 << a2;
+   next();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds values to parameters 1 through 4 and executes the
+///         statement.
+/// \copydetails insert(const T0&)
+template <typename T0, typename T1, typename T2, typename T3>
+inline void BatchWriter::insert(const T0& a0, const T1& a1, const T2& a2, const T3& a3)
+{
+   *this << a0 << a1 << a2 << a3;
+   next();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds values to parameters 1 through 5 and executes the
+///         statement.
+/// \copydetails insert(const T0&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4>
+inline void BatchWriter::insert(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4)
+{
+   *this << a0 << a1 << a2 << a3 << a4;
+   next();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds values to parameters 1 through 6 and executes the
+///         statement.
+/// \copydetails insert(const T0&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5>
+inline void BatchWriter::insert(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5)
+{
+   *this << a0 << a1 << a2 << a3 << a4 << a5;
+   next();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds values to parameters 1 through 7 and executes the
+///         statement.
+/// \copydetails insert(const T0&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6>
+inline void BatchWriter::insert(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5, const T6& a6)
+{
+   *this << a0 << a1 << a2 << a3 << a4 << a5 << a6;
+   next();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds values to parameters 1 through 8 and executes the
+///         statement.
+/// \copydetails insert(const T0&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7>
+inline void BatchWriter::insert(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5, const T6& a6, const T7& a7)
+{
+   *this << a0 << a1 << a2 << a3 << a4 << a5 << a6 << a7;
+   next();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds values to parameters 1 through 9 and executes the
+///         statement.
+/// \copydetails insert(const T0&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8>
+inline void BatchWriter::insert(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5, const T6& a6, const T7& a7, const T8& a8)
+{
+   *this << a0 << a1 << a2 << a3 << a4 << a5 << a6 << a7 << a8;
+   next();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds values to parameters 1 through 10 and executes the
+///         statement.
+/// \copydetails insert(const T0&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8, typename T9>
+inline void BatchWriter::insert(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5, const T6& a6, const T7& a7, const T8& a8, const T9& a9)
+{
+   *this << a0 << a1 << a2 << a3 << a4 << a5 << a6 << a7 << a8 << a9;
+   next();
+}
+
+} // namespace be::bed
+} // namespace be
+
+#endif
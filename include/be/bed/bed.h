@@ -51,6 +51,7 @@ class Bed : public std::enable_shared_from_this<Bed>
 {
 public:
    Bed(const Id& id, const std::string& path, bool read_only);
+   Bed(const Id& id, const std::string& path, bool read_only, const DbConfig& config);
 
    const Id& getId() const;
 
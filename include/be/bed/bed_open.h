@@ -31,6 +31,8 @@
 #define BE_BED_BED_OPEN_H_
 
 #include "be/bed/bed.h"
+#include "be/bed/connection_pool.h"
+#include "be/bed/write_queue.h"
 
 #include <boost/filesystem.hpp>
 
@@ -49,6 +51,9 @@ std::unordered_map<Id, boost::filesystem::path> getPaths();
 
 std::shared_ptr<Bed> open(const Id& bed_id);
 std::shared_ptr<Bed> openWritable(const Id& bed_id);
+std::shared_ptr<ConnectionPool<Bed> > openPool(const Id& bed_id);
+std::shared_ptr<WriteQueue<Bed> > openWriteQueue(const Id& bed_id);
+void closeWriteQueues();
 
 } // namespace bed
 } // namespace be
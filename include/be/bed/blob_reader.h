@@ -0,0 +1,87 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/bed/blob_reader.h
+/// \author Benjamin Crist
+///
+/// \brief  be::bed::BlobReader class header.
+
+#ifndef BE_BED_BLOB_READER_H_
+#define BE_BED_BLOB_READER_H_
+#include "be/_be.h"
+
+#include <string>
+#include "sqlite3.h"
+
+#include "be/bed/db.h"
+
+namespace be {
+namespace bed {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \class  BlobReader   be/bed/blob_reader.h "be/bed/blob_reader.h"
+///
+/// \brief  RAII wrapper for SQLite's incremental blob I/O API, used to read
+///         a single blob in pieces.
+/// \details Stmt::getBlob() requires SQLite to assemble the whole blob in
+///         memory, and the std::string overload then copies it again.  A
+///         BlobReader instead copies each requested range directly from the
+///         database pages into the caller's buffer, so large assets (textures,
+///         audio, etc.) can be decoded in small chunks without ever holding a
+///         complete copy of the data.
+///
+///         The blob is identified by table, column and rowid.  reopen() can
+///         be used to cheaply move to the same column of another row.
+///
+///         If the row is modified or deleted while the reader is open, further
+///         reads will throw.  BlobReaders must be destroyed before the Db they
+///         were opened from, just like Stmts.
+/// \ingroup db
+class BlobReader
+{
+public:
+   BlobReader(Db& db, const std::string& table, const std::string& column, sqlite3_int64 rowid);
+   ~BlobReader();
+
+   void reopen(sqlite3_int64 rowid);
+
+   int getSize() const;
+   int getPosition() const;
+   bool isEof() const;
+
+   int read(void* dest, int length);
+   void seek(int position);
+   void skip(int bytes);
+
+private:
+   Db& db_;
+   sqlite3_blob* blob_;
+   int size_;
+   int position_;
+
+   BlobReader(const BlobReader&);
+   void operator=(const BlobReader&);
+};
+
+} // namespace be::bed
+} // namespace be
+
+#endif
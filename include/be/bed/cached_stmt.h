@@ -36,6 +36,12 @@ namespace bed {
 
 class StmtCache;
 
+namespace detail {
+
+struct StmtCacheEntry;
+
+} // namespace be::bed::detail
+
 ///////////////////////////////////////////////////////////////////////////////
 /// \class  CachedStmt   be/bed/cached_stmt.h "be/bed/cached_stmt.h"
 ///
@@ -56,6 +62,7 @@ class StmtCache;
 /// \ingroup db
 class CachedStmt
 {
+   friend class RowReader;
    friend class StmtCache;
 public:
    CachedStmt(CachedStmt&& other);
@@ -90,6 +97,7 @@ public:
 
    int columns();
    int column(const std::string& name);
+   int column(const Id& name);
 
    int getType(int column);
 
@@ -103,10 +111,37 @@ public:
    std::string getBlob(int column);
    int getBlob(int column, const void*& dest);
 
+   template <typename T> T get(int column);
+
+   template <typename T0> void bindAll(const T0& a0);
+   template <typename T0, typename T1> void bindAll(const T0& a0, const T1& a1);
+   template <typename T0, typename T1, typename T2> void bindAll(const T0& a0, const T1& a1, const T2& a2);
+   template <typename T0, typename T1, typename T2, typename T3> void bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4> void bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5> void bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6> void bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5, const T6& a6);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7> void bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5, const T6& a6, const T7& a7);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8> void bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5, const T6& a6, const T7& a7, const T8& a8);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8, typename T9> void bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5, const T6& a6, const T7& a7, const T8& a8, const T9& a9);
+
+   template <typename T0> void readRow(T0& a0);
+   template <typename T0, typename T1> void readRow(T0& a0, T1& a1);
+   template <typename T0, typename T1, typename T2> void readRow(T0& a0, T1& a1, T2& a2);
+   template <typename T0, typename T1, typename T2, typename T3> void readRow(T0& a0, T1& a1, T2& a2, T3& a3);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4> void readRow(T0& a0, T1& a1, T2& a2, T3& a3, T4& a4);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5> void readRow(T0& a0, T1& a1, T2& a2, T3& a3, T4& a4, T5& a5);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6> void readRow(T0& a0, T1& a1, T2& a2, T3& a3, T4& a4, T5& a5, T6& a6);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7> void readRow(T0& a0, T1& a1, T2& a2, T3& a3, T4& a4, T5& a5, T6& a6, T7& a7);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8> void readRow(T0& a0, T1& a1, T2& a2, T3& a3, T4& a4, T5& a5, T6& a6, T7& a7, T8& a8);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8, typename T9> void readRow(T0& a0, T1& a1, T2& a2, T3& a3, T4& a4, T5& a5, T6& a6, T7& a7, T8& a8, T9& a9);
+
+   template <typename T> void readInto(T& row);
+
 private:
-   CachedStmt(StmtCache* cache, Stmt& stmt);
+   CachedStmt(StmtCache* cache, detail::StmtCacheEntry& entry);
 
    StmtCache* cache_;
+   detail::StmtCacheEntry* entry_;
    Stmt& stmt_;
 
    CachedStmt(const CachedStmt&);
@@ -118,4 +153,6 @@ std::ostream& operator<<(std::ostream& os, const CachedStmt& s);
 } // namespace be::bed
 } // namespace be
 
+#include "be/bed/cached_stmt.inl"
+
 #endif
@@ -0,0 +1,215 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/bed/cached_stmt.inl
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of be::bed::CachedStmt template functions.
+
+#if !defined(BE_BED_CACHED_STMT_H_) && !defined(DOXYGEN)
+#include "be/bed/cached_stmt.h"
+#elif !defined(BE_BED_CACHED_STMT_INL_)
+#define BE_BED_CACHED_STMT_INL_
+
+namespace be {
+namespace bed {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc   Stmt::get(int)
+template <typename T>
+inline T CachedStmt::get(int column)
+{
+   return stmt_.get<T>(column);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc   Stmt::bindAll(const T0&)
+template <typename T0>
+inline void CachedStmt::bindAll(const T0& a0)
+{
+   stmt_.bindAll(a0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc   Stmt::bindAll(const T0&, const T1&)
+template <typename T0, typename T1>
+inline void CachedStmt::bindAll(const T0& a0, const T1& a1)
+{
+   stmt_.bindAll(a0, a1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc   Stmt::bindAll(const T0&, const T1&, const T2&)
+template <typename T0, typename T1, typename T2>
+inline void CachedStmt::bindAll(const T0& a0, const T1& a1, const T2& a2)
+{
+   stmt_.bindAll(a0, a1, a2);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc   Stmt::bindAll(const T0&, const T1&, const T2&, const T3&)
+template <typename T0, typename T1, typename T2, typename T3>
+inline void CachedStmt::bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3)
+{
+   stmt_.bindAll(a0, a1, a2, a3);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc   Stmt::bindAll(const T0&, const T1&, const T2&, const T3&, const T4&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4>
+inline void CachedStmt::bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4)
+{
+   stmt_.bindAll(a0, a1, a2, a3, a4);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc   Stmt::bindAll(const T0&, const T1&, const T2&, const T3&, const T4&, const T5&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5>
+inline void CachedStmt::bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5)
+{
+   stmt_.bindAll(a0, a1, a2, a3, a4, a5);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc   Stmt::bindAll(const T0&, const T1&, const T2&, const T3&, const T4&, const T5&, const T6&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6>
+inline void CachedStmt::bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5, const T6& a6)
+{
+   stmt_.bindAll(a0, a1, a2, a3, a4, a5, a6);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc   Stmt::bindAll(const T0&, const T1&, const T2&, const T3&, const T4&, const T5&, const T6&, const T7&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7>
+inline void CachedStmt::bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5, const T6& a6, const T7& a7)
+{
+   stmt_.bindAll(a0, a1, a2, a3, a4, a5, a6, a7);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc   Stmt::bindAll(const T0&, const T1&, const T2&, const T3&, const T4&, const T5&, const T6&, const T7&, const T8&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8>
+inline void CachedStmt::bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5, const T6& a6, const T7& a7, const T8& a8)
+{
+   stmt_.bindAll(a0, a1, a2, a3, a4, a5, a6, a7, a8);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc   Stmt::bindAll(const T0&, const T1&, const T2&, const T3&, const T4&, const T5&, const T6&, const T7&, const T8&, const T9&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8, typename T9>
+inline void CachedStmt::bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5, const T6& a6, const T7& a7, const T8& a8, const T9& a9)
+{
+   stmt_.bindAll(a0, a1, a2, a3, a4, a5, a6, a7, a8, a9);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc   Stmt::readRow(T0&)
+template <typename T0>
+inline void CachedStmt::readRow(T0& a0)
+{
+   stmt_.readRow(a0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc   Stmt::readRow(T0&, T1&)
+template <typename T0, typename T1>
+inline void CachedStmt::readRow(T0& a0, T1& a1)
+{
+   stmt_.readRow(a0, a1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc   Stmt::readRow(T0&, T1&, T2&)
+template <typename T0, typename T1, typename T2>
+inline void CachedStmt::readRow(T0& a0, T1& a1, T2& a2)
+{
+   stmt_.readRow(a0, a1, a2);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc   Stmt::readRow(T0&, T1&, T2&, T3&)
+template <typename T0, typename T1, typename T2, typename T3>
+inline void CachedStmt::readRow(T0& a0, T1& a1, T2& a2, T3& a3)
+{
+   stmt_.readRow(a0, a1, a2, a3);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc   Stmt::readRow(T0&, T1&, T2&, T3&, T4&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4>
+inline void CachedStmt::readRow(T0& a0, T1& a1, T2& a2, T3& a3, T4& a4)
+{
+   stmt_.readRow(a0, a1, a2, a3, a4);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc   Stmt::readRow(T0&, T1&, T2&, T3&, T4&, T5&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5>
+inline void CachedStmt::readRow(T0& a0, T1& a1, T2& a2, T3& a3, T4& a4, T5& a5)
+{
+   stmt_.readRow(a0, a1, a2, a3, a4, a5);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc   Stmt::readRow(T0&, T1&, T2&, T3&, T4&, T5&, T6&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6>
+inline void CachedStmt::readRow(T0& a0, T1& a1, T2& a2, T3& a3, T4& a4, T5& a5, T6& a6)
+{
+   stmt_.readRow(a0, a1, a2, a3, a4, a5, a6);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc   Stmt::readRow(T0&, T1&, T2&, T3&, T4&, T5&, T6&, T7&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7>
+inline void CachedStmt::readRow(T0& a0, T1& a1, T2& a2, T3& a3, T4& a4, T5& a5, T6& a6, T7& a7)
+{
+   stmt_.readRow(a0, a1, a2, a3, a4, a5, a6, a7);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc   Stmt::readRow(T0&, T1&, T2&, T3&, T4&, T5&, T6&, T7&, T8&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8>
+inline void CachedStmt::readRow(T0& a0, T1& a1, T2& a2, T3& a3, T4& a4, T5& a5, T6& a6, T7& a7, T8& a8)
+{
+   stmt_.readRow(a0, a1, a2, a3, a4, a5, a6, a7, a8);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc   Stmt::readRow(T0&, T1&, T2&, T3&, T4&, T5&, T6&, T7&, T8&, T9&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8, typename T9>
+inline void CachedStmt::readRow(T0& a0, T1& a1, T2& a2, T3& a3, T4& a4, T5& a5, T6& a6, T7& a7, T8& a8, T9& a9)
+{
+   stmt_.readRow(a0, a1, a2, a3, a4, a5, a6, a7, a8, a9);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc   Stmt::readInto(T&)
+template <typename T>
+inline void CachedStmt::readInto(T& row)
+{
+   RowReader reader(*this);
+   reader >> row;
+}
+
+} // namespace be::bed
+} // namespace be
+
+#endif
@@ -0,0 +1,154 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/bed/connection_pool.h
+/// \author Benjamin Crist
+///
+/// \brief  be::bed::ConnectionPool class header.
+
+#ifndef BE_BED_CONNECTION_POOL_H_
+#define BE_BED_CONNECTION_POOL_H_
+
+#include "be/_be.h"
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace be {
+namespace bed {
+
+template <class T>
+class ConnectionPool;
+
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Used by ConnectionPool to keep track of each connection it owns
+///         and which thread (if any) currently holds it.
+template <class T>
+struct ConnectionPoolSlot
+{
+   ConnectionPoolSlot();
+
+   std::unique_ptr<T> connection;
+   std::thread::id owner;        ///< The thread holding the connection, if holds > 0.
+   std::thread::id last_owner;   ///< The thread which most recently released the connection.
+   size_t holds;
+};
+
+} // namespace be::bed::detail
+
+///////////////////////////////////////////////////////////////////////////////
+/// \class  PooledConnection   be/bed/connection_pool.h "be/bed/connection_pool.h"
+///
+/// \brief  A connection checked out of a ConnectionPool.
+/// \details PooledConnections are returned from ConnectionPool::hold() and
+///         are used like a pointer to the connection object.  When a
+///         PooledConnection is destroyed, the connection is returned to the
+///         pool.
+///
+///         Like CachedStmt, PooledConnections may be move-constructed, but
+///         not copied or assigned.  The pool must outlive any connections
+///         held from it.
+/// \ingroup db
+template <class T>
+class PooledConnection
+{
+   friend class ConnectionPool<T>;
+public:
+   PooledConnection(PooledConnection<T>&& other);
+   ~PooledConnection();
+
+   T& operator*() const;
+   T* operator->() const;
+   T* get() const;
+
+private:
+   PooledConnection(ConnectionPool<T>* pool, detail::ConnectionPoolSlot<T>& slot);
+
+   ConnectionPool<T>* pool_;
+   detail::ConnectionPoolSlot<T>* slot_;
+
+   PooledConnection(const PooledConnection<T>&);
+   void operator=(const PooledConnection<T>&);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \class  ConnectionPool   be/bed/connection_pool.h "be/bed/connection_pool.h"
+///
+/// \brief  Owns several connections to the same database so that multiple
+///         threads can access it at once.
+/// \details A single Db serializes every statement executed on it, so
+///         threads loading independent data from the same file end up
+///         waiting on each other.  A ConnectionPool instead opens up to
+///         \c capacity connections (typically read-only Beds or Sandwiches,
+///         each with their own StmtCache) using the factory function it was
+///         constructed with, and hands each one to a single thread at a time.
+///
+///         Connections are only opened when no existing connection is
+///         available.  A thread which calls hold() while it already holds a
+///         connection receives the same connection again, so nested loads
+///         never deadlock waiting on themselves.  When a connection is
+///         available, hold() prefers the one the calling thread used most
+///         recently, since its statements are likely to already be cached.
+///         If every connection is held by another thread and the pool is at
+///         capacity, hold() blocks until one is released.
+///
+/// \tparam T The type of connection object, eg. Bed or Sandwich.
+/// \ingroup db
+template <class T>
+class ConnectionPool
+{
+   friend class PooledConnection<T>;
+public:
+   explicit ConnectionPool(const std::function<T*()>& factory);
+   ConnectionPool(const std::function<T*()>& factory, size_t capacity);
+   ~ConnectionPool();
+
+   size_t getCapacity() const;
+   size_t getSize() const;
+
+   PooledConnection<T> hold();
+
+private:
+   void release_(detail::ConnectionPoolSlot<T>& slot);
+
+   std::function<T*()> factory_;
+   size_t capacity_;
+
+   mutable std::mutex mutex_;
+   std::condition_variable released_;
+   size_t waiters_;   ///< The number of threads blocked in hold().
+   std::unique_ptr<detail::ConnectionPoolSlot<T>[]> slots_;
+
+   ConnectionPool(const ConnectionPool<T>&);
+   void operator=(const ConnectionPool<T>&);
+};
+
+} // namespace be::bed
+} // namespace be
+
+#include "be/bed/connection_pool.inl"
+
+#endif
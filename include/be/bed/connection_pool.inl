@@ -0,0 +1,316 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/bed/connection_pool.inl
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of be::bed::ConnectionPool template functions.
+
+#if !defined(BE_BED_CONNECTION_POOL_H_) && !defined(DOXYGEN)
+#include "be/bed/connection_pool.h"
+#elif !defined(BE_BED_CONNECTION_POOL_INL_)
+#define BE_BED_CONNECTION_POOL_INL_
+
+#include <cassert>
+
+namespace be {
+namespace bed {
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs an empty slot.
+template <class T>
+inline ConnectionPoolSlot<T>::ConnectionPoolSlot()
+   : holds(0)
+{
+}
+
+} // namespace be::bed::detail
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Move constructor.
+/// \details After the move, \c other no longer holds a connection.
+///
+/// \param  other The PooledConnection to move.
+template <class T>
+inline PooledConnection<T>::PooledConnection(PooledConnection<T>&& other)
+   : pool_(other.pool_),
+     slot_(other.slot_)
+{
+   other.pool_ = nullptr;
+   other.slot_ = nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the connection to the pool it was held from.
+template <class T>
+inline PooledConnection<T>::~PooledConnection()
+{
+   if (pool_)
+      pool_->release_(*slot_);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the connection object.
+///
+/// \return A reference to the connection.
+template <class T>
+inline T& PooledConnection<T>::operator*() const
+{
+   return *slot_->connection;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Accesses members of the connection object.
+///
+/// \return A pointer to the connection.
+template <class T>
+inline T* PooledConnection<T>::operator->() const
+{
+   return slot_->connection.get();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the connection object.
+///
+/// \return A pointer to the connection, or nullptr if this PooledConnection
+///         has been moved from.
+template <class T>
+inline T* PooledConnection<T>::get() const
+{
+   return slot_ ? slot_->connection.get() : nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a PooledConnection for a slot which has already been
+///         marked as held by the calling thread.
+///
+/// \param  pool The pool which owns the slot.
+/// \param  slot The slot containing the held connection.
+template <class T>
+inline PooledConnection<T>::PooledConnection(ConnectionPool<T>* pool, detail::ConnectionPoolSlot<T>& slot)
+   : pool_(pool),
+     slot_(&slot)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a pool which will open up to one connection per
+///         hardware thread.
+///
+/// \param  factory A function which opens a new connection.  It may be
+///         called from any thread which calls hold().
+template <class T>
+inline ConnectionPool<T>::ConnectionPool(const std::function<T*()>& factory)
+   : factory_(factory),
+     capacity_(std::thread::hardware_concurrency()),
+     waiters_(0)
+{
+   if (capacity_ == 0)
+      capacity_ = 1;
+
+   slots_.reset(new detail::ConnectionPoolSlot<T>[capacity_]);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a pool which will open up to \c capacity connections.
+///
+/// \param  factory A function which opens a new connection.  It may be
+///         called from any thread which calls hold().
+/// \param  capacity The maximum number of connections to open.  If 0, the
+///         pool will have a capacity of 1.
+template <class T>
+inline ConnectionPool<T>::ConnectionPool(const std::function<T*()>& factory, size_t capacity)
+   : factory_(factory),
+     capacity_(capacity > 0 ? capacity : 1),
+     waiters_(0),
+     slots_(new detail::ConnectionPoolSlot<T>[capacity > 0 ? capacity : 1])
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Closes all connections in the pool.
+/// \details If any connections are still held, a warning is logged; they
+///         will be closed anyway, so their PooledConnections must not be
+///         used or destroyed after this point.
+template <class T>
+inline ConnectionPool<T>::~ConnectionPool()
+{
+   size_t held = 0;
+   for (size_t i = 0; i < capacity_; ++i)
+      if (slots_[i].holds > 0)
+         ++held;
+
+   if (held > 0)
+      BE_LOG(VWarning) << "ConnectionPool being destroyed with held connection(s)!" << BE_LOG_NL
+                       << "Held Connections: " << held << BE_LOG_END;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the maximum number of connections this pool will open.
+///
+/// \return The capacity of the pool.
+template <class T>
+inline size_t ConnectionPool<T>::getCapacity() const
+{
+   return capacity_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the number of connections which have been opened.
+///
+/// \return The number of open connections, whether held or not.
+template <class T>
+inline size_t ConnectionPool<T>::getSize() const
+{
+   std::lock_guard<std::mutex> lock(mutex_);
+
+   size_t size = 0;
+   for (size_t i = 0; i < capacity_; ++i)
+      if (slots_[i].connection)
+         ++size;
+
+   return size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Checks out a connection for use by the calling thread.
+/// \details If the calling thread already holds a connection from this pool,
+///         the same connection is returned.  Otherwise an unheld connection
+///         is returned (preferably the one this thread used last), or a new
+///         connection is opened if the pool is not yet at capacity.  If none
+///         of those are possible, hold() blocks until another thread releases
+///         its connection.
+///
+///         The factory function is called without the pool's mutex locked.
+///         If it throws, the exception is propagated to the caller.
+///
+/// \return A PooledConnection which returns the connection to the pool when
+///         it is destroyed.
+template <class T>
+inline PooledConnection<T> ConnectionPool<T>::hold()
+{
+   std::thread::id this_thread = std::this_thread::get_id();
+   std::unique_lock<std::mutex> lock(mutex_);
+
+   for (;;)
+   {
+      detail::ConnectionPoolSlot<T>* unheld = nullptr;
+      detail::ConnectionPoolSlot<T>* empty = nullptr;
+
+      for (size_t i = 0; i < capacity_; ++i)
+      {
+         detail::ConnectionPoolSlot<T>& slot = slots_[i];
+
+         if (slot.holds > 0)
+         {
+            if (slot.owner == this_thread)
+            {
+               ++slot.holds;
+               return PooledConnection<T>(this, slot);
+            }
+         }
+         else if (slot.connection)
+         {
+            if (!unheld || slot.last_owner == this_thread)
+               unheld = &slot;
+         }
+         else if (!empty)
+            empty = &slot;
+      }
+
+      if (unheld)
+      {
+         unheld->owner = this_thread;
+         unheld->holds = 1;
+         return PooledConnection<T>(this, *unheld);
+      }
+
+      if (empty)
+      {
+         // reserve the slot so no other thread uses it while the new
+         // connection is being opened without the mutex locked.
+         empty->owner = this_thread;
+         empty->holds = 1;
+         lock.unlock();
+
+         try
+         {
+            std::unique_ptr<T> connection(factory_());
+            lock.lock();
+            empty->connection = std::move(connection);
+         }
+         catch (...)
+         {
+            if (!lock.owns_lock())
+               lock.lock();
+
+            empty->owner = std::thread::id();
+            empty->holds = 0;
+            bool waiting = waiters_ > 0;
+            lock.unlock();
+
+            if (waiting)
+               released_.notify_one();
+            throw;
+         }
+
+         return PooledConnection<T>(this, *empty);
+      }
+
+      ++waiters_;
+      released_.wait(lock);
+      --waiters_;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns a connection to the pool when a PooledConnection is
+///         destroyed.
+/// \details The connection is only made available to other threads once
+///         every PooledConnection the owning thread holds for it has been
+///         destroyed.
+///
+/// \param  slot The slot containing the connection to release.
+template <class T>
+inline void ConnectionPool<T>::release_(detail::ConnectionPoolSlot<T>& slot)
+{
+   std::unique_lock<std::mutex> lock(mutex_);
+   assert(slot.holds > 0);
+
+   if (--slot.holds > 0)
+      return;
+
+   slot.last_owner = slot.owner;
+   slot.owner = std::thread::id();
+   bool waiting = waiters_ > 0;
+   lock.unlock();
+
+   // Most releases happen while no thread is waiting, so don't pay for a
+   // notification that nobody will receive.
+   if (waiting)
+      released_.notify_one();
+}
+
+} // namespace be::bed
+} // namespace be
+
+#endif
@@ -31,12 +31,14 @@
 #include <string>
 #include "sqlite3.h"
 
+#include "be/bed/db_config.h"
 #include "be/bed/detail/db_error.h"
 #include "be/id.h"
 
 namespace be {
 namespace bed {
 
+class BlobReader;
 class Stmt;
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -48,6 +50,7 @@ class Stmt;
 /// \ingroup db
 class Db
 {
+   friend class BlobReader;
    friend class Stmt;
 public:
    typedef detail::db_error error; ///< Exception type thrown when an SQLite function fails.  If related to a SQL query, it can be retrieved using Db::error::sql().
@@ -56,8 +59,11 @@ public:
    explicit Db(const std::string& path);
    explicit Db(const std::string& path, int flags);
    explicit Db(const std::string& path, int flags, const std::string& vfs_name);
+   Db(const std::string& path, int flags, const DbConfig& config);
    ~Db();
 
+   void configure(const DbConfig& config);
+
    void begin();
    void commit();
    void rollback();
@@ -0,0 +1,109 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/bed/db_config.h
+/// \author Benjamin Crist
+///
+/// \brief  be::bed::DbConfig class header.
+
+#ifndef BE_BED_DB_CONFIG_H_
+#define BE_BED_DB_CONFIG_H_
+#include "be/_be.h"
+
+#include "sqlite3.h"
+
+namespace be {
+namespace bed {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \class  DbConfig   be/bed/db_config.h "be/bed/db_config.h"
+///
+/// \brief  Describes the PRAGMA settings applied to a Db connection when it
+///         is opened.
+/// \details Each setting has a "default" value which leaves SQLite's own
+///         default (or the setting already stored in the database file)
+///         unchanged, so a default-constructed DbConfig has no effect.
+///
+///         The static functions provide profiles for the ways bengine
+///         normally uses databases: readOnly() for asset databases which are
+///         read by many threads, writable() for databases which are modified
+///         by the game, and editor() for databases which are being modified
+///         by the editor while they are also being read.
+///
+///         Note that the journal mode is stored in the database file when it
+///         is set to WAL, and can't be changed by a read-only connection.
+///         Once a writable connection has switched a file to WAL, readers no
+///         longer block the writer (or vice versa), but the switch persists:
+///         every later connection to the file uses WAL too, including
+///         read-only ones, which then need to be able to create the -wal and
+///         -shm files next to the database.  If the journal mode can't be
+///         changed (e.g. another connection is reading), Db::configure()
+///         logs a warning and the file keeps its current mode.
+/// \ingroup db
+struct DbConfig
+{
+   /// \brief  Values for <tt>PRAGMA journal_mode</tt>.
+   enum JournalMode
+   {
+      JournalDefault,
+      JournalDelete,
+      JournalTruncate,
+      JournalPersist,
+      JournalMemory,
+      JournalWal,
+      JournalOff
+   };
+
+   /// \brief  Values for <tt>PRAGMA synchronous</tt>.
+   enum Synchronous
+   {
+      SyncDefault,
+      SyncOff,
+      SyncNormal,
+      SyncFull
+   };
+
+   /// \brief  Values for <tt>PRAGMA temp_store</tt>.
+   enum TempStore
+   {
+      TempStoreDefault,
+      TempStoreFile,
+      TempStoreMemory
+   };
+
+   DbConfig();
+
+   static DbConfig readOnly();
+   static DbConfig writable();
+   static DbConfig editor();
+
+   JournalMode journal_mode;
+   Synchronous synchronous;
+   TempStore temp_store;
+   sqlite3_int64 mmap_size;   ///< Maximum bytes of the file to memory-map, or a negative value to leave unchanged.
+   int cache_size;            ///< Page cache size in KiB, or 0 to leave unchanged.
+   int busy_timeout;          ///< Milliseconds to retry when the database is locked, or 0 to fail immediately.
+};
+
+} // namespace be::bed
+} // namespace be
+
+#endif
@@ -0,0 +1,167 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/bed/detail/column_traits.h
+/// \author Benjamin Crist
+///
+/// \brief  be::bed::detail::ColumnTraits template header.
+
+#ifndef BE_BED_DETAIL_COLUMN_TRAITS_H_
+#define BE_BED_DETAIL_COLUMN_TRAITS_H_
+#include "be/_be.h"
+
+#include <climits>
+#include <string>
+#include <type_traits>
+#include "sqlite3.h"
+
+#include "be/id.h"
+
+namespace be {
+namespace bed {
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \class  ColumnTraits   be/bed/detail/column_traits.h "be/bed/detail/column_traits.h"
+///
+/// \brief  Selects the sqlite3_column_*() and sqlite3_bind_*() functions to
+///         use for a C++ type at compile time.
+/// \details Used by Stmt::bindAll(), Stmt::readRow() and RowReader.  The
+///         primary template is not defined, so using an unsupported type is
+///         a compile error.  Supported types are:
+///
+///         - All integral types (including \c bool) and enumerations, stored
+///           as 64-bit integers.  Like Stmt::getUInt(), unsigned values are
+///           stored in 2's complement format.
+///         - \c float and \c double.
+///         - \c std::string and <tt>const char*</tt>, stored as text.
+///           Strings are copied when bound.  A <tt>const char*</tt> read
+///           from a column is valid only until the statement is stepped,
+///           reset or destroyed.
+///         - be::Id, stored as a 64-bit integer.
+template <typename T, typename Enable = void>
+struct ColumnTraits;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  ColumnTraits for integral and enumeration types.
+template <typename T>
+struct ColumnTraits<T, typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type>
+{
+   static T get(sqlite3_stmt* stmt, int column)
+   {
+      return static_cast<T>(sqlite3_column_int64(stmt, column));
+   }
+
+   static int bind(sqlite3_stmt* stmt, int parameter, T value)
+   {
+      return sqlite3_bind_int64(stmt, parameter, static_cast<sqlite3_int64>(value));
+   }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  ColumnTraits for floating point types.
+template <typename T>
+struct ColumnTraits<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+{
+   static T get(sqlite3_stmt* stmt, int column)
+   {
+      return static_cast<T>(sqlite3_column_double(stmt, column));
+   }
+
+   static int bind(sqlite3_stmt* stmt, int parameter, T value)
+   {
+      return sqlite3_bind_double(stmt, parameter, static_cast<double>(value));
+   }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  ColumnTraits for \c std::string.
+template <>
+struct ColumnTraits<std::string>
+{
+   static std::string get(sqlite3_stmt* stmt, int column)
+   {
+      const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, column));
+      return text ? std::string(text, sqlite3_column_bytes(stmt, column)) : std::string();
+   }
+
+   static int bind(sqlite3_stmt* stmt, int parameter, const std::string& value)
+   {
+      // sqlite3_bind_text() takes an int length; longer strings can't be
+      // bound without truncating them.
+      if (value.length() > size_t(INT_MAX))
+         return SQLITE_TOOBIG;
+
+      return sqlite3_bind_text(stmt, parameter, value.c_str(), static_cast<int>(value.length()), SQLITE_TRANSIENT);
+   }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  ColumnTraits for <tt>const char*</tt>.
+/// \details Null pointers are bound as NULL.
+template <>
+struct ColumnTraits<const char*>
+{
+   static const char* get(sqlite3_stmt* stmt, int column)
+   {
+      return reinterpret_cast<const char*>(sqlite3_column_text(stmt, column));
+   }
+
+   static int bind(sqlite3_stmt* stmt, int parameter, const char* value)
+   {
+      if (!value)
+         return sqlite3_bind_null(stmt, parameter);
+      return sqlite3_bind_text(stmt, parameter, value, -1, SQLITE_TRANSIENT);
+   }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  ColumnTraits for string literals, which can only be bound.
+template <size_t N>
+struct ColumnTraits<char[N]>
+{
+   static int bind(sqlite3_stmt* stmt, int parameter, const char (&value)[N])
+   {
+      return sqlite3_bind_text(stmt, parameter, value, -1, SQLITE_TRANSIENT);
+   }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  ColumnTraits for be::Id.
+template <>
+struct ColumnTraits<Id>
+{
+   static Id get(sqlite3_stmt* stmt, int column)
+   {
+      return Id(static_cast<uint64_t>(sqlite3_column_int64(stmt, column)));
+   }
+
+   static int bind(sqlite3_stmt* stmt, int parameter, const Id& value)
+   {
+      return sqlite3_bind_int64(stmt, parameter, static_cast<sqlite3_int64>(value.value()));
+   }
+};
+
+} // namespace be::bed::detail
+} // namespace be::bed
+} // namespace be
+
+#endif
@@ -39,20 +39,30 @@ namespace detail {
 /// \class  StmtCacheEntry   be/bed/detail/stmt_cache_entry.h "be/bed/detail/stmt_cache_entry.h"
 ///
 /// \brief  Used by StmtCache to keep track of which statements are currently
-///         held or unheld, and how recently each statement was held.
+///         held or unheld, and how recently each statement was released.
+/// \details Each entry is linked into exactly one of two intrusive lists
+///         owned by the StmtCache: the list of held entries, or the list of
+///         unheld entries in the order they were released (least recently
+///         released first).  Unheld entries are also linked to the other
+///         unheld entries with the same Id, so that hold(), release, and
+///         eviction never need to search the cache.
 struct StmtCacheEntry
 {
 public:
    StmtCacheEntry();
    StmtCacheEntry(Stmt* stmt);
 
-   StmtCacheEntry(StmtCacheEntry&& other);
-   void operator=(StmtCacheEntry&& other);
+   void link(StmtCacheEntry& before);
+   void unlink();
 
    bool held;
-   size_t access_index;
    std::unique_ptr<Stmt> stmt;
 
+   StmtCacheEntry* prev;      ///< Previous entry in the held or unheld list.
+   StmtCacheEntry* next;      ///< Next entry in the held or unheld list.
+   StmtCacheEntry* id_prev;   ///< Previous (more recently released) unheld entry with the same Id.
+   StmtCacheEntry* id_next;   ///< Next (less recently released) unheld entry with the same Id.
+
 private:
    StmtCacheEntry(const StmtCacheEntry&);
    void operator=(const StmtCacheEntry&);
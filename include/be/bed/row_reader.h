@@ -0,0 +1,97 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/bed/row_reader.h
+/// \author Benjamin Crist
+///
+/// \brief  be::bed::RowReader class header.
+
+#ifndef BE_BED_ROW_READER_H_
+#define BE_BED_ROW_READER_H_
+#include "be/_be.h"
+
+#include "sqlite3.h"
+
+#include "be/bed/detail/column_traits.h"
+
+namespace be {
+namespace bed {
+
+class CachedStmt;
+class Stmt;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \class  RowReader   be/bed/row_reader.h "be/bed/row_reader.h"
+///
+/// \brief  Reads consecutive columns of the current row of a statement.
+/// \details The function used to read each column is chosen at compile time
+///         from the type of the destination (see detail::ColumnTraits) and
+///         inlined, so reading a row costs little more than the
+///         sqlite3_column_*() calls themselves:
+///
+/// \code
+///         db::RowReader row(stmt);
+///         row >> ws.mode >> ws.position.x >> ws.position.y;
+/// \endcode
+///
+///         Stmt::readInto() uses a RowReader to read a whole row into an
+///         object.  To support this for a struct, overload \c operator>> in
+///         the struct's namespace:
+///
+/// \code
+///         db::RowReader& operator>>(db::RowReader& row, Vertex& v)
+///         {
+///            return row >> v.x >> v.y >> v.z;
+///         }
+/// \endcode
+///
+///         A RowReader must not be used after the statement is stepped,
+///         reset or destroyed.
+/// \ingroup db
+class RowReader
+{
+public:
+   explicit RowReader(Stmt& stmt);
+   explicit RowReader(CachedStmt& stmt);
+   RowReader(Stmt& stmt, int column);
+   RowReader(CachedStmt& stmt, int column);
+
+   template <typename T>
+   RowReader& operator>>(T& value);
+
+   template <typename T>
+   T read();
+
+   RowReader& skip(int columns);
+
+   int getColumn() const;
+
+private:
+   sqlite3_stmt* stmt_;
+   int column_;
+};
+
+} // namespace be::bed
+} // namespace be
+
+#include "be/bed/row_reader.inl"
+
+#endif
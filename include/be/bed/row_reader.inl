@@ -0,0 +1,64 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/bed/row_reader.inl
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of be::bed::RowReader template functions.
+
+#if !defined(BE_BED_ROW_READER_H_) && !defined(DOXYGEN)
+#include "be/bed/row_reader.h"
+#elif !defined(BE_BED_ROW_READER_INL_)
+#define BE_BED_ROW_READER_INL_
+
+#include <cassert>
+
+namespace be {
+namespace bed {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads the next column into \c value.
+///
+/// \param  value Receives the value of the column.
+/// \return This RowReader, to allow chaining.
+template <typename T>
+inline RowReader& RowReader::operator>>(T& value)
+{
+   assert(column_ >= 0 && column_ < sqlite3_column_count(stmt_));
+   value = detail::ColumnTraits<T>::get(stmt_, column_++);
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads the next column.
+///
+/// \return The value of the column.
+template <typename T>
+inline T RowReader::read()
+{
+   assert(column_ >= 0 && column_ < sqlite3_column_count(stmt_));
+   return detail::ColumnTraits<T>::get(stmt_, column_++);
+}
+
+} // namespace be::bed
+} // namespace be
+
+#endif
@@ -0,0 +1,149 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/bed/sql_profiler.h
+/// \author Benjamin Crist
+///
+/// \brief  be::bed::SqlProfiler class header.
+
+#ifndef BE_BED_SQL_PROFILER_H_
+#define BE_BED_SQL_PROFILER_H_
+#include "be/_be.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "be/id.h"
+#include "be/id_map.h"
+
+namespace be {
+namespace bed {
+namespace detail {
+
+struct SqlProfileRecord;
+
+extern std::atomic<bool> sql_profiler_active;
+
+void recordSqlPrepare(const Id& id, const char* sql, uint64_t ticks);
+void recordSqlExecution(const Id& id, const char* sql, uint64_t ticks, uint64_t rows, bool failed);
+void recordSqlCacheHold(const Id& id, bool hit);
+void recordSqlCacheEviction(const Id& id);
+
+} // namespace be::bed::detail
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Statistics collected by a SqlProfiler for all statements with the
+///         same Id.
+/// \details An execution begins with the first call to Stmt::step() and
+///         ends when step() returns \c false or throws, or when the
+///         statement is reset or destroyed.
+/// \ingroup db
+struct SqlStmtStats
+{
+   Id id;                     ///< The statement Id.
+   std::string sql;           ///< The SQL text of the first statement seen with this Id.
+   uint64_t prepares;         ///< The number of times the SQL was compiled.
+   double prepare_ms;         ///< Total time spent compiling the SQL, in milliseconds.
+   uint64_t executions;       ///< The number of completed executions.
+   uint64_t errors;           ///< The number of executions which ended with an error.
+   uint64_t rows;             ///< The total number of rows returned by all executions.
+   double total_ms;           ///< Total time spent in Stmt::step(), in milliseconds.
+   double max_ms;             ///< The longest single execution, in milliseconds.
+   double p99_ms;             ///< 99% of executions took no longer than this (within 12.5%).
+   uint64_t cache_hits;       ///< StmtCache::hold() calls which reused a compiled statement.
+   uint64_t cache_misses;     ///< StmtCache::hold() calls which compiled a new statement.
+   uint64_t cache_evictions;  ///< Statements with this Id destroyed to keep a StmtCache within capacity.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \class  SqlProfiler   be/bed/sql_profiler.h "be/bed/sql_profiler.h"
+///
+/// \brief  Collects per-statement timing and StmtCache statistics while it
+///         exists.
+/// \details Stmt and StmtCache report to the active SqlProfiler; when none
+///         exists they perform only a relaxed atomic load.  Statistics are
+///         grouped by statement Id, so statements held from a StmtCache with
+///         an explicit Id are reported together even if their SQL is
+///         formatted differently.
+///
+///         Executions are timed around sqlite3_step() using the same
+///         timestamps as profiling zones, rather than with sqlite3_profile(),
+///         whose timings have millisecond resolution on some platforms and
+///         are reported only with the SQL text.
+///
+///         If a log interval is provided, a report of the most expensive
+///         statements is written to the log (at VInfo verbosity) whenever a
+///         statement finishes executing at least that long after the
+///         previous report, and again when the profiler is destroyed.
+///
+///         Only one SqlProfiler may exist at a time.  It may be used from any
+///         thread.
+/// \ingroup db
+class SqlProfiler
+{
+public:
+   SqlProfiler();
+   explicit SqlProfiler(std::chrono::seconds log_interval, size_t log_statements = 10);
+   ~SqlProfiler();
+
+   std::vector<SqlStmtStats> getStats();
+   SqlStmtStats getStats(const Id& id);
+   void reset();
+
+   void writeReport(std::ostream& os, size_t max_statements);
+   void logReport();
+
+private:
+   friend void detail::recordSqlPrepare(const Id&, const char*, uint64_t);
+   friend void detail::recordSqlExecution(const Id&, const char*, uint64_t, uint64_t, bool);
+   friend void detail::recordSqlCacheHold(const Id&, bool);
+   friend void detail::recordSqlCacheEviction(const Id&);
+
+   void init_();
+   detail::SqlProfileRecord& getRecord_(const Id& id);
+   std::vector<SqlStmtStats> getStats_();
+   void writeReport_(std::ostream& os, size_t max_statements);
+   SqlStmtStats makeStats_(const detail::SqlProfileRecord& record, double ticks_per_ms) const;
+   double ticksPerMs_() const;
+   bool checkLogInterval_();
+
+   std::chrono::seconds log_interval_;    ///< Zero if periodic logging is disabled.
+   size_t log_statements_;
+   std::chrono::steady_clock::time_point next_log_time_;
+
+   uint64_t origin_ticks_;
+   std::chrono::steady_clock::time_point origin_time_;
+
+   IdMap<std::unique_ptr<detail::SqlProfileRecord> > records_;
+
+   SqlProfiler(const SqlProfiler&);
+   void operator=(const SqlProfiler&);
+};
+
+} // namespace be::bed
+} // namespace be
+
+#endif
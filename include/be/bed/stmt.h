@@ -31,7 +31,9 @@
 #include <string>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 #include <cassert>
+#include <cstdint>
 #include <ostream>
 #include "sqlite3.h"
 
@@ -49,9 +51,16 @@ namespace bed {
 ///         prepared statement -- a compiled SQL query -- along with its
 ///         currently bound parameters and the resultset returned when the
 ///         query is executed.
+///
+///         Besides the bind() and get...() functions, which choose a type at
+///         runtime, the bindAll(), readRow(), readInto() and get<T>()
+///         templates choose the SQLite function for each value at compile
+///         time and are inlined, which makes loops over many rows cheaper.
 /// \ingroup db
 class Stmt
 {
+   friend class BatchWriter;
+   friend class RowReader;
 public:
    Stmt(Db& db, const std::string& sql);
    Stmt(Db& db, const Id& id, const std::string& sql);
@@ -86,6 +95,7 @@ public:
 
    int columns();
    int column(const std::string& name);
+   int column(const Id& name);
 
    int getType(int column);
 
@@ -99,11 +109,50 @@ public:
    std::string getBlob(int column);
    int getBlob(int column, const void*& dest);
 
+   template <typename T> T get(int column);
+
+   template <typename T0> void bindAll(const T0& a0);
+   template <typename T0, typename T1> void bindAll(const T0& a0, const T1& a1);
+   template <typename T0, typename T1, typename T2> void bindAll(const T0& a0, const T1& a1, const T2& a2);
+   template <typename T0, typename T1, typename T2, typename T3> void bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4> void bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5> void bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6> void bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5, const T6& a6);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7> void bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5, const T6& a6, const T7& a7);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8> void bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5, const T6& a6, const T7& a7, const T8& a8);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8, typename T9> void bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5, const T6& a6, const T7& a7, const T8& a8, const T9& a9);
+
+   template <typename T0> void readRow(T0& a0);
+   template <typename T0, typename T1> void readRow(T0& a0, T1& a1);
+   template <typename T0, typename T1, typename T2> void readRow(T0& a0, T1& a1, T2& a2);
+   template <typename T0, typename T1, typename T2, typename T3> void readRow(T0& a0, T1& a1, T2& a2, T3& a3);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4> void readRow(T0& a0, T1& a1, T2& a2, T3& a3, T4& a4);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5> void readRow(T0& a0, T1& a1, T2& a2, T3& a3, T4& a4, T5& a5);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6> void readRow(T0& a0, T1& a1, T2& a2, T3& a3, T4& a4, T5& a5, T6& a6);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7> void readRow(T0& a0, T1& a1, T2& a2, T3& a3, T4& a4, T5& a5, T6& a6, T7& a7);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8> void readRow(T0& a0, T1& a1, T2& a2, T3& a3, T4& a4, T5& a5, T6& a6, T7& a7, T8& a8);
+   template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8, typename T9> void readRow(T0& a0, T1& a1, T2& a2, T3& a3, T4& a4, T5& a5, T6& a6, T7& a7, T8& a8, T9& a9);
+
+   template <typename T> void readInto(T& row);
+
 private:
+   void prepare_(const std::string& sql);
+   void checkBind_(int result);
+   void throwBindError_(int result);
+   void recordProfile_(bool failed);
+   int findColumn_(const Id& name);
+   void buildColumnIds_();
+
    Db& db_;
    Id id_;
    sqlite3_stmt* stmt_;
-   std::unique_ptr<std::unordered_map<std::string, int> > col_names_;
+   std::vector<Id> col_ids_;  ///< Hashed column names, indexed by column.
+   std::vector<uint32_t> col_checked_; ///< The execution during which each column's Id was last verified.
+   uint32_t execution_;       ///< Incremented whenever step() begins a new execution.
+
+   bool profiling_;           ///< True if a SqlProfiler saw the current execution begin.
+   uint64_t profile_ticks_;   ///< Time spent in step() during the current execution.
+   uint64_t profile_rows_;    ///< Rows returned during the current execution.
 
    Stmt(const Stmt&);
    void operator=(const Stmt&);
@@ -114,4 +163,6 @@ std::ostream& operator<<(std::ostream& os, const Stmt& s);
 } // namespace be::bed
 } // namespace be
 
+#include "be/bed/stmt.inl"
+
 #endif
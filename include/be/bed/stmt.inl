@@ -0,0 +1,369 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/bed/stmt.inl
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of be::bed::Stmt template functions.
+
+#if !defined(BE_BED_STMT_H_) && !defined(DOXYGEN)
+#include "be/bed/stmt.h"
+#elif !defined(BE_BED_STMT_INL_)
+#define BE_BED_STMT_INL_
+
+#include "be/bed/detail/column_traits.h"
+#include "be/bed/row_reader.h"
+
+namespace be {
+namespace bed {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the specified column as a \c T.
+///
+/// \details The conversion is selected at compile time by
+///         detail::ColumnTraits, and is inlined into the caller.
+///
+/// \param  column The column to retrieve.
+/// \return The value of the column.
+template <typename T>
+inline T Stmt::get(int column)
+{
+   assert(column >= 0 && column < columns());
+   return detail::ColumnTraits<T>::get(stmt_, column);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds values to parameters 1 through 1.
+///
+/// \details The bind function used for each value is selected at compile
+///         time by detail::ColumnTraits.  Any other parameters keep their
+///         current values.
+template <typename T0>
+inline void Stmt::bindAll(const T0& a0)
+{
+   checkBind_(detail::ColumnTraits<T0>::bind(stmt_, 1, a0));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds values to parameters 1 through 2.
+/// \copydetails bindAll(const T0&)
+template <typename T0, typename T1>
+inline void Stmt::bindAll(const T0& a0, const T1& a1)
+{
+   checkBind_(detail::ColumnTraits<T0>::bind(stmt_, 1, a0));
+   checkBind_(detail::ColumnTraits<T1>::bind(stmt_, 2, a1));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds values to parameters 1 through 3.
+/// \copydetails bindAll(const T0&)
+template <typename T0, typename T1, typename T2>
+inline void Stmt::bindAll(const T0& a0, const T1& a1, const T2& a2)
+{
+   checkBind_(detail::ColumnTraits<T0>::bind(stmt_, 1, a0));
+   checkBind_(detail::ColumnTraits<T1>::bind(stmt_, 2, a1));
+   checkBind_(detail::ColumnTraits<T2>::bind(stmt_, 3, a2));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds values to parameters 1 through 4.
+/// \copydetails bindAll(const T0&)
+template <typename T0, typename T1, typename T2, typename T3>
+inline void Stmt::bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3)
+{
+   checkBind_(detail::ColumnTraits<T0>::bind(stmt_, 1, a0));
+   checkBind_(detail::ColumnTraits<T1>::bind(stmt_, 2, a1));
+   checkBind_(detail::ColumnTraits<T2>::bind(stmt_, 3, a2));
+   checkBind_(detail::ColumnTraits<T3>::bind(stmt_, 4, a3));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds values to parameters 1 through 5.
+/// \copydetails bindAll(const T0&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4>
+inline void Stmt::bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4)
+{
+   checkBind_(detail::ColumnTraits<T0>::bind(stmt_, 1, a0));
+   checkBind_(detail::ColumnTraits<T1>::bind(stmt_, 2, a1));
+   checkBind_(detail::ColumnTraits<T2>::bind(stmt_, 3, a2));
+   checkBind_(detail::ColumnTraits<T3>::bind(stmt_, 4, a3));
+   checkBind_(detail::ColumnTraits<T4>::bind(stmt_, 5, a4));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds values to parameters 1 through 6.
+/// \copydetails bindAll(const T0&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5>
+inline void Stmt::bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5)
+{
+   checkBind_(detail::ColumnTraits<T0>::bind(stmt_, 1, a0));
+   checkBind_(detail::ColumnTraits<T1>::bind(stmt_, 2, a1));
+   checkBind_(detail::ColumnTraits<T2>::bind(stmt_, 3, a2));
+   checkBind_(detail::ColumnTraits<T3>::bind(stmt_, 4, a3));
+   checkBind_(detail::ColumnTraits<T4>::bind(stmt_, 5, a4));
+   checkBind_(detail::ColumnTraits<T5>::bind(stmt_, 6, a5));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds values to parameters 1 through 7.
+/// \copydetails bindAll(const T0&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6>
+inline void Stmt::bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5, const T6& a6)
+{
+   checkBind_(detail::ColumnTraits<T0>::bind(stmt_, 1, a0));
+   checkBind_(detail::ColumnTraits<T1>::bind(stmt_, 2, a1));
+   checkBind_(detail::ColumnTraits<T2>::bind(stmt_, 3, a2));
+   checkBind_(detail::ColumnTraits<T3>::bind(stmt_, 4, a3));
+   checkBind_(detail::ColumnTraits<T4>::bind(stmt_, 5, a4));
+   checkBind_(detail::ColumnTraits<T5>::bind(stmt_, 6, a5));
+   checkBind_(detail::ColumnTraits<T6>::bind(stmt_, 7, a6));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds values to parameters 1 through 8.
+/// \copydetails bindAll(const T0&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7>
+inline void Stmt::bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5, const T6& a6, const T7& a7)
+{
+   checkBind_(detail::ColumnTraits<T0>::bind(stmt_, 1, a0));
+   checkBind_(detail::ColumnTraits<T1>::bind(stmt_, 2, a1));
+   checkBind_(detail::ColumnTraits<T2>::bind(stmt_, 3, a2));
+   checkBind_(detail::ColumnTraits<T3>::bind(stmt_, 4, a3));
+   checkBind_(detail::ColumnTraits<T4>::bind(stmt_, 5, a4));
+   checkBind_(detail::ColumnTraits<T5>::bind(stmt_, 6, a5));
+   checkBind_(detail::ColumnTraits<T6>::bind(stmt_, 7, a6));
+   checkBind_(detail::ColumnTraits<T7>::bind(stmt_, 8, a7));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds values to parameters 1 through 9.
+/// \copydetails bindAll(const T0&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8>
+inline void Stmt::bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5, const T6& a6, const T7& a7, const T8& a8)
+{
+   checkBind_(detail::ColumnTraits<T0>::bind(stmt_, 1, a0));
+   checkBind_(detail::ColumnTraits<T1>::bind(stmt_, 2, a1));
+   checkBind_(detail::ColumnTraits<T2>::bind(stmt_, 3, a2));
+   checkBind_(detail::ColumnTraits<T3>::bind(stmt_, 4, a3));
+   checkBind_(detail::ColumnTraits<T4>::bind(stmt_, 5, a4));
+   checkBind_(detail::ColumnTraits<T5>::bind(stmt_, 6, a5));
+   checkBind_(detail::ColumnTraits<T6>::bind(stmt_, 7, a6));
+   checkBind_(detail::ColumnTraits<T7>::bind(stmt_, 8, a7));
+   checkBind_(detail::ColumnTraits<T8>::bind(stmt_, 9, a8));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds values to parameters 1 through 10.
+/// \copydetails bindAll(const T0&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8, typename T9>
+inline void Stmt::bindAll(const T0& a0, const T1& a1, const T2& a2, const T3& a3, const T4& a4, const T5& a5, const T6& a6, const T7& a7, const T8& a8, const T9& a9)
+{
+   checkBind_(detail::ColumnTraits<T0>::bind(stmt_, 1, a0));
+   checkBind_(detail::ColumnTraits<T1>::bind(stmt_, 2, a1));
+   checkBind_(detail::ColumnTraits<T2>::bind(stmt_, 3, a2));
+   checkBind_(detail::ColumnTraits<T3>::bind(stmt_, 4, a3));
+   checkBind_(detail::ColumnTraits<T4>::bind(stmt_, 5, a4));
+   checkBind_(detail::ColumnTraits<T5>::bind(stmt_, 6, a5));
+   checkBind_(detail::ColumnTraits<T6>::bind(stmt_, 7, a6));
+   checkBind_(detail::ColumnTraits<T7>::bind(stmt_, 8, a7));
+   checkBind_(detail::ColumnTraits<T8>::bind(stmt_, 9, a8));
+   checkBind_(detail::ColumnTraits<T9>::bind(stmt_, 10, a9));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads columns 0 through 0 of the current row.
+///
+/// \details The column function used for each value is selected at compile
+///         time by detail::ColumnTraits, so unlike calling getInt() etc.
+///         for each column, nothing is checked at runtime except (in debug
+///         builds) the number of columns.
+template <typename T0>
+inline void Stmt::readRow(T0& a0)
+{
+   assert(columns() >= 1);
+   a0 = detail::ColumnTraits<T0>::get(stmt_, 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads columns 0 through 1 of the current row.
+/// \copydetails readRow(T0&)
+template <typename T0, typename T1>
+inline void Stmt::readRow(T0& a0, T1& a1)
+{
+   assert(columns() >= 2);
+   a0 = detail::ColumnTraits<T0>::get(stmt_, 0);
+   a1 = detail::ColumnTraits<T1>::get(stmt_, 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads columns 0 through 2 of the current row.
+/// \copydetails readRow(T0&)
+template <typename T0, typename T1, typename T2>
+inline void Stmt::readRow(T0& a0, T1& a1, T2& a2)
+{
+   assert(columns() >= 3);
+   a0 = detail::ColumnTraits<T0>::get(stmt_, 0);
+   a1 = detail::ColumnTraits<T1>::get(stmt_, 1);
+   a2 = detail::ColumnTraits<T2>::get(stmt_, 2);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads columns 0 through 3 of the current row.
+/// \copydetails readRow(T0&)
+template <typename T0, typename T1, typename T2, typename T3>
+inline void Stmt::readRow(T0& a0, T1& a1, T2& a2, T3& a3)
+{
+   assert(columns() >= 4);
+   a0 = detail::ColumnTraits<T0>::get(stmt_, 0);
+   a1 = detail::ColumnTraits<T1>::get(stmt_, 1);
+   a2 = detail::ColumnTraits<T2>::get(stmt_, 2);
+   a3 = detail::ColumnTraits<T3>::get(stmt_, 3);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads columns 0 through 4 of the current row.
+/// \copydetails readRow(T0&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4>
+inline void Stmt::readRow(T0& a0, T1& a1, T2& a2, T3& a3, T4& a4)
+{
+   assert(columns() >= 5);
+   a0 = detail::ColumnTraits<T0>::get(stmt_, 0);
+   a1 = detail::ColumnTraits<T1>::get(stmt_, 1);
+   a2 = detail::ColumnTraits<T2>::get(stmt_, 2);
+   a3 = detail::ColumnTraits<T3>::get(stmt_, 3);
+   a4 = detail::ColumnTraits<T4>::get(stmt_, 4);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads columns 0 through 5 of the current row.
+/// \copydetails readRow(T0&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5>
+inline void Stmt::readRow(T0& a0, T1& a1, T2& a2, T3& a3, T4& a4, T5& a5)
+{
+   assert(columns() >= 6);
+   a0 = detail::ColumnTraits<T0>::get(stmt_, 0);
+   a1 = detail::ColumnTraits<T1>::get(stmt_, 1);
+   a2 = detail::ColumnTraits<T2>::get(stmt_, 2);
+   a3 = detail::ColumnTraits<T3>::get(stmt_, 3);
+   a4 = detail::ColumnTraits<T4>::get(stmt_, 4);
+   a5 = detail::ColumnTraits<T5>::get(stmt_, 5);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads columns 0 through 6 of the current row.
+/// \copydetails readRow(T0&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6>
+inline void Stmt::readRow(T0& a0, T1& a1, T2& a2, T3& a3, T4& a4, T5& a5, T6& a6)
+{
+   assert(columns() >= 7);
+   a0 = detail::ColumnTraits<T0>::get(stmt_, 0);
+   a1 = detail::ColumnTraits<T1>::get(stmt_, 1);
+   a2 = detail::ColumnTraits<T2>::get(stmt_, 2);
+   a3 = detail::ColumnTraits<T3>::get(stmt_, 3);
+   a4 = detail::ColumnTraits<T4>::get(stmt_, 4);
+   a5 = detail::ColumnTraits<T5>::get(stmt_, 5);
+   a6 = detail::ColumnTraits<T6>::get(stmt_, 6);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads columns 0 through 7 of the current row.
+/// \copydetails readRow(T0&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7>
+inline void Stmt::readRow(T0& a0, T1& a1, T2& a2, T3& a3, T4& a4, T5& a5, T6& a6, T7& a7)
+{
+   assert(columns() >= 8);
+   a0 = detail::ColumnTraits<T0>::get(stmt_, 0);
+   a1 = detail::ColumnTraits<T1>::get(stmt_, 1);
+   a2 = detail::ColumnTraits<T2>::get(stmt_, 2);
+   a3 = detail::ColumnTraits<T3>::get(stmt_, 3);
+   a4 = detail::ColumnTraits<T4>::get(stmt_, 4);
+   a5 = detail::ColumnTraits<T5>::get(stmt_, 5);
+   a6 = detail::ColumnTraits<T6>::get(stmt_, 6);
+   a7 = detail::ColumnTraits<T7>::get(stmt_, 7);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads columns 0 through 8 of the current row.
+/// \copydetails readRow(T0&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8>
+inline void Stmt::readRow(T0& a0, T1& a1, T2& a2, T3& a3, T4& a4, T5& a5, T6& a6, T7& a7, T8& a8)
+{
+   assert(columns() >= 9);
+   a0 = detail::ColumnTraits<T0>::get(stmt_, 0);
+   a1 = detail::ColumnTraits<T1>::get(stmt_, 1);
+   a2 = detail::ColumnTraits<T2>::get(stmt_, 2);
+   a3 = detail::ColumnTraits<T3>::get(stmt_, 3);
+   a4 = detail::ColumnTraits<T4>::get(stmt_, 4);
+   a5 = detail::ColumnTraits<T5>::get(stmt_, 5);
+   a6 = detail::ColumnTraits<T6>::get(stmt_, 6);
+   a7 = detail::ColumnTraits<T7>::get(stmt_, 7);
+   a8 = detail::ColumnTraits<T8>::get(stmt_, 8);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads columns 0 through 9 of the current row.
+/// \copydetails readRow(T0&)
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8, typename T9>
+inline void Stmt::readRow(T0& a0, T1& a1, T2& a2, T3& a3, T4& a4, T5& a5, T6& a6, T7& a7, T8& a8, T9& a9)
+{
+   assert(columns() >= 10);
+   a0 = detail::ColumnTraits<T0>::get(stmt_, 0);
+   a1 = detail::ColumnTraits<T1>::get(stmt_, 1);
+   a2 = detail::ColumnTraits<T2>::get(stmt_, 2);
+   a3 = detail::ColumnTraits<T3>::get(stmt_, 3);
+   a4 = detail::ColumnTraits<T4>::get(stmt_, 4);
+   a5 = detail::ColumnTraits<T5>::get(stmt_, 5);
+   a6 = detail::ColumnTraits<T6>::get(stmt_, 6);
+   a7 = detail::ColumnTraits<T7>::get(stmt_, 7);
+   a8 = detail::ColumnTraits<T8>::get(stmt_, 8);
+   a9 = detail::ColumnTraits<T9>::get(stmt_, 9);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads the current row into an object using a RowReader.
+///
+/// \details Reads consecutive columns, starting with column 0, using
+///         <tt>RowReader& operator>>(RowReader&, T&)</tt>, which must be
+///         declared in \c T's namespace.
+///
+/// \param  row The object to read into.
+/// \sa     RowReader
+template <typename T>
+inline void Stmt::readInto(T& row)
+{
+   RowReader reader(*this);
+   reader >> row;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Throws if an sqlite3_bind_*() function failed.
+///
+/// \param  result The value returned by sqlite3_bind_*().
+inline void Stmt::checkBind_(int result)
+{
+   if (result != SQLITE_OK)
+      throwBindError_(result);
+}
+
+} // namespace be::bed
+} // namespace be
+
+#endif
@@ -29,10 +29,10 @@
 
 #include "be/bed/detail/stmt_cache_entry.h"
 #include "be/bed/cached_stmt.h"
-#include "be/id.h"
+#include "be/id_map.h"
 
+#include <cstdint>
 #include <mutex>
-#include <unordered_map>
 
 #define BE_BED_STMT_CACHE_DEFAULT_MAX_SIZE 24
 
@@ -53,12 +53,21 @@ class Db;
 ///        reached.  Note that if there are no unheld statements the cache's
 ///        capacity may increase beyond its capacity.
 ///
+///        Unheld statements are kept in an intrusive list ordered by when they
+///        were released, and in per-Id lists, so holding, releasing, and
+///        evicting a statement all take constant time regardless of the
+///        cache's capacity.
+///
 ///        When a database client wants a particular statement, they call one
 ///        of the hold() functions.  When the client is finished using the
 ///        statement that was returned, they let it go out of scope, which
 ///        causes it to inform the cache the underlying Stmt object can be
 ///        used again.
 ///
+///        The cache counts hits, misses and evictions so that its capacity
+///        can be tuned.  If a SqlProfiler exists, these are also reported
+///        per statement Id.
+///
 ///        The cache is synchronized for concurrent access from multiple
 ///        threads.
 ///
@@ -83,6 +92,10 @@ public:
    size_t getSize();
    size_t getHeldSize();
 
+   uint64_t getHitCount();
+   uint64_t getMissCount();
+   uint64_t getEvictionCount();
+
    CachedStmt hold(const std::string& sql);
    CachedStmt hold(const char* sql);
    CachedStmt hold(const Id& id, const std::string& sql);
@@ -90,7 +103,8 @@ public:
 
 private:
    void hold_(detail::StmtCacheEntry& entry);
-   void release_(Stmt& stmt);
+   void release_(detail::StmtCacheEntry& entry);
+   void unlinkId_(detail::StmtCacheEntry& entry, detail::StmtCacheEntry*& head);
    void checkSize_();
 
    std::mutex mutex_;
@@ -98,12 +112,16 @@ private:
    Db& db_;
 
    size_t capacity_;
+   size_t size_;
    size_t held_size_;
 
-   size_t next_index_;
-   size_t oldest_index_;
+   uint64_t hits_;
+   uint64_t misses_;
+   uint64_t evictions_;
 
-   std::unordered_multimap<Id, detail::StmtCacheEntry> cache_;
+   detail::StmtCacheEntry held_;      ///< Head of the list of held entries.
+   detail::StmtCacheEntry unheld_;    ///< Head of the list of unheld entries, least recently released first.
+   IdMap<detail::StmtCacheEntry*> unheld_ids_;  ///< The most recently released unheld entry for each Id, or nullptr if they are all held.
 };
 
 } // namespace be::bed
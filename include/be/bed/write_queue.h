@@ -0,0 +1,122 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/bed/write_queue.h
+/// \author Benjamin Crist
+///
+/// \brief  be::bed::WriteQueue class header.
+
+#ifndef BE_BED_WRITE_QUEUE_H_
+#define BE_BED_WRITE_QUEUE_H_
+
+#include "be/_be.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define BE_BED_WRITE_QUEUE_DEFAULT_MAX_BATCH_SIZE 1024
+
+namespace be {
+namespace bed {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \class  WriteQueue   be/bed/write_queue.h "be/bed/write_queue.h"
+///
+/// \brief  Applies mutations to a writable database on a dedicated thread,
+///         committing many of them in each transaction.
+/// \details Committing a transaction usually means waiting for the disk to
+///         sync, which can take far longer than the changes themselves.
+///         Instead of each caller opening its own transaction, callers
+///         push() mutation functions onto the queue and immediately receive a
+///         \c std::future.  The writer thread takes every mutation which has
+///         been queued (up to the maximum batch size), applies them all inside
+///         a single immediate transaction, and commits once (group commit).
+///         Only then are the futures made ready.
+///
+///         Each mutation runs inside its own savepoint, so a mutation which
+///         throws is rolled back on its own, and its future receives the
+///         exception, without affecting the rest of the batch.  If the
+///         transaction can't be started or committed, every future in the
+///         batch receives the exception.  Mutations must not begin, commit
+///         or roll back transactions themselves.
+///
+///         The queue owns a shared reference to its connection, and nothing
+///         else should use that connection while the queue exists.  When the
+///         queue is destroyed, all mutations which have already been pushed
+///         are committed before the writer thread exits.
+///
+/// \tparam T The type of connection object, eg. Bed or Sandwich.  It must
+///         have a getDb() member function.
+/// \ingroup db
+template <class T>
+class WriteQueue
+{
+public:
+   typedef std::function<void(T&)> mutation_t;
+
+   explicit WriteQueue(const std::shared_ptr<T>& connection);
+   WriteQueue(const std::shared_ptr<T>& connection, size_t max_batch_size);
+   ~WriteQueue();
+
+   std::future<void> push(const mutation_t& mutation);
+   void flush();
+
+   size_t getMaxBatchSize() const;
+
+private:
+   struct Job
+   {
+      mutation_t mutation;
+      std::promise<void> promise;
+   };
+
+   void run_();
+   void commit_(std::vector<std::unique_ptr<Job> >& batch);
+
+   std::shared_ptr<T> connection_;
+   size_t max_batch_size_;
+
+   std::mutex mutex_;
+   std::condition_variable queued_;
+   std::condition_variable committed_;
+   std::deque<std::unique_ptr<Job> > queue_;
+   size_t pushed_count_;
+   size_t committed_count_;
+   bool stopping_;
+
+   std::thread thread_;
+
+   WriteQueue(const WriteQueue<T>&);
+   void operator=(const WriteQueue<T>&);
+};
+
+} // namespace be::bed
+} // namespace be
+
+#include "be/bed/write_queue.inl"
+
+#endif
@@ -0,0 +1,227 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/bed/write_queue.inl
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of be::bed::WriteQueue template functions.
+
+#if !defined(BE_BED_WRITE_QUEUE_H_) && !defined(DOXYGEN)
+#include "be/bed/write_queue.h"
+#elif !defined(BE_BED_WRITE_QUEUE_INL_)
+#define BE_BED_WRITE_QUEUE_INL_
+
+#include "be/bed/db.h"
+#include "be/bed/transaction.h"
+
+#include <exception>
+
+namespace be {
+namespace bed {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a write queue and starts its writer thread.
+///
+/// \param  connection The writable connection to apply mutations to.
+template <class T>
+inline WriteQueue<T>::WriteQueue(const std::shared_ptr<T>& connection)
+   : connection_(connection),
+     max_batch_size_(BE_BED_WRITE_QUEUE_DEFAULT_MAX_BATCH_SIZE),
+     pushed_count_(0),
+     committed_count_(0),
+     stopping_(false)
+{
+   thread_ = std::thread(&WriteQueue<T>::run_, this);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a write queue and starts its writer thread.
+///
+/// \param  connection The writable connection to apply mutations to.
+/// \param  max_batch_size The maximum number of mutations to apply in a
+///         single transaction.  If 0, the default of
+///         BE_BED_WRITE_QUEUE_DEFAULT_MAX_BATCH_SIZE is used.
+template <class T>
+inline WriteQueue<T>::WriteQueue(const std::shared_ptr<T>& connection, size_t max_batch_size)
+   : connection_(connection),
+     max_batch_size_(max_batch_size > 0 ? max_batch_size : BE_BED_WRITE_QUEUE_DEFAULT_MAX_BATCH_SIZE),
+     pushed_count_(0),
+     committed_count_(0),
+     stopping_(false)
+{
+   thread_ = std::thread(&WriteQueue<T>::run_, this);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Commits any remaining mutations, then stops the writer thread.
+template <class T>
+inline WriteQueue<T>::~WriteQueue()
+{
+   {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+   }
+   queued_.notify_one();
+   thread_.join();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Queues a mutation to be applied by the writer thread.
+///
+/// \details push() never waits for the database.  Mutations are applied in
+///         the order they are pushed.
+///
+/// \param  mutation A function which modifies the database using the
+///         connection passed to it.  It is called on the writer thread.
+/// \return A future which becomes ready once the transaction containing the
+///         mutation has been committed, or which holds the exception thrown
+///         by the mutation or by the transaction.
+template <class T>
+inline std::future<void> WriteQueue<T>::push(const mutation_t& mutation)
+{
+   std::unique_ptr<Job> job(new Job());
+   job->mutation = mutation;
+   std::future<void> future(job->promise.get_future());
+
+   {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queue_.push_back(std::move(job));
+      ++pushed_count_;
+   }
+   queued_.notify_one();
+
+   return future;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Blocks until every mutation pushed before flush() was called has
+///         been committed (or has failed).
+template <class T>
+inline void WriteQueue<T>::flush()
+{
+   std::unique_lock<std::mutex> lock(mutex_);
+   size_t target = pushed_count_;
+   while (committed_count_ < target)
+      committed_.wait(lock);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the maximum number of mutations which will be applied in
+///         a single transaction.
+///
+/// \return The maximum batch size.
+template <class T>
+inline size_t WriteQueue<T>::getMaxBatchSize() const
+{
+   return max_batch_size_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Writer thread main loop.
+/// \details Waits for mutations to be queued, then commits as many as
+///         possible at once, until the queue is being destroyed and no
+///         mutations remain.
+template <class T>
+inline void WriteQueue<T>::run_()
+{
+   std::vector<std::unique_ptr<Job> > batch;
+
+   for (;;)
+   {
+      {
+         std::unique_lock<std::mutex> lock(mutex_);
+         while (queue_.empty() && !stopping_)
+            queued_.wait(lock);
+
+         if (queue_.empty())
+            break;
+
+         while (!queue_.empty() && batch.size() < max_batch_size_)
+         {
+            batch.push_back(std::move(queue_.front()));
+            queue_.pop_front();
+         }
+      }
+
+      commit_(batch);
+
+      {
+         std::lock_guard<std::mutex> lock(mutex_);
+         committed_count_ += batch.size();
+      }
+      committed_.notify_all();
+      batch.clear();
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Applies a batch of mutations in a single transaction and fulfills
+///         their promises.
+///
+/// \param  batch The jobs to apply.
+template <class T>
+inline void WriteQueue<T>::commit_(std::vector<std::unique_ptr<Job> >& batch)
+{
+   std::vector<std::exception_ptr> errors(batch.size());
+
+   try
+   {
+      Transaction transaction(connection_->getDb(), Transaction::Immediate);
+
+      for (size_t i = 0; i < batch.size(); ++i)
+      {
+         transaction.save("be_write_queue");
+         try
+         {
+            batch[i]->mutation(*connection_);
+         }
+         catch (...)
+         {
+            errors[i] = std::current_exception();
+            transaction.rollback("be_write_queue");
+         }
+         transaction.release("be_write_queue");
+      }
+
+      transaction.commit();
+   }
+   catch (...)
+   {
+      // the transaction couldn't be started or committed (and has been
+      // rolled back) so none of the mutations were saved.
+      for (size_t i = 0; i < errors.size(); ++i)
+         if (!errors[i])
+            errors[i] = std::current_exception();
+   }
+
+   for (size_t i = 0; i < batch.size(); ++i)
+   {
+      if (errors[i])
+         batch[i]->promise.set_exception(errors[i]);
+      else
+         batch[i]->promise.set_value();
+   }
+}
+
+} // namespace be::bed
+} // namespace be
+
+#endif
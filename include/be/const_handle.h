@@ -33,6 +33,8 @@
 
 namespace be {
 
+template <class T> class Pool;
+
 ///////////////////////////////////////////////////////////////////////////////
 /// \class  ConstHandle   be/const_handle.h "be/const_handle.h"
 ///
@@ -64,6 +66,7 @@ namespace be {
 template <class T>
 class ConstHandle
 {
+   friend class Pool<T>;
 public:
    ConstHandle();
    ConstHandle(const ConstHandle<T>& other);
@@ -78,7 +81,12 @@ public:
    bool operator==(const ConstHandle<T>& other) const;
    bool operator!=(const ConstHandle<T>& other) const;
 
+   static void resolve(const ConstHandle<T>* handles, size_t count, const T** out);
+
 protected:
+   template <class H, class P>
+   static void resolve_(const H* handles, size_t count, P* out);
+
    uint32_t index_;  ///< An index which tells the HandleManager the location of the handled object's address
    uint32_t check_;  ///< A value used by the HandleManager to ensure that the object at index_ is the same as it was when this handle was created.
 };
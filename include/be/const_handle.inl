@@ -78,14 +78,7 @@ inline ConstHandle<T>::operator bool() const
    }
 
    detail::HandleManager<T>& mgr(detail::getHandleManager<T>());
-
-   if (index_ >= mgr.entries.size())
-      return false;
-
-   if (mgr.entries[index_].check != check_)
-      return false;
-
-   return true;
+   return mgr.isValid(index_, check_);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -104,16 +97,7 @@ inline const T* ConstHandle<T>::get() const
       return nullptr;
 
    detail::HandleManager<T>& mgr(detail::getHandleManager<T>());
-
-   if (index_ >= mgr.entries.size())
-      return nullptr;
-
-   const detail::HandleEntry<T>& entry(mgr.entries[index_]);
-
-   if (entry.check != check_)
-      return nullptr;
-
-   return entry.target;
+   return mgr.resolve(index_, check_);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -156,6 +140,72 @@ inline bool ConstHandle<T>::operator!=(const ConstHandle<T>& other) const
    return get() != other.get();
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves pointers to the objects referenced by an array of
+///         handles.
+/// \details Equivalent to calling get() on each handle, but the handle
+///         manager is only looked up once, and check values are compared in
+///         blocks so that the comparison can be vectorized.
+/// \param  handles The first handle to resolve.
+/// \param  count The number of handles to resolve.
+/// \param  out The first element of an array of at least \c count pointers
+///         which will receive the addresses of the handled objects (or
+///         \c nullptr for invalid handles).
+template <class T>
+inline void ConstHandle<T>::resolve(const ConstHandle<T>* handles, size_t count, const T** out)
+{
+   resolve_(handles, count, out);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Implements batch resolution for ConstHandle and Handle.
+/// \details Entries are gathered into small local arrays first, then all the
+///         check values in the block are compared without branching.  Stale
+///         handles are rejected by the check value alone: the checks of
+///         valid handles always have their MSB set, invalidate() clears the
+///         MSB of the entry's check, and add() increments it before an entry
+///         is reused, so an invalidated entry keeps its last target but
+///         never matches any handle.  A null handle's check value of 0
+///         never matches a used entry either, and only matches entries
+///         which have never been used (or whose chunk is unallocated),
+///         which always have a \c nullptr target, so null handles need no
+///         special treatment.
+/// \tparam H The type of handle being resolved.
+/// \tparam P The type of pointer to output.
+/// \param  handles The first handle to resolve.
+/// \param  count The number of handles to resolve.
+/// \param  out Receives the resolved pointers.
+template <class T>
+template <class H, class P>
+inline void ConstHandle<T>::resolve_(const H* handles, size_t count, P* out)
+{
+   const size_t block_size = 16;
+
+   detail::HandleManager<T>& mgr(detail::getHandleManager<T>());
+   T* targets[block_size];
+   uint32_t expected[block_size];
+   uint32_t actual[block_size];
+
+   while (count > 0)
+   {
+      size_t n = count < block_size ? count : block_size;
+
+      for (size_t i = 0; i < n; ++i)
+      {
+         const ConstHandle<T>& handle = handles[i];
+         expected[i] = handle.check_;
+         mgr.load(handle.index_, targets[i], actual[i]);
+      }
+
+      for (size_t i = 0; i < n; ++i)
+         out[i] = expected[i] == actual[i] ? targets[i] : nullptr;
+
+      handles += n;
+      out += n;
+      count -= n;
+   }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  Outputs the address of the object referenced by the handle passed
 ///         in.
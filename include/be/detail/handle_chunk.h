@@ -0,0 +1,98 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/detail/handle_chunk.h
+/// \author Benjamin Crist
+///
+/// \brief  be::detail::HandleChunk declaration & implementation.
+
+#ifndef BE_DETAIL_HANDLE_CHUNK_H_
+#define BE_DETAIL_HANDLE_CHUNK_H_
+
+#include "be/_be.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace be {
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \struct HandleChunk   be/detail/handle_chunk.h "be/detail/handle_chunk.h"
+///
+/// \brief  A fixed-size block of handle entries in a HandleManager.
+/// \details Entries are stored as a structure of arrays: the check values
+///         for all entries are contiguous, followed by the targets, so that
+///         validating many handles only touches the check array, and
+///         resolving a batch of handles reads each array sequentially.
+///
+///         All members are atomic so that handles can be resolved while
+///         other threads add or invalidate entries.  When resolving a handle,
+///         the target must be loaded before the check value; since writers
+///         always change the check value before reusing an entry for a
+///         different target, a handle whose check still matches after the
+///         target has been loaded is guaranteed to have read the correct
+///         target.
+/// \tparam T The type of object that is being handled.
+template <class T>
+struct HandleChunk
+{
+   /// \brief  The number of entries in each chunk is 2^index_bits.
+   static const uint32_t index_bits = 10;
+
+   /// \brief  The number of entries in each chunk.
+   static const uint32_t capacity = 1 << index_bits;
+
+   ////////////////////////////////////////////////////////////////////////////
+   /// \brief  Constructs a chunk of unused entries.
+   HandleChunk()
+   {
+      for (uint32_t i = 0; i < capacity; ++i)
+      {
+         checks[i].store(0, std::memory_order_relaxed);
+         targets[i].store(nullptr, std::memory_order_relaxed);
+         next_free[i].store(0, std::memory_order_relaxed);
+      }
+   }
+
+   /// \brief  Values used to determine if a handle is valid.
+   /// \details When the MSB of a check value is set, it means the entry
+   ///         refers to a valid object somewhere.  When the MSB is not set,
+   ///         it means the entry is currently invalid; it can be reused for
+   ///         another handle.
+   ///
+   ///         Each time an entry is used for a new handle, the lower 31 bits
+   ///         are incremented once.  A handle's check value must match the
+   ///         check value of the entry its index refers to, otherwise the
+   ///         handle doesn't refer to the same object.
+   std::atomic<uint32_t> checks[capacity];
+   std::atomic<T*> targets[capacity];           ///< For valid entries, points to the handled object.
+   std::atomic<uint32_t> next_free[capacity];   ///< For unused entries in the free list, one more than the index of the next unused entry (or 0 if it is the last).
+
+private:
+   HandleChunk(const HandleChunk<T>&);
+   void operator=(const HandleChunk<T>&);
+};
+
+} // namespace be::detail
+} // namespace be
+
+#endif
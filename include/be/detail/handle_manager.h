@@ -27,9 +27,9 @@
 #ifndef BE_DETAIL_HANDLE_MANAGER_H_
 #define BE_DETAIL_HANDLE_MANAGER_H_
 
-#include "be/detail/handle_entry.h"
+#include "be/detail/handle_chunk.h"
 
-#include <vector>
+#include <atomic>
 
 namespace be {
 namespace detail {
@@ -42,20 +42,45 @@ namespace detail {
 /// \details A single HandleManager exists for each type of object that can
 ///         have handles, i.e. each specialization of SourceHandle, Handle
 ///         or ConstHandle.
+///
+///         HandleManagers are lock-free and may be used from any thread.
+///         Entries are allocated in fixed-size chunks which are never moved
+///         or freed until the manager is destroyed, so resolve() never races
+///         with growth.  Invalidated entries are kept on a lock-free stack
+///         (with an ABA tag) until they are reused by add().
+///
+///         A HandleManager does nothing in its constructor; it relies on
+///         zero-initialization of static storage so that it is usable even
+///         before static initialization has completed.
 /// \tparam T the type of object this manager deals with handles to.
 template <class T>
 struct HandleManager
 {
    HandleManager();
+   ~HandleManager();
 
    void add(uint32_t& index, uint32_t& check, T* target);
    void update(uint32_t index, T* target);
    void invalidate(uint32_t index);
 
-   std::vector<HandleEntry<T>> entries;   ///< Holds the address of all currently valid objects which can have handles to them.
-   size_t first_free;                     ///< Index in entries of the first unused (invalid) entry.  When an entry is added, it is located at this index.  Then first_free becomes the old entry's next_free index.
-   size_t last_free;                      ///< Index in entries of the last unused (invalid) entry.  When an entry is invalidated, this element's next_free is set to the newly invalidated entry and last_free is set to the new entry's index.
-   size_t size;                           ///< Holds the number of valid entries present in entries.  Not necessarily equal to entries.size().
+   T* resolve(uint32_t index, uint32_t check) const;
+   bool isValid(uint32_t index, uint32_t check) const;
+   void load(uint32_t index, T*& target, uint32_t& check) const;
+
+   HandleChunk<T>* getChunk(uint32_t index) const;
+   HandleChunk<T>& allocateChunk(uint32_t index);
+
+   /// \brief  The maximum number of chunks that can be allocated.
+   static const uint32_t max_chunks = 4096;
+
+   std::atomic<HandleChunk<T>*> chunks[max_chunks];  ///< Holds the entries for all objects which can have handles to them.  Chunks are allocated as needed and never moved.
+   std::atomic<uint32_t> next_index;                  ///< The number of entries which have ever been used.  When no free entries are available, an entry is added at this index.
+   std::atomic<uint64_t> free_head;                   ///< The lower 32 bits are one more than the index of the most recently invalidated (unused) entry, or 0 if there are none.  The upper 32 bits are incremented each time the head changes to avoid ABA problems.
+   std::atomic<size_t> size;                          ///< Holds the number of valid entries.
+
+private:
+   HandleManager(const HandleManager<T>&);
+   void operator=(const HandleManager<T>&);
 };
 
 template <class T>
@@ -29,17 +29,30 @@
 #elif !defined(BE_DETAIL_HANDLE_MANAGER_INL_)
 #define BE_DETAIL_HANDLE_MANAGER_INL_
 
+#include <stdexcept>
+
 namespace be {
 namespace detail {
 
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  Constructs a HandleManager.
+/// \details Intentionally does nothing; HandleManagers must have static
+///         storage duration, so all members are already zero.
 template <class T>
 HandleManager<T>::HandleManager()
-   : first_free(0),
-     last_free(0)
 {
-   entries.reserve(64);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Destroys a HandleManager, freeing all chunks of entries.
+template <class T>
+HandleManager<T>::~HandleManager()
+{
+   for (uint32_t i = 0; i < max_chunks; ++i)
+   {
+      HandleChunk<T>* chunk = chunks[i].exchange(nullptr);
+      delete chunk;
+   }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -54,38 +67,49 @@ HandleManager<T>::HandleManager()
 template <class T>
 void HandleManager<T>::add(uint32_t& index, uint32_t& check, T* target)
 {
-   if (first_free >= entries.size())
+   HandleChunk<T>* chunk = nullptr;
+
+   // try to pop an entry off the free list
+   uint64_t head = free_head.load(std::memory_order_acquire);
+   while (static_cast<uint32_t>(head) != 0)
    {
-      index = entries.size();
-      entries.push_back(HandleEntry<T>(0x80000000, target));
-      first_free = entries.size();
-      last_free = entries.size();
+      index = static_cast<uint32_t>(head) - 1;
+      HandleChunk<T>* candidate = getChunk(index);
+      uint32_t next_free = candidate->next_free[index & (HandleChunk<T>::capacity - 1)].load(std::memory_order_relaxed);
+      uint64_t next = ((head >> 32) + 1) << 32 | next_free;
+
+      if (free_head.compare_exchange_weak(head, next, std::memory_order_acquire))
+      {
+         chunk = candidate;
+         break;
+      }
    }
-   else
+
+   if (!chunk)
    {
-      // first_free is inside vector
-      index = first_free;
-      first_free = entries[first_free].next_free;
-      if (last_free == index)
-         last_free = first_free;
-      entries[index].target = target;
-      entries[index].check |= 0x80000000;
-      entries[index].check += 1;
+      // free list is empty; use a new entry
+      index = next_index.fetch_add(1);
+      chunk = &allocateChunk(index);
    }
 
-   check = entries[index].check;
+   uint32_t offset = index & (HandleChunk<T>::capacity - 1);
+   // Released so that a reader which sees the new target also sees the
+   // check value invalidate() left behind, rather than an older valid one.
+   chunk->targets[offset].store(target, std::memory_order_release);
+   check = ((chunk->checks[offset].load(std::memory_order_relaxed) & 0x7FFFFFFF) + 1) | 0x80000000;
+   chunk->checks[offset].store(check, std::memory_order_release);
    ++size;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  Updates an existing handle to point to a new target.  Existing
 ///         handles will remain valid, but now point to the new target.
-/// \param  index Determines the HandleEntry to update.
+/// \param  index Determines the entry to update.
 /// \param  target The new address of the handled object.
 template <class T>
 void HandleManager<T>::update(uint32_t index, T* target)
 {
-   entries[index].target = target;
+   getChunk(index)->targets[index & (HandleChunk<T>::capacity - 1)].store(target, std::memory_order_release);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -95,26 +119,125 @@ void HandleManager<T>::update(uint32_t index, T* target)
 ///         there are no more usable check values, so the index will not be
 ///         added to the free list and will not be used again until the process
 ///         ends.
-/// \param  index Determines the HandleEntry to invalidate.
+/// \param  index Determines the entry to invalidate.
 template <class T>
 void HandleManager<T>::invalidate(uint32_t index)
 {
-   entries[index].check &= 0x7FFFFFFF;
-   if (entries[index].check != 0x7FFFFFFF)
+   HandleChunk<T>& chunk = *getChunk(index);
+   uint32_t offset = index & (HandleChunk<T>::capacity - 1);
+   uint32_t check = chunk.checks[offset].load(std::memory_order_relaxed) & 0x7FFFFFFF;
+   chunk.checks[offset].store(check, std::memory_order_release);
+
+   if (check != 0x7FFFFFFF)
    {
       // only add this index to the free list if there is at least 1 usable check value left.
 
-      entries[index].next_free = entries.size();
-
-      if (last_free >= entries.size())
-         first_free = index;
-      else
-         entries[last_free].next_free = index;
-      last_free = index;
+      uint64_t head = free_head.load(std::memory_order_relaxed);
+      uint64_t next;
+      do
+      {
+         chunk.next_free[offset].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+         next = ((head >> 32) + 1) << 32 | (index + 1);
+      } while (!free_head.compare_exchange_weak(head, next, std::memory_order_release));
    }
    --size;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the target of a handle.
+/// \param  index The handle's index.
+/// \param  check The handle's check value.
+/// \return The handled object's address, or \c nullptr if the handle is not
+///         valid.
+template <class T>
+inline T* HandleManager<T>::resolve(uint32_t index, uint32_t check) const
+{
+   T* target;
+   uint32_t entry_check;
+   load(index, target, entry_check);
+   return entry_check == check ? target : nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Determines if a handle refers to a valid object.
+/// \param  index The handle's index.
+/// \param  check The handle's check value.
+/// \return \c true if the handle's check value matches its entry.
+template <class T>
+inline bool HandleManager<T>::isValid(uint32_t index, uint32_t check) const
+{
+   const HandleChunk<T>* chunk = getChunk(index);
+   return chunk && chunk->checks[index & (HandleChunk<T>::capacity - 1)].load(std::memory_order_acquire) == check;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads the target and check value of an entry without comparing
+///         it to a handle.
+/// \details The target is loaded before the check value (see HandleChunk),
+///         so the target is only meaningful if the check value returned
+///         matches the handle being resolved.  Entries in chunks which
+///         have not been allocated yield a \c nullptr target and a check
+///         value of 0.  Invalidated entries keep their last target, but their
+///         check value no longer matches any handle.
+/// \param  index The index of the entry.
+/// \param  target Receives the entry's target.
+/// \param  check Receives the entry's check value.
+template <class T>
+inline void HandleManager<T>::load(uint32_t index, T*& target, uint32_t& check) const
+{
+   const HandleChunk<T>* chunk = getChunk(index);
+   if (!chunk)
+   {
+      target = nullptr;
+      check = 0;
+      return;
+   }
+
+   uint32_t offset = index & (HandleChunk<T>::capacity - 1);
+   target = chunk->targets[offset].load(std::memory_order_acquire);
+   check = chunk->checks[offset].load(std::memory_order_acquire);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the chunk containing the entry with the provided index.
+/// \param  index The index of the entry.
+/// \return The chunk, or \c nullptr if it has not been allocated.
+template <class T>
+inline HandleChunk<T>* HandleManager<T>::getChunk(uint32_t index) const
+{
+   uint32_t chunk = index >> HandleChunk<T>::index_bits;
+   if (chunk >= max_chunks)
+      return nullptr;
+
+   return chunks[chunk].load(std::memory_order_acquire);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the chunk containing the entry with the provided index,
+///         allocating it if necessary.
+/// \details If multiple threads allocate the same chunk at once, only one
+///         of the allocations will be kept.
+/// \param  index The index of the entry.
+/// \return The chunk.
+template <class T>
+HandleChunk<T>& HandleManager<T>::allocateChunk(uint32_t index)
+{
+   uint32_t chunk = index >> HandleChunk<T>::index_bits;
+   if (chunk >= max_chunks)
+      throw std::runtime_error("Handle limit exceeded!");
+
+   HandleChunk<T>* existing = chunks[chunk].load(std::memory_order_acquire);
+   if (existing)
+      return *existing;
+
+   HandleChunk<T>* new_chunk = new HandleChunk<T>();
+   if (chunks[chunk].compare_exchange_strong(existing, new_chunk))
+      return *new_chunk;
+
+   delete new_chunk;   // another thread allocated this chunk first
+   return *existing;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  Retrieves a handle manager for a specific type.
 template <class T>
@@ -0,0 +1,121 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/detail/log_format.h
+/// \author Benjamin Crist
+///
+/// \brief  Constants and helpers shared by the text and binary log formats.
+/// \details A binary log begins with an 8 byte header: the characters
+///         "BELOG", a version byte, and two zero bytes.  The header is
+///         followed by a sequence of records, each starting with a
+///         LogRecordType byte:
+///
+///         - \c LogRecordString: <tt>uint32 index, uint32 length, char[length]</tt>.
+///           Adds a string to the string table.  Strings are numbered in the
+///           order they are defined, starting at 0.
+///         - \c LogRecordMessage: <tt>int64 time, uint32 level, uint32 file,
+///           uint32 line, uint32 size, values[size]</tt>.  \c time is in
+///           microseconds since the epoch, \c file is a string table index,
+///           and \c size is the number of bytes of values which follow.
+///
+///         Each value starts with a LogValueType byte followed by its data.
+///         All integers are stored in native (little-endian) byte order.
+
+#ifndef BE_DETAIL_LOG_FORMAT_H_
+#define BE_DETAIL_LOG_FORMAT_H_
+
+#include "be/_be.h"
+
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace be {
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  The number of bytes in a binary log header.
+const size_t log_header_size = 8;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  The binary log format version written by this version of bengine.
+const char log_format_version = 1;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Identifies the type of each record in a binary log.
+enum LogRecordType
+{
+   LogRecordString = 'S',
+   LogRecordMessage = 'M'
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Identifies the type of each value in a binary log message.
+enum LogValueType
+{
+   LogValueSigned = 'i',      ///< int64
+   LogValueUnsigned = 'u',    ///< uint64
+   LogValueFloat = 'f',       ///< double
+   LogValueChar = 'c',        ///< char
+   LogValueBool = 'b',        ///< uint8
+   LogValueText = 't',        ///< uint32 length, char[length]
+   LogValueCString = 's',     ///< uint32 length, char[length]; only used in memory, converted to LogValueStringRef when written.
+   LogValueStringRef = 'r',   ///< uint32 string table index
+   LogValueId = 'I'           ///< uint64 Id value
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Caches the formatted text of the most recently formatted time.
+struct LogTimeCache
+{
+   LogTimeCache();
+
+   std::time_t time;
+   char text[20];
+};
+
+void appendLogPrefix(std::string& out, LogTimeCache& cache, std::time_t time, const char* file, size_t file_length, int line, int level);
+void renderLogValues(const char* data, size_t size, const std::vector<std::string>& strings, std::string& out);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends the binary representation of a value to a string.
+template <typename T>
+inline void appendLogBytes(std::string& out, const T& value)
+{
+   out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads the binary representation of a value from a buffer.
+template <typename T>
+inline T readLogBytes(const char* data)
+{
+   T value;
+   memcpy(&value, data, sizeof(T));
+   return value;
+}
+
+} // namespace be::detail
+} // namespace be
+
+#endif
@@ -0,0 +1,123 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/detail/log_record.h
+/// \author Benjamin Crist
+///
+/// \brief  be::detail::LogRecord class header.
+
+#ifndef BE_DETAIL_LOG_RECORD_H_
+#define BE_DETAIL_LOG_RECORD_H_
+
+#include "be/_be.h"
+
+#include <ios>
+#include <ostream>
+#include <string>
+
+namespace be {
+
+class Id;
+
+namespace detail {
+
+class LogFormatter;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \class  LogRecord   be/detail/log_record.h "be/detail/log_record.h"
+///
+/// \brief  Collects a single #BE_LOG message.
+/// \details A temporary LogRecord is created by each #BE_LOG expression.
+///         Values inserted into it are collected in a buffer owned by the
+///         calling thread, and the message is submitted when the LogRecord
+///         is destroyed at the end of the full expression.  If an AsyncLog is
+///         active, the message is queued for its writer thread; otherwise it
+///         is written to #BE_LOG_STREAM immediately.
+///
+///         When the active AsyncLog writes a binary log, integers, floating
+///         point numbers, characters, strings, and Ids are stored as typed
+///         values rather than being formatted as text (unless formatting
+///         flags such as \c std::hex or \c std::setw are in effect).  Anything
+///         else is formatted with its \c std::ostream insertion operator, so
+///         any type that can be written to a \c std::ostream can be logged.
+class LogRecord
+{
+public:
+   LogRecord(int level, const char* file, int line);
+   ~LogRecord();
+
+   LogRecord& operator<<(bool value);
+   LogRecord& operator<<(char value);
+   LogRecord& operator<<(signed char value);
+   LogRecord& operator<<(unsigned char value);
+   LogRecord& operator<<(short value);
+   LogRecord& operator<<(unsigned short value);
+   LogRecord& operator<<(int value);
+   LogRecord& operator<<(unsigned int value);
+   LogRecord& operator<<(long value);
+   LogRecord& operator<<(unsigned long value);
+   LogRecord& operator<<(long long value);
+   LogRecord& operator<<(unsigned long long value);
+   LogRecord& operator<<(float value);
+   LogRecord& operator<<(double value);
+   LogRecord& operator<<(const char* value);
+   LogRecord& operator<<(const std::string& value);
+   LogRecord& operator<<(const Id& value);
+   LogRecord& operator<<(std::ostream& (*manipulator)(std::ostream&));
+   LogRecord& operator<<(std::ios_base& (*manipulator)(std::ios_base&));
+
+   template <class T>
+   LogRecord& operator<<(const T& value);
+
+   std::ostream& stream();
+
+private:
+   size_t beginText_();
+   void endText_(size_t mark);
+   bool isPlain_() const;
+
+   template <class T>
+   LogRecord& writeText_(const T& value);
+   template <class T>
+   LogRecord& writeSigned_(T value);
+   template <class T>
+   LogRecord& writeUnsigned_(T value);
+   template <class T>
+   LogRecord& writeChar_(T value);
+   template <class T>
+   LogRecord& writeFloat_(T value);
+
+   int level_;
+   const char* file_;
+   int line_;
+   LogFormatter* formatter_;
+   bool binary_;
+
+   LogRecord(const LogRecord&);
+   void operator=(const LogRecord&);
+};
+
+} // namespace be::detail
+} // namespace be
+
+#include "be/detail/log_record.inl"
+
+#endif
@@ -0,0 +1,68 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/detail/log_record.inl
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of be::detail::LogRecord template functions.
+
+#if !defined(BE_DETAIL_LOG_RECORD_H_) && !defined(DOXYGEN)
+#include "be/detail/log_record.h"
+#elif !defined(BE_DETAIL_LOG_RECORD_INL_)
+#define BE_DETAIL_LOG_RECORD_INL_
+
+namespace be {
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends any value that can be written to a \c std::ostream.
+/// \param  value The value to log.
+/// \return This LogRecord (for chaining).
+template <class T>
+inline LogRecord& LogRecord::operator<<(const T& value)
+{
+   return writeText_(value);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Formats a value using its \c std::ostream insertion operator.
+/// \details In a binary log, the formatted text is stored as a string value.
+/// \param  value The value to log.
+/// \return This LogRecord (for chaining).
+template <class T>
+inline LogRecord& LogRecord::writeText_(const T& value)
+{
+   if (binary_)
+   {
+      size_t mark = beginText_();
+      stream() << value;
+      endText_(mark);
+   }
+   else
+      stream() << value;
+
+   return *this;
+}
+
+} // namespace be::detail
+} // namespace be
+
+#endif
@@ -70,6 +70,8 @@ public:
    T* get() const;
    T* operator->() const;
    T& operator*() const;
+
+   static void resolve(const Handle<T>* handles, size_t count, T** out);
 };
 
 } // namespace be
@@ -59,8 +59,8 @@ inline Handle<T>::Handle(const Handle<T>& other)
 template <class T>
 inline Handle<T>& Handle<T>::operator=(const Handle<T>& other)
 {
-   check_ = other.check_;
-   index_ = other.index_;
+   this->check_ = other.check_;
+   this->index_ = other.index_;
    return *this;
 }
 
@@ -76,20 +76,11 @@ inline Handle<T>& Handle<T>::operator=(const Handle<T>& other)
 template <class T>
 inline T* Handle<T>::get() const
 {
-   if (check_ == 0)
+   if (this->check_ == 0)
       return nullptr;
 
    detail::HandleManager<T>& mgr(detail::getHandleManager<T>());
-
-   if (index_ >= mgr.entries.size())
-      return nullptr;
-
-   const detail::HandleEntry<T>& entry(mgr.entries[index_]);
-
-   if (entry.check != check_)
-      return nullptr;
-
-   return entry.target;
+   return mgr.resolve(this->index_, this->check_);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -108,6 +99,22 @@ inline T& Handle<T>::operator*() const
    return *get();
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves pointers to the objects referenced by an array of
+///         handles.
+/// \details Equivalent to calling get() on each handle; see
+///         ConstHandle::resolve().
+/// \param  handles The first handle to resolve.
+/// \param  count The number of handles to resolve.
+/// \param  out The first element of an array of at least \c count pointers
+///         which will receive the addresses of the handled objects (or
+///         \c nullptr for invalid handles).
+template <class T>
+inline void Handle<T>::resolve(const Handle<T>* handles, size_t count, T** out)
+{
+   ConstHandle<T>::resolve_(handles, count, out);
+}
+
 } // namespace be
 
 #endif
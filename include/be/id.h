@@ -52,12 +52,25 @@
 /// \ingroup ids
 #define BE_ID_NAMES_DISABLED
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Defined when Ids constructed from string literals are compile-time
+///         constants.
+/// \details This requires #BE_CONSTEXPR_ENABLED and is never defined when
+///         #BE_ID_NAMES_ENABLED is defined, since remembering a name requires
+///         some work at runtime.
+/// \ingroup ids
+#define BE_ID_CONSTEXPR_ENABLED
+
 #endif
 
 #if (defined BE_BEDITOR || defined(DEBUG)) && !defined(BE_ID_NAMES_ENABLED) && !defined(BE_ID_NAMES_DISABLED)
 #define BE_ID_NAMES_ENABLED
 #endif
 
+#if defined(BE_CONSTEXPR_ENABLED) && !defined(BE_ID_NAMES_ENABLED) && !defined(BE_ID_CONSTEXPR_ENABLED)
+#define BE_ID_CONSTEXPR_ENABLED
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  The initial state used in the 64-bit FNV-1a hash algorithm.
 /// \ingroup ids
@@ -68,8 +81,24 @@
 /// \ingroup ids
 #define BE_ID_FNV_PRIME 1099511628211ULL
 
+#ifdef BE_ID_CONSTEXPR_ENABLED
+#define BE_ID_LITERAL_CONSTEXPR BE_CONSTEXPR
+#else
+#define BE_ID_LITERAL_CONSTEXPR inline
+#endif
+
 
 namespace be {
+namespace detail {
+
+BE_CONSTEXPR uint64_t fnv1a(const char* str, uint64_t basis = BE_ID_FNV_OFFSET_BASIS);
+uint64_t fnv1aIterative(const char* str, uint64_t basis = BE_ID_FNV_OFFSET_BASIS);
+
+#ifdef BE_ID_NAMES_ENABLED
+void registerIdName(uint64_t id, const char* name);
+#endif
+
+} // namespace be::detail
 
 ///////////////////////////////////////////////////////////////////////////////
 /// \class  Id   be/id.h "be/id.h"
@@ -97,26 +126,32 @@ namespace be {
 ///         defined otherwise, but this behavior can be overridden by
 ///         explicitly defining either #BE_ID_NAMES_ENABLED or
 ///         #BE_ID_NAMES_DISABLED.
+///
+///         Ids constructed directly from string literals are hashed without
+///         allocating a \c std::string.  If #BE_ID_CONSTEXPR_ENABLED is
+///         defined, they are compile-time constants, as are Ids created with
+///         the \c _id literal suffix from be::literals.
 /// \ingroup ids
 class Id
 {
 public:
-   Id();
-   explicit Id(uint64_t id);
+   BE_CONSTEXPR Id();
+   explicit BE_CONSTEXPR Id(uint64_t id);
+   template <size_t N> explicit BE_ID_LITERAL_CONSTEXPR Id(const char (&name)[N]);
    explicit Id(const std::string& name);
-   Id(const Id& other);
+   BE_CONSTEXPR Id(const Id& other);
    Id& operator=(const Id& other);
 
    std::string to_string() const;
 
-   uint64_t value() const;
+   BE_CONSTEXPR uint64_t value() const;
 
-   bool operator==(const Id& other) const;
-   bool operator!=(const Id& other) const;
-   bool operator<(const Id& other) const;
-   bool operator>(const Id& other) const;
-   bool operator<=(const Id& other) const;
-   bool operator>=(const Id& other) const;
+   BE_CONSTEXPR bool operator==(const Id& other) const;
+   BE_CONSTEXPR bool operator!=(const Id& other) const;
+   BE_CONSTEXPR bool operator<(const Id& other) const;
+   BE_CONSTEXPR bool operator>(const Id& other) const;
+   BE_CONSTEXPR bool operator<=(const Id& other) const;
+   BE_CONSTEXPR bool operator>=(const Id& other) const;
 
 private:
    uint64_t id_;
@@ -124,6 +159,19 @@ private:
 
 std::ostream& operator<<(std::ostream& os, const Id& id);
 
+#ifdef BE_CONSTEXPR_ENABLED
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  User-defined literals for bengine types.
+/// \details Only available if #BE_CONSTEXPR_ENABLED is defined.
+namespace literals {
+
+BE_ID_LITERAL_CONSTEXPR Id operator"" _id(const char* name, size_t length);
+
+} // namespace be::literals
+
+#endif
+
 } // namespace be
 
 #include "be/id.inl"
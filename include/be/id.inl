@@ -22,13 +22,230 @@
 /// \file   be/id.inl
 /// \author Benjamin Crist
 ///
-/// \brief  Implementations of be::Id template functions.
+/// \brief  Implementations of be::Id inline and template functions.
 
 #if !defined(BE_ID_H_) && !defined(DOXYGEN)
 #include "be/id.h"
 #elif !defined(BE_ID_INL_)
 #define BE_ID_INL_
 
+namespace be {
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Calculates the 64-bit FNV-1a hash of a null-terminated string.
+///
+/// \details Written as a single recursive expression so that it can be
+///         evaluated at compile time when #BE_CONSTEXPR_ENABLED is defined.
+///         The result is identical to the hash used by
+///         Id::Id(const std::string&).  When the hash will be computed at
+///         runtime, use fnv1aIterative() instead; unoptimized builds would
+///         otherwise recurse once per character.
+///
+/// \param  str The string to hash.
+/// \param  basis The hash state before hashing \c str.
+/// \return The hash state after hashing each character in \c str.
+BE_CONSTEXPR uint64_t fnv1a(const char* str, uint64_t basis)
+{
+   return *str == '\0' ? basis :
+      fnv1a(str + 1, (basis ^ static_cast<uint8_t>(*str)) * BE_ID_FNV_PRIME);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Calculates the 64-bit FNV-1a hash of a null-terminated string
+///         using a loop.
+///
+/// \details Produces the same result as fnv1a(), but never recurses, so it
+///         is used wherever the hash is calculated at runtime.
+///
+/// \param  str The string to hash.
+/// \param  basis The hash state before hashing \c str.
+/// \return The hash state after hashing each character in \c str.
+inline uint64_t fnv1aIterative(const char* str, uint64_t basis)
+{
+   for (; *str != '\0'; ++str)
+      basis = (basis ^ static_cast<uint8_t>(*str)) * BE_ID_FNV_PRIME;
+
+   return basis;
+}
+
+} // namespace be::detail
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a new Id object which has the same value as if it were 
+///         constructed from a zero-length string.
+BE_CONSTEXPR Id::Id()
+   : id_(BE_ID_FNV_OFFSET_BASIS)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a new Id object which has the exact integer value
+///         specified.
+///
+/// \param  id The numeric value for the new Id.
+BE_CONSTEXPR Id::Id(uint64_t id)
+   : id_(id)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a new Id object by hashing a string literal.
+///
+/// \details The resulting Id is identical to one constructed from
+///         \c std::string(name), but no temporary string is created.  If
+///         #BE_ID_CONSTEXPR_ENABLED is defined, this constructor can be
+///         evaluated at compile time.  Otherwise, if #BE_ID_NAMES_ENABLED is
+///         defined, the name is remembered only if no name has been
+///         registered for this Id yet.
+///
+/// \param  name The string to hash to generate the numeric value for the Id.
+#ifdef BE_ID_NAMES_ENABLED
+template <size_t N>
+inline Id::Id(const char (&name)[N])
+   : id_(detail::fnv1aIterative(name))
+{
+   detail::registerIdName(id_, name);
+}
+#elif defined(BE_ID_CONSTEXPR_ENABLED)
+template <size_t N>
+BE_ID_LITERAL_CONSTEXPR Id::Id(const char (&name)[N])
+   : id_(detail::fnv1a(name))
+{
+}
+#else
+template <size_t N>
+BE_ID_LITERAL_CONSTEXPR Id::Id(const char (&name)[N])
+   : id_(detail::fnv1aIterative(name))
+{
+}
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a new Id object which has the same value as an existing
+///         Id. (copy constructor)
+///
+/// \param  other The Id whose value we will copy.
+BE_CONSTEXPR Id::Id(const Id& other)
+   : id_(other.id_)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Assigns an Id the same value as another Id object.
+///
+/// \param  other The Id whose value we will copy.
+/// \return *this
+inline Id& Id::operator=(const Id& other)
+{
+   id_ = other.id_;
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the numeric value of this object.
+///
+/// \return The 64-bit numeric value of this Id. 
+BE_CONSTEXPR uint64_t Id::value() const
+{
+   return id_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compares this Id with another to see if they have the same value.
+///
+/// \param  other The Id to compate to this one.
+/// \return \c true if both Ids have the same numeric value.
+BE_CONSTEXPR bool Id::operator==(const Id& other) const
+{
+   return id_ == other.id_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compares this Id with another to see if they have different values.
+///
+/// \param  other The Id to compate to this one.
+/// \return \c true if the Ids have different numeric values.
+BE_CONSTEXPR bool Id::operator!=(const Id& other) const
+{
+   return id_ != other.id_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compares this Id with another to see if it has a smaller value
+///         than the other.
+///
+/// \param  other The Id to compate to this one.
+/// \return \c true if this Id's numeric value is less than other's.
+BE_CONSTEXPR bool Id::operator<(const Id& other) const
+{
+   return id_ < other.id_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compares this Id with another to see if it has a larger value
+///         than the other.
+///
+/// \param  other The Id to compate to this one.
+/// \return \c true if this Id's numeric value is greater than other's.
+BE_CONSTEXPR bool Id::operator>(const Id& other) const
+{
+   return id_ > other.id_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compares this Id with another to see if its value is not larger
+///         than other's.
+///
+/// \param  other The Id to compate to this one.
+/// \return \c true if this Id's numeric value is not larger than other's.
+BE_CONSTEXPR bool Id::operator<=(const Id& other) const
+{
+   return id_ <= other.id_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compares this Id with another to see if its value is not smaller
+///         than other's.
+///
+/// \param  other The Id to compate to this one.
+/// \return \c true if this Id's numeric value is not smaller than other's.
+BE_CONSTEXPR bool Id::operator>=(const Id& other) const
+{
+   return id_ >= other.id_;
+}
+
+#ifdef BE_CONSTEXPR_ENABLED
+namespace literals {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Creates an Id by hashing a string literal:
+///         <tt>"Shader.TextureFontText.vertex"_id</tt>.
+///
+/// \details Hashing stops at the first null character, just like
+///         Id::Id(const char (&)[N]).
+///
+/// \param  name The string literal to hash.
+/// \return An Id with the same value as <tt>Id(std::string(name))</tt>.
+#ifdef BE_ID_NAMES_ENABLED
+inline Id operator"" _id(const char* name, size_t)
+{
+   Id id(detail::fnv1aIterative(name));
+   detail::registerIdName(id.value(), name);
+   return id;
+}
+#else
+BE_ID_LITERAL_CONSTEXPR Id operator"" _id(const char* name, size_t)
+{
+   return Id(detail::fnv1a(name));
+}
+#endif
+
+} // namespace be::literals
+#endif
+
+} // namespace be
+
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  \c std::hash specialization for utilizing Id objects in
 ///         \c std::unordered_set and \c std::unordered_map containers.
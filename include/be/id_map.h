@@ -0,0 +1,204 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/id_map.h
+/// \author Benjamin Crist
+///
+/// \brief  be::IdMap class header.
+
+#ifndef BE_ID_MAP_H_
+#define BE_ID_MAP_H_
+
+#include "be/id.h"
+
+#include <memory>
+#include <utility>
+
+#if !defined(BE_ID_MAP_SSE2) && !defined(BE_ID_MAP_NO_SSE2) && \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define BE_ID_MAP_SSE2
+#endif
+
+#ifdef DOXYGEN
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Indicates that IdMap will use SSE2 instructions to scan groups of
+///         control bytes.
+/// \details Defined automatically when the target architecture supports
+///         SSE2, unless #BE_ID_MAP_NO_SSE2 is defined.
+/// \ingroup ids
+#define BE_ID_MAP_SSE2
+#endif
+
+namespace be {
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  The number of slots whose control bytes are checked at once when
+///         probing an IdMap.
+const size_t id_map_group_size = 16;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  IdMap control byte for a slot which has never been used.
+const int8_t id_map_empty = -128;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  IdMap control byte for a slot whose value has been erased.
+const int8_t id_map_deleted = -2;
+
+uint32_t idMapMatch(const int8_t* group, int8_t h2);
+uint32_t idMapMatchEmpty(const int8_t* group);
+uint32_t idMapMatchEmptyOrDeleted(const int8_t* group);
+uint32_t idMapLowestBit(uint32_t mask);
+
+} // namespace be::detail
+
+///////////////////////////////////////////////////////////////////////////////
+/// \class  IdMap   be/id_map.h "be/id_map.h"
+///
+/// \brief  Associative container mapping Ids to values.
+/// \details IdMap is a replacement for <tt>std::unordered_map<Id, T></tt>.
+///         Since Ids constructed from strings are already FNV-1a hashes, no
+///         additional hashing is done: the low bits of Id::value() select
+///         the first group of slots to probe and the high 7 bits are stored
+///         in a control byte for each occupied slot.
+///
+///         Values are stored in a single flat array using open addressing
+///         rather than in separately allocated nodes.  Slots are probed in
+///         groups of 16; the control bytes for a group are compared at once
+///         (using SSE2 if #BE_ID_MAP_SSE2 is defined) so that most lookups
+///         touch only one group and compare only one key.
+///
+///         The interface mirrors the subset of \c std::unordered_map used by
+///         bengine: iterators dereference to
+///         <tt>std::pair<const Id, T></tt>, and find(), insert(), erase(),
+///         and operator[]() behave the same way.  Unlike
+///         \c std::unordered_map, any insertion may invalidate all iterators
+///         and references to elements, and erase() invalidates only the
+///         erased element.
+///
+///         Ids constructed directly from small integers will work correctly,
+///         but their high bits are all the same, so lookups will need to
+///         compare more keys than they would for hashed Ids.
+///
+///         IdMap is not synchronized for access from multiple threads.
+/// \ingroup ids
+template <typename T>
+class IdMap
+{
+   template <typename V>
+   class iterator_;
+
+public:
+   typedef Id key_type;
+   typedef T mapped_type;
+   typedef std::pair<const Id, T> value_type;
+   typedef size_t size_type;
+   typedef iterator_<value_type> iterator;
+   typedef iterator_<const value_type> const_iterator;
+
+   IdMap();
+   explicit IdMap(size_t capacity);
+   IdMap(IdMap<T>&& other);
+   IdMap<T>& operator=(IdMap<T>&& other);
+   ~IdMap();
+
+   iterator begin();
+   const_iterator begin() const;
+   iterator end();
+   const_iterator end() const;
+
+   bool empty() const;
+   size_t size() const;
+   size_t capacity() const;
+
+   iterator find(const Id& id);
+   const_iterator find(const Id& id) const;
+   size_t count(const Id& id) const;
+
+   T& operator[](const Id& id);
+
+   template <typename P>
+   std::pair<iterator, bool> insert(P&& value);
+
+   iterator erase(const_iterator position);
+   size_t erase(const Id& id);
+
+   void clear();
+   void reserve(size_t size);
+
+private:
+   template <typename V>
+   class iterator_
+   {
+      friend class IdMap<T>;
+      template <typename V2> friend class iterator_;
+   public:
+      iterator_();
+      template <typename V2>
+      iterator_(const iterator_<V2>& other);
+
+      V& operator*() const;
+      V* operator->() const;
+      iterator_<V>& operator++();
+      iterator_<V> operator++(int);
+
+      template <typename V2>
+      bool operator==(const iterator_<V2>& other) const;
+      template <typename V2>
+      bool operator!=(const iterator_<V2>& other) const;
+
+   private:
+      iterator_(const int8_t* ctrl, V* slot, V* end);
+      void skipUnused_();
+
+      const int8_t* ctrl_;
+      V* slot_;
+      V* end_;
+   };
+
+   size_t findIndex_(const Id& id) const;
+   size_t prepareInsert_(const Id& id);
+   void setCtrl_(size_t index, int8_t ctrl);
+   void rehash_(size_t capacity);
+   void destroy_();
+
+   iterator makeIterator_(size_t index);
+   const_iterator makeIterator_(size_t index) const;
+
+   static size_t groupIndex_(const Id& id, size_t group_mask);
+   static int8_t h2_(const Id& id);
+
+   std::allocator<value_type> alloc_;
+   int8_t* ctrl_;
+   value_type* slots_;
+   size_t capacity_;
+   size_t size_;
+   size_t growth_left_;
+
+   IdMap(const IdMap<T>&);
+   void operator=(const IdMap<T>&);
+};
+
+} // namespace be
+
+#include "be/id_map.inl"
+
+#endif
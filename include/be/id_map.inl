@@ -0,0 +1,771 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/id_map.inl
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of be::IdMap template functions.
+
+#if !defined(BE_ID_MAP_H_) && !defined(DOXYGEN)
+#include "be/id_map.h"
+#elif !defined(BE_ID_MAP_INL_)
+#define BE_ID_MAP_INL_
+
+#ifdef BE_ID_MAP_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace be {
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Finds the control bytes in a group which are equal to the
+///         provided value.
+///
+/// \param  group A pointer to the first of 16 control bytes.
+/// \param  h2 The control byte value to search for.
+/// \return A bitmask where bit \c n is set if <tt>group[n] == h2</tt>.
+inline uint32_t idMapMatch(const int8_t* group, int8_t h2)
+{
+#ifdef BE_ID_MAP_SSE2
+   __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+   return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+#else
+   uint32_t mask = 0;
+   for (size_t i = 0; i < id_map_group_size; ++i)
+      if (group[i] == h2)
+         mask |= 1u << i;
+
+   return mask;
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Finds the slots in a group which have never been used.
+///
+/// \param  group A pointer to the first of 16 control bytes.
+/// \return A bitmask where bit \c n is set if slot \c n is empty.
+inline uint32_t idMapMatchEmpty(const int8_t* group)
+{
+   return idMapMatch(group, id_map_empty);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Finds the slots in a group which do not currently hold a value.
+///
+/// \param  group A pointer to the first of 16 control bytes.
+/// \return A bitmask where bit \c n is set if slot \c n is empty or deleted.
+inline uint32_t idMapMatchEmptyOrDeleted(const int8_t* group)
+{
+#ifdef BE_ID_MAP_SSE2
+   // empty and deleted are the only control bytes less than -1.
+   __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+   return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrl)));
+#else
+   uint32_t mask = 0;
+   for (size_t i = 0; i < id_map_group_size; ++i)
+      if (group[i] < -1)
+         mask |= 1u << i;
+
+   return mask;
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Determines the index of the least significant set bit in a
+///         bitmask.
+///
+/// \param  mask The bitmask to check.  Must not be zero.
+/// \return The index of the lowest set bit.
+inline uint32_t idMapLowestBit(uint32_t mask)
+{
+#if defined(_MSC_VER)
+   unsigned long index;
+   _BitScanForward(&index, mask);
+   return index;
+#elif defined(__GNUC__)
+   return __builtin_ctz(mask);
+#else
+   uint32_t index = 0;
+   while ((mask & 1) == 0)
+   {
+      mask >>= 1;
+      ++index;
+   }
+   return index;
+#endif
+}
+
+} // namespace be::detail
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs an empty map.
+///
+/// \details No memory is allocated until the first insertion.
+template <typename T>
+IdMap<T>::IdMap()
+   : ctrl_(nullptr),
+     slots_(nullptr),
+     capacity_(0),
+     size_(0),
+     growth_left_(0)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs an empty map which can hold at least \c capacity
+///         values before needing to reallocate.
+///
+/// \param  capacity The number of values to reserve space for.
+template <typename T>
+IdMap<T>::IdMap(size_t capacity)
+   : ctrl_(nullptr),
+     slots_(nullptr),
+     capacity_(0),
+     size_(0),
+     growth_left_(0)
+{
+   reserve(capacity);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Move-constructs a map.
+///
+/// \param  other The map to move from.  It will be left empty.
+template <typename T>
+IdMap<T>::IdMap(IdMap<T>&& other)
+   : ctrl_(other.ctrl_),
+     slots_(other.slots_),
+     capacity_(other.capacity_),
+     size_(other.size_),
+     growth_left_(other.growth_left_)
+{
+   other.ctrl_ = nullptr;
+   other.slots_ = nullptr;
+   other.capacity_ = 0;
+   other.size_ = 0;
+   other.growth_left_ = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Move-assigns a map.
+///
+/// \param  other The map to move from.  It will be left empty.
+/// \return *this
+template <typename T>
+IdMap<T>& IdMap<T>::operator=(IdMap<T>&& other)
+{
+   if (this != &other)
+   {
+      destroy_();
+
+      ctrl_ = other.ctrl_;
+      slots_ = other.slots_;
+      capacity_ = other.capacity_;
+      size_ = other.size_;
+      growth_left_ = other.growth_left_;
+
+      other.ctrl_ = nullptr;
+      other.slots_ = nullptr;
+      other.capacity_ = 0;
+      other.size_ = 0;
+      other.growth_left_ = 0;
+   }
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Destroys all values in the map and frees its storage.
+template <typename T>
+IdMap<T>::~IdMap()
+{
+   destroy_();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves an iterator to the first value in the map.
+///
+/// \details Iteration order is unspecified.
+///
+/// \return An iterator to the first value, or end() if the map is empty.
+template <typename T>
+typename IdMap<T>::iterator IdMap<T>::begin()
+{
+   iterator i(makeIterator_(0));
+   i.skipUnused_();
+   return i;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc IdMap::begin()
+template <typename T>
+typename IdMap<T>::const_iterator IdMap<T>::begin() const
+{
+   const_iterator i(makeIterator_(0));
+   i.skipUnused_();
+   return i;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves an iterator past the last value in the map.
+///
+/// \return An iterator which is returned by find() when a key is not found.
+template <typename T>
+typename IdMap<T>::iterator IdMap<T>::end()
+{
+   return makeIterator_(capacity_);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc IdMap::end()
+template <typename T>
+typename IdMap<T>::const_iterator IdMap<T>::end() const
+{
+   return makeIterator_(capacity_);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Determines if the map contains no values.
+///
+/// \return \c true if size() is 0.
+template <typename T>
+bool IdMap<T>::empty() const
+{
+   return size_ == 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the number of values in the map.
+///
+/// \return The number of values.
+template <typename T>
+size_t IdMap<T>::size() const
+{
+   return size_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the number of slots allocated by the map.
+///
+/// \details The map will reallocate before more than 7/8 of its slots are
+///         in use.
+///
+/// \return The number of slots.  Always 0 or a power of two which is at
+///         least 16.
+template <typename T>
+size_t IdMap<T>::capacity() const
+{
+   return capacity_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Looks up the value associated with an Id.
+///
+/// \param  id The Id to search for.
+/// \return An iterator to the value associated with \c id, or end() if there
+///         is no such value.
+template <typename T>
+typename IdMap<T>::iterator IdMap<T>::find(const Id& id)
+{
+   return makeIterator_(findIndex_(id));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc IdMap::find(const Id&)
+template <typename T>
+typename IdMap<T>::const_iterator IdMap<T>::find(const Id& id) const
+{
+   return makeIterator_(findIndex_(id));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Counts the number of values associated with an Id.
+///
+/// \param  id The Id to search for.
+/// \return 1 if a value is associated with \c id, otherwise 0.
+template <typename T>
+size_t IdMap<T>::count(const Id& id) const
+{
+   return findIndex_(id) == capacity_ ? 0 : 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the value associated with an Id, inserting a
+///         value-initialized value if there is none.
+///
+/// \param  id The Id to look up.
+/// \return A reference to the value associated with \c id.
+template <typename T>
+T& IdMap<T>::operator[](const Id& id)
+{
+   size_t index = findIndex_(id);
+   if (index == capacity_)
+   {
+      index = prepareInsert_(id);
+      alloc_.construct(slots_ + index, value_type(id, T()));
+      setCtrl_(index, h2_(id));
+   }
+
+   return slots_[index].second;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Inserts a value into the map if its key is not already present.
+///
+/// \param  value A \c std::pair whose \c first member is the Id to insert
+///         and whose \c second member is convertible to \c T.  It will be
+///         moved from if it is an rvalue and the insertion takes place.
+/// \return A pair containing an iterator to the value associated with the
+///         key and a \c bool which is \c true if the insertion took place.
+template <typename T>
+template <typename P>
+std::pair<typename IdMap<T>::iterator, bool> IdMap<T>::insert(P&& value)
+{
+   Id id(value.first);
+   size_t index = findIndex_(id);
+   if (index != capacity_)
+      return std::make_pair(makeIterator_(index), false);
+
+   index = prepareInsert_(id);
+   alloc_.construct(slots_ + index, std::forward<P>(value));
+   setCtrl_(index, h2_(id));
+
+   return std::make_pair(makeIterator_(index), true);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Removes a value from the map.
+///
+/// \param  position An iterator referring to the value to remove.
+/// \return An iterator to the value following the removed value.
+template <typename T>
+typename IdMap<T>::iterator IdMap<T>::erase(const_iterator position)
+{
+   size_t index = position.slot_ - slots_;
+   size_t group = index & ~(detail::id_map_group_size - 1);
+
+   alloc_.destroy(slots_ + index);
+   --size_;
+
+   // If this group already has an empty slot, no probe sequence continues
+   // past it, so the slot can be marked empty instead of deleted.
+   if (detail::idMapMatchEmpty(ctrl_ + group) != 0)
+   {
+      ctrl_[index] = detail::id_map_empty;
+      ++growth_left_;
+   }
+   else
+      ctrl_[index] = detail::id_map_deleted;
+
+   iterator i(makeIterator_(index));
+   i.skipUnused_();
+   return i;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Removes the value associated with an Id, if there is one.
+///
+/// \param  id The Id to remove.
+/// \return The number of values removed (0 or 1).
+template <typename T>
+size_t IdMap<T>::erase(const Id& id)
+{
+   size_t index = findIndex_(id);
+   if (index == capacity_)
+      return 0;
+
+   erase(const_iterator(makeIterator_(index)));
+   return 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Removes all values from the map.
+///
+/// \details The map's capacity is not changed.
+template <typename T>
+void IdMap<T>::clear()
+{
+   for (size_t i = 0; i < capacity_; ++i)
+   {
+      if (ctrl_[i] >= 0)
+         alloc_.destroy(slots_ + i);
+
+      ctrl_[i] = detail::id_map_empty;
+   }
+
+   size_ = 0;
+   growth_left_ = capacity_ - capacity_ / 8;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Ensures that at least \c size values can be stored without
+///         reallocating.
+///
+/// \param  size The number of values to reserve space for.
+template <typename T>
+void IdMap<T>::reserve(size_t size)
+{
+   size_t capacity = capacity_ == 0 ? detail::id_map_group_size : capacity_;
+   while (capacity - capacity / 8 < size)
+      capacity *= 2;
+
+   if (capacity > capacity_)
+      rehash_(capacity);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Finds the slot holding a value with the provided Id.
+///
+/// \param  id The Id to search for.
+/// \return The index of the slot, or \c capacity_ if it is not found.
+template <typename T>
+size_t IdMap<T>::findIndex_(const Id& id) const
+{
+   if (size_ == 0)
+      return capacity_;
+
+   const size_t group_mask = capacity_ / detail::id_map_group_size - 1;
+   const int8_t h2 = h2_(id);
+   size_t group = groupIndex_(id, group_mask);
+
+   for (size_t probe = 1; ; ++probe)
+   {
+      const int8_t* ctrl = ctrl_ + group * detail::id_map_group_size;
+
+      for (uint32_t match = detail::idMapMatch(ctrl, h2); match != 0; match &= match - 1)
+      {
+         size_t index = group * detail::id_map_group_size + detail::idMapLowestBit(match);
+         if (slots_[index].first == id)
+            return index;
+      }
+
+      if (detail::idMapMatchEmpty(ctrl) != 0)
+         return capacity_;
+
+      group = (group + probe) & group_mask;   // triangular probing
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Finds an unused slot where a new value with the provided Id
+///         should be constructed, growing the table if necessary.
+///
+/// \details The Id must not already be in the map.  After constructing the
+///         value, setCtrl_() must be called to mark the slot as used.
+///
+/// \param  id The Id which will be inserted.
+/// \return The index of the slot to use.
+template <typename T>
+size_t IdMap<T>::prepareInsert_(const Id& id)
+{
+   if (growth_left_ == 0)
+   {
+      // If at least half of the usable slots are tombstones, rehashing in
+      // place is enough; otherwise double the capacity.
+      size_t usable = capacity_ - capacity_ / 8;
+      rehash_(size_ < usable / 2 ? capacity_ : capacity_ * 2);
+   }
+
+   const size_t group_mask = capacity_ / detail::id_map_group_size - 1;
+   size_t group = groupIndex_(id, group_mask);
+
+   for (size_t probe = 1; ; ++probe)
+   {
+      const int8_t* ctrl = ctrl_ + group * detail::id_map_group_size;
+      uint32_t match = detail::idMapMatchEmptyOrDeleted(ctrl);
+      if (match != 0)
+         return group * detail::id_map_group_size + detail::idMapLowestBit(match);
+
+      group = (group + probe) & group_mask;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Marks a slot returned by prepareInsert_() as being in use.
+///
+/// \param  index The index of the slot.
+/// \param  ctrl The control byte for the slot's value (see h2_()).
+template <typename T>
+void IdMap<T>::setCtrl_(size_t index, int8_t ctrl)
+{
+   if (ctrl_[index] == detail::id_map_empty)
+      --growth_left_;
+
+   ctrl_[index] = ctrl;
+   ++size_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Moves all values into a newly allocated table.
+///
+/// \details Also removes all tombstones left behind by erase().
+///
+/// \param  capacity The new number of slots.  Must be a power of two which
+///         is at least 16 and large enough to hold all current values.
+template <typename T>
+void IdMap<T>::rehash_(size_t capacity)
+{
+   if (capacity < detail::id_map_group_size)
+      capacity = detail::id_map_group_size;
+
+   std::allocator<int8_t> ctrl_alloc;
+   int8_t* ctrl = ctrl_alloc.allocate(capacity);
+   value_type* slots = alloc_.allocate(capacity);
+
+   for (size_t i = 0; i < capacity; ++i)
+      ctrl[i] = detail::id_map_empty;
+
+   const size_t group_mask = capacity / detail::id_map_group_size - 1;
+   for (size_t i = 0; i < capacity_; ++i)
+   {
+      if (ctrl_[i] < 0)
+         continue;
+
+      value_type& value = slots_[i];
+      size_t group = groupIndex_(value.first, group_mask);
+      for (size_t probe = 1; ; ++probe)
+      {
+         uint32_t match = detail::idMapMatchEmpty(ctrl + group * detail::id_map_group_size);
+         if (match != 0)
+         {
+            size_t index = group * detail::id_map_group_size + detail::idMapLowestBit(match);
+            alloc_.construct(slots + index, std::move(value));
+            ctrl[index] = ctrl_[i];
+            break;
+         }
+         group = (group + probe) & group_mask;
+      }
+      alloc_.destroy(slots_ + i);
+   }
+
+   if (ctrl_)
+   {
+      ctrl_alloc.deallocate(ctrl_, capacity_);
+      alloc_.deallocate(slots_, capacity_);
+   }
+
+   ctrl_ = ctrl;
+   slots_ = slots;
+   capacity_ = capacity;
+   growth_left_ = capacity - capacity / 8 - size_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Destroys all values and frees the map's storage.
+template <typename T>
+void IdMap<T>::destroy_()
+{
+   if (ctrl_)
+   {
+      for (size_t i = 0; i < capacity_; ++i)
+         if (ctrl_[i] >= 0)
+            alloc_.destroy(slots_ + i);
+
+      std::allocator<int8_t>().deallocate(ctrl_, capacity_);
+      alloc_.deallocate(slots_, capacity_);
+
+      ctrl_ = nullptr;
+      slots_ = nullptr;
+      capacity_ = 0;
+      size_ = 0;
+      growth_left_ = 0;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Creates an iterator referring to a specific slot.
+///
+/// \param  index The index of the slot, or \c capacity_ for end().
+/// \return An iterator referring to the slot.
+template <typename T>
+typename IdMap<T>::iterator IdMap<T>::makeIterator_(size_t index)
+{
+   return iterator(ctrl_ + index, slots_ + index, slots_ + capacity_);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc IdMap::makeIterator_(size_t)
+template <typename T>
+typename IdMap<T>::const_iterator IdMap<T>::makeIterator_(size_t index) const
+{
+   return const_iterator(ctrl_ + index, slots_ + index, slots_ + capacity_);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Determines which group of slots should be probed first when
+///         looking for an Id.
+///
+/// \param  id The Id to look for.
+/// \param  group_mask One less than the number of groups in the table.
+/// \return The index of the first group to probe.
+template <typename T>
+size_t IdMap<T>::groupIndex_(const Id& id, size_t group_mask)
+{
+   return static_cast<size_t>(id.value()) & group_mask;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Calculates the control byte stored for slots holding an Id.
+///
+/// \param  id The Id to look for.
+/// \return The upper 7 bits of the Id's value.
+template <typename T>
+int8_t IdMap<T>::h2_(const Id& id)
+{
+   return static_cast<int8_t>(id.value() >> 57);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a singular iterator.
+template <typename T>
+template <typename V>
+IdMap<T>::iterator_<V>::iterator_()
+   : ctrl_(nullptr),
+     slot_(nullptr),
+     end_(nullptr)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Converts an iterator to a const_iterator.
+///
+/// \param  other The iterator to copy.
+template <typename T>
+template <typename V>
+template <typename V2>
+IdMap<T>::iterator_<V>::iterator_(const iterator_<V2>& other)
+   : ctrl_(other.ctrl_),
+     slot_(other.slot_),
+     end_(other.end_)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Accesses the value this iterator refers to.
+///
+/// \return A reference to the key/value pair.
+template <typename T>
+template <typename V>
+V& IdMap<T>::iterator_<V>::operator*() const
+{
+   return *slot_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Accesses the value this iterator refers to.
+///
+/// \return A pointer to the key/value pair.
+template <typename T>
+template <typename V>
+V* IdMap<T>::iterator_<V>::operator->() const
+{
+   return slot_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Advances to the next value in the map.
+///
+/// \return *this
+template <typename T>
+template <typename V>
+typename IdMap<T>::template iterator_<V>& IdMap<T>::iterator_<V>::operator++()
+{
+   ++ctrl_;
+   ++slot_;
+   skipUnused_();
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Advances to the next value in the map.
+///
+/// \return A copy of this iterator before it was advanced.
+template <typename T>
+template <typename V>
+typename IdMap<T>::template iterator_<V> IdMap<T>::iterator_<V>::operator++(int)
+{
+   iterator_<V> copy(*this);
+   ++*this;
+   return copy;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Checks if two iterators refer to the same slot.
+///
+/// \param  other The iterator to compare to.
+/// \return \c true if both iterators refer to the same slot.
+template <typename T>
+template <typename V>
+template <typename V2>
+bool IdMap<T>::iterator_<V>::operator==(const iterator_<V2>& other) const
+{
+   return slot_ == other.slot_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Checks if two iterators refer to different slots.
+///
+/// \param  other The iterator to compare to.
+/// \return \c true if the iterators refer to different slots.
+template <typename T>
+template <typename V>
+template <typename V2>
+bool IdMap<T>::iterator_<V>::operator!=(const iterator_<V2>& other) const
+{
+   return slot_ != other.slot_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs an iterator referring to a specific slot.
+///
+/// \param  ctrl The control byte of the slot.
+/// \param  slot The slot.
+/// \param  end The slot past the end of the table.
+template <typename T>
+template <typename V>
+IdMap<T>::iterator_<V>::iterator_(const int8_t* ctrl, V* slot, V* end)
+   : ctrl_(ctrl),
+     slot_(slot),
+     end_(end)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Advances the iterator until it refers to a used slot or the end
+///         of the table.
+template <typename T>
+template <typename V>
+void IdMap<T>::iterator_<V>::skipUnused_()
+{
+   while (slot_ != end_ && *ctrl_ < 0)
+   {
+      ++ctrl_;
+      ++slot_;
+   }
+}
+
+} // namespace be
+
+#endif
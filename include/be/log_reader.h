@@ -0,0 +1,68 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/log_reader.h
+/// \author Benjamin Crist
+///
+/// \brief  be::LogReader class header.
+
+#ifndef BE_LOG_READER_H_
+#define BE_LOG_READER_H_
+
+#include "be/detail/log_format.h"
+
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace be {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \class  LogReader   be/log_reader.h "be/log_reader.h"
+///
+/// \brief  Converts a binary log written by an AsyncLog back to text.
+/// \details Messages are rendered exactly as they would have been written to
+///         a text log, except that Ids are rendered using the names known to
+///         the reading process, so Id names can be recovered by registering
+///         them (eg. by constructing an Id from each name) before reading.
+/// \ingroup logging
+class LogReader
+{
+public:
+   explicit LogReader(std::istream& input);
+
+   bool read(std::string& message);
+
+private:
+   bool readBytes_(char* data, size_t size);
+
+   std::istream& input_;
+   std::vector<std::string> strings_;
+   std::string values_;
+   detail::LogTimeCache time_cache_;
+
+   LogReader(const LogReader&);
+   void operator=(const LogReader&);
+};
+
+} // namespace be
+
+#endif
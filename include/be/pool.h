@@ -0,0 +1,161 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/pool.h
+/// \author Benjamin Crist
+///
+/// \brief  be::Pool class header.
+
+#ifndef BE_POOL_H_
+#define BE_POOL_H_
+
+#include "be/source_handle.h"
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace be {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \class  Pool   be/pool.h "be/pool.h"
+///
+/// \brief  Owns objects of a handled type in contiguous, chunked storage.
+/// \details Objects are constructed in place with create() and destroyed
+///         with destroy(); only whole chunks of slots are ever requested from
+///         the global allocator, and never released until the pool is
+///         destroyed.  Since chunks are never moved, objects in a pool never
+///         move either, so their SourceHandles never need to be updated.
+///
+///         Freed slots are reused in LIFO order, mirroring the free list of
+///         the HandleManager, so an object created immediately after another
+///         is destroyed will usually occupy the same memory and the same
+///         handle index.  The pool keeps its own free list rather than using
+///         the HandleManager's: a handle index is only assigned once T's
+///         constructor runs, after its storage has been chosen, and the
+///         HandleManager's indices are shared with every other pool and
+///         any objects of type T allocated outside a pool.
+///
+///         forEach() visits live objects in storage order, walking each
+///         chunk linearly.
+///
+///         T must have a be::SourceHandle<T> which is associated with the
+///         object when it is constructed, and a getHandle() member function
+///         which returns a Handle<T> (or something convertible to one).
+///
+///         Pool is not synchronized for access from multiple threads, but
+///         handles created by a pool may be resolved on any thread.
+/// \tparam T The type of object to store.
+/// \ingroup handles
+template <class T>
+class Pool
+{
+   class Reservation;
+
+public:
+   Pool();
+   ~Pool();
+
+   Handle<T> create();
+   template <class A1>
+   Handle<T> create(A1&& a1);
+   template <class A1, class A2>
+   Handle<T> create(A1&& a1, A2&& a2);
+   template <class A1, class A2, class A3>
+   Handle<T> create(A1&& a1, A2&& a2, A3&& a3);
+   template <class A1, class A2, class A3, class A4>
+   Handle<T> create(A1&& a1, A2&& a2, A3&& a3, A4&& a4);
+   template <class A1, class A2, class A3, class A4, class A5>
+   Handle<T> create(A1&& a1, A2&& a2, A3&& a3, A4&& a4, A5&& a5);
+   template <class A1, class A2, class A3, class A4, class A5, class A6>
+   Handle<T> create(A1&& a1, A2&& a2, A3&& a3, A4&& a4, A5&& a5, A6&& a6);
+   template <class A1, class A2, class A3, class A4, class A5, class A6, class A7>
+   Handle<T> create(A1&& a1, A2&& a2, A3&& a3, A4&& a4, A5&& a5, A6&& a6, A7&& a7);
+
+   bool destroy(const ConstHandle<T>& handle);
+   void clear();
+
+   size_t size() const;
+   size_t capacity() const;
+
+   template <class F>
+   void forEach(F func);
+   template <class F>
+   void forEach(F func) const;
+
+   /// \brief  The number of objects in each chunk is 2^chunk_bits.
+   static const uint32_t chunk_bits = 6;
+
+   /// \brief  The number of objects in each chunk.
+   static const uint32_t chunk_size = 1 << chunk_bits;
+
+private:
+   struct Chunk
+   {
+      typedef typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type Storage;
+
+      Chunk();
+
+      Storage slots[chunk_size];
+      bool live[chunk_size];
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   /// \brief  Holds a free slot while an object is being constructed in it.
+   /// \details If the constructor throws, the slot is returned to the free
+   ///         list when the reservation is destroyed.
+   class Reservation
+   {
+   public:
+      explicit Reservation(Pool<T>& pool);
+      ~Reservation();
+
+      void* address() const;
+      Handle<T> commit(T* object);
+
+   private:
+      Pool<T>& pool_;
+      uint32_t slot_;
+      bool committed_;
+
+      Reservation(const Reservation&);
+      void operator=(const Reservation&);
+   };
+
+   uint32_t allocate_();
+   void* address_(uint32_t slot) const;
+   bool find_(const ConstHandle<T>& handle, uint32_t& slot) const;
+   void destroy_(uint32_t slot);
+
+   std::vector<std::unique_ptr<Chunk> > chunks_;
+   std::vector<uint32_t> free_;           ///< Indices of unused slots; the last element is reused first.
+   std::vector<uint32_t> handle_slots_;   ///< The slot of each live object, indexed by its handle's index.
+   size_t size_;
+
+   Pool(const Pool<T>&);
+   void operator=(const Pool<T>&);
+};
+
+} // namespace be
+
+#include "be/pool.inl"
+
+#endif
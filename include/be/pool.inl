@@ -0,0 +1,382 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/pool.inl
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of be::Pool template functions.
+
+#if !defined(BE_POOL_H_) && !defined(DOXYGEN)
+#include "be/pool.h"
+#elif !defined(BE_POOL_INL_)
+#define BE_POOL_INL_
+
+#include <new>
+
+namespace be {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs an empty pool.
+/// \details No storage is allocated until the first object is created.
+template <class T>
+inline Pool<T>::Pool()
+   : size_(0)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Destroys all objects in the pool and frees its storage.
+template <class T>
+inline Pool<T>::~Pool()
+{
+   clear();
+}
+
+// The debug CRT's new macro (see be/_be.h) can't be used for placement new.
+#pragma push_macro("new")
+#undef new
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a new object in the pool.
+/// \details Overloads are provided for constructors taking up to 7
+///         arguments, which are forwarded to T's constructor.  If the
+///         constructor throws, the pool is unchanged.
+/// \return A handle to the new object.
+template <class T>
+inline Handle<T> Pool<T>::create()
+{
+   Reservation slot(*this);
+   return slot.commit(new (slot.address()) T());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a new object in the pool.
+/// \sa     create()
+template <class T>
+template <class A1>
+inline Handle<T> Pool<T>::create(A1&& a1)
+{
+   Reservation slot(*this);
+   return slot.commit(new (slot.address()) T(std::forward<A1>(a1)));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a new object in the pool.
+/// \sa     create()
+template <class T>
+template <class A1, class A2>
+inline Handle<T> Pool<T>::create(A1&& a1, A2&& a2)
+{
+   Reservation slot(*this);
+   return slot.commit(new (slot.address()) T(std::forward<A1>(a1), std::forward<A2>(a2)));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a new object in the pool.
+/// \sa     create()
+template <class T>
+template <class A1, class A2, class A3>
+inline Handle<T> Pool<T>::create(A1&& a1, A2&& a2, A3&& a3)
+{
+   Reservation slot(*this);
+   return slot.commit(new (slot.address()) T(std::forward<A1>(a1), std::forward<A2>(a2), std::forward<A3>(a3)));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a new object in the pool.
+/// \sa     create()
+template <class T>
+template <class A1, class A2, class A3, class A4>
+inline Handle<T> Pool<T>::create(A1&& a1, A2&& a2, A3&& a3, A4&& a4)
+{
+   Reservation slot(*this);
+   return slot.commit(new (slot.address()) T(std::forward<A1>(a1), std::forward<A2>(a2), std::forward<A3>(a3), std::forward<A4>(a4)));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a new object in the pool.
+/// \sa     create()
+template <class T>
+template <class A1, class A2, class A3, class A4, class A5>
+inline Handle<T> Pool<T>::create(A1&& a1, A2&& a2, A3&& a3, A4&& a4, A5&& a5)
+{
+   Reservation slot(*this);
+   return slot.commit(new (slot.address()) T(std::forward<A1>(a1), std::forward<A2>(a2), std::forward<A3>(a3), std::forward<A4>(a4), std::forward<A5>(a5)));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a new object in the pool.
+/// \sa     create()
+template <class T>
+template <class A1, class A2, class A3, class A4, class A5, class A6>
+inline Handle<T> Pool<T>::create(A1&& a1, A2&& a2, A3&& a3, A4&& a4, A5&& a5, A6&& a6)
+{
+   Reservation slot(*this);
+   return slot.commit(new (slot.address()) T(std::forward<A1>(a1), std::forward<A2>(a2), std::forward<A3>(a3), std::forward<A4>(a4), std::forward<A5>(a5), std::forward<A6>(a6)));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a new object in the pool.
+/// \sa     create()
+template <class T>
+template <class A1, class A2, class A3, class A4, class A5, class A6, class A7>
+inline Handle<T> Pool<T>::create(A1&& a1, A2&& a2, A3&& a3, A4&& a4, A5&& a5, A6&& a6, A7&& a7)
+{
+   Reservation slot(*this);
+   return slot.commit(new (slot.address()) T(std::forward<A1>(a1), std::forward<A2>(a2), std::forward<A3>(a3), std::forward<A4>(a4), std::forward<A5>(a5), std::forward<A6>(a6), std::forward<A7>(a7)));
+}
+
+#pragma pop_macro("new")
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Destroys the object referenced by a handle.
+/// \details All handles to the object will become invalid.  The object's
+///         slot is found through the index of its handle, so this takes
+///         constant time no matter how many chunks the pool has.
+/// \param  handle A handle to an object in this pool.
+/// \return \c true if the object was destroyed, or \c false if the handle is
+///         invalid or refers to an object which does not belong to this
+///         pool.
+template <class T>
+inline bool Pool<T>::destroy(const ConstHandle<T>& handle)
+{
+   uint32_t slot;
+   if (!find_(handle, slot))
+      return false;
+
+   destroy_(slot);
+   return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Destroys all objects in the pool.
+/// \details Storage is retained for reuse.
+template <class T>
+inline void Pool<T>::clear()
+{
+   for (uint32_t c = 0; c < chunks_.size(); ++c)
+   {
+      Chunk& chunk = *chunks_[c];
+      for (uint32_t i = 0; i < chunk_size; ++i)
+         if (chunk.live[i])
+            destroy_((c << chunk_bits) | i);
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the number of objects in the pool.
+template <class T>
+inline size_t Pool<T>::size() const
+{
+   return size_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the number of objects the pool can hold before another
+///         chunk must be allocated.
+template <class T>
+inline size_t Pool<T>::capacity() const
+{
+   return chunks_.size() * chunk_size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Calls a function once for each object in the pool.
+/// \details Objects are visited in storage order, not creation order.  The
+///         function must not create or destroy objects in this pool.
+/// \param  func A function or function object taking a \c T&.
+template <class T>
+template <class F>
+inline void Pool<T>::forEach(F func)
+{
+   for (auto i(chunks_.begin()), end(chunks_.end()); i != end; ++i)
+   {
+      Chunk& chunk = **i;
+      for (uint32_t s = 0; s < chunk_size; ++s)
+         if (chunk.live[s])
+            func(*reinterpret_cast<T*>(&chunk.slots[s]));
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Calls a function once for each object in the pool.
+/// \details Objects are visited in storage order, not creation order.
+/// \param  func A function or function object taking a <tt>const T&</tt>.
+template <class T>
+template <class F>
+inline void Pool<T>::forEach(F func) const
+{
+   for (auto i(chunks_.begin()), end(chunks_.end()); i != end; ++i)
+   {
+      const Chunk& chunk = **i;
+      for (uint32_t s = 0; s < chunk_size; ++s)
+         if (chunk.live[s])
+            func(*reinterpret_cast<const T*>(&chunk.slots[s]));
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a chunk of unused slots.
+template <class T>
+inline Pool<T>::Chunk::Chunk()
+{
+   for (uint32_t i = 0; i < chunk_size; ++i)
+      live[i] = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Removes a slot from the pool's free list.
+template <class T>
+inline Pool<T>::Reservation::Reservation(Pool<T>& pool)
+   : pool_(pool),
+     slot_(pool.allocate_()),
+     committed_(false)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the slot to the free list unless commit() was called.
+template <class T>
+inline Pool<T>::Reservation::~Reservation()
+{
+   if (!committed_)
+      pool_.free_.push_back(slot_);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the address of the reserved slot.
+template <class T>
+inline void* Pool<T>::Reservation::address() const
+{
+   return pool_.address_(slot_);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Marks the reserved slot as containing a live object.
+/// \details The object's handle index isn't known until it has been
+///         constructed, so the slot lookup table may need to grow here.  If
+///         that fails, the object is destroyed before the exception
+///         propagates, so the slot can safely be returned to the free list.
+/// \param  object The object which was constructed at address().
+/// \return A handle to the object.
+template <class T>
+inline Handle<T> Pool<T>::Reservation::commit(T* object)
+{
+   Handle<T> handle(object->getHandle());
+
+   std::vector<uint32_t>& handle_slots = pool_.handle_slots_;
+   if (handle.index_ >= handle_slots.size())
+   {
+      try
+      {
+         handle_slots.resize(handle.index_ + 1, uint32_t(-1));
+      }
+      catch (...)
+      {
+         object->~T();
+         throw;
+      }
+   }
+   handle_slots[handle.index_] = slot_;
+
+   pool_.chunks_[slot_ >> chunk_bits]->live[slot_ & (chunk_size - 1)] = true;
+   ++pool_.size_;
+   committed_ = true;
+   return handle;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Removes an unused slot from the free list, allocating a new chunk
+///         if there are none.
+/// \return The index of the slot.
+template <class T>
+uint32_t Pool<T>::allocate_()
+{
+   if (free_.empty())
+   {
+      uint32_t first = uint32_t(chunks_.size()) << chunk_bits;
+      chunks_.push_back(std::unique_ptr<Chunk>(new Chunk()));
+
+      // free_ can then hold every slot, so returning slots never allocates
+      free_.reserve(capacity());
+
+      // push in reverse so that slots are used in address order
+      for (uint32_t i = chunk_size; i > 0; --i)
+         free_.push_back(first + i - 1);
+   }
+
+   uint32_t slot = free_.back();
+   free_.pop_back();
+   return slot;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the address of a slot.
+template <class T>
+inline void* Pool<T>::address_(uint32_t slot) const
+{
+   return &chunks_[slot >> chunk_bits]->slots[slot & (chunk_size - 1)];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Determines which slot holds the object a handle refers to.
+/// \details The slot recorded for the handle's index is only trusted if it
+///         holds a live object at the address the handle resolves to, since
+///         handle indices are shared by every pool (and every other object)
+///         of type T.
+/// \param  handle A handle to the object to find.
+/// \param  slot Receives the slot's index if the object is found.
+/// \return \c true if the handle refers to a live object in this pool.
+template <class T>
+bool Pool<T>::find_(const ConstHandle<T>& handle, uint32_t& slot) const
+{
+   const T* object = handle.get();
+   if (!object || handle.index_ >= handle_slots_.size())
+      return false;
+
+   uint32_t s = handle_slots_[handle.index_];
+   if (s >= capacity() || !chunks_[s >> chunk_bits]->live[s & (chunk_size - 1)] || address_(s) != object)
+      return false;
+
+   slot = s;
+   return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Destroys the object in a slot and adds the slot to the free list.
+template <class T>
+inline void Pool<T>::destroy_(uint32_t slot)
+{
+   Chunk& chunk = *chunks_[slot >> chunk_bits];
+   uint32_t i = slot & (chunk_size - 1);
+   T* object = reinterpret_cast<T*>(&chunk.slots[i]);
+
+   handle_slots_[ConstHandle<T>(object->getHandle()).index_] = uint32_t(-1);
+   chunk.live[i] = false;
+   --size_;
+   free_.push_back(slot);
+
+   object->~T();
+}
+
+} // namespace be
+
+#endif
@@ -0,0 +1,277 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/profiler.h
+/// \author Benjamin Crist
+///
+/// \brief  be::Profiler class header and profiling zone macros.
+
+#ifndef BE_PROFILER_H_
+#define BE_PROFILER_H_
+
+#include "be/_be.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#define BE_PROFILE_RDTSC
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#include <x86intrin.h>
+#define BE_PROFILE_RDTSC
+#endif
+
+#ifdef DOXYGEN
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Indicates that #BE_PROFILE_ZONE and the other profiling macros
+///         should record timing information.
+/// \details If #BE_PROFILE_ENABLED and #BE_PROFILE_DISABLED are both defined
+///         then #BE_PROFILE_ENABLED takes precedence.  If neither name is
+///         explicitly defined, #BE_PROFILE_ENABLED will be defined only if
+///         #BE_BEDITOR or \c PBJ_EDITOR is defined.  \c PBJ_EDITOR is checked
+///         as well because it is defined on the command line for editor
+///         builds, while #BE_BEDITOR is only defined once \c pbj/_pbj.h has
+///         been included.  When profiling is disabled, the profiling macros
+///         expand to nothing.
+/// \ingroup profiling
+#define BE_PROFILE_ENABLED
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Indicates that the profiling macros should be compiled out.
+/// \ingroup profiling
+#define BE_PROFILE_DISABLED
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Defined when profiling timestamps are read with the \c rdtsc
+///         instruction rather than \c std::chrono::steady_clock.
+/// \ingroup profiling
+#define BE_PROFILE_RDTSC
+#endif
+
+#if (defined(BE_BEDITOR) || defined(PBJ_EDITOR)) && !defined(BE_PROFILE_ENABLED) && !defined(BE_PROFILE_DISABLED)
+#define BE_PROFILE_ENABLED
+#endif
+
+namespace be {
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  A completed profiling zone or frame boundary.
+struct ProfileEvent
+{
+   const char* name;    ///< The zone's name, or nullptr for a frame boundary.
+   uint64_t begin;      ///< Tick count when the zone was entered.
+   uint64_t end;        ///< Tick count when the zone was exited.
+   uint32_t thread;     ///< Identifies the thread that recorded the event.
+};
+
+extern std::atomic<bool> profiler_active;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads the high-resolution timestamp used by profiling zones.
+/// \details Ticks are converted to real time by the Profiler.
+inline uint64_t getProfileTicks()
+{
+#ifdef BE_PROFILE_RDTSC
+   return __rdtsc();
+#else
+   return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+void recordProfileZone(const char* name, uint64_t begin, uint64_t end);
+void markProfileFrame();
+void setProfileThreadName(const char* name);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \class  ProfileZone   be/profiler.h "be/profiler.h"
+///
+/// \brief  Records the time between its construction and destruction.
+/// \details Created by #BE_PROFILE_ZONE.  When no Profiler exists, only a
+///         single relaxed atomic load is performed.
+class ProfileZone
+{
+public:
+   explicit ProfileZone(const char* name)
+      : name_(name),
+        begin_(profiler_active.load(std::memory_order_relaxed) ? getProfileTicks() : 0)
+   {
+   }
+
+   ~ProfileZone()
+   {
+      if (begin_ != 0)
+         recordProfileZone(name_, begin_, getProfileTicks());
+   }
+
+private:
+   const char* name_;
+   uint64_t begin_;
+
+   ProfileZone(const ProfileZone&);
+   void operator=(const ProfileZone&);
+};
+
+} // namespace be::detail
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Timing statistics for all zones with the same name in one frame.
+/// \ingroup profiling
+struct ProfileZoneStats
+{
+   const char* name;    ///< The name passed to #BE_PROFILE_ZONE.
+   uint32_t calls;      ///< The number of times the zone was exited.
+   double total_ms;     ///< Total time spent in the zone, in milliseconds.
+   double max_ms;       ///< The longest time spent in the zone at once.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Timing statistics for one frame.
+/// \ingroup profiling
+struct ProfileFrameStats
+{
+   uint64_t index;                        ///< The number of frames before this one.
+   double duration_ms;                    ///< The time between the frame's boundaries.
+   std::vector<ProfileZoneStats> zones;   ///< One entry per zone name, in the order they were first exited.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \class  Profiler   be/profiler.h "be/profiler.h"
+///
+/// \brief  Collects profiling zones while it exists.
+/// \details Zones are marked with #BE_PROFILE_ZONE or #BE_PROFILE_FUNCTION.
+///         Each thread records completed zones into its own lock-free ring
+///         buffer, so entering and leaving a zone never blocks.  If a
+///         thread's buffer fills up before the Profiler collects it, further
+///         zones from that thread are dropped and counted.
+///
+///         #BE_PROFILE_FRAME marks the end of each frame and collects all
+///         buffers.  Zones are grouped into the frame in which they exit and
+///         summarized in a ProfileFrameStats; the most recent frames'
+///         statistics are retained.  The most recent zones are also retained
+///         individually so they can be written in the Chrome trace event
+///         format with writeChromeTrace() and viewed with \c chrome://tracing
+///         or any compatible trace viewer.
+///
+///         If #BE_PROFILE_FRAME is never used, zones are still retained for
+///         writeChromeTrace(), but at most \c max_events zones wait to be
+///         assigned to a frame; older ones are discarded and counted as
+///         dropped.
+///
+///         Only one Profiler may exist at a time.  collect(), the frame
+///         accessors, and writeChromeTrace() should be called from the
+///         thread that uses #BE_PROFILE_FRAME.
+/// \ingroup profiling
+class Profiler
+{
+public:
+   explicit Profiler(size_t max_events = 262144, size_t max_frames = 300);
+   ~Profiler();
+
+   void collect();
+
+   size_t getFrameCount() const;
+   const ProfileFrameStats& getFrame(size_t index) const;
+   uint64_t getDroppedCount() const;
+
+   void writeChromeTrace(std::ostream& os);
+
+private:
+   void closeFrame_(uint64_t end);
+   double ticksToMs_(uint64_t ticks) const;
+   void calibrate_();
+
+   size_t max_events_;
+   size_t max_frames_;
+
+   uint64_t origin_ticks_;
+   std::chrono::steady_clock::time_point origin_time_;
+   double ticks_per_ms_;
+
+   std::deque<detail::ProfileEvent> events_;    ///< Retained for writeChromeTrace().
+   std::vector<detail::ProfileEvent> pending_;  ///< Zones not yet assigned to a frame.  At most max_events_ are kept.
+   std::vector<uint64_t> frame_marks_;
+   std::deque<ProfileFrameStats> frames_;
+   uint64_t frame_count_;
+   uint64_t frame_begin_;
+   uint64_t dropped_;
+   std::vector<std::pair<uint32_t, std::string> > thread_names_;
+
+   std::mutex mutex_;
+
+   Profiler(const Profiler&);
+   void operator=(const Profiler&);
+};
+
+} // namespace be
+
+#define BE_PROFILE_CONCAT_(a, b) a##b
+#define BE_PROFILE_CONCAT(a, b) BE_PROFILE_CONCAT_(a, b)
+
+#if defined(BE_PROFILE_ENABLED) || defined(DOXYGEN)
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Records the time from this statement to the end of the enclosing
+///         scope.
+/// \details \c name must be a string literal (or otherwise outlive the
+///         Profiler) since it is not copied.  Expands to nothing unless
+///         #BE_PROFILE_ENABLED is defined.
+///
+/// \code   BE_PROFILE_ZONE("Texture upload");
+/// \endcode
+/// \ingroup profiling
+#define BE_PROFILE_ZONE(name) ::be::detail::ProfileZone BE_PROFILE_CONCAT(be_profile_zone_, __LINE__)(name)
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Records the time from this statement to the end of the enclosing
+///         function, using the function's name as the zone name.
+/// \ingroup profiling
+#define BE_PROFILE_FUNCTION() BE_PROFILE_ZONE(__FUNCTION__)
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Marks the end of a frame and collects recorded zones.
+/// \ingroup profiling
+#define BE_PROFILE_FRAME() ::be::detail::markProfileFrame()
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Names the calling thread in profiler output.
+/// \details \c name must be a string literal.
+/// \ingroup profiling
+#define BE_PROFILE_THREAD(name) ::be::detail::setProfileThreadName(name)
+
+#else
+
+#define BE_PROFILE_ZONE(name) ((void)0)
+#define BE_PROFILE_FUNCTION() ((void)0)
+#define BE_PROFILE_FRAME() ((void)0)
+#define BE_PROFILE_THREAD(name) ((void)0)
+
+#endif
+
+#endif
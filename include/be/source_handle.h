@@ -44,15 +44,16 @@ namespace be {
 ///         become invalid, and converting them to a pointer will yield
 ///         \c nullptr.
 ///
-///         SourceHandles (and the underlying handle managers) are <b>not</b>
-///         synchronized for access from multiple threads!  All SourceHandles
-///         of a particular type must be created and destroyed from the same
-///         thread.  Since handles have no locking mechanism, the application
-///         must be designed in such a way that handled objects will not be
-///         destroyed or moved between the time that the handle is converted
-///         to a raw pointer and the time the handle client is done with the
-///         handled object.  Therefore in many situations it doesn't make
-///         much sense to use handles from multiple threads anyway.
+///         The underlying handle managers are lock-free, so SourceHandles may
+///         be created, associated, and destroyed on any thread, and handles
+///         may be resolved on any thread while that happens.  A handle to an
+///         object whose SourceHandle has been destroyed will never resolve
+///         to a non-null pointer again.  However, an individual SourceHandle
+///         must not be used by multiple threads at once, and since handles
+///         have no locking mechanism, the application must be designed in
+///         such a way that handled objects will not be destroyed or moved
+///         between the time that the handle is converted to a raw pointer
+///         and the time the handle client is done with the handled object.
 ///
 ///         Each object which can have handles should have exactly one
 ///         SourceHandle object as a member (usually the first member, so that
@@ -43,7 +43,7 @@ inline SourceHandle<T>::SourceHandle()
    : Handle<T>()
 {
    detail::HandleManager<T>& mgr(detail::getHandleManager<T>());
-   mgr.add(index_, check_, nullptr);
+   mgr.add(this->index_, this->check_, nullptr);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -58,7 +58,7 @@ inline SourceHandle<T>::SourceHandle(SourceHandle<T>&& other)
    : Handle<T>(other)
 {
    detail::HandleManager<T>& mgr(detail::getHandleManager<T>());
-   mgr.update(index_, nullptr);
+   mgr.update(this->index_, nullptr);
 
    other.check_ = 0;
 }
@@ -73,16 +73,16 @@ inline SourceHandle<T>::SourceHandle(SourceHandle<T>&& other)
 template <class T>
 inline SourceHandle<T>& SourceHandle<T>::operator=(SourceHandle<T>&& other)
 {
-   T* target = get();
+   T* target = this->get();
    T* other_target = other.get();
 
-   std::swap(index_, other.index_);
-   std::swap(check_, other.check_);
+   std::swap(this->index_, other.index_);
+   std::swap(this->check_, other.check_);
 
    detail::HandleManager<T>& mgr(detail::getHandleManager<T>());
 
-   if (check_)
-      mgr.update(index_, target);
+   if (this->check_)
+      mgr.update(this->index_, target);
 
    if (other.check_)
       mgr.update(other.index_, other_target);
@@ -97,11 +97,11 @@ inline SourceHandle<T>& SourceHandle<T>::operator=(SourceHandle<T>&& other)
 template <class T>
 inline SourceHandle<T>::~SourceHandle()
 {
-   if (check_ == 0)
+   if (this->check_ == 0)
       return;
 
    detail::HandleManager<T>& mgr(detail::getHandleManager<T>());
-   mgr.invalidate(index_);
+   mgr.invalidate(this->index_);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -113,7 +113,7 @@ template <class T>
 inline void SourceHandle<T>::associate(T* target)
 {
    detail::HandleManager<T>& mgr(detail::getHandleManager<T>());
-   mgr.update(index_, target);
+   mgr.update(this->index_, target);
 }
 
 } // namespace be
@@ -31,6 +31,8 @@
 #include "pbj/_pbj.h"
 #include "pbj/window.h"
 #include "pbj/gfx/built_ins.h"
+#include "pbj/sw/resource_cache.h"
+#include "pbj/sw/resource_loader.h"
 
 #include <memory>
 
@@ -50,9 +52,16 @@ public:
 
    const gfx::BuiltIns& getBuiltIns() const;
 
+   sw::ResourceLoader& getResourceLoader() const;
+   sw::ResourceCache& getResourceCache() const;
+   sw::ContentResolver& getContentResolver() const;
+
 private:
     std::unique_ptr<Window> window_;
     std::unique_ptr<gfx::BuiltIns> built_ins_;
+    std::unique_ptr<sw::ResourceLoader> resource_loader_;
+    std::unique_ptr<sw::ContentResolver> content_resolver_;
+    std::unique_ptr<sw::ResourceCache> resource_cache_;
 
    Engine(const Engine&);
    void operator=(const Engine&);
@@ -29,8 +29,9 @@
 
 #include "pbj/sw/resource_id.h"
 #include "pbj/_pbj.h"
+#include "be/id_map.h"
+#include "be/pool.h"
 
-#include <unordered_map>
 #include <memory>
 
 namespace pbj {
@@ -67,14 +68,19 @@ private:
 
     void logWarning(const char* type, const sw::ResourceId id, const std::string& what_arg) const;
 
-    std::unordered_map<Id, std::unique_ptr<TextureFont> > texture_fonts_;
+    be::Pool<TextureFont> texture_font_pool_;
+    be::IdMap<be::Handle<TextureFont> > texture_fonts_;
 
-    //std::unordered_map<Id, std::unique_ptr<Mesh> > meshes_;
+    //be::IdMap<std::unique_ptr<Mesh> > meshes_;
 
-    std::unordered_map<Id, std::unique_ptr<Texture> > textures_;
+    be::Pool<Texture> texture_pool_;
+    be::IdMap<be::Handle<Texture> > textures_;
 
-    std::unordered_map<Id, std::unique_ptr<Shader> > shaders_;
-    std::unordered_map<Id, std::unique_ptr<ShaderProgram> > programs_;
+    be::Pool<Shader> shader_pool_;
+    be::IdMap<be::Handle<Shader> > shaders_;
+
+    be::Pool<ShaderProgram> program_pool_;
+    be::IdMap<be::Handle<ShaderProgram> > programs_;
 
 
     BuiltIns(const BuiltIns&);
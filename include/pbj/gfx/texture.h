@@ -27,6 +27,7 @@
 #ifndef PBJ_GFX_TEXTURE_H_
 #define PBJ_GFX_TEXTURE_H_
 
+#include <functional>
 #include <map>
 #include <vector>
 
@@ -58,7 +59,34 @@ public:
         FM_Nearest = 1
     };
 
+    ///////////////////////////////////////////////////////////////////////////
+    /// \brief  Image data which has been decoded but not yet uploaded.
+    /// \details Decoding doesn't use OpenGL, so it can be done on any thread
+    ///         with decode(), leaving only the upload for the thread which
+    ///         owns the GL context.
+    class Pixels
+    {
+    public:
+        Pixels();
+        Pixels(Pixels&& other);
+        Pixels& operator=(Pixels&& other);
+        ~Pixels();
+
+        ivec2 dimensions;
+        GLubyte* data;                  ///< Allocated by stb_image.
+#ifdef PBJ_EDITOR
+        std::vector<GLubyte> source;    ///< The encoded image, which the editor keeps.
+#endif
+
+    private:
+        Pixels(const Pixels&);
+        void operator=(const Pixels&);
+    };
+
+    static Pixels decode(const sw::ResourceId& id, const GLubyte* data, size_t size, InternalFormat format);
+
     Texture(const sw::ResourceId& id, const GLubyte* data, size_t size, InternalFormat format, bool srgb_color, FilterMode mag_mode, FilterMode min_mode);
+    Texture(const sw::ResourceId& id, Pixels&& pixels, InternalFormat format, bool srgb_color, FilterMode mag_mode, FilterMode min_mode);
     ~Texture();
 
     be::Handle<Texture> getHandle();
@@ -104,6 +132,8 @@ public:
 
 private:
     void upload_(const GLubyte* data, size_t size, InternalFormat format, bool srgb_color, FilterMode mag_mode, FilterMode min_mode);
+    void upload_(const std::function<GLubyte*(ivec2&, int)>& decode, InternalFormat format, bool srgb_color, FilterMode mag_mode, FilterMode min_mode);
+    void upload_(const Pixels& pixels, InternalFormat format, bool srgb_color, FilterMode mag_mode, FilterMode min_mode);
     void invalidate_();
 
     be::SourceHandle<Texture> handle_;
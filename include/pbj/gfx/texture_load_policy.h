@@ -0,0 +1,89 @@
+// Copyright (c) 2013 PBJ^2 Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   pbj/gfx/texture_load_policy.h
+/// \author Benjamin Crist
+///
+/// \brief  pbj::gfx::TextureLoadPolicy class header.
+
+#ifndef PBJ_GFX_TEXTURE_LOAD_POLICY_H_
+#define PBJ_GFX_TEXTURE_LOAD_POLICY_H_
+
+#include "pbj/gfx/texture.h"
+#include "pbj/sw/sandwich.h"
+
+#include <string>
+#include <vector>
+
+namespace pbj {
+namespace gfx {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Load policy for reading textures with a sw::ResourceLoader.
+/// \details The encoded image is read from the sandwich on an I/O thread,
+///         decoded on a CPU thread, and only uploaded by the thread which
+///         owns the GL context.
+///
+///         The table and column containing encoded images are provided by
+///         the caller.  The resource portion of the texture's ResourceId
+///         must be the rowid of its row (ie. its INTEGER PRIMARY KEY).  The
+///         image is read with a db::BlobReader directly into a buffer of
+///         the blob's size, rather than being assembled by SQLite and then
+///         copied.
+///
+///         The policy can also be used with a sw::ResourceCache, which
+///         counts each texture's uncompressed size against its GPU budget.
+///
+/// \sa     sw::ResourceLoader::load()
+/// \sa     sw::ResourceCache::hold()
+class TextureLoadPolicy
+{
+public:
+    typedef Texture resource_type;
+
+    struct data_type
+    {
+        std::vector<GLubyte> encoded;
+        Texture::Pixels pixels;
+    };
+
+    TextureLoadPolicy(const std::string& table, const std::string& column, Texture::InternalFormat format, bool srgb_color, Texture::FilterMode mag_mode, Texture::FilterMode min_mode);
+
+    void read(sw::Sandwich& sandwich, const sw::ResourceId& id, data_type& data) const;
+    void decode(const sw::ResourceId& id, data_type& data) const;
+    Texture* finalize(const sw::ResourceId& id, data_type& data) const;
+    void measure(const Texture& texture, size_t& cpu_bytes, size_t& gpu_bytes) const;
+    Id getVariant() const;
+    Id getContentType() const;
+
+private:
+    std::string table_;
+    std::string column_;
+    Texture::InternalFormat format_;
+    bool srgb_color_;
+    Texture::FilterMode mag_mode_;
+    Texture::FilterMode min_mode_;
+};
+
+} // namespace pbj::gfx
+} // namespace pbj
+
+#endif
@@ -0,0 +1,82 @@
+// Generated by idgen --sql.  Do not edit this file directly; run
+// tools/generate.cmd after changing any *_SQL_* statement.
+
+#ifndef PBJ_SQL_IDS_H_
+#define PBJ_SQL_IDS_H_
+
+#include "pbj/sw/sandwich_sql.h"
+#include "pbj/window_settings_sql.h"
+
+#define PBJ_SQL_IDS(X) \
+   X(PBJ_SW_SANDWICH_SQL_GET_ID, 0xbc84f3d62d1b0e60ULL) \
+   X(PBJ_SW_SANDWICH_SQL_GET_SCHEMA_VERSION, 0x680ca5f66b7d6727ULL) \
+   X(PBJ_SW_SANDWICH_SQL_TABLES, 0x3f4d379242968c8bULL) \
+   X(PBJ_SW_MANIFEST_SQL_GET_VERSION, 0x63e69807a76d6973ULL) \
+   X(PBJ_SW_MANIFEST_SQL_SET_VERSION, 0x94376eebb1d477ffULL) \
+   X(PBJ_SW_MANIFEST_SQL_DROP_TABLE, 0xb6f30fc738138dbdULL) \
+   X(PBJ_SW_MANIFEST_SQL_CREATE_TABLE, 0x2c272206ab0ff063ULL) \
+   X(PBJ_SW_MANIFEST_SQL_LOAD, 0x346f3cef06b4c641ULL) \
+   X(PBJ_SW_MANIFEST_SQL_SAVE, 0xb952eda65c45962fULL) \
+   X(PBJ_SW_MANIFEST_SQL_REMOVE, 0x44f48992248989e6ULL) \
+   X(PBJ_SW_CONTENT_SQL_CREATE_TABLE, 0x89ba9c2e4cbb9cf3ULL) \
+   X(PBJ_SW_CONTENT_SQL_LOAD, 0x8188c8a73e2757f1ULL) \
+   X(PBJ_SW_CONTENT_SQL_SAVE, 0x0f15e4c68974be1dULL) \
+   X(PBJ_WINDOW_SETTINGS_SQL_LOAD, 0x00bec87823fa2d94ULL) \
+   X(PBJ_WINDOW_SETTINGS_SQL_TABLE_EXISTS, 0x1555b36b8b36ab5eULL) \
+   X(PBJ_WINDOW_SETTINGS_SQL_LATEST_INDEX, 0xc2403378f23385acULL) \
+   X(PBJ_WINDOW_SETTINGS_SQL_CREATE_TABLE, 0x8b001ebca7947fb6ULL) \
+   X(PBJ_WINDOW_SETTINGS_SQL_SAVE, 0xe9a12b11e02c3b3cULL) \
+   X(PBJ_WINDOW_SETTINGS_SQL_SAVE_POS, 0x96e9291c93e199b9ULL) \
+   X(PBJ_WINDOW_SETTINGS_SQL_TRUNCATE, 0x88aa050342fc63eaULL) \
+   X(PBJ_WINDOW_SETTINGS_SQL_REVERT, 0x80005c033e141715ULL) \
+   X(PBJ_WINDOW_SETTINGS_SQL_COMPRESS, 0xf6020813d4632f68ULL)
+
+#ifdef BE_ID_NAMES_ENABLED
+#define PBJ_SW_SANDWICH_SQLID_GET_ID PBJ_SW_SANDWICH_SQL_GET_ID
+#define PBJ_SW_SANDWICH_SQLID_GET_SCHEMA_VERSION PBJ_SW_SANDWICH_SQL_GET_SCHEMA_VERSION
+#define PBJ_SW_SANDWICH_SQLID_TABLES PBJ_SW_SANDWICH_SQL_TABLES
+#define PBJ_SW_MANIFEST_SQLID_GET_VERSION PBJ_SW_MANIFEST_SQL_GET_VERSION
+#define PBJ_SW_MANIFEST_SQLID_SET_VERSION PBJ_SW_MANIFEST_SQL_SET_VERSION
+#define PBJ_SW_MANIFEST_SQLID_DROP_TABLE PBJ_SW_MANIFEST_SQL_DROP_TABLE
+#define PBJ_SW_MANIFEST_SQLID_CREATE_TABLE PBJ_SW_MANIFEST_SQL_CREATE_TABLE
+#define PBJ_SW_MANIFEST_SQLID_LOAD PBJ_SW_MANIFEST_SQL_LOAD
+#define PBJ_SW_MANIFEST_SQLID_SAVE PBJ_SW_MANIFEST_SQL_SAVE
+#define PBJ_SW_MANIFEST_SQLID_REMOVE PBJ_SW_MANIFEST_SQL_REMOVE
+#define PBJ_SW_CONTENT_SQLID_CREATE_TABLE PBJ_SW_CONTENT_SQL_CREATE_TABLE
+#define PBJ_SW_CONTENT_SQLID_LOAD PBJ_SW_CONTENT_SQL_LOAD
+#define PBJ_SW_CONTENT_SQLID_SAVE PBJ_SW_CONTENT_SQL_SAVE
+#define PBJ_WINDOW_SETTINGS_SQLID_LOAD PBJ_WINDOW_SETTINGS_SQL_LOAD
+#define PBJ_WINDOW_SETTINGS_SQLID_TABLE_EXISTS PBJ_WINDOW_SETTINGS_SQL_TABLE_EXISTS
+#define PBJ_WINDOW_SETTINGS_SQLID_LATEST_INDEX PBJ_WINDOW_SETTINGS_SQL_LATEST_INDEX
+#define PBJ_WINDOW_SETTINGS_SQLID_CREATE_TABLE PBJ_WINDOW_SETTINGS_SQL_CREATE_TABLE
+#define PBJ_WINDOW_SETTINGS_SQLID_SAVE PBJ_WINDOW_SETTINGS_SQL_SAVE
+#define PBJ_WINDOW_SETTINGS_SQLID_SAVE_POS PBJ_WINDOW_SETTINGS_SQL_SAVE_POS
+#define PBJ_WINDOW_SETTINGS_SQLID_TRUNCATE PBJ_WINDOW_SETTINGS_SQL_TRUNCATE
+#define PBJ_WINDOW_SETTINGS_SQLID_REVERT PBJ_WINDOW_SETTINGS_SQL_REVERT
+#define PBJ_WINDOW_SETTINGS_SQLID_COMPRESS PBJ_WINDOW_SETTINGS_SQL_COMPRESS
+#else
+#define PBJ_SW_SANDWICH_SQLID_GET_ID 0xbc84f3d62d1b0e60ULL
+#define PBJ_SW_SANDWICH_SQLID_GET_SCHEMA_VERSION 0x680ca5f66b7d6727ULL
+#define PBJ_SW_SANDWICH_SQLID_TABLES 0x3f4d379242968c8bULL
+#define PBJ_SW_MANIFEST_SQLID_GET_VERSION 0x63e69807a76d6973ULL
+#define PBJ_SW_MANIFEST_SQLID_SET_VERSION 0x94376eebb1d477ffULL
+#define PBJ_SW_MANIFEST_SQLID_DROP_TABLE 0xb6f30fc738138dbdULL
+#define PBJ_SW_MANIFEST_SQLID_CREATE_TABLE 0x2c272206ab0ff063ULL
+#define PBJ_SW_MANIFEST_SQLID_LOAD 0x346f3cef06b4c641ULL
+#define PBJ_SW_MANIFEST_SQLID_SAVE 0xb952eda65c45962fULL
+#define PBJ_SW_MANIFEST_SQLID_REMOVE 0x44f48992248989e6ULL
+#define PBJ_SW_CONTENT_SQLID_CREATE_TABLE 0x89ba9c2e4cbb9cf3ULL
+#define PBJ_SW_CONTENT_SQLID_LOAD 0x8188c8a73e2757f1ULL
+#define PBJ_SW_CONTENT_SQLID_SAVE 0x0f15e4c68974be1dULL
+#define PBJ_WINDOW_SETTINGS_SQLID_LOAD 0x00bec87823fa2d94ULL
+#define PBJ_WINDOW_SETTINGS_SQLID_TABLE_EXISTS 0x1555b36b8b36ab5eULL
+#define PBJ_WINDOW_SETTINGS_SQLID_LATEST_INDEX 0xc2403378f23385acULL
+#define PBJ_WINDOW_SETTINGS_SQLID_CREATE_TABLE 0x8b001ebca7947fb6ULL
+#define PBJ_WINDOW_SETTINGS_SQLID_SAVE 0xe9a12b11e02c3b3cULL
+#define PBJ_WINDOW_SETTINGS_SQLID_SAVE_POS 0x96e9291c93e199b9ULL
+#define PBJ_WINDOW_SETTINGS_SQLID_TRUNCATE 0x88aa050342fc63eaULL
+#define PBJ_WINDOW_SETTINGS_SQLID_REVERT 0x80005c033e141715ULL
+#define PBJ_WINDOW_SETTINGS_SQLID_COMPRESS 0xf6020813d4632f68ULL
+#endif
+
+#endif
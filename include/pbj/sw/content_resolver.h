@@ -0,0 +1,129 @@
+// Copyright (c) 2013 PBJ^2 Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   pbj/sw/content_resolver.h
+/// \author Benjamin Crist
+///
+/// \brief  pbj::sw::ContentResolver class header.
+
+#ifndef PBJ_SW_CONTENT_RESOLVER_H_
+#define PBJ_SW_CONTENT_RESOLVER_H_
+
+#include "pbj/sw/resource_id.h"
+#include "pbj/sw/sandwich.h"
+#include "be/id_map.h"
+#include "pbj/_pbj.h"
+
+#include <cstdint>
+#include <map>
+
+namespace pbj {
+namespace sw {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Identifies the data a resource is stored as, independent of
+///         where it is stored.
+/// \details Two resources with equal ContentHashes are assumed to have
+///         identical data.  The hash is a 64-bit FNV-1a hash, so this is
+///         only safe for data which isn't chosen to collide deliberately,
+///         like the assets a game ships with.
+struct ContentHash
+{
+   uint64_t hash;    ///< FNV-1a hash of the data.
+   uint64_t size;    ///< The length of the data in bytes.
+
+   bool operator==(const ContentHash& other) const;
+   bool operator!=(const ContentHash& other) const;
+   bool operator<(const ContentHash& other) const;
+};
+
+ContentHash hashContent(const void* data, size_t size);
+void storeContentHash(Sandwich& sandwich, const Id& type, const Id& resource, const ContentHash& hash);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \class  ContentResolver   pbj/sw/content_resolver.h "pbj/sw/content_resolver.h"
+///
+/// \brief  Maps ResourceIds of resources with identical data to a single
+///         canonical ResourceId.
+/// \details The same texture or shader is often imported into several
+///         sandwiches, or several times into the same sandwich.  When
+///         resources are imported, storeContentHash() records a hash of
+///         their data, along with an Id for their type, in the sandwich's
+///         \c pbj_sandwich_content table.  The resolver reads that table from
+///         each sandwich the first time one of its resources is resolved.
+///
+///         Identical data only makes an identical resource if it is loaded
+///         as the same type, in the same way, so resolve() also takes the
+///         resource's type Id and a variant Id describing the load policy's
+///         settings (e.g. a texture's format and filtering).  It returns the
+///         first ResourceId resolved with the same type, variant and
+///         ContentHash.  Since the hashes are keyed by type, resources of
+///         different types may share a resource Id.
+///
+///         A ResourceCache with a resolver loads resources by their
+///         canonical ResourceId, so identical data is only loaded (and
+///         uploaded to the GPU) once, no matter how many ResourceIds refer to
+///         it.  Resources without a recorded hash resolve to themselves.
+///
+///         Hashes are only read once per sandwich, so if a sandwich's
+///         resources are changed while the resolver is in use, clear() must
+///         be called.  Only sandwiches which had a \c pbj_sandwich_content
+///         table when readDirectory() last scanned them are read, so if the
+///         first hash is stored in a sandwich, the directory must be scanned
+///         again too.  Like ResourceCache, a resolver must only be used from
+///         one thread.
+class ContentResolver
+{
+public:
+   ContentResolver();
+
+   ResourceId resolve(const ResourceId& id, const Id& type, const Id& variant);
+   void clear();
+
+   size_t getHashCount() const;
+
+private:
+   /// \brief  Identifies resources which can be shared.
+   struct Key
+   {
+      Id type;
+      Id variant;
+      ContentHash content;
+
+      bool operator<(const Key& other) const;
+   };
+
+   void load_(const Id& sandwich_id);
+
+   typedef std::pair<Id, ResourceId> hash_key_t;   ///< A resource's type Id and ResourceId.
+
+   be::IdMap<bool> loaded_;                  ///< Sandwiches whose hashes have been read.
+   std::map<hash_key_t, ContentHash> hashes_;
+   std::map<Key, ResourceId> canonical_;     ///< The first ResourceId resolved with each Key.
+
+   ContentResolver(const ContentResolver&);
+   void operator=(const ContentResolver&);
+};
+
+} // namespace pbj::sw
+} // namespace pbj
+
+#endif
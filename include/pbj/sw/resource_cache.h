@@ -0,0 +1,216 @@
+// Copyright (c) 2013 PBJ^2 Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   pbj/sw/resource_cache.h
+/// \author Benjamin Crist
+///
+/// \brief  pbj::sw::ResourceCache class header.
+
+#ifndef PBJ_SW_RESOURCE_CACHE_H_
+#define PBJ_SW_RESOURCE_CACHE_H_
+
+#include "pbj/sw/content_resolver.h"
+#include "pbj/sw/resource_loader.h"
+#include "be/const_handle.h"
+#include "pbj/_pbj.h"
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <map>
+#include <utility>
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  The main memory budget of the Engine's ResourceCache, in bytes.
+#define PBJ_SW_RESOURCE_CACHE_DEFAULT_CPU_BUDGET (256 << 20)
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  The video memory budget of the Engine's ResourceCache, in bytes.
+#define PBJ_SW_RESOURCE_CACHE_DEFAULT_GPU_BUDGET (512 << 20)
+
+namespace pbj {
+namespace sw {
+
+class ResourceCache;
+
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Everything a ResourceCache knows about one of its resources.
+struct ResourceCacheEntry
+{
+   enum State
+   {
+      SLoading,   ///< The loader hasn't finalized the resource yet.
+      SResident,  ///< The resource is loaded and counted against the budget.
+      SFailed     ///< The resource could not be loaded.
+   };
+
+   ResourceCacheEntry();
+
+   ResourceKey key;
+   State state;
+   size_t references;         ///< The number of CachedResources referring to this entry.
+   size_t cpu_bytes;          ///< Main memory used by the resource, once resident.
+   size_t gpu_bytes;          ///< Video memory used by the resource, once resident.
+   bool unreferenced;         ///< The entry is in the cache's LRU list.
+   std::list<ResourceCacheEntry*>::iterator lru;
+
+   std::shared_future<void> ready;
+   std::function<void(size_t&, size_t&)> measure;  ///< Measures the resource once it has been finalized.
+   std::function<void()> unload;                  ///< Unloads the resource from the ResourceLoader.
+};
+
+} // namespace pbj::sw::detail
+
+///////////////////////////////////////////////////////////////////////////////
+/// \class  CachedResource   pbj/sw/resource_cache.h "pbj/sw/resource_cache.h"
+///
+/// \brief  A counted reference to a resource owned by a ResourceCache.
+/// \details CachedResources are returned from ResourceCache::hold().  While
+///         any CachedResource refers to a resource, the cache will not evict
+///         it.  They may be freely copied; each copy counts as a reference.
+///
+///         The resource itself is accessed through a be::ConstHandle, which
+///         resolves to \c nullptr until the resource has been loaded.
+///         CachedResources must be destroyed (or released) before the cache
+///         that created them, and only on the cache's owning thread.
+template <class T>
+class CachedResource
+{
+   friend class ResourceCache;
+public:
+   CachedResource();
+   CachedResource(const CachedResource<T>& other);
+   CachedResource<T>& operator=(const CachedResource<T>& other);
+   ~CachedResource();
+
+   const be::ConstHandle<T>& getHandle() const;
+   const std::shared_future<void>& getReady() const;
+
+   const T* get() const;
+   const T* operator->() const;
+   const T& operator*() const;
+
+   void release();
+
+private:
+   CachedResource(ResourceCache& cache, detail::ResourceCacheEntry& entry, const be::ConstHandle<T>& handle, const std::shared_future<void>& ready);
+
+   ResourceCache* cache_;
+   detail::ResourceCacheEntry* entry_;
+   be::ConstHandle<T> handle_;
+   std::shared_future<void> ready_;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Counters describing the contents and effectiveness of a
+///         ResourceCache.
+struct ResourceCacheStats
+{
+   uint64_t hits;          ///< hold() calls for resources which were already cached or loading.
+   uint64_t misses;        ///< hold() calls which started a new load.
+   uint64_t evictions;     ///< Resources unloaded to stay within the budget.
+   uint64_t deduplicated;  ///< hold() calls redirected by the ContentResolver to a resource with identical data.
+
+   size_t loading;         ///< Resources which haven't been loaded yet.
+   size_t resident;        ///< Resources which are loaded.
+   size_t unreferenced;    ///< Resident resources which may be evicted.
+   size_t cpu_bytes;       ///< Main memory used by resident resources.
+   size_t gpu_bytes;       ///< Video memory used by resident resources.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \class  ResourceCache   pbj/sw/resource_cache.h "pbj/sw/resource_cache.h"
+///
+/// \brief  Shares loaded resources between their users, and unloads unused
+///         resources when they exceed a memory budget.
+/// \details Resources are loaded by a ResourceLoader and identified by their
+///         type and ResourceId, so no matter how many scenes hold a
+///         resource, it is only loaded (and uploaded to the GPU) once.
+///
+///         Once a resource has been loaded, the cache measures how much main
+///         and video memory it uses.  When no CachedResources refer to a
+///         resource anymore, it isn't unloaded immediately; instead, it is
+///         kept in case it is needed again, until the total memory used by
+///         resident resources exceeds either budget.  Then the least recently
+///         released resources are evicted until both budgets are satisfied
+///         again (or no unreferenced resources remain).
+///
+///         If a ContentResolver is set, resources with identical data share
+///         a single cache entry, even if they are held under different
+///         ResourceIds (see setResolver()).
+///
+///         Resources held by the cache should not be requested from or
+///         unloaded from its ResourceLoader directly.  Like the loader, the
+///         cache must only be used by the loader's owning thread.
+class ResourceCache
+{
+   template <class T> friend class CachedResource;
+public:
+   ResourceCache(ResourceLoader& loader, size_t cpu_budget, size_t gpu_budget);
+   ~ResourceCache();
+
+   template <class P>
+   CachedResource<typename P::resource_type> hold(const ResourceId& id, int priority, const P& policy);
+
+   void update();
+
+   void setResolver(ContentResolver* resolver);
+   ContentResolver* getResolver() const;
+
+   void setBudget(size_t cpu_budget, size_t gpu_budget);
+   size_t getCpuBudget() const;
+   size_t getGpuBudget() const;
+
+   const ResourceCacheStats& getStats() const;
+
+private:
+   typedef detail::ResourceKey key_t;
+
+   detail::ResourceCacheEntry* find_(const key_t& key);
+   detail::ResourceCacheEntry& insert_(const key_t& key);
+   void addRef_(detail::ResourceCacheEntry& entry);
+   void release_(detail::ResourceCacheEntry& entry);
+   void remove_(detail::ResourceCacheEntry& entry);
+   void evict_();
+
+   ResourceLoader& loader_;
+   ContentResolver* resolver_;
+   size_t cpu_budget_;
+   size_t gpu_budget_;
+   ResourceCacheStats stats_;
+
+   std::map<key_t, detail::ResourceCacheEntry> entries_;
+   std::list<detail::ResourceCacheEntry*> loading_;
+   std::list<detail::ResourceCacheEntry*> lru_;   ///< Unreferenced resident entries; most recently released first.
+
+   ResourceCache(const ResourceCache&);
+   void operator=(const ResourceCache&);
+};
+
+} // namespace pbj::sw
+} // namespace pbj
+
+#include "pbj/sw/resource_cache.inl"
+
+#endif
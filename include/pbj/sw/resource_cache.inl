@@ -0,0 +1,240 @@
+// Copyright (c) 2013 PBJ^2 Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   pbj/sw/resource_cache.inl
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of pbj::sw::ResourceCache and
+///         pbj::sw::CachedResource template functions.
+
+#if !defined(PBJ_SW_RESOURCE_CACHE_H_) && !defined(DOXYGEN)
+#include "pbj/sw/resource_cache.h"
+#elif !defined(PBJ_SW_RESOURCE_CACHE_INL_)
+#define PBJ_SW_RESOURCE_CACHE_INL_
+
+namespace pbj {
+namespace sw {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a CachedResource which doesn't refer to anything.
+template <class T>
+inline CachedResource<T>::CachedResource()
+   : cache_(nullptr),
+     entry_(nullptr)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs another reference to the same resource.
+template <class T>
+inline CachedResource<T>::CachedResource(const CachedResource<T>& other)
+   : cache_(other.cache_),
+     entry_(other.entry_),
+     handle_(other.handle_),
+     ready_(other.ready_)
+{
+   if (entry_)
+      cache_->addRef_(*entry_);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Releases the current resource (if any) and refers to the same
+///         resource as another CachedResource.
+template <class T>
+inline CachedResource<T>& CachedResource<T>::operator=(const CachedResource<T>& other)
+{
+   if (other.entry_)
+      other.cache_->addRef_(*other.entry_);
+
+   release();
+
+   cache_ = other.cache_;
+   entry_ = other.entry_;
+   handle_ = other.handle_;
+   ready_ = other.ready_;
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Releases the resource.
+template <class T>
+inline CachedResource<T>::~CachedResource()
+{
+   release();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns a handle to the resource, which resolves to \c nullptr
+///         until the resource has been loaded.
+template <class T>
+inline const be::ConstHandle<T>& CachedResource<T>::getHandle() const
+{
+   return handle_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns a future which becomes ready once the resource has been
+///         loaded, and rethrows any exception thrown while loading it.
+template <class T>
+inline const std::shared_future<void>& CachedResource<T>::getReady() const
+{
+   return ready_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the resource, or \c nullptr if it hasn't been loaded.
+template <class T>
+inline const T* CachedResource<T>::get() const
+{
+   return handle_.get();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Accesses the resource.  It must have been loaded.
+template <class T>
+inline const T* CachedResource<T>::operator->() const
+{
+   return handle_.get();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Accesses the resource.  It must have been loaded.
+template <class T>
+inline const T& CachedResource<T>::operator*() const
+{
+   return *handle_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Releases this reference to the resource early.
+/// \details Afterwards, this CachedResource doesn't refer to anything.
+template <class T>
+inline void CachedResource<T>::release()
+{
+   if (entry_)
+   {
+      ResourceCache* cache = cache_;
+      detail::ResourceCacheEntry* entry = entry_;
+
+      cache_ = nullptr;
+      entry_ = nullptr;
+      handle_ = be::ConstHandle<T>();
+      ready_ = std::shared_future<void>();
+
+      cache->release_(*entry);
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a new reference to a cache entry.
+template <class T>
+inline CachedResource<T>::CachedResource(ResourceCache& cache, detail::ResourceCacheEntry& entry, const be::ConstHandle<T>& handle, const std::shared_future<void>& ready)
+   : cache_(&cache),
+     entry_(&entry),
+     handle_(handle),
+     ready_(ready)
+{
+   cache_->addRef_(*entry_);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves a resource from the cache, loading it if necessary.
+///
+/// \details The policy is the same as for ResourceLoader::load(), except that
+///         it must also be able to measure the resources it loads, and
+///         identify the type of content they are made from:
+///
+/// \code
+///         // Called on the owning thread, once the resource is finalized.
+///         void measure(const resource_type& resource, size_t& cpu_bytes, size_t& gpu_bytes) const;
+///
+///         // The type Id passed to storeContentHash() for these resources.
+///         Id getContentType() const;
+/// \endcode
+///
+///         If the resource is already cached or loading with the same
+///         variant, this is a cache hit, the existing resource is returned,
+///         and the policy is ignored
+///         (though the load's priority may be raised).  Otherwise it's a miss
+///         and the resource starts loading.
+///
+///         If the cache has a ContentResolver, the resource is loaded under
+///         its canonical ResourceId, so holding resources with identical
+///         data under different ResourceIds is a hit once the data is cached,
+///         as long as the policies' variants are equal too.  Resources held
+///         with different variants are never shared this way.
+///
+/// \param  id The ResourceId of the resource.
+/// \param  priority The priority with which to load the resource.
+/// \param  policy Defines how the resource is loaded and measured.
+/// \return A reference to the resource, which keeps it from being evicted.
+template <class P>
+inline CachedResource<typename P::resource_type> ResourceCache::hold(const ResourceId& id, int priority, const P& policy)
+{
+   typedef typename P::resource_type T;
+
+   Id variant(policy.getVariant());
+   ResourceId source(id);
+   if (resolver_)
+   {
+      source = resolver_->resolve(id, policy.getContentType(), variant);
+      if (source != id)
+         ++stats_.deduplicated;
+   }
+
+   key_t key(detail::getResourceTypeTag<T>(), source, variant);
+
+   ResourceRequest<T> request(loader_.load(source, priority, policy));
+
+   detail::ResourceCacheEntry* entry = find_(key);
+   if (entry)
+   {
+      ++stats_.hits;
+   }
+   else
+   {
+      ++stats_.misses;
+
+      entry = &insert_(key);
+      entry->ready = request.ready;
+
+      be::ConstHandle<T> handle(request.handle);
+      entry->measure = [=](size_t& cpu_bytes, size_t& gpu_bytes)
+      {
+         const T* resource = handle.get();
+         if (resource)
+            policy.measure(*resource, cpu_bytes, gpu_bytes);
+      };
+
+      ResourceLoader* loader = &loader_;
+      entry->unload = [=]()
+      {
+         loader->unload<T>(source, variant);
+      };
+   }
+
+   return CachedResource<T>(*this, *entry, request.handle, request.ready);
+}
+
+} // namespace pbj::sw
+} // namespace pbj
+
+#endif
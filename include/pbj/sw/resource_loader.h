@@ -0,0 +1,231 @@
+// Copyright (c) 2013 PBJ^2 Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   pbj/sw/resource_loader.h
+/// \author Benjamin Crist
+///
+/// \brief  pbj::sw::ResourceLoader class header.
+
+#ifndef PBJ_SW_RESOURCE_LOADER_H_
+#define PBJ_SW_RESOURCE_LOADER_H_
+
+#include "pbj/sw/resource_id.h"
+#include "pbj/sw/sandwich.h"
+#include "be/bed/connection_pool.h"
+#include "be/source_handle.h"
+#include "pbj/_pbj.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  The number of threads a default-constructed ResourceLoader uses to
+///         read resources from sandwiches.
+#define PBJ_SW_RESOURCE_LOADER_DEFAULT_IO_THREADS 2
+
+namespace pbj {
+namespace sw {
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  The state of a single ResourceLoader request, independent of the
+///         type of resource being loaded.
+class ResourceJob
+{
+public:
+   ResourceJob(const ResourceId& id, int priority);
+   virtual ~ResourceJob();
+
+   virtual void read(Sandwich& sandwich) = 0;
+   virtual void decode() = 0;
+   virtual void finalize() = 0;
+
+   ResourceId id;
+   int priority;              ///< Jobs with higher priority are processed first.
+   uint64_t sequence;         ///< Orders jobs with equal priority by submission.
+   bool cancelled;            ///< The request was unloaded before it finished.
+   bool finished;             ///< The request has been finalized (or failed).
+   std::exception_ptr error;  ///< The exception thrown by read() or decode(), if any.  Only written by the thread processing the job.
+
+   std::promise<void> promise;
+   std::shared_future<void> future;
+
+private:
+   ResourceJob(const ResourceJob&);
+   void operator=(const ResourceJob&);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Holds the resource produced by a ResourceJob and the SourceHandle
+///         which refers to it.
+template <class T>
+class TypedResourceJob : public ResourceJob
+{
+public:
+   TypedResourceJob(const ResourceId& id, int priority);
+
+   std::unique_ptr<T> resource;
+   be::SourceHandle<T> handle;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Runs the stages of a load policy (see ResourceLoader::load()).
+template <class P>
+class PolicyResourceJob : public TypedResourceJob<typename P::resource_type>
+{
+public:
+   PolicyResourceJob(const ResourceId& id, int priority, const P& policy);
+
+   virtual void read(Sandwich& sandwich);
+   virtual void decode();
+   virtual void finalize();
+
+private:
+   P policy_;
+   std::unique_ptr<typename P::data_type> data_;
+};
+
+template <class T>
+const void* getResourceTypeTag();
+
+/// Identifies a resource by its type tag, ResourceId and the variant of the
+/// policy it was loaded with.
+typedef std::tuple<const void*, ResourceId, Id> ResourceKey;
+
+} // namespace pbj::sw::detail
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returned by ResourceLoader::load() to track a request.
+///
+/// \details The handle resolves to \c nullptr until the resource has been
+///         finalized, and becomes invalid again if the resource fails to
+///         load or is unloaded.  Note that it is not the same handle as the
+///         one returned by the resource's own getHandle() function.
+template <class T>
+struct ResourceRequest
+{
+   be::Handle<T> handle;            ///< Refers to the resource once it has been finalized.
+   std::shared_future<void> ready;  ///< Ready once the resource has been finalized; rethrows any exception thrown while loading it.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \class  ResourceLoader   pbj/sw/resource_loader.h "pbj/sw/resource_loader.h"
+///
+/// \brief  Loads resources from sandwiches in the background.
+/// \details Each resource is loaded in three stages, which are provided by a
+///         load policy (see load()).  Blobs are read from the resource's
+///         sandwich on one of a few I/O threads (each using a connection
+///         from the sandwich's ConnectionPool), decoded on one of several CPU
+///         threads, and finally turned into a resource by the thread which
+///         owns the loader.  That thread is usually the one with the current
+///         OpenGL and OpenAL contexts, so finalization may create GL or AL
+///         objects.  Within each stage, requests with higher priority go
+///         first, and requests with the same priority are handled in the
+///         order they were made.
+///
+///         The owning thread calls update() once per frame, which finalizes
+///         as many resources as it can in the time allowed, so a level can
+///         continue to be drawn while its resources load.  Loading screens
+///         can call flush() to finish every outstanding request instead.
+///
+///         Resources are owned by the loader until they are unloaded or the
+///         loader is destroyed.  Requesting a resource which has already been
+///         requested returns the same handle.
+///
+///         All member functions must be called from the thread which
+///         constructed the loader, and the loader must be destroyed there too,
+///         since destroying resources may release GL or AL objects.
+///         ResourceRequest::ready should not be waited on from that thread
+///         (nothing would finalize the resource); check it with
+///         \c wait_for(0) or call flush() instead.
+class ResourceLoader
+{
+public:
+   ResourceLoader();
+   ResourceLoader(size_t io_threads, size_t cpu_threads);
+   ~ResourceLoader();
+
+   template <class P>
+   ResourceRequest<typename P::resource_type> load(const ResourceId& id, int priority, const P& policy);
+
+   template <class T>
+   bool unload(const ResourceId& id, const Id& variant);
+
+   size_t update(const std::chrono::duration<double>& budget);
+   void flush();
+
+   size_t getPendingCount() const;
+
+private:
+   typedef detail::ResourceKey key_t;
+   typedef std::shared_ptr<detail::ResourceJob> job_ptr;
+
+   void start_(size_t io_threads, size_t cpu_threads);
+   job_ptr find_(const key_t& key, int priority);
+   void submit_(const key_t& key, const job_ptr& job);
+   bool unload_(const key_t& key);
+   void finalize_(detail::ResourceJob& job);
+   std::shared_ptr<db::ConnectionPool<Sandwich> > getPool_(const Id& sandwich);
+
+   void push_(std::vector<job_ptr>& queue, const job_ptr& job);
+   job_ptr pop_(std::vector<job_ptr>& queue);
+
+   void runIo_();
+   void runCpu_();
+
+   std::thread::id owner_;
+   std::map<key_t, job_ptr> jobs_;
+
+   mutable std::mutex mutex_; ///< Guards the queues, pools_, pending_count_, next_sequence_, stopping_, and the priority and cancelled fields of each job.
+   std::condition_variable io_ready_;
+   std::condition_variable cpu_ready_;
+   std::condition_variable finalize_ready_;
+   std::vector<job_ptr> io_queue_;        ///< Heaps ordered by priority, then sequence.
+   std::vector<job_ptr> cpu_queue_;
+   std::vector<job_ptr> finalize_queue_;
+   std::unordered_map<Id, std::shared_ptr<db::ConnectionPool<Sandwich> > > pools_; ///< Keeps each sandwich's connections open between reads.
+   size_t pending_count_;
+   uint64_t next_sequence_;
+   bool stopping_;
+
+   std::vector<std::thread> threads_;
+
+   ResourceLoader(const ResourceLoader&);
+   void operator=(const ResourceLoader&);
+};
+
+} // namespace pbj::sw
+} // namespace pbj
+
+#include "pbj/sw/resource_loader.inl"
+
+#endif
@@ -0,0 +1,177 @@
+// Copyright (c) 2013 PBJ^2 Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   pbj/sw/resource_loader.inl
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of pbj::sw::ResourceLoader template functions.
+
+#if !defined(PBJ_SW_RESOURCE_LOADER_H_) && !defined(DOXYGEN)
+#include "pbj/sw/resource_loader.h"
+#elif !defined(PBJ_SW_RESOURCE_LOADER_INL_)
+#define PBJ_SW_RESOURCE_LOADER_INL_
+
+namespace pbj {
+namespace sw {
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Creates a job whose handle won't resolve until it is finalized.
+template <class T>
+inline TypedResourceJob<T>::TypedResourceJob(const ResourceId& id, int priority)
+   : ResourceJob(id, priority)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Creates a job which loads a resource using a copy of the provided
+///         policy.
+template <class P>
+inline PolicyResourceJob<P>::PolicyResourceJob(const ResourceId& id, int priority, const P& policy)
+   : TypedResourceJob<typename P::resource_type>(id, priority),
+     policy_(policy),
+     data_(new typename P::data_type())
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads the resource's data from its sandwich.  Called on an I/O
+///         thread.
+template <class P>
+inline void PolicyResourceJob<P>::read(Sandwich& sandwich)
+{
+   policy_.read(sandwich, this->id, *data_);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Decodes the data read by read().  Called on a CPU thread.
+template <class P>
+inline void PolicyResourceJob<P>::decode()
+{
+   policy_.decode(this->id, *data_);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Creates the resource from the decoded data and associates the
+///         job's handle with it.  Called on the loader's owning thread.
+/// \details The intermediate data is released afterwards.
+template <class P>
+inline void PolicyResourceJob<P>::finalize()
+{
+   this->resource.reset(policy_.finalize(this->id, *data_));
+   this->handle.associate(this->resource.get());
+   data_.reset();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns a value which is unique to the type T, used to keep
+///         resources of different types with the same ResourceId apart.
+template <class T>
+inline const void* getResourceTypeTag()
+{
+   static const char tag = 0;
+   return &tag;
+}
+
+} // namespace pbj::sw::detail
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Requests that a resource be loaded in the background.
+///
+/// \details The policy describes how to load one type of resource.  It must
+///         be copyable, and is copied for each request.  It must provide:
+///
+/// \code
+///         typedef ... resource_type;  // The type of resource produced.
+///         typedef ... data_type;      // Default-constructible intermediate data.
+///
+///         // Called on an I/O thread.
+///         void read(Sandwich& sandwich, const ResourceId& id, data_type& data) const;
+///
+///         // Called on a CPU thread, after read().
+///         void decode(const ResourceId& id, data_type& data) const;
+///
+///         // Called on the loader's owning thread, after decode().  Returns
+///         // a new resource, which the loader takes ownership of.
+///         resource_type* finalize(const ResourceId& id, data_type& data) const;
+///
+///         // Identifies every setting which affects the loaded resource.
+///         Id getVariant() const;
+/// \endcode
+///
+///         Any of these functions may throw to indicate that the resource
+///         could not be loaded.  The exception is logged by update() and
+///         rethrown by ResourceRequest::ready.
+///
+///         If a resource of the same type with the same ResourceId has
+///         already been requested by a policy with the same variant, the
+///         policy is ignored, and the existing
+///         request is returned.  If it hasn't finished yet, its priority is
+///         raised to \c priority if that is higher.
+///
+/// \param  id The ResourceId of the resource to load.  Its sandwich must
+///         have been found by readDirectory().
+/// \param  priority Determines which requests are processed first.
+///         Higher priorities are processed before lower ones.
+/// \param  policy Defines how the resource is read, decoded and finalized.
+/// \return The handle and future for the request.
+template <class P>
+inline ResourceRequest<typename P::resource_type> ResourceLoader::load(const ResourceId& id, int priority, const P& policy)
+{
+   typedef typename P::resource_type T;
+   key_t key(detail::getResourceTypeTag<T>(), id, policy.getVariant());
+
+   job_ptr job = find_(key, priority);
+   if (!job)
+   {
+      job = std::make_shared<detail::PolicyResourceJob<P> >(id, priority, policy);
+      submit_(key, job);
+   }
+
+   detail::TypedResourceJob<T>& typed_job = static_cast<detail::TypedResourceJob<T>&>(*job);
+
+   ResourceRequest<T> request;
+   request.handle = typed_job.handle;
+   request.ready = job->future;
+   return request;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Destroys a resource, or cancels it if it hasn't been loaded yet.
+///
+/// \details Handles to the resource will no longer resolve, and if it has not
+///         yet been finalized, its ResourceRequest::ready future will rethrow
+///         \c std::future_error (broken promise).
+///
+/// \tparam T The type of resource to unload.
+/// \param  id The ResourceId of the resource to unload.
+/// \param  variant The variant of the policy the resource was requested with.
+/// \return \c true if the resource had been requested.
+template <class T>
+inline bool ResourceLoader::unload(const ResourceId& id, const Id& variant)
+{
+   return unload_(key_t(detail::getResourceTypeTag<T>(), id, variant));
+}
+
+} // namespace pbj::sw
+} // namespace pbj
+
+#endif
@@ -27,6 +27,7 @@
 #ifndef PBJ_SW_SANDWICH_H_
 #define PBJ_SW_SANDWICH_H_
 
+#include "be/bed/bed.h"
 #include "be/bed/db.h"
 #include "be/bed/stmt.h"
 #include "be/bed/stmt_cache.h"
@@ -36,6 +37,14 @@
 
 #include <memory>
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  The schema version of sandwiches this build can read, packed as
+///         stored in the 'schema_version' sandwich property.
+/// \details Sandwiches share their schema versioning with be::bed::Bed.  A
+///         sandwich is compatible if its major version matches and its minor
+///         version is not newer.
+#define PBJ_SW_SCHEMA_VERSION ((BE_BED_SCHEMA_VERSION_MAJOR << 16) | BE_BED_SCHEMA_VERSION_MINOR)
+
 namespace pbj {
 namespace sw {
 
@@ -48,6 +57,7 @@ class Sandwich : public std::enable_shared_from_this<Sandwich>
 {
 public:
    Sandwich(const std::string& path, bool read_only);
+   Sandwich(const std::string& path, bool read_only, const db::DbConfig& config);
 
    const Id& getId() const;
 
@@ -55,6 +65,8 @@ public:
    db::StmtCache& getStmtCache();
 
 private:
+   void readId_();
+
    Id id_;
    db::Db db_;
    db::StmtCache stmt_cache_;
@@ -0,0 +1,107 @@
+// Copyright (c) 2013 PBJ^2 Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   pbj/sw/sandwich_manifest.h
+/// \author Benjamin Crist
+///
+/// \brief  pbj::sw::SandwichManifest class header.
+
+#ifndef PBJ_SW_SANDWICH_MANIFEST_H_
+#define PBJ_SW_SANDWICH_MANIFEST_H_
+
+#include "be/id.h"
+#include "pbj/_pbj.h"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  The name of the manifest file which readDirectory() keeps in each
+///         directory it scans.
+#define PBJ_SW_MANIFEST_FILENAME "sandwiches.manifest"
+
+namespace pbj {
+namespace sw {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  What a SandwichManifest remembers about a single sandwich.
+struct SandwichManifestEntry
+{
+   int64_t mtime;             ///< The file's modification time when it was last read.
+   int64_t size;              ///< The file's size in bytes when it was last read.
+   Id id;                     ///< The sandwich's Id.
+   uint32_t schema_version;   ///< The packed schema version, or 0 if the sandwich doesn't have one.
+   std::string tables;        ///< The names of the sandwich's tables, each followed by '\n'.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \class  SandwichManifest   pbj/sw/sandwich_manifest.h "pbj/sw/sandwich_manifest.h"
+///
+/// \brief  Persistent cache of the Id and table of contents of each sandwich
+///         in a directory.
+/// \details Reading a sandwich's Id requires opening it as a database, which
+///         dominates startup time when there are many sandwiches.  The
+///         manifest remembers the modification time and size of each
+///         sandwich it has read, so that refresh() only opens files which
+///         have changed since the manifest was last saved.
+///
+///         refresh() may be called from several threads at once, so that
+///         changed sandwiches can be opened concurrently.
+///
+///         The manifest is itself a small SQLite database.  If it can't be
+///         read or written, every sandwich is simply opened as before.
+class SandwichManifest
+{
+public:
+   explicit SandwichManifest(const std::string& path);
+
+   SandwichManifestEntry refresh(const std::string& sandwich_path);
+   void save();
+
+   size_t getOpenedCount() const;
+
+private:
+   struct Record
+   {
+      SandwichManifestEntry entry;
+      bool seen;     ///< refresh() has been called for this path.
+      bool changed;  ///< The entry must be written by save().
+   };
+
+   void load_();
+
+   std::string path_;
+   bool outdated_;   ///< The manifest file has a different PBJ_SW_MANIFEST_VERSION.
+
+   mutable std::mutex mutex_; ///< Guards records_ and opened_.
+   std::unordered_map<std::string, Record> records_;
+   size_t opened_;
+
+   SandwichManifest(const SandwichManifest&);
+   void operator=(const SandwichManifest&);
+};
+
+} // namespace pbj::sw
+} // namespace pbj
+
+#endif
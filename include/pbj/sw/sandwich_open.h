@@ -28,16 +28,28 @@
 #define PBJ_SW_SANDWICH_OPEN_H_
 
 #include "pbj/sw/sandwich.h"
+#include "be/bed/connection_pool.h"
+#include "be/bed/write_queue.h"
 
 #include <unordered_map>
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  The maximum number of threads readDirectory() will use to open
+///         sandwiches which have changed since they were last scanned.
+#define PBJ_SW_READ_DIRECTORY_MAX_THREADS 16
+
 namespace pbj {
 namespace sw {
 
 void readDirectory(const std::string& path);
+void readDirectory(const std::string& path, const std::string& manifest_path);
+bool hasTable(const Id& id, const std::string& table);
 
 std::shared_ptr<Sandwich> open(const Id& id);
 std::shared_ptr<Sandwich> openWritable(const Id& id);
+std::shared_ptr<db::ConnectionPool<Sandwich> > openPool(const Id& id);
+std::shared_ptr<db::WriteQueue<Sandwich> > openWriteQueue(const Id& id);
+void closeWriteQueues();
 
 } // namespace pbj::sw
 } // namespace pbj
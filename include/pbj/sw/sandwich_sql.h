@@ -0,0 +1,142 @@
+// Copyright (c) 2013 PBJ^2 Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   pbj/sw/sandwich_sql.h
+/// \author Benjamin Crist
+///
+/// \brief  SQL statements used by pbj::sw::Sandwich,
+///         pbj::sw::SandwichManifest, and pbj::sw::ContentResolver.
+///
+/// \details Ids for these statements are precalculated in pbj/sql_ids.h;
+///         run tools/generate.cmd after changing any of them.
+
+#ifndef PBJ_SW_SANDWICH_SQL_H_
+#define PBJ_SW_SANDWICH_SQL_H_
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  SQL statement to get the Id of a DbFile.
+/// \details The Id is stored in the 'id' property of the
+///         'pbj_sandwich_properties' table.
+#define PBJ_SW_SANDWICH_SQL_GET_ID "SELECT value FROM pbj_sandwich_properties WHERE property = 'id' LIMIT 1"
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  SQL statement to get the schema version of a sandwich.
+/// \details The version is stored in the 'schema_version' property of the
+///         'pbj_sandwich_properties' table, packed as
+///         <tt>(major << 16) | minor</tt>.  Sandwiches without the property
+///         predate schema versioning.
+#define PBJ_SW_SANDWICH_SQL_GET_SCHEMA_VERSION "SELECT value FROM pbj_sandwich_properties WHERE property = 'schema_version' LIMIT 1"
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  SQL statement to list the tables in a sandwich.
+/// \details Used to build the table of contents stored in a
+///         SandwichManifest.
+#define PBJ_SW_SANDWICH_SQL_TABLES \
+      "SELECT name FROM sqlite_master " \
+      "WHERE type = 'table' ORDER BY name"
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  The format of the pbj_sandwich_manifest table.
+/// \details Stored in the manifest's <tt>PRAGMA user_version</tt>.  Manifests
+///         with a different version are discarded and rebuilt.  Must match
+///         #PBJ_SW_MANIFEST_SQL_SET_VERSION.
+#define PBJ_SW_MANIFEST_VERSION 1
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  SQL statement to get the format version of a SandwichManifest.
+#define PBJ_SW_MANIFEST_SQL_GET_VERSION "PRAGMA user_version"
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  SQL statement to set the format version of a SandwichManifest to
+///         #PBJ_SW_MANIFEST_VERSION.
+#define PBJ_SW_MANIFEST_SQL_SET_VERSION "PRAGMA user_version = 1"
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  SQL statement to discard a SandwichManifest table with an
+///         outdated format.
+#define PBJ_SW_MANIFEST_SQL_DROP_TABLE "DROP TABLE IF EXISTS pbj_sandwich_manifest"
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  SQL statement to create the table which stores a
+///         SandwichManifest.
+#define PBJ_SW_MANIFEST_SQL_CREATE_TABLE \
+      "CREATE TABLE IF NOT EXISTS pbj_sandwich_manifest (" \
+      "path TEXT PRIMARY KEY, " \
+      "mtime INTEGER NOT NULL, " \
+      "size INTEGER NOT NULL, " \
+      "id INTEGER NOT NULL, " \
+      "schema_version INTEGER NOT NULL, " \
+      "tables TEXT NOT NULL )"
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  SQL statement to load every entry in a SandwichManifest.
+#define PBJ_SW_MANIFEST_SQL_LOAD \
+      "SELECT path, mtime, size, id, schema_version, tables " \
+      "FROM pbj_sandwich_manifest"
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  SQL statement to add or replace a SandwichManifest entry.
+/// \param  1 The path of the sandwich.
+/// \param  2 The sandwich file's modification time.
+/// \param  3 The sandwich file's size in bytes.
+/// \param  4 The sandwich's Id.
+/// \param  5 The sandwich's packed schema version.
+/// \param  6 The sandwich's table of contents.
+#define PBJ_SW_MANIFEST_SQL_SAVE \
+      "INSERT OR REPLACE INTO pbj_sandwich_manifest " \
+      "(path, mtime, size, id, schema_version, tables) VALUES (?, ?, ?, ?, ?, ?)"
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  SQL statement to remove a SandwichManifest entry.
+/// \param  1 The path of the sandwich which no longer exists.
+#define PBJ_SW_MANIFEST_SQL_REMOVE \
+      "DELETE FROM pbj_sandwich_manifest WHERE path = ?"
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  SQL statement to create the table which stores the content hash
+///         of each resource in a sandwich.
+/// \details Written by storeContentHash() when resources are imported, and
+///         read by ContentResolver.  Resources of different types may share
+///         a resource Id, so each hash is keyed by the type's Id as well.
+#define PBJ_SW_CONTENT_SQL_CREATE_TABLE \
+      "CREATE TABLE IF NOT EXISTS pbj_sandwich_content (" \
+      "type INTEGER NOT NULL, " \
+      "id INTEGER NOT NULL, " \
+      "hash INTEGER NOT NULL, " \
+      "size INTEGER NOT NULL, " \
+      "PRIMARY KEY (type, id) )"
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  SQL statement to load every content hash in a sandwich.
+#define PBJ_SW_CONTENT_SQL_LOAD \
+      "SELECT type, id, hash, size FROM pbj_sandwich_content"
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  SQL statement to add or replace a resource's content hash.
+/// \param  1 The Id of the resource's type.
+/// \param  2 The Id of the resource.
+/// \param  3 The ContentHash::hash of the resource's stored data.
+/// \param  4 The size of the resource's stored data in bytes.
+#define PBJ_SW_CONTENT_SQL_SAVE \
+      "INSERT OR REPLACE INTO pbj_sandwich_content " \
+      "(type, id, hash, size) VALUES (?, ?, ?, ?)"
+
+#endif
@@ -31,6 +31,8 @@
 #include "pbj/_math.h"
 #include "pbj/_pbj.h"
 
+#include <future>
+
 namespace pbj {
 namespace sw {
 
@@ -168,10 +170,10 @@ struct WindowSettings
 
 WindowSettings loadWindowSettings(sw::Sandwich& sandwich, const Id& id);
 
-bool saveWindowSettings(const WindowSettings& window_settings);
-bool updateSavedPosition(const WindowSettings& window_settings);
+std::future<void> saveWindowSettings(const WindowSettings& window_settings);
+std::future<void> updateSavedPosition(const WindowSettings& window_settings);
 WindowSettings revertWindowSettings(const sw::ResourceId& id);
-void truncateWindowSettingsHistory(const sw::ResourceId& id, int max_history_entries);
+std::future<void> truncateWindowSettingsHistory(const sw::ResourceId& id, int max_history_entries);
 
 } // namespace pbj
 
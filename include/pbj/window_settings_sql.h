@@ -0,0 +1,189 @@
+// Copyright (c) 2013 PBJ^2 Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   pbj/window_settings_sql.h
+/// \author Benjamin Crist
+///
+/// \brief  SQL statements used to load and save pbj::WindowSettings.
+///
+/// \details Ids for these statements are precalculated in pbj/sql_ids.h;
+///         run tools/generate.cmd after changing any of them.
+
+#ifndef PBJ_WINDOW_SETTINGS_SQL_H_
+#define PBJ_WINDOW_SETTINGS_SQL_H_
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  SQL statement to load a set of window settings from a sandwich.
+/// \param  1 The id of the winow settings stack to load.
+#define PBJ_WINDOW_SETTINGS_SQL_LOAD \
+      "SELECT window_mode, " \
+      "system_positioned, save_pos_on_close, position_x, position_y, " \
+      "size_x, size_y, monitor_index, refresh_rate, v_sync, " \
+      "msaa_level, red_bits, green_bits, blue_bits, alpha_bits, " \
+      "depth_bits, stencil_bits, " \
+      "srgb_capable, use_custom_gamma, custom_gamma " \
+      "FROM pbj_window_settings WHERE id = ? " \
+      "ORDER BY history_index DESC LIMIT 1"
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  SQL statement to check if the pbj_window_settings table exists
+///         in a sandwich.
+#define PBJ_WINDOW_SETTINGS_SQL_TABLE_EXISTS \
+      "SELECT count(*) FROM sqlite_master " \
+      "WHERE type='table' AND name='pbj_window_settings'"
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  SQL statement to get the active (highest) history_index for the
+///         requested window settings.
+/// \param  1 The id of the window settings stack to look at.
+#define PBJ_WINDOW_SETTINGS_SQL_LATEST_INDEX \
+      "SELECT max(history_index) " \
+      "FROM pbj_window_settings WHERE id = ?"
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  SQL statement to create the pbj_window_settings table.
+#define PBJ_WINDOW_SETTINGS_SQL_CREATE_TABLE \
+      "CREATE TABLE IF NOT EXISTS pbj_window_settings (" \
+      "id INTEGER NOT NULL, " \
+      "history_index INTEGER NOT NULL, " \
+      "window_mode INTEGER NOT NULL, " \
+      "system_positioned INTEGER NOT NULL, " \
+      "save_pos_on_close INTEGER NOT NULL, " \
+      "position_x INTEGER NOT NULL, " \
+      "position_y INTEGER NOT NULL, " \
+      "size_x INTEGER NOT NULL, " \
+      "size_y INTEGER NOT NULL, " \
+      "monitor_index INTEGER NOT NULL, " \
+      "refresh_rate INTEGER NOT NULL, " \
+      "v_sync INTEGER NOT NULL, " \
+      "msaa_level INTEGER NOT NULL, " \
+      "red_bits INTEGER NOT NULL, " \
+      "green_bits INTEGER NOT NULL, " \
+      "blue_bits INTEGER NOT NULL, " \
+      "alpha_bits INTEGER NOT NULL, " \
+      "depth_bits INTEGER NOT NULL, " \
+      "stencil_bits INTEGER NOT NULL, " \
+      "srgb_capable INTEGER NOT NULL, " \
+      "use_custom_gamma INTEGER NOT NULL, " \
+      "custom_gamma REAL NOT NULL " \
+      "PRIMARY KEY (id, history_index) )"
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  SQL statement to save a set of window settings using a specific id
+///         and history index.
+///
+/// \details The history_index should be incremented from te result of
+///         #PBJ_WINDOW_SETTINGS_SQL_LATEST_INDEX so that the settings can
+///         be reverted if desired.
+/// \param  1 The id of the window_settings stack to save to.
+/// \param  2 The history_index of the entry to save to.
+/// \param  3 The value of be::wnd::WindowSettings::mode.
+/// \param  4 The value of be::wnd::WindowSettings::system_positioned.
+/// \param  5 The value of be::wnd::WindowSettings::save_position_on_close.
+/// \param  6 The value of be::wnd::WindowSettings::position.x.
+/// \param  7 The value of be::wnd::WindowSettings::position.y.
+/// \param  8 The value of be::wnd::WindowSettings::size.x.
+/// \param  9 The value of be::wnd::WindowSettings::size.y.
+/// \param  10 The value of be::wnd::WindowSettings::monitor_index.
+/// \param  11 The value of be::wnd::WindowSettings::refresh_rate.
+/// \param  12 The value of be::wnd::WindowSettings::v_sync.
+/// \param  13 The value of be::wnd::WindowSettings::msaa_level.
+/// \param  14 The value of be::wnd::WindowSettings::red_bits.
+/// \param  15 The value of be::wnd::WindowSettings::green_bits.
+/// \param  16 The value of be::wnd::WindowSettings::blue_bits.
+/// \param  17 The value of be::wnd::WindowSettings::alpha_bits.
+/// \param  18 The value of be::wnd::WindowSettings::depth_bits.
+/// \param  19 The value of be::wnd::WindowSettings::stencil_bits.
+/// \param  20 The value of be::wnd::WindowSettings::srgb_capable.
+/// \param  21 The value of be::wnd::WindowSettings::use_custom_gamma.
+/// \param  22 The value of be::wnd::WindowSettings::custom_gamma.
+#define PBJ_WINDOW_SETTINGS_SQL_SAVE \
+      "INSERT INTO pbj_window_settings (" \
+      "id, history_index, window_mode, " \
+      "system_positioned, save_pos_on_close, position_x, position_y, " \
+      "size_x, size_y, monitor_index, refresh_rate, v_sync, " \
+      "msaa_level, red_bits, green_bits, blue_bits, alpha_bits, " \
+      "depth_bits, stencil_bits, " \
+      "srgb_capable, use_custom_gamma, custom_gamma" \
+      ") VALUES (" \
+      "?,?,?," \
+      "?,?,?,?," \
+      "?,?,?,?,?," \
+      "?,?,?,?,?," \
+      "?,?," \
+      "?,?,?)"
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  SQL statement to update the position and size settings from a
+///         specific id and history_index.
+///
+/// \param  1 The new x position.
+/// \param  2 The new y position.
+/// \param  3 The new width.
+/// \param  4 The new height.
+/// \param  5 The id of the window settings stack to update.
+/// \param  6 The history_index to update.
+#define PBJ_WINDOW_SETTINGS_SQL_SAVE_POS \
+      "UPDATE pbj_window_settings " \
+      "SET position_x = ?, position_y = ?, " \
+      "size_x = ?, size_y = ? " \
+      "WHERE id = ? AND history_index = ?"
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  SQL statement to remove any history entries with the id provided 
+///         and an history_index less than the provided minimum.
+///
+/// \param  1 The id of the window settings stack to truncate.
+/// \param  2 The minimum history_index that will remain untouched.
+#define PBJ_WINDOW_SETTINGS_SQL_TRUNCATE \
+      "DELETE FROM pbj_window_settings " \
+      "WHERE id = ? AND history_index < ?"
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  SQL statement to remove a specific history_index from a window
+///         settings stack.
+///
+/// \details The history_index should almost always be retrieved using
+///         #PBJ_WINDOW_SETTINGS_SQL_LATEST_INDEX.
+///
+/// \param  1 The id of the window_settings stack to modify.
+/// \param  2 This history_index to delete.
+#define PBJ_WINDOW_SETTINGS_SQL_REVERT \
+      "DELETE FROM pbj_window_settings " \
+      "WHERE id = ? AND history_index = ?"
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  SQL statement to compress history_index values by subtracting a
+///         constant value from all history_index values in a window settings
+///         stack.
+///
+/// \details This should generally only be done after
+///         #PBJ_WINDOW_SETTINGS_SQL_TRUNCATE.
+///
+/// \param  1 The value of the history_index which should become zero after
+///         this statement.
+/// \param  2 The id of the window_settings stack to modify.
+#define PBJ_WINDOW_SETTINGS_SQL_COMPRESS \
+      "UPDATE pbj_window_settings " \
+      "SET history_index = history_index - ? " \
+      "WHERE id = ?"
+
+#endif
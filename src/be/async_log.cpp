@@ -0,0 +1,1083 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/async_log.cpp
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of be::AsyncLog and be::detail::LogRecord
+///         functions.
+
+#include "be/async_log.h"
+#include "be/detail/log_format.h"
+#include "be/id.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+namespace be {
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  A stream buffer which appends everything written to it to a
+///         string.
+/// \details Unlike \c std::stringbuf, the string can be swapped out without
+///         copying, so the same buffers are reused for every message.
+class LogStreamBuf : public std::streambuf
+{
+public:
+   std::string text;
+
+protected:
+   virtual int_type overflow(int_type c)
+   {
+      if (!traits_type::eq_int_type(c, traits_type::eof()))
+         text.push_back(traits_type::to_char_type(c));
+
+      return traits_type::not_eof(c);
+   }
+
+   virtual std::streamsize xsputn(const char* s, std::streamsize n)
+   {
+      text.append(s, static_cast<size_t>(n));
+      return n;
+   }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  The stream that a LogRecord's text is inserted into.
+class LogFormatter
+{
+public:
+   LogFormatter()
+      : stream(&buf),
+        in_use(false)
+   {
+   }
+
+   LogStreamBuf buf;
+   std::ostream stream;
+   bool in_use;   ///< Set while a LogRecord is using this formatter, so that messages logged while formatting another message get their own.
+};
+
+} // namespace be::detail
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  The number of messages each thread can have waiting to be written.
+const uint32_t log_buffer_capacity = 256;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  How often the writer thread checks for new messages.
+const int log_write_interval_ms = 10;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  A message waiting to be written.
+struct LogEntry
+{
+   int level;
+   const char* file;
+   int line;
+   std::chrono::system_clock::time_point time;
+   std::string text;
+   bool binary;   ///< If true, text holds typed values (see be/detail/log_format.h) rather than formatted text.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Holds the messages logged by a single thread.
+/// \details The owning thread is the only producer and the thread which holds
+///         the drain mutex is the only consumer, so the ring buffer needs no
+///         locking.
+///
+///         When a thread exits, its LogBuffer is released rather than freed,
+///         since the writer thread walks the list of buffers without
+///         locking, and the buffer may still hold messages which haven't
+///         been written.  Once the writer has emptied it, the next thread
+///         to log a message reuses it, so the number of LogBuffers stays
+///         close to the number of threads which log at the same time.
+struct LogBuffer
+{
+   LogBuffer()
+      : head(0),
+        tail(0),
+        dropped(0),
+        owned(true),
+        next(nullptr)
+   {
+   }
+
+   detail::LogFormatter formatter;
+   LogEntry entries[log_buffer_capacity];
+   std::atomic<uint32_t> head;      ///< The number of entries that have been removed.  Written only by the consumer.
+   std::atomic<uint32_t> tail;      ///< The number of entries that have been added.  Written only by the owning thread.
+   std::atomic<uint32_t> dropped;   ///< The number of messages dropped because the buffer was full.
+   std::atomic<bool> owned;         ///< false once the owning thread has exited, until another thread claims the buffer.
+   LogBuffer* next;                 ///< The next buffer in the list of all buffers.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  The maximum number of C strings logged as values that will be
+///         added to the string table of a binary log.
+/// \details Once the table is full, C strings are written inline.  File
+///         names are always added to the table.
+const uint32_t max_interned_strings = 4096;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  C strings logged as values which are longer than this are always
+///         written inline in a binary log.
+const size_t max_interned_string_length = 256;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  State used by drainLogBuffers() to write messages.
+/// \details Only accessed by the thread holding the drain mutex.
+struct LogWriter
+{
+   LogWriter()
+      : binary(false),
+        header_written(false)
+   {
+   }
+
+   bool binary;                                                ///< If true, messages are written in the binary format.
+   bool header_written;                                        ///< Whether the binary log header has been written yet.
+   std::unordered_map<const char*, uint32_t> files;            ///< String table indices of file names, by address.
+   std::unordered_map<std::string, uint32_t> strings;          ///< String table indices, by content.
+   std::string key;                                            ///< Scratch space for string table lookups.
+   std::string values;                                         ///< Scratch space for binary message values.
+   detail::LogTimeCache time_cache;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  State shared by every thread which logs messages.
+/// \details Constructed explicitly by getLogState() the first time it is
+///         needed rather than being a function-local static, since VC11
+///         does not initialize those in a thread-safe way, and messages may
+///         be logged during static initialization, before a namespace-scope
+///         object would be constructed.  It is never destroyed, so messages
+///         can also be logged during static destruction.
+struct LogState
+{
+   LogState();
+
+   std::mutex drain_mutex;                     ///< Only the thread holding this mutex may remove entries from LogBuffers.
+   std::condition_variable writer_condition;   ///< Used to wake the writer thread early.
+   std::mutex writer_mutex;                    ///< Used with writer_condition.
+   LogWriter writer;                           ///< The state used to write messages.  Only used while holding drain_mutex.
+
+   // entries removed from ring buffers are swapped into batch, and the batch's
+   // old (cleared) strings are swapped back, so string capacity is reused.
+   // Only used while holding drain_mutex.
+   std::vector<LogEntry> batch;
+   std::vector<LogEntry*> order;
+   std::string out;
+
+   bool has_thread_exit_key;   ///< false if the key couldn't be allocated, in which case LogBuffers are never released.
+#ifdef _WIN32
+   DWORD thread_exit_key;      ///< Fiber-local storage index whose callback releases a thread's LogBuffer.
+#else
+   pthread_key_t thread_exit_key;   ///< Thread-specific data key whose destructor releases a thread's LogBuffer.
+#endif
+};
+
+// These rely on zero-initialization so that they can be used during static
+// initialization.
+std::atomic<LogBuffer*> log_buffers;   ///< Head of a lock-free, append-only list of all LogBuffers.
+std::atomic<bool> async_log_running;   ///< true while an AsyncLog exists.
+std::atomic<bool> binary_log_values;   ///< true while an AsyncLog using the binary format exists.
+std::atomic<int> log_state_status;     ///< 0 before log_state is constructed, 1 while it is being constructed, 2 afterwards.
+std::aligned_storage<sizeof(LogState), std::alignment_of<LogState>::value>::type log_state;
+BE_THREAD_LOCAL LogBuffer* thread_log_buffer;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Called when a thread which has logged a message exits.
+/// \details Releases the thread's LogBuffer so that another thread can reuse
+///         it.  Any messages still in the buffer are written as usual.
+#ifdef _WIN32
+void WINAPI releaseThreadLogBuffer(void* ptr)
+#else
+void releaseThreadLogBuffer(void* ptr)
+#endif
+{
+   LogBuffer* buffer = static_cast<LogBuffer*>(ptr);
+   if (!buffer)
+      return;
+
+   if (thread_log_buffer == buffer)
+      thread_log_buffer = nullptr;
+
+   buffer->owned.store(false, std::memory_order_release);
+}
+
+LogState::LogState()
+   : has_thread_exit_key(false)
+{
+#ifdef _WIN32
+   thread_exit_key = FlsAlloc(releaseThreadLogBuffer);
+   has_thread_exit_key = thread_exit_key != FLS_OUT_OF_INDEXES;
+#else
+   has_thread_exit_key = pthread_key_create(&thread_exit_key, releaseThreadLogBuffer) == 0;
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the shared logging state, constructing it if this is
+///         the first call.
+LogState& getLogState()
+{
+   if (log_state_status.load(std::memory_order_acquire) != 2)
+   {
+      int expected = 0;
+      if (log_state_status.compare_exchange_strong(expected, 1, std::memory_order_acquire))
+      {
+         // The debug CRT's new macro (see be/_be.h) can't be used for
+         // placement new.
+#pragma push_macro("new")
+#undef new
+         new (&log_state) LogState();
+#pragma pop_macro("new")
+         log_state_status.store(2, std::memory_order_release);
+      }
+      else
+      {
+         // another thread is constructing it
+         while (log_state_status.load(std::memory_order_acquire) != 2)
+            std::this_thread::yield();
+      }
+   }
+
+   return *reinterpret_cast<LogState*>(&log_state);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the calling thread's LogBuffer, claiming or creating it
+///         if necessary.
+/// \details An empty buffer released by a thread which has exited is reused
+///         if there is one; otherwise a new buffer is added to the list.
+LogBuffer& getThreadLogBuffer()
+{
+   LogBuffer* buffer = thread_log_buffer;
+   if (!buffer)
+   {
+      LogState& state = getLogState();
+
+      // Only empty buffers are reused, so that messages the writer hasn't
+      // collected yet don't reduce this thread's capacity.  A released
+      // buffer's tail doesn't change, and its head only moves towards it.
+      for (LogBuffer* b = log_buffers.load(std::memory_order_acquire); b; b = b->next)
+      {
+         bool owned = false;
+         if (!b->owned.load(std::memory_order_acquire) &&
+             b->head.load(std::memory_order_acquire) == b->tail.load(std::memory_order_relaxed) &&
+             b->owned.compare_exchange_strong(owned, true, std::memory_order_acquire))
+         {
+            buffer = b;
+            break;
+         }
+      }
+
+      if (!buffer)
+      {
+         buffer = new LogBuffer();
+         LogBuffer* head = log_buffers.load(std::memory_order_relaxed);
+         do
+         {
+            buffer->next = head;
+         } while (!log_buffers.compare_exchange_weak(head, buffer, std::memory_order_release));
+      }
+
+      thread_log_buffer = buffer;
+
+      if (state.has_thread_exit_key)
+      {
+#ifdef _WIN32
+         FlsSetValue(state.thread_exit_key, buffer);
+#else
+         pthread_setspecific(state.thread_exit_key, buffer);
+#endif
+      }
+   }
+   return *buffer;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Formats a message in the #BE_LOG format.
+void appendTextEntry(LogWriter& writer, std::string& out, const LogEntry& entry)
+{
+   detail::appendLogPrefix(out, writer.time_cache, std::chrono::system_clock::to_time_t(entry.time),
+                           entry.file, strlen(entry.file), entry.line, entry.level);
+
+   if (entry.binary)
+      detail::renderLogValues(entry.text.data(), entry.text.size(), std::vector<std::string>(), out);
+   else
+      out.append(entry.text);
+
+   out.push_back('\n');
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Looks up a string in the binary log's string table, adding it
+///         if necessary.
+/// \details If the string is added, a string record is appended to \c out.
+/// \return The string's index in the string table.
+uint32_t internString(LogWriter& writer, std::string& out, const char* data, size_t length)
+{
+   writer.key.assign(data, length);
+   auto i(writer.strings.find(writer.key));
+   if (i != writer.strings.end())
+      return i->second;
+
+   uint32_t index = static_cast<uint32_t>(writer.strings.size());
+   writer.strings[writer.key] = index;
+
+   out.push_back(static_cast<char>(detail::LogRecordString));
+   detail::appendLogBytes(out, index);
+   detail::appendLogBytes(out, static_cast<uint32_t>(length));
+   out.append(data, length);
+
+   return index;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Converts the values of a message to the form they are written
+///         in a binary log.
+/// \details C strings are replaced with references to the string table
+///         when possible.  Any necessary string records are appended to
+///         \c out, and the converted values are stored in writer.values.
+void translateValues(LogWriter& writer, std::string& out, const std::string& text)
+{
+   const char* data = text.data();
+   const char* end = data + text.size();
+
+   while (data < end)
+   {
+      char type = *data;
+      size_t size;
+
+      switch (type)
+      {
+         case detail::LogValueChar:
+         case detail::LogValueBool:
+            size = 2;
+            break;
+
+         case detail::LogValueText:
+            size = 5 + detail::readLogBytes<uint32_t>(data + 1);
+            break;
+
+         case detail::LogValueCString:
+         {
+            uint32_t length = detail::readLogBytes<uint32_t>(data + 1);
+            size = 5 + length;
+
+            if (length <= max_interned_string_length &&
+                (writer.strings.size() < max_interned_strings ||
+                 writer.strings.count(writer.key.assign(data + 5, length)) > 0))
+            {
+               writer.values.push_back(static_cast<char>(detail::LogValueStringRef));
+               detail::appendLogBytes(writer.values, internString(writer, out, data + 5, length));
+               data += size;
+               continue;
+            }
+
+            writer.values.push_back(static_cast<char>(detail::LogValueText));
+            writer.values.append(data + 1, size - 1);
+            data += size;
+            continue;
+         }
+
+         default:
+            size = 9;
+            break;
+      }
+
+      writer.values.append(data, size);
+      data += size;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends a message to a binary log.
+/// \details Writes the log header first if it has not been written yet.
+void appendBinaryEntry(LogWriter& writer, std::string& out, const LogEntry& entry)
+{
+   if (!writer.header_written)
+   {
+      out.append("BELOG", 5);
+      out.push_back(detail::log_format_version);
+      out.append(2, '\0');
+      writer.header_written = true;
+   }
+
+   uint32_t file;
+   auto i(writer.files.find(entry.file));
+   if (i != writer.files.end())
+      file = i->second;
+   else
+   {
+      file = internString(writer, out, entry.file, strlen(entry.file));
+      writer.files[entry.file] = file;
+   }
+
+   writer.values.clear();
+   if (entry.binary)
+      translateValues(writer, out, entry.text);
+   else
+   {
+      writer.values.push_back(static_cast<char>(detail::LogValueText));
+      detail::appendLogBytes(writer.values, static_cast<uint32_t>(entry.text.size()));
+      writer.values.append(entry.text);
+   }
+
+   int64_t time = std::chrono::duration_cast<std::chrono::microseconds>(entry.time.time_since_epoch()).count();
+
+   out.push_back(static_cast<char>(detail::LogRecordMessage));
+   detail::appendLogBytes(out, time);
+   detail::appendLogBytes(out, static_cast<uint32_t>(entry.level));
+   detail::appendLogBytes(out, file);
+   detail::appendLogBytes(out, static_cast<uint32_t>(entry.line));
+   detail::appendLogBytes(out, static_cast<uint32_t>(writer.values.size()));
+   out.append(writer.values);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends a message in the format currently being written.
+void appendEntry(LogWriter& writer, std::string& out, const LogEntry& entry)
+{
+   if (writer.binary)
+      appendBinaryEntry(writer, out, entry);
+   else
+      appendTextEntry(writer, out, entry);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Orders LogEntries by the time they were logged.
+bool compareEntryTime(const LogEntry* a, const LogEntry* b)
+{
+   return a->time < b->time;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Removes all pending messages from every LogBuffer and writes them
+///         to #BE_LOG_STREAM.
+/// \details Messages are sorted by time (messages from the same thread stay
+///         in the order they were logged), written with a single call to
+///         \c write(), and flushed once.
+void drainLogBuffers()
+{
+   LogState& state = getLogState();
+   std::lock_guard<std::mutex> lock(state.drain_mutex);
+
+   std::vector<LogEntry>& batch = state.batch;
+   std::vector<LogEntry*>& order = state.order;
+   std::string& out = state.out;
+
+   size_t count = 0;
+   uint64_t dropped = 0;
+
+   for (LogBuffer* buffer = log_buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next)
+   {
+      uint32_t head = buffer->head.load(std::memory_order_relaxed);
+      uint32_t tail = buffer->tail.load(std::memory_order_acquire);
+
+      for (; head != tail; ++head)
+      {
+         if (count == batch.size())
+            batch.resize(count + log_buffer_capacity);
+
+         LogEntry& src = buffer->entries[head % log_buffer_capacity];
+         LogEntry& dest = batch[count++];
+         dest.level = src.level;
+         dest.file = src.file;
+         dest.line = src.line;
+         dest.time = src.time;
+         dest.binary = src.binary;
+         dest.text.clear();
+         dest.text.swap(src.text);
+      }
+
+      buffer->head.store(head, std::memory_order_release);
+      dropped += buffer->dropped.exchange(0, std::memory_order_relaxed);
+   }
+
+   if (count == 0 && dropped == 0)
+      return;
+
+   order.clear();
+   for (size_t i = 0; i < count; ++i)
+      order.push_back(&batch[i]);
+
+   std::stable_sort(order.begin(), order.end(), compareEntryTime);
+
+   LogWriter& writer = state.writer;
+   out.clear();
+   for (auto i(order.begin()), end(order.end()); i != end; ++i)
+      appendEntry(writer, out, **i);
+
+   if (dropped > 0)
+   {
+      std::ostringstream oss;
+      oss << dropped << " log message(s) were dropped because the log buffer was full.";
+
+      LogEntry entry;
+      entry.level = VWarning;
+      entry.file = __FILE__;
+      entry.line = __LINE__;
+      entry.time = std::chrono::system_clock::now();
+      entry.text = oss.str();
+      entry.binary = false;
+      appendEntry(writer, out, entry);
+   }
+
+   BE_LOG_STREAM.write(out.data(), out.size());
+   BE_LOG_STREAM.flush();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Adds a message to the calling thread's LogBuffer.
+/// \details If the buffer is full, the message is dropped unless it is an
+///         error, in which case this waits for the writer thread to make
+///         space.
+void submitLogEntry(int level, const char* file, int line, const std::chrono::system_clock::time_point& time, std::string& text, bool binary)
+{
+   LogBuffer& buffer = getThreadLogBuffer();
+   uint32_t tail = buffer.tail.load(std::memory_order_relaxed);
+
+   while (tail - buffer.head.load(std::memory_order_acquire) >= log_buffer_capacity)
+   {
+      if ((level & VError) != VError)
+      {
+         buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+         return;
+      }
+
+      if (async_log_running.load())
+      {
+         getLogState().writer_condition.notify_one();
+         std::this_thread::yield();
+      }
+      else
+         drainLogBuffers();
+   }
+
+   LogEntry& entry = buffer.entries[tail % log_buffer_capacity];
+   entry.level = level;
+   entry.file = file;
+   entry.line = line;
+   entry.time = time;
+   entry.binary = binary;
+   entry.text.clear();
+   entry.text.swap(text);
+   buffer.tail.store(tail + 1, std::memory_order_release);
+
+   if (!async_log_running.load())
+      drainLogBuffers();
+   else if ((level & VError) == VError)
+      getLogState().writer_condition.notify_one();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Entry point for the AsyncLog writer thread.
+void runLogWriter()
+{
+   LogState& state = getLogState();
+   std::unique_lock<std::mutex> lock(state.writer_mutex);
+   while (async_log_running.load())
+   {
+      state.writer_condition.wait_for(lock, std::chrono::milliseconds(log_write_interval_ms));
+
+      lock.unlock();
+      drainLogBuffers();
+      lock.lock();
+   }
+}
+
+} // namespace be::(anon)
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Writes all pending #BE_LOG messages to #BE_LOG_STREAM.
+/// \details When no AsyncLog exists, messages are written as soon as they
+///         are logged, so this does nothing.
+void flushLog()
+{
+   drainLogBuffers();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Starts the background writer thread.
+/// \details If the binary format is used, the binary log header is written
+///         before the first message, and the string table starts out empty,
+///         so #BE_LOG_STREAM should be redirected to a new file before the
+///         AsyncLog is created.
+/// \param  format The format to write messages in.
+/// \throws std::logic_error if another AsyncLog already exists.
+AsyncLog::AsyncLog(Format format)
+{
+   if (async_log_running.exchange(true))
+      throw std::logic_error("An AsyncLog already exists!");
+
+   if (format == Binary)
+   {
+      LogState& state = getLogState();
+      std::lock_guard<std::mutex> lock(state.drain_mutex);
+      LogWriter& writer = state.writer;
+      writer.binary = true;
+      writer.header_written = false;
+      writer.files.clear();
+      writer.strings.clear();
+   }
+   binary_log_values.store(format == Binary, std::memory_order_relaxed);
+
+   writer_ = std::thread(runLogWriter);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Stops the background writer thread after writing all pending
+///         messages.
+AsyncLog::~AsyncLog()
+{
+   LogState& state = getLogState();
+   {
+      std::lock_guard<std::mutex> lock(state.writer_mutex);
+      async_log_running.store(false);
+   }
+   state.writer_condition.notify_one();
+   writer_.join();
+
+   // messages submitted while the writer was stopping
+   drainLogBuffers();
+
+   binary_log_values.store(false, std::memory_order_relaxed);
+
+   std::lock_guard<std::mutex> lock(state.drain_mutex);
+   state.writer.binary = false;
+}
+
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Begins a new log message.
+/// \param  level The verbosity level of the message.
+/// \param  file The source file which logged the message.  Must be a string
+///         literal (ie. \c __FILE__) since it is not copied.
+/// \param  line The line number which logged the message.
+LogRecord::LogRecord(int level, const char* file, int line)
+   : level_(level),
+     file_(file),
+     line_(line),
+     binary_(binary_log_values.load(std::memory_order_relaxed))
+{
+   LogFormatter& formatter = getThreadLogBuffer().formatter;
+   if (formatter.in_use)
+      formatter_ = new LogFormatter();
+   else
+      formatter_ = &formatter;
+
+   formatter_->in_use = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Submits the message to be written.
+/// \details Any formatting flags set while logging the message are reset.
+LogRecord::~LogRecord()
+{
+   try
+   {
+      submitLogEntry(level_, file_, line_, std::chrono::system_clock::now(), formatter_->buf.text, binary_);
+   }
+   catch (...)
+   {
+      // logging must never throw out of a destructor
+   }
+
+   std::ostream& stream = formatter_->stream;
+   formatter_->buf.text.clear();
+   stream.clear();
+   stream.flags(std::ios_base::dec | std::ios_base::skipws);
+   stream.width(0);
+   stream.precision(6);
+   stream.fill(' ');
+
+   if (formatter_ == &getThreadLogBuffer().formatter)
+      formatter_->in_use = false;
+   else
+      delete formatter_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends a signed integer of any size.
+template <class T>
+LogRecord& LogRecord::writeSigned_(T value)
+{
+   if (binary_ && isPlain_())
+   {
+      formatter_->buf.text.push_back(static_cast<char>(LogValueSigned));
+      appendLogBytes(formatter_->buf.text, static_cast<int64_t>(value));
+   }
+   else
+      writeText_(value);
+
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends an unsigned integer of any size.
+template <class T>
+LogRecord& LogRecord::writeUnsigned_(T value)
+{
+   if (binary_ && isPlain_())
+   {
+      formatter_->buf.text.push_back(static_cast<char>(LogValueUnsigned));
+      appendLogBytes(formatter_->buf.text, static_cast<uint64_t>(value));
+   }
+   else
+      writeText_(value);
+
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends a character of any type.
+template <class T>
+LogRecord& LogRecord::writeChar_(T value)
+{
+   if (binary_ && isPlain_())
+   {
+      formatter_->buf.text.push_back(static_cast<char>(LogValueChar));
+      formatter_->buf.text.push_back(static_cast<char>(value));
+   }
+   else
+      writeText_(value);
+
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends a floating point number of any size.
+template <class T>
+LogRecord& LogRecord::writeFloat_(T value)
+{
+   if (binary_ && isPlain_())
+   {
+      formatter_->buf.text.push_back(static_cast<char>(LogValueFloat));
+      appendLogBytes(formatter_->buf.text, static_cast<double>(value));
+   }
+   else
+      writeText_(value);
+
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends a boolean value.
+/// \param  value The value to log.
+/// \return This LogRecord (for chaining).
+LogRecord& LogRecord::operator<<(bool value)
+{
+   if (binary_ && isPlain_())
+   {
+      formatter_->buf.text.push_back(static_cast<char>(LogValueBool));
+      formatter_->buf.text.push_back(value ? 1 : 0);
+   }
+   else
+      writeText_(value);
+
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends a character.
+/// \param  value The value to log.
+/// \return This LogRecord (for chaining).
+LogRecord& LogRecord::operator<<(char value)
+{
+   return writeChar_(value);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends a character.
+/// \param  value The value to log.
+/// \return This LogRecord (for chaining).
+LogRecord& LogRecord::operator<<(signed char value)
+{
+   return writeChar_(value);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends a character.
+/// \param  value The value to log.
+/// \return This LogRecord (for chaining).
+LogRecord& LogRecord::operator<<(unsigned char value)
+{
+   return writeChar_(value);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends an integer.
+/// \param  value The value to log.
+/// \return This LogRecord (for chaining).
+LogRecord& LogRecord::operator<<(short value)
+{
+   return writeSigned_(value);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends an integer.
+/// \param  value The value to log.
+/// \return This LogRecord (for chaining).
+LogRecord& LogRecord::operator<<(unsigned short value)
+{
+   return writeUnsigned_(value);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends an integer.
+/// \param  value The value to log.
+/// \return This LogRecord (for chaining).
+LogRecord& LogRecord::operator<<(int value)
+{
+   return writeSigned_(value);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends an integer.
+/// \param  value The value to log.
+/// \return This LogRecord (for chaining).
+LogRecord& LogRecord::operator<<(unsigned int value)
+{
+   return writeUnsigned_(value);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends an integer.
+/// \param  value The value to log.
+/// \return This LogRecord (for chaining).
+LogRecord& LogRecord::operator<<(long value)
+{
+   return writeSigned_(value);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends an integer.
+/// \param  value The value to log.
+/// \return This LogRecord (for chaining).
+LogRecord& LogRecord::operator<<(unsigned long value)
+{
+   return writeUnsigned_(value);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends an integer.
+/// \param  value The value to log.
+/// \return This LogRecord (for chaining).
+LogRecord& LogRecord::operator<<(long long value)
+{
+   return writeSigned_(value);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends an integer.
+/// \param  value The value to log.
+/// \return This LogRecord (for chaining).
+LogRecord& LogRecord::operator<<(unsigned long long value)
+{
+   return writeUnsigned_(value);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends a floating point number.
+/// \param  value The value to log.
+/// \return This LogRecord (for chaining).
+LogRecord& LogRecord::operator<<(float value)
+{
+   return writeFloat_(value);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends a floating point number.
+/// \param  value The value to log.
+/// \return This LogRecord (for chaining).
+LogRecord& LogRecord::operator<<(double value)
+{
+   return writeFloat_(value);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends a C string.
+/// \details In a binary log, short strings (eg. string literals) are only
+///         written once; subsequent uses refer to the log's string table.
+/// \param  value The value to log.
+/// \return This LogRecord (for chaining).
+LogRecord& LogRecord::operator<<(const char* value)
+{
+   if (binary_ && value && isPlain_())
+   {
+      std::string& text = formatter_->buf.text;
+      size_t length = strlen(value);
+      text.push_back(static_cast<char>(LogValueCString));
+      appendLogBytes(text, static_cast<uint32_t>(length));
+      text.append(value, length);
+   }
+   else
+      writeText_(value);
+
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends a string.
+/// \param  value The value to log.
+/// \return This LogRecord (for chaining).
+LogRecord& LogRecord::operator<<(const std::string& value)
+{
+   if (binary_ && isPlain_())
+   {
+      std::string& text = formatter_->buf.text;
+      text.push_back(static_cast<char>(LogValueText));
+      appendLogBytes(text, static_cast<uint32_t>(value.size()));
+      text.append(value);
+   }
+   else
+      writeText_(value);
+
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends an Id.
+/// \details In a binary log, only the Id's value is stored; its name is
+///         looked up when the log is decoded.
+/// \param  value The value to log.
+/// \return This LogRecord (for chaining).
+LogRecord& LogRecord::operator<<(const Id& value)
+{
+   if (binary_ && isPlain_())
+   {
+      formatter_->buf.text.push_back(static_cast<char>(LogValueId));
+      appendLogBytes(formatter_->buf.text, value.value());
+   }
+   else
+      writeText_(value);
+
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Applies a manipulator such as \c std::endl or \c std::flush.
+/// \param  manipulator The manipulator to apply.
+/// \return This LogRecord (for chaining).
+LogRecord& LogRecord::operator<<(std::ostream& (*manipulator)(std::ostream&))
+{
+   if (binary_)
+   {
+      size_t mark = beginText_();
+      formatter_->stream << manipulator;
+      endText_(mark);
+   }
+   else
+      formatter_->stream << manipulator;
+
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Applies a formatting manipulator such as \c std::hex.
+/// \param  manipulator The manipulator to apply.
+/// \return This LogRecord (for chaining).
+LogRecord& LogRecord::operator<<(std::ios_base& (*manipulator)(std::ios_base&))
+{
+   formatter_->stream << manipulator;
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the stream that formatted values are inserted into.
+/// \details In a binary log, text inserted directly into this stream (rather
+///         than through the LogRecord) is not framed as a value, so it
+///         should only be used between beginText_() and endText_().
+std::ostream& LogRecord::stream()
+{
+   return formatter_->stream;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Starts a text value whose content will be formatted by stream().
+/// \return The position of the value, to be passed to endText_().
+size_t LogRecord::beginText_()
+{
+   std::string& text = formatter_->buf.text;
+   size_t mark = text.size();
+   text.push_back(static_cast<char>(LogValueText));
+   text.append(sizeof(uint32_t), '\0');
+   return mark;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Finishes a text value started by beginText_().
+/// \details If no text was formatted, the value is removed.
+/// \param  mark The value returned by beginText_().
+void LogRecord::endText_(size_t mark)
+{
+   std::string& text = formatter_->buf.text;
+   size_t header = mark + 1 + sizeof(uint32_t);
+   if (text.size() == header)
+   {
+      text.resize(mark);
+      return;
+   }
+
+   uint32_t length = static_cast<uint32_t>(text.size() - header);
+   memcpy(&text[mark + 1], &length, sizeof(length));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Determines whether the stream's formatting flags are all set to
+///         their defaults.
+/// \details If they aren't, values must be formatted as text so that the
+///         flags are respected.
+bool LogRecord::isPlain_() const
+{
+   const std::ostream& stream = formatter_->stream;
+   return stream.flags() == (std::ios_base::dec | std::ios_base::skipws) &&
+          stream.width() == 0 &&
+          stream.precision() == 6;
+}
+
+} // namespace be::detail
+} // namespace be
@@ -0,0 +1,406 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/bed/batch_writer.cpp
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of be::bed::BatchWriter functions.
+
+#include "be/bed/batch_writer.h"
+
+#include <climits>
+#include <cstring>
+#include <utility>
+
+namespace be {
+namespace bed {
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Quotes an identifier for use in SQL, doubling any quotes it
+///         contains.
+std::string quoteName(const std::string& name)
+{
+   std::string quoted("\"");
+   for (auto c(name.begin()), end(name.end()); c != end; ++c)
+   {
+      if (*c == '"')
+         quoted.push_back('"');
+      quoted.push_back(*c);
+   }
+   quoted.push_back('"');
+   return quoted;
+}
+
+} // namespace be::bed::(anon)
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compiles the statement that will be executed for each row, using
+///         the default chunk size.
+///
+/// \param  db The database to write to.
+/// \param  sql The SQL text of the statement to execute for each row.
+BatchWriter::BatchWriter(Db& db, const std::string& sql)
+   : db_(db),
+     stmt_(db, sql),
+     chunk_size_(BE_BED_BATCH_WRITER_DEFAULT_CHUNK_SIZE),
+     chunk_rows_(0),
+     rows_(0),
+     parameter_(0)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compiles the statement that will be executed for each row.
+///
+/// \param  db The database to write to.
+/// \param  sql The SQL text of the statement to execute for each row.
+/// \param  chunk_size The maximum number of rows to write in each
+///         transaction.
+BatchWriter::BatchWriter(Db& db, const std::string& sql, size_t chunk_size)
+   : db_(db),
+     stmt_(db, sql),
+     chunk_size_(chunk_size > 0 ? chunk_size : 1),
+     chunk_rows_(0),
+     rows_(0),
+     parameter_(0)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Rolls back any rows written since the last commit, and recreates
+///         any indexes dropped by dropIndexes().
+///
+/// \details Errors while recreating indexes are logged rather than thrown.
+BatchWriter::~BatchWriter()
+{
+   // reset the statement so that it doesn't prevent the rollback.
+   stmt_.reset();
+   transaction_.reset();
+
+   if (!dropped_indexes_.empty())
+   {
+      try
+      {
+         rebuildIndexes_();
+      }
+      catch (const Db::error& err)
+      {
+         BE_LOG(VWarning) << "BatchWriter could not recreate dropped indexes!" << BE_LOG_NL
+                          << "Exception: " << err.what() << BE_LOG_NL
+                          << "      SQL: " << err.sql() << BE_LOG_END;
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Sets the maximum number of rows to write in each transaction.
+///
+/// \details If the current chunk already has at least this many rows, it
+///         will be committed after the next row is written.
+///
+/// \param  chunk_size The new chunk size.  Values less than 1 are treated
+///         as 1.
+void BatchWriter::setChunkSize(size_t chunk_size)
+{
+   chunk_size_ = chunk_size > 0 ? chunk_size : 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the maximum number of rows to write in each
+///         transaction.
+///
+/// \return The chunk size.
+size_t BatchWriter::getChunkSize() const
+{
+   return chunk_size_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the number of rows written so far, including rows
+///         which have not been committed yet.
+///
+/// \return The number of times next() has succeeded.
+uint64_t BatchWriter::getRowCount() const
+{
+   return rows_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Drops the non-unique indexes on a table so that they can be
+///         rebuilt once all rows have been written.
+///
+/// \details Any open chunk is committed first.  The dropped indexes are
+///         recreated by finish(), or by the destructor.  This may be called
+///         for several tables.
+///
+///         UNIQUE indexes are never dropped, whether they were created by a
+///         constraint or by <tt>CREATE UNIQUE INDEX</tt>, so uniqueness is
+///         still enforced while rows are written, and rebuilding the
+///         remaining indexes can't fail because of duplicate rows.
+///
+/// \param  table The name of the table whose indexes should be dropped.
+void BatchWriter::dropIndexes(const std::string& table)
+{
+   commit();
+
+   std::vector<std::string> names;
+   {
+      // columns: seq, name, unique
+      Stmt list(db_, "PRAGMA index_list(" + quoteName(table) + ")");
+      while (list.step())
+         if (list.getInt(2) == 0)
+            names.push_back(list.getText(1));
+   }
+
+   std::vector<std::pair<std::string, std::string> > indexes;
+   {
+      Stmt select(db_, "SELECT sql FROM sqlite_master WHERE type = 'index' AND name = ? AND sql IS NOT NULL");
+      for (auto i(names.begin()), end(names.end()); i != end; ++i)
+      {
+         select.bind(1, *i);
+         if (select.step())
+            indexes.push_back(std::make_pair(*i, std::string(select.getText(0))));
+         select.reset();
+      }
+   }
+
+   if (indexes.empty())
+      return;
+
+   Transaction transaction(db_, Transaction::Immediate);
+   for (auto i(indexes.begin()), end(indexes.end()); i != end; ++i)
+      db_.exec("DROP INDEX " + quoteName(i->first));
+   transaction.commit();
+
+   for (auto i(indexes.begin()), end(indexes.end()); i != end; ++i)
+      dropped_indexes_.push_back(i->second);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds text to the next parameter of the current row.
+///
+/// \details The text is copied into the arena, so it does not need to
+///         outlive this call.
+///
+/// \param  value The value to bind.
+/// \return This BatchWriter, to allow chaining.
+BatchWriter& BatchWriter::operator<<(const std::string& value)
+{
+   arenaBind_(value.data(), value.length(), false);
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds text to the next parameter of the current row.
+///
+/// \details The text is copied into the arena, so it does not need to
+///         outlive this call.  A null pointer binds NULL.
+///
+/// \param  value The value to bind.
+/// \return This BatchWriter, to allow chaining.
+BatchWriter& BatchWriter::operator<<(const char* value)
+{
+   if (!value)
+      return bindNull();
+
+   arenaBind_(value, strlen(value), false);
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds a blob to the next parameter of the current row.
+///
+/// \details The data is copied into the arena, so it does not need to
+///         outlive this call.
+///
+/// \param  value The value to bind.
+/// \return This BatchWriter, to allow chaining.
+BatchWriter& BatchWriter::bindBlob(const std::string& value)
+{
+   arenaBind_(value.data(), value.length(), true);
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds a blob to the next parameter of the current row.
+///
+/// \details The data is copied into the arena, so it does not need to
+///         outlive this call.
+///
+/// \param  value A pointer to the data to bind.
+/// \param  length The number of bytes to bind.
+/// \return This BatchWriter, to allow chaining.
+BatchWriter& BatchWriter::bindBlob(const void* value, int length)
+{
+   arenaBind_(value, length, true);
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Binds NULL to the next parameter of the current row.
+///
+/// \return This BatchWriter, to allow chaining.
+BatchWriter& BatchWriter::bindNull()
+{
+   checkBind_(sqlite3_bind_null(stmt_.stmt_, ++parameter_));
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Executes the statement using the parameters bound for the
+///         current row, and prepares for the next row.
+///
+/// \details Begins a new chunk if necessary, and commits the chunk if it
+///         is full.  If the statement fails, the row's parameters are
+///         discarded and the exception is propagated.  The chunk remains
+///         open, so the caller may skip the row and continue, or destroy
+///         the BatchWriter to roll back the chunk.
+void BatchWriter::next()
+{
+   try
+   {
+      if (!transaction_)
+         transaction_.reset(new Transaction(db_, Transaction::Immediate));
+
+      // the arena won't be reallocated until the next row, so its contents
+      // can be bound without SQLite making a copy.
+      for (auto i(arena_values_.begin()), end(arena_values_.end()); i != end; ++i)
+      {
+         const char* data = arena_.data() + i->offset;
+         if (i->blob)
+            checkBind_(sqlite3_bind_blob(stmt_.stmt_, i->parameter, data, i->length, SQLITE_STATIC));
+         else
+            checkBind_(sqlite3_bind_text(stmt_.stmt_, i->parameter, data, i->length, SQLITE_STATIC));
+      }
+
+      stmt_.step();
+   }
+   catch (...)
+   {
+      stmt_.reset();
+      stmt_.bind();
+      arena_.clear();
+      arena_values_.clear();
+      parameter_ = 0;
+      throw;
+   }
+
+   stmt_.reset();
+
+   // don't leave parameters pointing into the arena
+   for (auto i(arena_values_.begin()), end(arena_values_.end()); i != end; ++i)
+      sqlite3_bind_null(stmt_.stmt_, i->parameter);
+
+   arena_.clear();
+   arena_values_.clear();
+   parameter_ = 0;
+   ++rows_;
+
+   if (++chunk_rows_ >= chunk_size_)
+      commit();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Commits the rows written since the last commit, if there are
+///         any.
+void BatchWriter::commit()
+{
+   if (transaction_)
+   {
+      transaction_->commit();
+      transaction_.reset();
+   }
+   chunk_rows_ = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Commits the last chunk and recreates any indexes dropped by
+///         dropIndexes().
+///
+/// \details The BatchWriter may continue to be used afterwards.
+void BatchWriter::finish()
+{
+   commit();
+   rebuildIndexes_();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Copies text or a blob into the arena and schedules it to be
+///         bound to the next parameter by next().
+/// \details sqlite3_bind_text() and sqlite3_bind_blob() take int lengths,
+///         so longer values are rejected with SQLITE_TOOBIG rather than
+///         being truncated.
+void BatchWriter::arenaBind_(const void* value, size_t length, bool blob)
+{
+   if (length > size_t(INT_MAX))
+      checkBind_(SQLITE_TOOBIG);
+
+   ArenaValue arena_value;
+   arena_value.parameter = ++parameter_;
+   arena_value.offset = arena_.size();
+   arena_value.length = static_cast<int>(length);
+   arena_value.blob = blob;
+
+   const char* data = static_cast<const char*>(value);
+   arena_.insert(arena_.end(), data, data + length);
+
+   // keep the terminator so that an empty value never has a null pointer,
+   // which SQLite would bind as NULL.
+   arena_.push_back('\0');
+
+   arena_values_.push_back(arena_value);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Throws if an sqlite3_bind_*() function failed.
+///
+/// \param  result The value returned by sqlite3_bind_*().
+void BatchWriter::checkBind_(int result)
+{
+   if (result != SQLITE_OK)
+   {
+      // ColumnTraits may reject a value without calling sqlite, leaving an
+      // unrelated error message on the connection.
+      sqlite3* db = sqlite3_db_handle(stmt_.stmt_);
+      const char* message = sqlite3_errcode(db) == result ? sqlite3_errmsg(db) : sqlite3_errstr(result);
+      throw Db::error(message, stmt_.getSql());
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Recreates the indexes dropped by dropIndexes() in a single
+///         transaction.
+void BatchWriter::rebuildIndexes_()
+{
+   if (dropped_indexes_.empty())
+      return;
+
+   Transaction transaction(db_, Transaction::Immediate);
+   for (auto i(dropped_indexes_.begin()), end(dropped_indexes_.end()); i != end; ++i)
+      db_.exec(*i);
+   transaction.commit();
+
+   dropped_indexes_.clear();
+}
+
+} // namespace be::bed
+} // namespace be
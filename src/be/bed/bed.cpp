@@ -28,16 +28,48 @@
 
 namespace be {
 namespace bed {
+namespace {
+
+DbConfig getWritableConfig()
+{
+#ifdef BE_BEDITOR
+   return DbConfig::editor();
+#else
+   return DbConfig::writable();
+#endif
+}
+
+} // namespace be::bed::(anon)
 
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  Constructs a bed using the provided parameters.
 ///
+/// \details Read-only connections are configured with DbConfig::readOnly().
+///         Writable connections use DbConfig::editor() if #BE_BEDITOR is
+///         defined, or DbConfig::writable() otherwise, so that only the
+///         editor switches databases to WAL.
+///
 /// \param  id The Id of the bed.
 /// \param  path The location of the bed's SQLite database.
 /// \param  read_only Whether or not the bed should be modifiable.
 Bed::Bed(const Id& id, const std::string& path, bool read_only)
    : id_(id),
-     db_(path, read_only ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE),
+     db_(path, read_only ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+         read_only ? DbConfig::readOnly() : getWritableConfig()),
+     stmt_cache_(db_)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a bed using the provided parameters.
+///
+/// \param  id The Id of the bed.
+/// \param  path The location of the bed's SQLite database.
+/// \param  read_only Whether or not the bed should be modifiable.
+/// \param  config The PRAGMA settings to apply to the database connection.
+Bed::Bed(const Id& id, const std::string& path, bool read_only, const DbConfig& config)
+   : id_(id),
+     db_(path, read_only ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, config),
      stmt_cache_(db_)
 {
 }
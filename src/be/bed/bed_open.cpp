@@ -27,7 +27,12 @@
 
 #include "be/bed/bed_open.h"
 
+#include "be/id_map.h"
+
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace be {
 namespace bed {
@@ -37,20 +42,26 @@ struct BedInfo
 {
    boost::filesystem::path path;
    std::weak_ptr<Bed> bed;
+   std::weak_ptr<ConnectionPool<Bed> > pool;
+   std::shared_ptr<WriteQueue<Bed> > write_queue;
 };
 
-typedef std::unordered_map<Id, BedInfo> bed_map_t;
+// IdMap may move its values when it grows, so each BedInfo is allocated
+// separately to keep pointers to it valid when other beds are specified.
+typedef IdMap<std::unique_ptr<BedInfo> > bed_map_t;
 
 boost::filesystem::path empty_path;
 bed_map_t beds;
+std::mutex open_mutex;  ///< Guards beds and every BedInfo in it.
 
+// open_mutex must be held by the caller.
 BedInfo* getBI(const Id& bed_id)
 {
    auto i(beds.find(bed_id));
    if (i == beds.end())
       return nullptr;
 
-   return &i->second;
+   return i->second.get();
 }
 
 } // namespace be::bed::(anon)
@@ -81,14 +92,15 @@ bool specify(const Id& bed_id, const boost::filesystem::path& path)
       }
       
 
-      auto insert_result = beds.insert(std::make_pair(bed_id, BedInfo()));
-      boost::filesystem::path& map_path = insert_result.first->second.path;
+      std::lock_guard<std::mutex> lock(open_mutex);
+      std::unique_ptr<BedInfo>& bi = beds[bed_id];
 
-      if (insert_result.second)
+      if (!bi)
       {
-         // the insertion was successful
-         map_path = path;
-         map_path.make_preferred();
+         // the bed hasn't been specified before
+         bi.reset(new BedInfo());
+         bi->path = path;
+         bi->path.make_preferred();
       }
       else
       {
@@ -96,11 +108,11 @@ bool specify(const Id& bed_id, const boost::filesystem::path& path)
          boost::filesystem::path preferred(path);
          preferred.make_preferred();
 
-         if (map_path != preferred)
+         if (bi->path != preferred)
          {
             BE_LOG(VWarning) << "Bed ID/path collision!" << BE_LOG_NL
                              << "            ID: " << bed_id << BE_LOG_NL
-                             << " Existing Path: " << map_path << BE_LOG_NL
+                             << " Existing Path: " << bi->path << BE_LOG_NL
                              << "Specified Path: " << preferred << BE_LOG_END;
             return false;
          }
@@ -203,11 +215,13 @@ void directory(const boost::filesystem::path& path)
 /// \return The path of the database file associated with the bed.
 const boost::filesystem::path& getPath(const Id& bed_id)
 {
-   auto i(beds.find(bed_id));
-   if (i == beds.end())
+   std::lock_guard<std::mutex> lock(open_mutex);
+   BedInfo* bi = getBI(bed_id);
+   if (!bi)
       return empty_path;
 
-   return i->second.path;
+   // a bed's path never changes once it has been specified
+   return bi->path;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -223,8 +237,9 @@ const boost::filesystem::path& getPath(const Id& bed_id)
 std::unordered_map<Id, boost::filesystem::path> getPaths()
 {
    std::unordered_map<Id, boost::filesystem::path> paths;
+   std::lock_guard<std::mutex> lock(open_mutex);
    for (auto i(beds.begin()), end(beds.end()); i != end; ++i)
-      paths[i->first] = i->second.path;
+      paths[i->first] = i->second->path;
 
    return std::move(paths);
 }
@@ -245,6 +260,7 @@ std::unordered_map<Id, boost::filesystem::path> getPaths()
 /// \return A shared_ptr to the open read-only bed.
 std::shared_ptr<Bed> open(const Id& bed_id)
 {
+   std::lock_guard<std::mutex> lock(open_mutex);
    BedInfo* bi = getBI(bed_id);
    
    if (!bi)
@@ -262,7 +278,7 @@ std::shared_ptr<Bed> open(const Id& bed_id)
       bi->bed = std::weak_ptr<Bed>(ptr);
    }
 
-   return std::move(ptr);
+   return ptr;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -280,16 +296,144 @@ std::shared_ptr<Bed> open(const Id& bed_id)
 /// \return A shared_ptr to the open bed.
 std::shared_ptr<Bed> openWritable(const Id& bed_id)
 {
-   BedInfo* bi = getBI(bed_id);
+   std::string path;
+   {
+      std::lock_guard<std::mutex> lock(open_mutex);
+      BedInfo* bi = getBI(bed_id);
+      if (bi)
+         path = bi->path.string();
+   }
 
-   if (!bi)
+   if (path.empty())
    {
       BE_LOG(VWarning) << "Attempted to open unspecified bed!" << BE_LOG_NL
                        << "ID: " << bed_id << BE_LOG_END;
       return std::shared_ptr<Bed>();
    }
    
-   return std::shared_ptr<Bed>(new Bed(bed_id, bi->path.string(), false));
+   return std::shared_ptr<Bed>(new Bed(bed_id, path, false));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves a shared_ptr to a pool of read-only connections to the
+///         bed associated with the provided ID.
+///
+/// \details Use this instead of open() when several threads will be reading
+///         from the same bed at once.  Each thread holds its own read-only
+///         Bed (with its own StmtCache) from the pool, so queries on
+///         different threads don't wait on a single connection.  See
+///         ConnectionPool for details.
+///
+///         Multiple calls to openPool() using the same ID will return
+///         shared_ptrs to the same pool (assuming the shared_ptr is not
+///         invalidated in between calls).  Connections are not opened until
+///         they are first held.
+///
+///         A path must be specified for a particular ID before that bed can be
+///         opened.  If no path has been specified for the requested ID, a
+///         warning will be emitted and an empty shared_ptr will be returned.
+///
+/// \param  bed_id The Id of the pre-specified bed.
+/// \return A shared_ptr to the pool of read-only beds.
+std::shared_ptr<ConnectionPool<Bed> > openPool(const Id& bed_id)
+{
+   std::lock_guard<std::mutex> lock(open_mutex);
+   BedInfo* bi = getBI(bed_id);
+
+   if (!bi)
+   {
+      BE_LOG(VWarning) << "Attempted to open unspecified bed!" << BE_LOG_NL
+                       << "ID: " << bed_id << BE_LOG_END;
+      return std::shared_ptr<ConnectionPool<Bed> >();
+   }
+
+   std::shared_ptr<ConnectionPool<Bed> > ptr(bi->pool.lock());
+
+   if (!ptr)   // previous instance has already been destroyed
+   {
+      Id id(bed_id);
+      std::string path(bi->path.string());
+      ptr.reset(new ConnectionPool<Bed>([=]() { return new Bed(id, path, true); }));
+      bi->pool = std::weak_ptr<ConnectionPool<Bed> >(ptr);
+   }
+
+   return ptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the write queue for the bed associated with the
+///         provided ID, opening a writable connection for it if necessary.
+///
+/// \details Changes pushed onto the queue are applied on a dedicated thread
+///         and committed in batches; see WriteQueue for details.  The queue
+///         stays open until closeWriteQueues() is called, so callers can push
+///         a change and immediately drop their reference to the queue.
+///
+///         A path must be specified for a particular ID before that bed can be
+///         opened.  If no path has been specified for the requested ID, or the
+///         bed can't be opened for writing, a warning will be emitted and an
+///         empty shared_ptr will be returned.
+///
+/// \param  bed_id The Id of the pre-specified bed.
+/// \return A shared_ptr to the bed's write queue.
+std::shared_ptr<WriteQueue<Bed> > openWriteQueue(const Id& bed_id)
+{
+   std::lock_guard<std::mutex> lock(open_mutex);
+   BedInfo* bi = getBI(bed_id);
+
+   if (!bi)
+   {
+      BE_LOG(VWarning) << "Attempted to open unspecified bed!" << BE_LOG_NL
+                       << "ID: " << bed_id << BE_LOG_END;
+      return std::shared_ptr<WriteQueue<Bed> >();
+   }
+
+   if (!bi->write_queue)
+   {
+      try
+      {
+         std::shared_ptr<Bed> bed(new Bed(bed_id, bi->path.string(), false));
+         bi->write_queue.reset(new WriteQueue<Bed>(bed));
+      }
+      catch (const Db::error& err)
+      {
+         BE_LOG(VWarning) << "Database error while opening bed for writing!" << BE_LOG_NL
+                          << "       ID: " << bed_id << BE_LOG_NL
+                          << "     Path: " << bi->path << BE_LOG_NL
+                          << "Exception: " << err.what() << BE_LOG_END;
+      }
+   }
+
+   return bi->write_queue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Commits all changes queued on any bed's write queue and closes the
+///         queues.
+///
+/// \details This should be called before shutting down, since the queues'
+///         writer threads can't safely be stopped during static destruction.
+///         Queues which are still referenced elsewhere will remain open until
+///         those references are released.
+void closeWriteQueues()
+{
+   std::vector<std::shared_ptr<WriteQueue<Bed> > > queues;
+
+   {
+      std::lock_guard<std::mutex> lock(open_mutex);
+      for (auto i(beds.begin()), end(beds.end()); i != end; ++i)
+      {
+         if (i->second->write_queue)
+         {
+            queues.push_back(i->second->write_queue);
+            i->second->write_queue.reset();
+         }
+      }
+   }
+
+   // destroying the queues flushes them, which shouldn't block
+   // openWriteQueue() calls on other threads.
+   queues.clear();
 }
 
 } // namespace be::bed
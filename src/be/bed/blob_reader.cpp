@@ -0,0 +1,169 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/bed/blob_reader.cpp
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of be::bed::BlobReader functions.
+
+#include "be/bed/blob_reader.h"
+
+#include <cassert>
+
+namespace be {
+namespace bed {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Opens a blob for reading.
+///
+/// \details If the row does not exist or the column does not contain a blob
+///         or text value, Db::error is thrown.
+///
+/// \param  db The database containing the blob.
+/// \param  table The name of the table containing the blob.
+/// \param  column The name of the column containing the blob.
+/// \param  rowid The rowid of the row containing the blob.
+BlobReader::BlobReader(Db& db, const std::string& table, const std::string& column, sqlite3_int64 rowid)
+   : db_(db),
+     blob_(nullptr),
+     size_(0),
+     position_(0)
+{
+   if (sqlite3_blob_open(db_.db_, "main", table.c_str(), column.c_str(), rowid, 0, &blob_) != SQLITE_OK)
+   {
+      Db::error e(sqlite3_errmsg(db_.db_));
+      sqlite3_blob_close(blob_);
+      throw e;
+   }
+
+   size_ = sqlite3_blob_bytes(blob_);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Closes the blob.
+BlobReader::~BlobReader()
+{
+   sqlite3_blob_close(blob_);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Moves the reader to the same column of a different row in the
+///         same table.
+///
+/// \details This is faster than opening a new BlobReader.  The position is
+///         reset to the beginning of the new blob.  If the row does not exist
+///         or does not contain a blob, Db::error is thrown and the reader
+///         can't be used again until it is successfully reopened.
+///
+/// \param  rowid The rowid of the row containing the new blob.
+void BlobReader::reopen(sqlite3_int64 rowid)
+{
+   position_ = 0;
+   size_ = 0;
+
+   if (sqlite3_blob_reopen(blob_, rowid) != SQLITE_OK)
+      throw Db::error(sqlite3_errmsg(db_.db_));
+
+   size_ = sqlite3_blob_bytes(blob_);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the total size of the blob.
+///
+/// \return The size of the blob in bytes.
+int BlobReader::getSize() const
+{
+   return size_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the offset of the next byte which will be read.
+///
+/// \return The current position, in bytes from the beginning of the blob.
+int BlobReader::getPosition() const
+{
+   return position_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Determines if the whole blob has been read.
+///
+/// \return \c true if the position is at the end of the blob.
+bool BlobReader::isEof() const
+{
+   return position_ >= size_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Copies bytes from the current position into a buffer and advances
+///         the position.
+///
+/// \details If there are fewer than \c length bytes remaining, only the
+///         remaining bytes are read.  If the row has been modified since the
+///         blob was opened, Db::error is thrown.
+///
+/// \param  dest The buffer to copy into.  It must be at least \c length bytes
+///         long.
+/// \param  length The maximum number of bytes to read.
+/// \return The number of bytes read.
+int BlobReader::read(void* dest, int length)
+{
+   assert(length >= 0);
+
+   if (length > size_ - position_)
+      length = size_ - position_;
+
+   if (length <= 0)
+      return 0;
+
+   if (sqlite3_blob_read(blob_, dest, length, position_) != SQLITE_OK)
+      throw Db::error(sqlite3_errmsg(db_.db_));
+
+   position_ += length;
+   return length;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Sets the position of the next byte to read.
+///
+/// \param  position The new position, which will be clamped to the size of
+///         the blob.
+void BlobReader::seek(int position)
+{
+   if (position < 0)
+      position = 0;
+   else if (position > size_)
+      position = size_;
+
+   position_ = position;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Moves the position forward (or backward, if \c bytes is negative).
+///
+/// \param  bytes The number of bytes to skip.
+void BlobReader::skip(int bytes)
+{
+   seek(position_ + bytes);
+}
+
+} // namespace be::bed
+} // namespace be
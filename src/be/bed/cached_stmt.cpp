@@ -45,6 +45,7 @@ namespace bed {
 /// \param  other The CachedStmt to move.
 CachedStmt::CachedStmt(CachedStmt&& other)
    : cache_(other.cache_),
+     entry_(other.entry_),
      stmt_(other.stmt_)
 {
    other.cache_ = nullptr;
@@ -57,7 +58,7 @@ CachedStmt::CachedStmt(CachedStmt&& other)
 CachedStmt::~CachedStmt()
 {
    if (cache_)
-      cache_->release_(stmt_);
+      cache_->release_(*entry_);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -222,6 +223,13 @@ int CachedStmt::column(const std::string& name)
    return stmt_.column(name);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// \copydoc   Stmt::column(const Id&)
+int CachedStmt::column(const Id& name)
+{
+   return stmt_.column(name);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// \copydoc   Stmt::getType(int)
 int CachedStmt::getType(int column)
@@ -298,10 +306,12 @@ int CachedStmt::getBlob(int column, const void*& dest)
 /// \details Called from StmtCache to create cached stmts.
 ///
 /// \param  cache The StmtCache that manages this cached statement.
-/// \param  stmt The Stmt object which should be used for all accesses.
-CachedStmt::CachedStmt(StmtCache* cache, Stmt& stmt)
+/// \param  entry The cache entry which owns the Stmt object which should be
+///         used for all accesses.
+CachedStmt::CachedStmt(StmtCache* cache, detail::StmtCacheEntry& entry)
    : cache_(cache),
-     stmt_(stmt)
+     entry_(&entry),
+     stmt_(*entry.stmt)
 {
 }
 
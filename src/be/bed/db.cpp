@@ -27,11 +27,60 @@
 #include "be/bed/db.h"
 
 #include <cassert>
+#include <sstream>
 
 #include "be/bed/stmt.h"
 
 namespace be {
 namespace bed {
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Changes a connection's journal mode, logging a warning instead
+///         of throwing if it can't be changed.
+/// \details SQLite returns the journal mode in effect after the PRAGMA, which
+///         is the old mode if the change was refused (e.g. for in-memory
+///         databases), or an error if another connection holds a lock on the
+///         database for longer than the busy timeout.
+///
+/// \param  db The connection to change.
+/// \param  mode The lowercase name of the journal mode to use.
+void setJournalMode(sqlite3* db, const char* mode)
+{
+   std::string sql("PRAGMA journal_mode = ");
+   sql.append(mode);
+
+   std::string current;
+   std::string error;
+
+   sqlite3_stmt* stmt = nullptr;
+   int result = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
+   if (result == SQLITE_OK)
+      result = sqlite3_step(stmt);
+
+   if (result == SQLITE_ROW)
+   {
+      const unsigned char* text = sqlite3_column_text(stmt, 0);
+      if (text)
+         current = reinterpret_cast<const char*>(text);
+   }
+   else
+      error = sqlite3_errmsg(db);
+
+   sqlite3_finalize(stmt);
+
+   if (current == mode)
+      return;
+
+   const char* path = sqlite3_db_filename(db, "main");
+   BE_LOG(VWarning) << "Could not change database journal mode!" << BE_LOG_NL
+                    << "     Path: " << (path ? path : "") << BE_LOG_NL
+                    << "Requested: " << mode << BE_LOG_NL
+                    << "  Current: " << (current.empty() ? "unknown" : current) << BE_LOG_NL
+                    << "    Error: " << (error.empty() ? "none" : error) << BE_LOG_END;
+}
+
+} // namespace be::bed::(anon)
 
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  Constructs an in-memory database.
@@ -101,6 +150,35 @@ Db::Db(const std::string& path, int flags, const std::string& vfs_name)
    }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Opens a database file, using a custom sqlite3_open_v2() flag
+///         bitfield, and applies the provided configuration to the
+///         connection.
+///
+/// \param  path The path to the database file.
+/// \param  flags A set of sqlite3_open_v2() flags.
+/// \param  config The PRAGMA settings to apply.
+/// \sa     configure()
+Db::Db(const std::string& path, int flags, const DbConfig& config)
+{
+   if (sqlite3_open_v2(path.c_str(), &db_, flags, nullptr) != SQLITE_OK)
+   {
+      error e(sqlite3_errmsg(db_));
+      sqlite3_close(db_);
+      throw e;
+   }
+
+   try
+   {
+      configure(config);
+   }
+   catch (...)
+   {
+      sqlite3_close(db_);
+      throw;
+   }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  Cleans up the Db object.
 ///
@@ -115,6 +193,64 @@ Db::~Db()
    assert(result == SQLITE_OK);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Applies PRAGMA settings to the connection.
+///
+/// \details Settings whose value is "default" are not changed.  Changing the
+///         journal mode may fail if another connection holds a lock on the
+///         database for longer than the busy timeout, or if the database is
+///         read-only or in memory.  In that case a warning is logged and the
+///         journal mode is left unchanged; it is not treated as an error,
+///         since the connection still works.  This should not be called
+///         while a transaction is active.
+///
+/// \param  config The settings to apply.
+void Db::configure(const DbConfig& config)
+{
+   if (config.busy_timeout > 0)
+      sqlite3_busy_timeout(db_, config.busy_timeout);
+
+   switch (config.journal_mode)
+   {
+      case DbConfig::JournalDelete:    setJournalMode(db_, "delete");   break;
+      case DbConfig::JournalTruncate:  setJournalMode(db_, "truncate"); break;
+      case DbConfig::JournalPersist:   setJournalMode(db_, "persist");  break;
+      case DbConfig::JournalMemory:    setJournalMode(db_, "memory");   break;
+      case DbConfig::JournalWal:       setJournalMode(db_, "wal");      break;
+      case DbConfig::JournalOff:       setJournalMode(db_, "off");      break;
+      default: break;
+   }
+
+   std::ostringstream oss;
+
+   switch (config.synchronous)
+   {
+      case DbConfig::SyncOff:    oss << "PRAGMA synchronous = OFF;";    break;
+      case DbConfig::SyncNormal: oss << "PRAGMA synchronous = NORMAL;"; break;
+      case DbConfig::SyncFull:   oss << "PRAGMA synchronous = FULL;";   break;
+      default: break;
+   }
+
+   switch (config.temp_store)
+   {
+      case DbConfig::TempStoreFile:   oss << "PRAGMA temp_store = FILE;";   break;
+      case DbConfig::TempStoreMemory: oss << "PRAGMA temp_store = MEMORY;"; break;
+      default: break;
+   }
+
+   if (config.mmap_size >= 0)
+      oss << "PRAGMA mmap_size = " << config.mmap_size << ';';
+
+   // negative cache_size values are interpreted by SQLite as KiB rather than
+   // pages.
+   if (config.cache_size > 0)
+      oss << "PRAGMA cache_size = -" << config.cache_size << ';';
+
+   std::string sql(oss.str());
+   if (!sql.empty())
+      exec(sql);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  Convienience function for starting a new transaction.
 ///
@@ -166,7 +302,11 @@ void Db::exec(const std::string& sql)
    if (result != SQLITE_OK)
    {
       if (err)
-         throw error(err);
+      {
+         error e(err);
+         sqlite3_free(err);
+         throw e;
+      }
       else
 #if defined(_MSC_VER) && _MSC_VER <= 1600
          // VC10 doesn't include std::to_string(int)
@@ -0,0 +1,112 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/bed/db_config.cpp
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of be::bed::DbConfig functions.
+
+#include "be/bed/db_config.h"
+
+namespace be {
+namespace bed {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a configuration which leaves every setting unchanged.
+DbConfig::DbConfig()
+   : journal_mode(JournalDefault),
+     synchronous(SyncDefault),
+     temp_store(TempStoreDefault),
+     mmap_size(-1),
+     cache_size(0),
+     busy_timeout(0)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Creates a configuration for read-only connections to asset
+///         databases.
+/// \details The file is memory-mapped (up to 256 MiB) so that pages are read
+///         directly from the OS page cache instead of being copied, and
+///         temporary tables and indices used by queries are kept in memory.
+///         The journal mode is left unchanged, since read-only connections
+///         can't change it.  A short busy timeout lets readers wait out a
+///         writer's checkpoint instead of failing.
+///
+/// \return A read-heavy configuration.
+DbConfig DbConfig::readOnly()
+{
+   DbConfig config;
+   config.temp_store = TempStoreMemory;
+   config.mmap_size = 256 * 1024 * 1024;
+   config.cache_size = 8 * 1024;
+   config.busy_timeout = 1000;
+   return config;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Creates a configuration for writable connections outside the
+///         editor.
+/// \details Like readOnly(), but with a larger page cache.  The journal mode
+///         and synchronous setting are left unchanged: switching to WAL is
+///         stored in the database file, and would leave -wal and -shm files
+///         next to shipped databases, which breaks read-only installs.
+///
+/// \return A configuration which doesn't change the database file.
+DbConfig DbConfig::writable()
+{
+   DbConfig config;
+   config.temp_store = TempStoreMemory;
+   config.mmap_size = 256 * 1024 * 1024;
+   config.cache_size = 16 * 1024;
+   config.busy_timeout = 1000;
+   return config;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Creates a configuration for writable connections used by the
+///         editor.
+/// \details Switches the file to WAL journaling so that readers don't block
+///         the writer, and only syncs the WAL at checkpoints
+///         (<tt>synchronous=NORMAL</tt>), which is still safe against
+///         application crashes, though the most recent transactions may be
+///         lost if the OS crashes or power is lost.
+///
+///         The switch to WAL is stored in the file, so it also affects
+///         read-only connections opened afterwards, including those of the
+///         game itself.  It only happens if no other connection is using
+///         the file at the time; otherwise a warning is logged.
+///
+/// \return A write-heavy configuration.
+DbConfig DbConfig::editor()
+{
+   DbConfig config;
+   config.journal_mode = JournalWal;
+   config.synchronous = SyncNormal;
+   config.temp_store = TempStoreMemory;
+   config.mmap_size = 256 * 1024 * 1024;
+   config.cache_size = 16 * 1024;
+   config.busy_timeout = 1000;
+   return config;
+}
+
+} // namespace be::bed
+} // namespace be
@@ -33,11 +33,14 @@ namespace detail {
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  Default constructor.
 ///
-/// \details Constructs an entry in an invalid state.  stmt must still be
-///         initialized before the object is usable.
+/// \details Constructs an entry with no statement, linked only to itself.
+///         StmtCache uses such entries as the heads of its circular lists.
 StmtCacheEntry::StmtCacheEntry()
    : held(false),
-     access_index(0)
+     prev(this),
+     next(this),
+     id_prev(nullptr),
+     id_next(nullptr)
 {
 }
 
@@ -49,31 +52,37 @@ StmtCacheEntry::StmtCacheEntry()
 /// \param  stmt The statement object used for this entry.
 StmtCacheEntry::StmtCacheEntry(Stmt* stmt)
    : held(false),
-     access_index(0),
-     stmt(stmt)
+     stmt(stmt),
+     prev(this),
+     next(this),
+     id_prev(nullptr),
+     id_next(nullptr)
 {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-/// \brief  Move-constructs an existing entry.
+/// \brief  Inserts this entry into a list immediately before another entry.
 ///
-/// \param  other An existing entry to move from.
-StmtCacheEntry::StmtCacheEntry(StmtCacheEntry&& other)
-   : held(std::move(other.held)),
-     access_index(std::move(other.access_index)),
-     stmt(std::move(other.stmt))
+/// \details The entry must not currently be linked into any list.  Linking
+///         an entry before a list's head entry appends it to the list.
+///
+/// \param  before The entry which will follow this one.
+void StmtCacheEntry::link(StmtCacheEntry& before)
 {
+   prev = before.prev;
+   next = &before;
+   prev->next = this;
+   before.prev = this;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-/// \brief  Move-assigns an existing entry.
-///
-/// \param  other An existing entry to move from.
-void StmtCacheEntry::operator=(StmtCacheEntry&& other)
+/// \brief  Removes this entry from the held or unheld list it is in.
+void StmtCacheEntry::unlink()
 {
-   held = std::move(other.held);
-   access_index = std::move(other.access_index);
-   stmt = std::move(other.stmt);
+   prev->next = next;
+   next->prev = prev;
+   prev = this;
+   next = this;
 }
 
 } // namespace be::bed::detail
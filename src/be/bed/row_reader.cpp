@@ -0,0 +1,102 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/bed/row_reader.cpp
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of be::bed::RowReader functions.
+
+#include "be/bed/row_reader.h"
+
+#include "be/bed/cached_stmt.h"
+#include "be/bed/stmt.h"
+
+namespace be {
+namespace bed {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a RowReader which will read a statement's current row,
+///         starting with the first column.
+///
+/// \param  stmt The statement to read from.
+RowReader::RowReader(Stmt& stmt)
+   : stmt_(stmt.stmt_),
+     column_(0)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a RowReader which will read a cached statement's
+///         current row, starting with the first column.
+///
+/// \param  stmt The statement to read from.
+RowReader::RowReader(CachedStmt& stmt)
+   : stmt_(stmt.stmt_.stmt_),
+     column_(0)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a RowReader which will read a statement's current row,
+///         starting with the specified column.
+///
+/// \param  stmt The statement to read from.
+/// \param  column The index of the first column to read.
+RowReader::RowReader(Stmt& stmt, int column)
+   : stmt_(stmt.stmt_),
+     column_(column)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a RowReader which will read a cached statement's
+///         current row, starting with the specified column.
+///
+/// \param  stmt The statement to read from.
+/// \param  column The index of the first column to read.
+RowReader::RowReader(CachedStmt& stmt, int column)
+   : stmt_(stmt.stmt_.stmt_),
+     column_(column)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Skips over one or more columns without reading them.
+///
+/// \param  columns The number of columns to skip.
+/// \return This RowReader, to allow chaining.
+RowReader& RowReader::skip(int columns)
+{
+   column_ += columns;
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the index of the next column that will be read.
+///
+/// \return The next column index.
+int RowReader::getColumn() const
+{
+   return column_;
+}
+
+} // namespace be::bed
+} // namespace be
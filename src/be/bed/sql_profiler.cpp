@@ -0,0 +1,540 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/bed/sql_profiler.cpp
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of be::bed::SqlProfiler functions.
+
+#include "be/bed/sql_profiler.h"
+
+#include "be/profiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace be {
+namespace bed {
+namespace detail {
+
+// Relies on zero-initialization so that statements can be used during static
+// initialization.
+std::atomic<bool> sql_profiler_active;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  The number of buckets in an execution time histogram.
+/// \details Times below 8 ticks have their own bucket.  Above that, each
+///         power of two is split into 8 buckets, so a bucket's upper bound is
+///         never more than 12.5% larger than the times it contains.
+const size_t sql_histogram_buckets = 8 + 61 * 8;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Accumulates statistics for all statements with the same Id.
+struct SqlProfileRecord
+{
+   SqlProfileRecord()
+      : prepares(0),
+        prepare_ticks(0),
+        executions(0),
+        errors(0),
+        rows(0),
+        total_ticks(0),
+        max_ticks(0),
+        cache_hits(0),
+        cache_misses(0),
+        cache_evictions(0)
+   {
+      std::fill(histogram, histogram + sql_histogram_buckets, 0);
+   }
+
+   std::string sql;
+   uint64_t prepares;
+   uint64_t prepare_ticks;
+   uint64_t executions;
+   uint64_t errors;
+   uint64_t rows;
+   uint64_t total_ticks;
+   uint64_t max_ticks;
+   uint64_t cache_hits;
+   uint64_t cache_misses;
+   uint64_t cache_evictions;
+   uint32_t histogram[sql_histogram_buckets];   ///< Execution times, indexed by getHistogramBucket().
+};
+
+} // namespace be::bed::detail
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Guards active_sql_profiler and the statistics it contains.
+std::mutex& getSqlProfilerMutex()
+{
+   static std::mutex mutex;
+   return mutex;
+}
+
+SqlProfiler* active_sql_profiler = nullptr;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Determines which histogram bucket an execution time belongs in.
+size_t getHistogramBucket(uint64_t ticks)
+{
+   if (ticks < 8)
+      return static_cast<size_t>(ticks);
+
+   size_t shift = 0;
+   while ((ticks >> shift) >= 16)
+      ++shift;
+
+   return 8 + shift * 8 + static_cast<size_t>((ticks >> shift) - 8);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the largest execution time which belongs in a histogram
+///         bucket.
+uint64_t getHistogramBucketLimit(size_t bucket)
+{
+   if (bucket < 8)
+      return bucket;
+
+   size_t shift = (bucket - 8) / 8;
+   uint64_t mantissa = 8 + (bucket - 8) % 8;
+   return ((mantissa + 1) << shift) - 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Orders statistics by total time spent, most expensive first.
+bool compareTotalTime(const SqlStmtStats& a, const SqlStmtStats& b)
+{
+   return a.total_ms + a.prepare_ms > b.total_ms + b.prepare_ms;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Writes a report generated by SqlProfiler::writeReport_() to the
+///         log as a single message.
+void logSqlReport(const std::string& report)
+{
+   std::istringstream iss(report);
+   std::ostringstream message;
+   std::string line;
+   if (std::getline(iss, line))
+      message << line;
+   while (std::getline(iss, line))
+      message << BE_LOG_NL << line;
+
+   BE_LOG(VInfo) << message.str() << BE_LOG_END;
+}
+
+} // namespace be::bed::(anon)
+
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Called when a Stmt compiles its SQL.
+void recordSqlPrepare(const Id& id, const char* sql, uint64_t ticks)
+{
+   std::lock_guard<std::mutex> lock(getSqlProfilerMutex());
+   if (!active_sql_profiler)
+      return;
+
+   SqlProfileRecord& record = active_sql_profiler->getRecord_(id);
+   if (record.sql.empty() && sql)
+      record.sql = sql;
+
+   ++record.prepares;
+   record.prepare_ticks += ticks;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Called when a Stmt finishes executing.
+/// \details If the active profiler's log interval has elapsed, a report is
+///         logged from the calling thread.
+void recordSqlExecution(const Id& id, const char* sql, uint64_t ticks, uint64_t rows, bool failed)
+{
+   std::string report;
+   {
+      std::lock_guard<std::mutex> lock(getSqlProfilerMutex());
+      if (!active_sql_profiler)
+         return;
+
+      SqlProfileRecord& record = active_sql_profiler->getRecord_(id);
+      if (record.sql.empty() && sql)
+         record.sql = sql;
+
+      ++record.executions;
+      if (failed)
+         ++record.errors;
+      record.rows += rows;
+      record.total_ticks += ticks;
+      record.max_ticks = std::max(record.max_ticks, ticks);
+      ++record.histogram[getHistogramBucket(ticks)];
+
+      if (active_sql_profiler->checkLogInterval_())
+      {
+         std::ostringstream oss;
+         active_sql_profiler->writeReport_(oss, active_sql_profiler->log_statements_);
+         report = oss.str();
+      }
+   }
+
+   // don't write to the log while holding the mutex
+   if (!report.empty())
+      logSqlReport(report);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Called when StmtCache::hold() is called.
+/// \param  hit \c false if the statement had to be compiled.
+void recordSqlCacheHold(const Id& id, bool hit)
+{
+   std::lock_guard<std::mutex> lock(getSqlProfilerMutex());
+   if (!active_sql_profiler)
+      return;
+
+   SqlProfileRecord& record = active_sql_profiler->getRecord_(id);
+   if (hit)
+      ++record.cache_hits;
+   else
+      ++record.cache_misses;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Called when a StmtCache destroys an unheld statement because the
+///         cache is over capacity.
+void recordSqlCacheEviction(const Id& id)
+{
+   std::lock_guard<std::mutex> lock(getSqlProfilerMutex());
+   if (!active_sql_profiler)
+      return;
+
+   ++active_sql_profiler->getRecord_(id).cache_evictions;
+}
+
+} // namespace be::bed::detail
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Starts collecting statistics without logging them periodically.
+/// \throws std::logic_error if another SqlProfiler already exists.
+SqlProfiler::SqlProfiler()
+   : log_interval_(0),
+     log_statements_(0)
+{
+   init_();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Starts collecting statistics and logging a report periodically.
+///
+/// \details Reports are logged at \ref VInfo.  If #BE_MIN_VERBOSITY excludes
+///         that level (as it does by default when \c NDEBUG is defined),
+///         reports are never written, so callers which only want the reports
+///         should not create a profiler at all in that case.
+///
+/// \param  log_interval The minimum time between reports.  If zero, reports
+///         are not logged automatically.
+/// \param  log_statements The maximum number of statements to include in
+///         each report.
+/// \throws std::logic_error if another SqlProfiler already exists.
+SqlProfiler::SqlProfiler(std::chrono::seconds log_interval, size_t log_statements)
+   : log_interval_(log_interval),
+     log_statements_(log_statements)
+{
+   init_();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Stops collecting statistics.
+/// \details If periodic logging is enabled, a final report is logged.
+SqlProfiler::~SqlProfiler()
+{
+   detail::sql_profiler_active.store(false);
+
+   {
+      std::lock_guard<std::mutex> lock(getSqlProfilerMutex());
+      active_sql_profiler = nullptr;
+   }
+
+   if (log_interval_.count() > 0)
+   {
+      std::ostringstream oss;
+      writeReport_(oss, log_statements_);
+      logSqlReport(oss.str());
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the statistics for every statement that has been
+///         prepared, executed, or held since the profiler was created or
+///         reset.
+///
+/// \return The statistics for each statement Id, most expensive first.
+std::vector<SqlStmtStats> SqlProfiler::getStats()
+{
+   std::lock_guard<std::mutex> lock(getSqlProfilerMutex());
+   return getStats_();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the statistics for a single statement Id.
+///
+/// \param  id The statement Id.
+/// \return The statement's statistics.  All counters will be zero if no
+///         statement with this Id has been seen.
+SqlStmtStats SqlProfiler::getStats(const Id& id)
+{
+   std::lock_guard<std::mutex> lock(getSqlProfilerMutex());
+   auto i(records_.find(id));
+   if (i != records_.end())
+      return makeStats_(*i->second, ticksPerMs_());
+
+   detail::SqlProfileRecord empty;
+   SqlStmtStats stats(makeStats_(empty, 1.0));
+   stats.id = id;
+   return stats;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Discards all statistics collected so far.
+void SqlProfiler::reset()
+{
+   std::lock_guard<std::mutex> lock(getSqlProfilerMutex());
+   records_.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Writes a table of the most expensive statements, along with
+///         totals for all statements.
+///
+/// \param  os The stream to write to.
+/// \param  max_statements The maximum number of statements to list.
+void SqlProfiler::writeReport(std::ostream& os, size_t max_statements)
+{
+   std::lock_guard<std::mutex> lock(getSqlProfilerMutex());
+   writeReport_(os, max_statements);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Writes the same report as writeReport() to the log immediately.
+void SqlProfiler::logReport()
+{
+   std::ostringstream oss;
+   writeReport(oss, log_statements_ > 0 ? log_statements_ : 10);
+   logSqlReport(oss.str());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Registers this profiler as the active profiler.
+void SqlProfiler::init_()
+{
+   origin_time_ = std::chrono::steady_clock::now();
+   origin_ticks_ = be::detail::getProfileTicks();
+   next_log_time_ = origin_time_ + log_interval_;
+
+   std::lock_guard<std::mutex> lock(getSqlProfilerMutex());
+   if (active_sql_profiler)
+      throw std::logic_error("A SqlProfiler already exists!");
+
+   active_sql_profiler = this;
+   detail::sql_profiler_active.store(true);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the record for a statement Id, creating it if
+///         necessary.
+///
+/// \note   The SqlProfiler mutex must be locked before calling this function!
+detail::SqlProfileRecord& SqlProfiler::getRecord_(const Id& id)
+{
+   std::unique_ptr<detail::SqlProfileRecord>& record = records_[id];
+   if (!record)
+      record.reset(new detail::SqlProfileRecord());
+
+   return *record;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the statistics for every statement, most expensive
+///         first.
+///
+/// \note   The SqlProfiler mutex must be locked before calling this function!
+std::vector<SqlStmtStats> SqlProfiler::getStats_()
+{
+   double ticks_per_ms = ticksPerMs_();
+
+   std::vector<SqlStmtStats> stats;
+   stats.reserve(records_.size());
+   for (auto i(records_.begin()), end(records_.end()); i != end; ++i)
+   {
+      stats.push_back(makeStats_(*i->second, ticks_per_ms));
+      stats.back().id = i->first;
+   }
+
+   std::sort(stats.begin(), stats.end(), compareTotalTime);
+   return stats;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Converts a record's tick counts to milliseconds.
+SqlStmtStats SqlProfiler::makeStats_(const detail::SqlProfileRecord& record, double ticks_per_ms) const
+{
+   SqlStmtStats stats;
+   stats.sql = record.sql;
+   stats.prepares = record.prepares;
+   stats.prepare_ms = record.prepare_ticks / ticks_per_ms;
+   stats.executions = record.executions;
+   stats.errors = record.errors;
+   stats.rows = record.rows;
+   stats.total_ms = record.total_ticks / ticks_per_ms;
+   stats.max_ms = record.max_ticks / ticks_per_ms;
+   stats.p99_ms = 0;
+   stats.cache_hits = record.cache_hits;
+   stats.cache_misses = record.cache_misses;
+   stats.cache_evictions = record.cache_evictions;
+
+   if (record.executions > 0)
+   {
+      // the smallest bucket limit which at least 99% of executions fit under
+      uint64_t threshold = record.executions - record.executions / 100;
+      uint64_t count = 0;
+      size_t bucket = 0;
+      while (bucket + 1 < detail::sql_histogram_buckets)
+      {
+         count += record.histogram[bucket];
+         if (count >= threshold)
+            break;
+         ++bucket;
+      }
+
+      uint64_t limit = std::min(getHistogramBucketLimit(bucket), record.max_ticks);
+      stats.p99_ms = limit / ticks_per_ms;
+   }
+
+   return stats;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Writes a report of the most expensive statements.
+///
+/// \note   The SqlProfiler mutex must be locked before calling this function!
+void SqlProfiler::writeReport_(std::ostream& os, size_t max_statements)
+{
+   std::vector<SqlStmtStats> stats(getStats_());
+
+   SqlStmtStats total = SqlStmtStats();
+   for (auto i(stats.begin()), end(stats.end()); i != end; ++i)
+   {
+      total.prepares += i->prepares;
+      total.prepare_ms += i->prepare_ms;
+      total.executions += i->executions;
+      total.errors += i->errors;
+      total.rows += i->rows;
+      total.total_ms += i->total_ms;
+      total.cache_hits += i->cache_hits;
+      total.cache_misses += i->cache_misses;
+      total.cache_evictions += i->cache_evictions;
+   }
+
+   uint64_t holds = total.cache_hits + total.cache_misses;
+
+   os << std::fixed << std::setprecision(3)
+      << "SQL profile: " << stats.size() << " statements, "
+      << total.executions << " executions (" << total.errors << " failed), "
+      << total.rows << " rows, " << total.total_ms << " ms executing, "
+      << total.prepares << " prepares, " << total.prepare_ms << " ms preparing\n"
+      << "StmtCache: " << total.cache_hits << " hits, "
+      << total.cache_misses << " misses, "
+      << total.cache_evictions << " evictions";
+
+   if (holds > 0)
+      os << std::setprecision(1) << " (" << 100.0 * total.cache_hits / holds << "% hits)";
+
+   os << '\n' << std::setprecision(3)
+      << std::setw(10) << "Execs" << std::setw(12) << "Total ms"
+      << std::setw(10) << "p99 ms" << std::setw(10) << "Max ms"
+      << std::setw(10) << "Rows" << std::setw(9) << "Prepares"
+      << std::setw(9) << "Hits" << std::setw(9) << "Misses"
+      << std::setw(9) << "Evicted" << "  Statement";
+
+   size_t count = std::min(stats.size(), max_statements);
+   for (size_t i = 0; i < count; ++i)
+   {
+      const SqlStmtStats& s = stats[i];
+
+      // collapse whitespace so that each statement fits on one line
+      std::string sql;
+      for (auto c(s.sql.begin()), end(s.sql.end()); c != end && sql.length() < 80; ++c)
+      {
+         if (*c == ' ' || *c == '\t' || *c == '\r' || *c == '\n')
+         {
+            if (!sql.empty() && sql[sql.length() - 1] != ' ')
+               sql.push_back(' ');
+         }
+         else
+            sql.push_back(*c);
+      }
+
+      os << '\n'
+         << std::setw(10) << s.executions << std::setw(12) << s.total_ms
+         << std::setw(10) << s.p99_ms << std::setw(10) << s.max_ms
+         << std::setw(10) << s.rows << std::setw(9) << s.prepares
+         << std::setw(9) << s.cache_hits << std::setw(9) << s.cache_misses
+         << std::setw(9) << s.cache_evictions << "  " << s.id << ' ' << sql;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Estimates the number of profiling ticks per millisecond.
+/// \details The estimate is more accurate the longer the profiler has
+///         existed, so if it was created very recently this waits until at
+///         least 10 ms have passed.
+double SqlProfiler::ticksPerMs_() const
+{
+   std::chrono::steady_clock::time_point time;
+   while ((time = std::chrono::steady_clock::now()) - origin_time_ < std::chrono::milliseconds(10))
+      std::this_thread::yield();
+
+   uint64_t ticks = be::detail::getProfileTicks();
+   return (ticks - origin_ticks_) / std::chrono::duration<double, std::milli>(time - origin_time_).count();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Determines whether a periodic report should be logged now.
+/// \details If so, the next report will be logged one interval from now.
+///
+/// \note   The SqlProfiler mutex must be locked before calling this function!
+bool SqlProfiler::checkLogInterval_()
+{
+   if (log_interval_.count() <= 0)
+      return false;
+
+   std::chrono::steady_clock::time_point now(std::chrono::steady_clock::now());
+   if (now < next_log_time_)
+      return false;
+
+   next_log_time_ = now + log_interval_;
+   return true;
+}
+
+} // namespace be::bed
+} // namespace be
@@ -26,6 +26,9 @@
 
 #include "be/bed/stmt.h"
 
+#include "be/bed/sql_profiler.h"
+#include "be/profiler.h"
+
 namespace be {
 namespace bed {
    
@@ -40,10 +43,13 @@ namespace bed {
 /// \param  sql The SQL text of the statement to compile.
 Stmt::Stmt(Db& db, const std::string &sql)
    : db_(db),
-     id_(sql)
+     id_(sql),
+     execution_(0),
+     profiling_(false),
+     profile_ticks_(0),
+     profile_rows_(0)
 {
-   if (sqlite3_prepare_v2(db.db_, sql.c_str(), sql.length() + 1, &stmt_, nullptr) != SQLITE_OK)
-      throw Db::error(sqlite3_errmsg(db.db_), sql.c_str());
+   prepare_(sql);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -55,10 +61,13 @@ Stmt::Stmt(Db& db, const std::string &sql)
 /// \param  sql The SQL text of the statement to compile.
 Stmt::Stmt(Db& db, const Id& id, const std::string &sql)
    : db_(db),
-     id_(id)
+     id_(id),
+     execution_(0),
+     profiling_(false),
+     profile_ticks_(0),
+     profile_rows_(0)
 {
-   if (sqlite3_prepare_v2(db.db_, sql.c_str(), sql.length() + 1, &stmt_, nullptr) != SQLITE_OK)
-      throw Db::error(sqlite3_errmsg(db.db_), sql.c_str());
+   prepare_(sql);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -69,6 +78,9 @@ Stmt::Stmt(Db& db, const Id& id, const std::string &sql)
 ///         may result in an assertion failure.
 Stmt::~Stmt()
 {
+   if (profiling_)
+      recordProfile_(false);
+
    sqlite3_finalize(stmt_);
 }
 
@@ -295,11 +307,31 @@ void Stmt::bindBlob_s(int parameter, const void* value, int length)
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  Executes the statement.
 ///
+/// \details If a SqlProfiler exists, the time spent in each call and the
+///         number of rows returned are recorded.  The execution is reported
+///         to the profiler when it is done, or when reset() is called.
+///
 /// \return \c true if a result set was returned and there is a row available.
 bool Stmt::step()
 {
+   uint64_t begin = detail::sql_profiler_active.load(std::memory_order_relaxed) ? be::detail::getProfileTicks() : 0;
+
+   // SQLite may re-prepare the statement when a new execution begins, so
+   // column Ids must be verified again before they are trusted.
+   if (!sqlite3_stmt_busy(stmt_))
+      ++execution_;
+
    int result = sqlite3_step(stmt_);
-   col_names_.reset();
+
+   if (begin != 0)
+   {
+      profiling_ = true;
+      profile_ticks_ += be::detail::getProfileTicks() - begin;
+      if (result == SQLITE_ROW)
+         ++profile_rows_;
+      else
+         recordProfile_(result != SQLITE_DONE);
+   }
 
    if (result == SQLITE_DONE)
       return false;
@@ -319,6 +351,9 @@ bool Stmt::step()
 ///         executed again.
 void Stmt::reset()
 {
+   if (profiling_)
+      recordProfile_(false);
+
    sqlite3_reset(stmt_);
 }
 
@@ -334,24 +369,105 @@ int Stmt::columns()
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  Returns the column index of the column with the specified name.
 /// 
-/// \note   This is __much__ slower than specifying column indices directly.
+/// \note   This is slower than column(const Id&) since the name must be
+///         hashed on every call.  Prefer that overload in loops.
 ///
 /// \param  name The name of the column we are interested in.
 /// \return The index of the column with the specified name.
 int Stmt::column(const std::string& name)
 {
-   if (!col_names_)
+   int index = findColumn_(Id(be::detail::fnv1aIterative(name.c_str())));
+   if (index < 0)
+      throw Db::error(std::string("Column '").append(name).append("' not found!"), sqlite3_sql(stmt_));
+   return index;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the column index of the column whose name hashes to the
+///         specified Id.
+///
+/// \details The first lookup builds a flat array of the hashed names of each
+///         result column, which is kept for the life of the statement.  Later
+///         lookups are a linear scan comparing 64-bit values; nothing is
+///         allocated, and a column's name is only hashed again the first
+///         time it is found during each execution.  Loaders which address
+///         columns by name can hold the Ids (e.g. in \c static \c const
+///         variables) to make lookups as cheap as possible.
+///
+/// \param  name The Id of the name of the column we are interested in.
+/// \return The index of the column with the specified name.
+int Stmt::column(const Id& name)
+{
+   int index = findColumn_(name);
+   if (index < 0)
+      throw Db::error(std::string("Column '").append(name.to_string()).append("' not found!"), sqlite3_sql(stmt_));
+   return index;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Searches for a column by the Id of its name.
+///
+/// \details The array of column Ids is built on the first lookup and kept
+///         across executions.  If SQLite re-prepares the statement after a
+///         schema change (e.g. a table used by a <tt>SELECT *</tt> was
+///         dropped and recreated), its result columns may be different, so
+///         the array is rebuilt if the number of result columns has changed,
+///         if the name of the column found no longer hashes to \c name (which
+///         is checked once per column per execution), or before reporting
+///         that no column matches.  Names are hashed in place, without
+///         constructing strings.
+///
+/// \param  name The Id of the column name to find.
+/// \return The index of the first column with that name, or -1 if there is
+///         no such column.
+int Stmt::findColumn_(const Id& name)
+{
+   int cols = columns();
+   bool rebuilt = false;
+   if (col_ids_.size() != size_t(cols))
    {
-      col_names_.reset(new std::unordered_map<std::string, int>());
-      int cols = columns();
-      for (int i = 0; i < cols; ++i)
-         col_names_->insert(std::pair<std::string,int>(sqlite3_column_name(stmt_, i), i));
+      buildColumnIds_();
+      rebuilt = true;
    }
 
-   std::unordered_map<std::string, int>::iterator it = col_names_->find(name);
-   if (it != col_names_->end())
-      return it->second;
-   throw Db::error(std::string("Column '").append(name).append("' not found!"), sqlite3_sql(stmt_));
+   for (;;)
+   {
+      for (size_t i = 0, n = col_ids_.size(); i < n; ++i)
+      {
+         if (col_ids_[i] == name)
+         {
+            if (col_checked_[i] == execution_)
+               return int(i);
+
+            if (Id(be::detail::fnv1aIterative(sqlite3_column_name(stmt_, int(i)))) == name)
+            {
+               col_checked_[i] = execution_;
+               return int(i);
+            }
+
+            break;   // the statement was re-prepared with different columns
+         }
+      }
+
+      if (rebuilt)
+         return -1;
+
+      buildColumnIds_();
+      rebuilt = true;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Hashes the name of each result column into col_ids_.
+void Stmt::buildColumnIds_()
+{
+   int cols = columns();
+   col_ids_.clear();
+   col_ids_.reserve(cols);
+   for (int i = 0; i < cols; ++i)
+      col_ids_.push_back(Id(be::detail::fnv1aIterative(sqlite3_column_name(stmt_, i))));
+
+   col_checked_.assign(cols, execution_);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -494,5 +610,49 @@ std::ostream& operator<<(std::ostream& os, const Stmt& s)
    return os << s.getSql();
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compiles the SQL text provided.
+///
+/// \details If a SqlProfiler exists, the time taken is recorded.
+///
+/// \param  sql The SQL text of the statement to compile.
+void Stmt::prepare_(const std::string& sql)
+{
+   uint64_t begin = detail::sql_profiler_active.load(std::memory_order_relaxed) ? be::detail::getProfileTicks() : 0;
+
+   if (sqlite3_prepare_v2(db_.db_, sql.c_str(), sql.length() + 1, &stmt_, nullptr) != SQLITE_OK)
+      throw Db::error(sqlite3_errmsg(db_.db_), sql.c_str());
+
+   if (begin != 0)
+      detail::recordSqlPrepare(id_, sql.c_str(), be::detail::getProfileTicks() - begin);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Throws the error reported by a failed sqlite3_bind_*() call.
+/// \details ColumnTraits may reject a value without calling sqlite, in which
+///         case the connection's error message is unrelated to \c result.
+///
+/// \param  result The value returned by sqlite3_bind_*().
+void Stmt::throwBindError_(int result)
+{
+   const char* message = sqlite3_errcode(db_.db_) == result ? sqlite3_errmsg(db_.db_) : sqlite3_errstr(result);
+   throw Db::error(message, sqlite3_sql(stmt_));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reports the execution that just ended to the SqlProfiler.
+///
+/// \param  failed \c true if the execution ended with an error.
+void Stmt::recordProfile_(bool failed)
+{
+   uint64_t ticks = profile_ticks_;
+   uint64_t rows = profile_rows_;
+   profiling_ = false;
+   profile_ticks_ = 0;
+   profile_rows_ = 0;
+
+   detail::recordSqlExecution(id_, sqlite3_sql(stmt_), ticks, rows, failed);
+}
+
 } // namespace be::bed
 } // namespace be
@@ -26,9 +26,11 @@
 
 #include "be/bed/stmt_cache.h"
 
+#include "be/bed/sql_profiler.h"
 #include "be/bed/stmt.h"
 
 #include <iostream>
+#include <sstream>
 
 namespace be {
 namespace bed {
@@ -41,9 +43,11 @@ namespace bed {
 StmtCache::StmtCache(Db& db)
    : db_(db),
      capacity_(BE_BED_STMT_CACHE_DEFAULT_MAX_SIZE),
+     size_(0),
      held_size_(0),
-     next_index_(1),
-     oldest_index_(1)
+     hits_(0),
+     misses_(0),
+     evictions_(0)
 {
 }
 
@@ -56,9 +60,11 @@ StmtCache::StmtCache(Db& db)
 StmtCache::StmtCache(Db& db, size_t capacity)
    : db_(db),
      capacity_(capacity),
+     size_(0),
      held_size_(0),
-     next_index_(1),
-     oldest_index_(1)
+     hits_(0),
+     misses_(0),
+     evictions_(0)
 {
 }
 
@@ -73,21 +79,31 @@ StmtCache::~StmtCache()
 {
    if (held_size_ > 0)
    {
-      BE_LOG(VWarning) << "StmtCache being destroyed with held statement(s)!" << BE_LOG_NL
-                       << "     Held Size: " << held_size_;
+      std::ostringstream held;
 
 #ifdef DEBUG
       int index = 1;
-      for (auto i(cache_.begin()), end(cache_.end()); i != end; ++i)
-      {
-         detail::StmtCacheEntry& entry = i->second;
-
-         if (entry.held)
-            BE_LOG_STREAM << BE_LOG_NL << "Held Stmt " << index++ << " ID: " << entry.stmt->getId();
-      }
+      for (detail::StmtCacheEntry* entry = held_.next; entry != &held_; entry = entry->next)
+         held << BE_LOG_NL << "Held Stmt " << index++ << " ID: " << entry->stmt->getId();
 #endif
 
-      BE_LOG_STREAM << BE_LOG_END;
+      BE_LOG(VWarning) << "StmtCache being destroyed with held statement(s)!" << BE_LOG_NL
+                       << "     Held Size: " << held_size_
+                       << held.str() << BE_LOG_END;
+   }
+
+   while (held_.next != &held_)
+   {
+      detail::StmtCacheEntry* entry = held_.next;
+      entry->unlink();
+      delete entry;
+   }
+
+   while (unheld_.next != &unheld_)
+   {
+      detail::StmtCacheEntry* entry = unheld_.next;
+      entry->unlink();
+      delete entry;
    }
 }
 
@@ -129,7 +145,7 @@ size_t StmtCache::getSize()
    // lock mutex
    std::lock_guard<std::mutex> lock(mutex_);
 
-   return cache_.size();
+   return size_;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -144,6 +160,45 @@ size_t StmtCache::getHeldSize()
    return held_size_;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the number of hold() calls which returned a statement
+///         that was already compiled.
+///
+/// \return The number of cache hits since the cache was created.
+uint64_t StmtCache::getHitCount()
+{
+   // lock mutex
+   std::lock_guard<std::mutex> lock(mutex_);
+
+   return hits_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the number of hold() calls which compiled a new
+///         statement.
+///
+/// \return The number of cache misses since the cache was created.
+uint64_t StmtCache::getMissCount()
+{
+   // lock mutex
+   std::lock_guard<std::mutex> lock(mutex_);
+
+   return misses_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the number of unheld statements which have been
+///         destroyed to keep the cache within its capacity.
+///
+/// \return The number of evictions since the cache was created.
+uint64_t StmtCache::getEvictionCount()
+{
+   // lock mutex
+   std::lock_guard<std::mutex> lock(mutex_);
+
+   return evictions_;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  Holds a statement using the provided SQL and an Id generated by
 ///         hashing the SQL text.
@@ -215,38 +270,41 @@ CachedStmt StmtCache::hold(const Id& id, const char* sql)
 {
    // First check to see if there's an existing unheld statement we can use
    std::unique_lock<std::mutex> lock(mutex_);
-   if (held_size_ < cache_.size())
+   auto i(unheld_ids_.find(id));
+   if (i != unheld_ids_.end() && i->second)
    {
-      // it only makes sense to check for a specific unheld statement
-      // if there is at least one unheld statement in the cache.
+      detail::StmtCacheEntry& entry = *i->second;
+      unlinkId_(entry, i->second);
+      hold_(entry);
+      ++hits_;
+      lock.unlock();
 
-      auto range(cache_.equal_range(id));
+      if (detail::sql_profiler_active.load(std::memory_order_relaxed))
+         detail::recordSqlCacheHold(id, true);
 
-      for (auto i(range.first); i != range.second; ++i)
-      {
-         detail::StmtCacheEntry& entry = i->second;
-
-         if (!entry.held)
-         {
-            hold_(entry);
-            return CachedStmt(this, *entry.stmt);
-         }
-      }
+      return CachedStmt(this, entry);
    }
+   ++misses_;
    lock.unlock(); // unlock mutex while SQL compiles
 
+   if (detail::sql_profiler_active.load(std::memory_order_relaxed))
+      detail::recordSqlCacheHold(id, false);
+
    // If not, release the mutex lock and construct a new statement
    // SQL statement compilation can be an expensive operation, so
    // we don't want to prevent other threads from accessing the cache
    // while SQLite is doing its thing.
-   Stmt* stmt = new Stmt(db_, id, sql);
+   std::unique_ptr<Stmt> stmt(new Stmt(db_, id, sql));
+   detail::StmtCacheEntry* entry = new detail::StmtCacheEntry(stmt.get());
+   stmt.release();
 
    // re-lock mutex and insert the new statement object
    lock.lock();
-   hold_(cache_.insert(std::make_pair(id, detail::StmtCacheEntry(stmt)))->second);
+   ++size_;
+   hold_(*entry);
    checkSize_();
 
-   return CachedStmt(this, *stmt);
+   return CachedStmt(this, *entry);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -256,53 +314,70 @@ CachedStmt StmtCache::hold(const Id& id, const char* sql)
 ///         restore its original state.  After being released, the statement
 ///         may be returned by future calls to hold().
 ///
-/// \param  stmt The statement to release.
-void StmtCache::release_(Stmt& stmt)
+/// \param  entry The entry of the statement to release.
+void StmtCache::release_(detail::StmtCacheEntry& entry)
 {
-   const Id& id = stmt.getId();
+   Stmt& stmt = *entry.stmt;
    stmt.reset(); // ensure statement is in a clean state
    stmt.bind();  // release any bound parameters
 
-   {
-      std::lock_guard<std::mutex> lock(mutex_);
-      auto range(cache_.equal_range(id));
-
-      for (auto i(range.first); i != range.second; ++i)
-      {
-         detail::StmtCacheEntry& entry = i->second;
-
-         if (entry.stmt.get() == &stmt && entry.held)
-         {
-            entry.held = false;
-            --held_size_;
-            checkSize_();
-            return;
-         }
-      }
-   }
+   std::lock_guard<std::mutex> lock(mutex_);
+   if (!entry.held)
+      return;
+
+   entry.held = false;
+   --held_size_;
+
+   // the most recently released entry goes at the end of the unheld list,
+   // and at the front of the list of unheld entries with the same Id.
+   entry.unlink();
+   entry.link(unheld_);
+
+   detail::StmtCacheEntry*& head = unheld_ids_[stmt.getId()];
+   entry.id_prev = nullptr;
+   entry.id_next = head;
+   if (head)
+      head->id_prev = &entry;
+   head = &entry;
+
+   checkSize_();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-/// \brief  Helper function to hold an existing entry in the cache.
+/// \brief  Helper function to hold an entry in the cache.
 ///
 /// \note   StmtCache::mutex_ must be locked before calling this function!
 ///
-/// \param  entry A reference to an entry owned by StmtCache::cache_.
+/// \param  entry A reference to a new entry, or an unheld entry which has
+///         already been removed from StmtCache::unheld_ids_.
 void StmtCache::hold_(detail::StmtCacheEntry& entry)
 {
    entry.held = true;
-   entry.access_index = next_index_++;
+   entry.unlink();
+   entry.link(held_);
    ++held_size_;
+}
 
-   if (next_index_ == 0)
-   {
-      // when next_index_ overflows, set all held access indices to 0
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Helper function to remove an unheld entry from the list of unheld
+///         entries with the same Id.
+///
+/// \note   StmtCache::mutex_ must be locked before calling this function!
+///
+/// \param  entry A reference to an unheld entry.
+/// \param  head The StmtCache::unheld_ids_ value for the entry's Id.
+void StmtCache::unlinkId_(detail::StmtCacheEntry& entry, detail::StmtCacheEntry*& head)
+{
+   if (entry.id_next)
+      entry.id_next->id_prev = entry.id_prev;
 
-      next_index_ = 1;
-      oldest_index_ = 1;
-      for (auto i(cache_.begin()), end(cache_.end()); i != end; ++i)
-         i->second.access_index = 0;
-   }
+   if (entry.id_prev)
+      entry.id_prev->id_next = entry.id_next;
+   else
+      head = entry.id_next;
+
+   entry.id_prev = nullptr;
+   entry.id_next = nullptr;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -311,51 +386,24 @@ void StmtCache::hold_(detail::StmtCacheEntry& entry)
 /// \note   StmtCache::mutex_ must be locked before calling this function!
 void StmtCache::checkSize_()
 {
-   while (cache_.size() > capacity_ && held_size_ < cache_.size())
+   // remove the least recently released entry until size <= capacity or
+   // there are no unheld entries.
+   while (size_ > capacity_ && unheld_.next != &unheld_)
    {
-      // remove the oldest entry
-      size_t oldest_index = 0;
-      auto oldest = cache_.end();
-
-      for (auto i(cache_.begin()), end(cache_.end()); i != end; ++i)
-      {
-         detail::StmtCacheEntry& entry = i->second;
-
-         if (!entry.held)
-         {
-            if (entry.access_index == 0)
-            {
-               // if this entry is older than the last overflow of next_index_
-               // then we can remove it.
-               cache_.erase(i);
-               oldest_index = 0; // don't call erase(oldest) at end of while()
-               break;
-            }
-
-            if (entry.access_index == oldest_index_)
-            {
-               // if we know this entry is the oldest, theres no point in looking
-               // at any further entries.
-               oldest_index = oldest_index_;
-               oldest = i; // we will remove this at end of while()
-               break;
-            }
-
-            // if we get here, check to see if this entry is older than 'oldest'
-            if (entry.access_index < oldest_index || oldest_index == 0)
-            {
-               oldest_index = entry.access_index;
-               oldest = i; // we will remove this at end of while()
-            }
-         }
-      }
-
-      if (oldest_index > 0)
-      {
-         oldest_index_ = oldest_index + 1;
-         cache_.erase(oldest);
-      }
-   } // remove oldest unheld entry until size < max size or there are no unheld entries.
+      detail::StmtCacheEntry* oldest = unheld_.next;
+      auto i(unheld_ids_.find(oldest->stmt->getId()));
+      unlinkId_(*oldest, i->second);
+      if (!i->second)
+         unheld_ids_.erase(i);
+
+      if (detail::sql_profiler_active.load(std::memory_order_relaxed))
+         detail::recordSqlCacheEviction(oldest->stmt->getId());
+
+      oldest->unlink();
+      delete oldest;
+      --size_;
+      ++evictions_;
+   }
 }
 
 } // namespace be::bed
@@ -40,23 +40,65 @@ namespace {
 
 #ifdef BE_ID_NAMES_ENABLED
 
-// Retrieves a map of Id values to strings used to generate them.
-std::unordered_map<uint64_t, std::string>& getNames()
+// The name registry is split into 2^names_shard_bits shards, each with its
+// own lock, so that threads hashing unrelated names rarely contend.
+const int names_shard_bits = 6;
+
+// One shard of the map of Id values to strings used to generate them.
+struct NamesShard
 {
-   static std::unordered_map<uint64_t, std::string> names;
-   return names;
+   std::mutex mutex;
+   std::unordered_map<uint64_t, std::string> names;
+};
+
+// Defined at namespace scope rather than as a function-local static so that
+// it is constructed before any thread can register a name; VC11 does not
+// initialize function-local statics in a thread-safe way.
+NamesShard names_shards[1 << names_shard_bits];
+
+// Retrieves the shard responsible for the provided Id value.  The shard is
+// selected using the high bits of the value, since unordered_map uses the
+// low bits to select buckets.
+NamesShard& getNamesShard(uint64_t id)
+{
+   return names_shards[id >> (64 - names_shard_bits)];
 }
 
-// Retrieves a mutex that protects the map above.
-std::mutex& getNamesMutex()
+// Remembers the name used to generate an Id, or emits a warning if a
+// different name has already been recorded for it.
+template <typename S>
+void registerName(uint64_t hash, const S& name)
 {
-   static std::mutex mutex;
-   return mutex;
+   NamesShard& shard = getNamesShard(hash);
+   std::string existing;
+   {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      auto i(shard.names.find(hash));
+      if (i == shard.names.end())
+      {
+         // Save this name/hash for future checks
+         shard.names.insert(std::make_pair(hash, std::string(name)));
+         return;
+      }
+
+      // Check for collision with any previously hashed name
+      if (i->second == name)
+         return;
+
+      existing = i->second;
+   }
+
+   // Hash collision: Print a warning
+   std::ostringstream oss;
+   oss << "ID hash collision detected!" << BE_LOG_NL
+       << "    Hash: " << std::hex << std::setfill('0') << std::setw(16) << hash << BE_LOG_NL
+       << "Existing: " << existing << BE_LOG_NL
+       << " Current: " << name << BE_LOG_END;
+   BE_LOG(VNotice) << oss.str();
 }
 
 #endif // BE_ID_NAMES_ENABLED
 
-
 // Calculates 64-bit FNV-1a hash of provided name.
 uint64_t hash(const std::string& name)
 {
@@ -65,55 +107,35 @@ uint64_t hash(const std::string& name)
       hash = (hash ^ static_cast<uint8_t>(*i)) * BE_ID_FNV_PRIME;
 
 #ifdef BE_ID_NAMES_ENABLED
-   std::unordered_map<uint64_t, std::string>& names = getNames();
-   std::mutex& mutex = getNamesMutex();
-   std::lock_guard<std::mutex> lock(mutex);
-   auto i(names.find(hash));
-   if (i != names.end())
-   {
-      // Check for collision with any previously hashed name
-      if (i->second != name)
-      {
-         // Hash collision: Print a warning
-         std::ostringstream oss;
-         oss << "ID hash collision detected!" << BE_LOG_NL
-             << "    Hash: " << std::hex << std::setfill('0') << std::setw(16) << hash << BE_LOG_NL
-             << "Existing: " << i->second << BE_LOG_NL
-             << " Current: " << name << BE_LOG_END;
-         BE_LOG(VNotice) << oss;
-      }
-   }
-   else
-   {
-      // Save this name/hash for future checks
-      names[hash] = name;          
-   }
-#endif // BE_ID_NAMES_ENABLED
+   registerName(hash, name);
+#endif
 
    return hash;
 }
 
 } // namespace be::(annon)
 
+#ifdef BE_ID_NAMES_ENABLED
+namespace detail {
 
 ///////////////////////////////////////////////////////////////////////////////
-/// \brief  Constructs a new Id object which has the same value as if it were 
-///         constructed from a zero-length string.
-Id::Id()
-   : id_(BE_ID_FNV_OFFSET_BASIS)
-{
-}
-
-///////////////////////////////////////////////////////////////////////////////
-/// \brief  Constructs a new Id object which has the exact integer value
-///         specified.
+/// \brief  Remembers the string used to generate an Id's value.
 ///
-/// \param  id The numeric value for the new Id.
-Id::Id(uint64_t id)
-   : id_(id)
+/// \details Used by Ids constructed from string literals.  The name is only
+///         copied if no name has been recorded for the Id yet.  A notice is
+///         logged if a different name has already been recorded.
+///
+/// \param  id The hashed value of \c name.
+/// \param  name The null-terminated string that was hashed.
+void registerIdName(uint64_t id, const char* name)
 {
+   registerName(id, name);
 }
 
+} // namespace be::detail
+#endif
+
+
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  Constructs a new Id object by hashing a string value.
 ///
@@ -126,27 +148,6 @@ Id::Id(const std::string& name)
 {
 }
 
-///////////////////////////////////////////////////////////////////////////////
-/// \brief  Constructs a new Id object which has the same value as an existing
-///         Id. (copy constructor)
-///
-/// \param  other The Id whose value we will copy.
-Id::Id(const Id& other)
-   : id_(other.id_)
-{
-}
-
-///////////////////////////////////////////////////////////////////////////////
-/// \brief  Assigns an Id the same value as another Id object.
-///
-/// \param  other The Id whose value we will copy.
-/// \return *this
-Id& Id::operator=(const Id& other)
-{
-   id_ = other.id_;
-   return *this;
-}
-
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  Returns a string representation of this Id.
 ///
@@ -180,90 +181,16 @@ std::string Id::to_string() const
    oss << '#' << std::hex << std::setfill('0') << std::setw(16) << id_;
 
 #ifdef BE_ID_NAMES_ENABLED
-   std::unordered_map<uint64_t, std::string>& names = getNames();
-   std::mutex& mutex = getNamesMutex();
-   std::lock_guard<std::mutex> lock(mutex);
-   auto i(names.find(id_));
-   if (i != names.end())
+   NamesShard& shard = getNamesShard(id_);
+   std::lock_guard<std::mutex> lock(shard.mutex);
+   auto i(shard.names.find(id_));
+   if (i != shard.names.end())
       oss << ':' << i->second;
 #endif
 
    return oss.str();
 }
 
-///////////////////////////////////////////////////////////////////////////////
-/// \brief  Retrieves the numeric value of this object.
-///
-/// \return The 64-bit numeric value of this Id. 
-uint64_t Id::value() const
-{
-   return id_;
-}
-
-///////////////////////////////////////////////////////////////////////////////
-/// \brief  Compares this Id with another to see if they have the same value.
-///
-/// \param  other The Id to compate to this one.
-/// \return \c true if both Ids have the same numeric value.
-bool Id::operator==(const Id& other) const
-{
-   return id_ == other.id_;
-}
-
-///////////////////////////////////////////////////////////////////////////////
-/// \brief  Compares this Id with another to see if they have different values.
-///
-/// \param  other The Id to compate to this one.
-/// \return \c true if the Ids have different numeric values.
-bool Id::operator!=(const Id& other) const
-{
-   return id_ != other.id_;
-}
-
-///////////////////////////////////////////////////////////////////////////////
-/// \brief  Compares this Id with another to see if it has a smaller value
-///         than the other.
-///
-/// \param  other The Id to compate to this one.
-/// \return \c true if this Id's numeric value is less than other's.
-bool Id::operator<(const Id& other) const
-{
-   return id_ < other.id_;
-}
-
-///////////////////////////////////////////////////////////////////////////////
-/// \brief  Compares this Id with another to see if it has a larger value
-///         than the other.
-///
-/// \param  other The Id to compate to this one.
-/// \return \c true if this Id's numeric value is greater than other's.
-bool Id::operator>(const Id& other) const
-{
-   return id_ > other.id_;
-}
-
-///////////////////////////////////////////////////////////////////////////////
-/// \brief  Compares this Id with another to see if its value is not larger
-///         than other's.
-///
-/// \param  other The Id to compate to this one.
-/// \return \c true if this Id's numeric value is not larger than other's.
-bool Id::operator<=(const Id& other) const
-{
-   return id_ <= other.id_;
-}
-
-///////////////////////////////////////////////////////////////////////////////
-/// \brief  Compares this Id with another to see if its value is not smaller
-///         than other's.
-///
-/// \param  other The Id to compate to this one.
-/// \return \c true if this Id's numeric value is not smaller than other's.
-bool Id::operator>=(const Id& other) const
-{
-   return id_ >= other.id_;
-}
-
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  Outputs a string representation of an Id object to the provided
 ///         stream.
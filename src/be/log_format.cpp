@@ -0,0 +1,189 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/log_format.cpp
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of helpers shared by the text and binary log
+///         formats.
+
+#include "be/detail/log_format.h"
+#include "be/id.h"
+
+#include <sstream>
+#include <stdexcept>
+
+namespace be {
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs an empty LogTimeCache.
+LogTimeCache::LogTimeCache()
+   : time(0)
+{
+   text[0] = '\0';
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends the prefix which starts each line of a text log.
+/// \details The format is the same as #BE_LOG:
+///         <tt>"YYYY-MM-DD HH:MM:SS file.cpp(line) Level: "</tt>.  The time
+///         is only reformatted when it differs from the last time formatted
+///         with the same cache.
+/// \param  out The string to append to.
+/// \param  cache Holds the most recently formatted time.
+/// \param  time The time the message was logged.
+/// \param  file The source file which logged the message.
+/// \param  file_length The length of the file name.
+/// \param  line The line number which logged the message.
+/// \param  level The verbosity level of the message.
+void appendLogPrefix(std::string& out, LogTimeCache& cache, std::time_t time, const char* file, size_t file_length, int line, int level)
+{
+   if (time != cache.time || cache.text[0] == '\0')
+   {
+#ifdef _MSC_VER
+      tm local_;
+      localtime_s(&local_, &time);
+      tm* local = &local_;
+#else
+      tm* local = localtime(&time);
+#endif
+      strftime(cache.text, sizeof(cache.text), "%Y-%m-%d %H:%M:%S", local);
+      cache.time = time;
+   }
+
+   out.append(cache.text);
+   out.push_back(' ');
+   out.append(file, file_length);
+   out.push_back('(');
+
+   char digits[16];
+   char* end = digits + sizeof(digits);
+   char* begin = end;
+   unsigned int n = static_cast<unsigned int>(line);
+   do
+   {
+      *--begin = static_cast<char>('0' + n % 10);
+      n /= 10;
+   } while (n > 0);
+   out.append(begin, end);
+
+   out.append(") ");
+   out.append(getVerbosityLevel(level));
+   out.append(": ");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Converts the values of a binary log message to text.
+/// \details The text is the same as would have been written to a text log,
+///         except that Ids are rendered using the names known to this
+///         process (if Id names are enabled).
+/// \param  data The first byte of the message's values.
+/// \param  size The number of bytes of values.
+/// \param  strings The string table, used for \c LogValueStringRef values.
+/// \param  out The string to append to.
+/// \throws std::runtime_error if the values are malformed.
+void renderLogValues(const char* data, size_t size, const std::vector<std::string>& strings, std::string& out)
+{
+   const char* end = data + size;
+   std::ostringstream oss;
+
+   while (data < end)
+   {
+      char type = *data++;
+      size_t remaining = end - data;
+
+      switch (type)
+      {
+         case LogValueSigned:
+         case LogValueUnsigned:
+         case LogValueFloat:
+         case LogValueId:
+         {
+            if (remaining < 8)
+               throw std::runtime_error("Malformed log message!");
+
+            oss.str(std::string());
+            if (type == LogValueSigned)
+               oss << readLogBytes<int64_t>(data);
+            else if (type == LogValueUnsigned)
+               oss << readLogBytes<uint64_t>(data);
+            else if (type == LogValueFloat)
+               oss << readLogBytes<double>(data);
+            else
+               oss << Id(readLogBytes<uint64_t>(data));
+
+            out.append(oss.str());
+            data += 8;
+            break;
+         }
+
+         case LogValueChar:
+         case LogValueBool:
+            if (remaining < 1)
+               throw std::runtime_error("Malformed log message!");
+
+            if (type == LogValueChar)
+               out.push_back(*data);
+            else
+               out.push_back(*data ? '1' : '0');
+
+            ++data;
+            break;
+
+         case LogValueText:
+         case LogValueCString:
+         {
+            if (remaining < 4)
+               throw std::runtime_error("Malformed log message!");
+
+            uint32_t length = readLogBytes<uint32_t>(data);
+            data += 4;
+            if (length > remaining - 4)
+               throw std::runtime_error("Malformed log message!");
+
+            out.append(data, length);
+            data += length;
+            break;
+         }
+
+         case LogValueStringRef:
+         {
+            if (remaining < 4)
+               throw std::runtime_error("Malformed log message!");
+
+            uint32_t index = readLogBytes<uint32_t>(data);
+            data += 4;
+            if (index >= strings.size())
+               throw std::runtime_error("Log message references undefined string!");
+
+            out.append(strings[index]);
+            break;
+         }
+
+         default:
+            throw std::runtime_error("Unknown log value type!");
+      }
+   }
+}
+
+} // namespace be::detail
+} // namespace be
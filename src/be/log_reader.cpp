@@ -0,0 +1,123 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/log_reader.cpp
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of be::LogReader functions.
+
+#include "be/log_reader.h"
+
+#include <stdexcept>
+
+namespace be {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads the header of a binary log.
+/// \param  input The stream to read from.  It should have been opened in
+///         binary mode.
+/// \throws std::runtime_error if the stream does not contain a binary log
+///         or the log was written by a newer version of bengine.
+LogReader::LogReader(std::istream& input)
+   : input_(input)
+{
+   char header[detail::log_header_size];
+   if (!readBytes_(header, sizeof(header)) || memcmp(header, "BELOG", 5) != 0)
+      throw std::runtime_error("Not a binary log!");
+
+   if (header[5] > detail::log_format_version)
+      throw std::runtime_error("Unsupported binary log version!");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads the next message from the log.
+/// \details If the log ends in the middle of a record (eg. because the
+///         process that wrote it crashed) the incomplete record is ignored.
+/// \param  message Receives the message, in the same format as a text log,
+///         including the trailing newline.
+/// \return \c false if there are no more messages in the log.
+/// \throws std::runtime_error if the log is corrupt.
+bool LogReader::read(std::string& message)
+{
+   char type;
+   while (readBytes_(&type, 1))
+   {
+      if (type == detail::LogRecordString)
+      {
+         char header[8];
+         if (!readBytes_(header, sizeof(header)))
+            return false;
+
+         uint32_t index = detail::readLogBytes<uint32_t>(header);
+         uint32_t length = detail::readLogBytes<uint32_t>(header + 4);
+         if (index != strings_.size())
+            throw std::runtime_error("Binary log string table is corrupt!");
+
+         values_.resize(length);
+         if (length > 0 && !readBytes_(&values_[0], length))
+            return false;
+
+         strings_.push_back(values_);
+      }
+      else if (type == detail::LogRecordMessage)
+      {
+         char header[24];
+         if (!readBytes_(header, sizeof(header)))
+            return false;
+
+         int64_t time = detail::readLogBytes<int64_t>(header);
+         int level = static_cast<int>(detail::readLogBytes<uint32_t>(header + 8));
+         uint32_t file = detail::readLogBytes<uint32_t>(header + 12);
+         int line = static_cast<int>(detail::readLogBytes<uint32_t>(header + 16));
+         uint32_t size = detail::readLogBytes<uint32_t>(header + 20);
+
+         if (file >= strings_.size())
+            throw std::runtime_error("Log message references undefined string!");
+
+         values_.resize(size);
+         if (size > 0 && !readBytes_(&values_[0], size))
+            return false;
+
+         const std::string& file_name = strings_[file];
+         message.clear();
+         detail::appendLogPrefix(message, time_cache_, static_cast<std::time_t>(time / 1000000),
+                                 file_name.data(), file_name.size(), line, level);
+         detail::renderLogValues(values_.data(), values_.size(), strings_, message);
+         message.push_back('\n');
+         return true;
+      }
+      else
+         throw std::runtime_error("Unknown binary log record type!");
+   }
+
+   return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads exactly \c size bytes from the input stream.
+/// \return \c false if the end of the stream was reached first.
+bool LogReader::readBytes_(char* data, size_t size)
+{
+   input_.read(data, static_cast<std::streamsize>(size));
+   return static_cast<size_t>(input_.gcount()) == size;
+}
+
+} // namespace be
@@ -0,0 +1,589 @@
+// Copyright (c) 2013 Benjamin Crist
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   be/profiler.cpp
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of be::Profiler functions.
+
+#include "be/profiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX   // std::max is used below
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+namespace be {
+namespace detail {
+
+// Relies on zero-initialization so that zones can be used during static
+// initialization.
+std::atomic<bool> profiler_active;
+
+} // namespace be::detail
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  The number of events each thread can record between collections.
+const uint32_t profile_buffer_capacity = 16384;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Holds the events recorded by a single thread.
+/// \details The owning thread is the only producer and the active Profiler
+///         (while holding its mutex) is the only consumer.  ProfileBuffers
+///         are never freed; when a thread exits, its buffer is released so
+///         that a new thread can reuse it once its events have been
+///         collected.
+struct ProfileBuffer
+{
+   ProfileBuffer()
+      : head(0),
+        tail(0),
+        dropped(0),
+        name(nullptr),
+        thread(0),
+        owned(true),
+        next(nullptr)
+   {
+   }
+
+   detail::ProfileEvent events[profile_buffer_capacity];
+   std::atomic<uint32_t> head;         ///< The number of events that have been removed.  Written only by the consumer.
+   std::atomic<uint32_t> tail;         ///< The number of events that have been added.  Written only by the owning thread.
+   std::atomic<uint32_t> dropped;      ///< The number of events dropped because the buffer was full.
+   std::atomic<const char*> name;      ///< Set by #BE_PROFILE_THREAD.
+   std::atomic<uint32_t> thread;       ///< Identifies the owning thread in trace output.
+   std::atomic<bool> owned;            ///< false once the owning thread has exited.
+   ProfileBuffer* next;                ///< The next buffer in the list of all buffers.
+};
+
+// These rely on zero-initialization so that they can be used during static
+// initialization.
+std::atomic<ProfileBuffer*> profile_buffers;   ///< Head of a lock-free, append-only list of all ProfileBuffers.
+std::atomic<uint32_t> profile_thread_count;
+std::atomic<int> profile_exit_key_status;   ///< 0 before profile_exit_key is allocated, 1 while it is being allocated, 2 if it was allocated, 3 if it couldn't be.
+#ifdef _WIN32
+DWORD profile_exit_key;                     ///< Fiber-local storage index whose callback releases a thread's ProfileBuffer.
+#else
+pthread_key_t profile_exit_key;             ///< Thread-specific data key whose destructor releases a thread's ProfileBuffer.
+#endif
+BE_THREAD_LOCAL ProfileBuffer* thread_profile_buffer;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Called when a thread which has recorded a zone exits.
+/// \details Releases the thread's ProfileBuffer so that another thread can
+///         reuse it.  Any events still in the buffer are collected as usual.
+#ifdef _WIN32
+void WINAPI releaseThreadProfileBuffer(void* ptr)
+#else
+void releaseThreadProfileBuffer(void* ptr)
+#endif
+{
+   ProfileBuffer* buffer = static_cast<ProfileBuffer*>(ptr);
+   if (!buffer)
+      return;
+
+   if (thread_profile_buffer == buffer)
+      thread_profile_buffer = nullptr;
+
+   buffer->owned.store(false, std::memory_order_release);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Allocates the key used to release ProfileBuffers when threads
+///         exit, if that hasn't been done yet.
+/// \return \c false if the key couldn't be allocated, in which case
+///         ProfileBuffers are never released.
+bool initProfileExitKey()
+{
+   int status = profile_exit_key_status.load(std::memory_order_acquire);
+   if (status < 2)
+   {
+      int expected = 0;
+      if (profile_exit_key_status.compare_exchange_strong(expected, 1, std::memory_order_acquire))
+      {
+#ifdef _WIN32
+         profile_exit_key = FlsAlloc(releaseThreadProfileBuffer);
+         bool allocated = profile_exit_key != FLS_OUT_OF_INDEXES;
+#else
+         bool allocated = pthread_key_create(&profile_exit_key, releaseThreadProfileBuffer) == 0;
+#endif
+         profile_exit_key_status.store(allocated ? 2 : 3, std::memory_order_release);
+      }
+      else
+      {
+         // another thread is allocating it
+         while (profile_exit_key_status.load(std::memory_order_acquire) < 2)
+            std::this_thread::yield();
+      }
+
+      status = profile_exit_key_status.load(std::memory_order_acquire);
+   }
+
+   return status == 2;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Guards active_profiler so that markProfileFrame() never uses a
+///         Profiler that is being destroyed.
+std::mutex& getActiveProfilerMutex()
+{
+   static std::mutex mutex;
+   return mutex;
+}
+
+Profiler* active_profiler = nullptr;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the calling thread's ProfileBuffer, claiming or
+///         creating it if necessary.
+/// \details A buffer released by a thread which has exited is reused once
+///         all of its events have been collected; otherwise a new buffer is
+///         added to the list.  Either way, the thread gets a new number, so
+///         its zones aren't attributed to the exited thread.
+ProfileBuffer& getThreadProfileBuffer()
+{
+   ProfileBuffer* buffer = thread_profile_buffer;
+   if (!buffer)
+   {
+      bool has_exit_key = initProfileExitKey();
+
+      // A released buffer's tail doesn't change, and its head only moves
+      // towards it.
+      for (ProfileBuffer* b = profile_buffers.load(std::memory_order_acquire); b; b = b->next)
+      {
+         bool owned = false;
+         if (!b->owned.load(std::memory_order_acquire) &&
+             b->head.load(std::memory_order_acquire) == b->tail.load(std::memory_order_relaxed) &&
+             b->owned.compare_exchange_strong(owned, true, std::memory_order_acquire))
+         {
+            buffer = b;
+            buffer->name.store(nullptr, std::memory_order_relaxed);
+            break;
+         }
+      }
+
+      if (!buffer)
+      {
+         buffer = new ProfileBuffer();
+         ProfileBuffer* head = profile_buffers.load(std::memory_order_relaxed);
+         do
+         {
+            buffer->next = head;
+         } while (!profile_buffers.compare_exchange_weak(head, buffer, std::memory_order_release));
+      }
+
+      buffer->thread.store(++profile_thread_count, std::memory_order_release);
+      thread_profile_buffer = buffer;
+
+      if (has_exit_key)
+      {
+#ifdef _WIN32
+         FlsSetValue(profile_exit_key, buffer);
+#else
+         pthread_setspecific(profile_exit_key, buffer);
+#endif
+      }
+   }
+   return *buffer;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Adds an event to the calling thread's ProfileBuffer.
+void pushProfileEvent(const char* name, uint64_t begin, uint64_t end)
+{
+   ProfileBuffer& buffer = getThreadProfileBuffer();
+   uint32_t tail = buffer.tail.load(std::memory_order_relaxed);
+
+   if (tail - buffer.head.load(std::memory_order_acquire) >= profile_buffer_capacity)
+   {
+      buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+   }
+
+   detail::ProfileEvent& event = buffer.events[tail % profile_buffer_capacity];
+   event.name = name;
+   event.begin = begin;
+   event.end = end;
+   event.thread = buffer.thread.load(std::memory_order_relaxed);
+   buffer.tail.store(tail + 1, std::memory_order_release);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Writes a string as a JSON string literal.
+void writeJsonString(std::ostream& os, const char* str)
+{
+   os << '"';
+   for (; *str; ++str)
+   {
+      unsigned char c = static_cast<unsigned char>(*str);
+      if (c == '"' || c == '\\')
+         os << '\\' << *str;
+      else if (c < 0x20)
+      {
+         static const char hex[] = "0123456789abcdef";
+         os << "\\u00" << hex[c >> 4] << hex[c & 0xF];
+      }
+      else
+         os << *str;
+   }
+   os << '"';
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Orders events by the time they started.
+bool compareEventBegin(const detail::ProfileEvent& a, const detail::ProfileEvent& b)
+{
+   return a.begin < b.begin;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Orders events by the time they ended.
+bool compareEventEnd(const detail::ProfileEvent& a, const detail::ProfileEvent& b)
+{
+   return a.end < b.end;
+}
+
+} // namespace be::(anon)
+
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Called when a ProfileZone is destroyed.
+/// \details Zones which end after the Profiler is destroyed are ignored.
+void recordProfileZone(const char* name, uint64_t begin, uint64_t end)
+{
+   if (profiler_active.load(std::memory_order_relaxed))
+      pushProfileEvent(name, begin, end);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Marks the end of a frame and collects recorded zones.
+/// \details Does nothing if no Profiler exists.
+void markProfileFrame()
+{
+   if (!profiler_active.load(std::memory_order_relaxed))
+      return;
+
+   uint64_t now = getProfileTicks();
+   pushProfileEvent(nullptr, now, now);
+
+   std::lock_guard<std::mutex> lock(getActiveProfilerMutex());
+   if (active_profiler)
+      active_profiler->collect();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Names the calling thread in profiler output.
+/// \param  name The thread's name.  Must be a string literal since it is
+///         not copied.
+void setProfileThreadName(const char* name)
+{
+   getThreadProfileBuffer().name.store(name, std::memory_order_relaxed);
+}
+
+} // namespace be::detail
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Starts recording profiling zones.
+/// \details Any events left over from a previous Profiler are discarded.
+/// \param  max_events The maximum number of zones to retain for
+///         writeChromeTrace().  Once this many have been collected, the
+///         oldest are discarded.
+/// \param  max_frames The maximum number of frames' statistics to retain.
+/// \throws std::logic_error if another Profiler already exists.
+Profiler::Profiler(size_t max_events, size_t max_frames)
+   : max_events_(max_events),
+     max_frames_(max_frames),
+     frame_count_(0),
+     dropped_(0)
+{
+   {
+      std::lock_guard<std::mutex> lock(getActiveProfilerMutex());
+      if (active_profiler)
+         throw std::logic_error("A Profiler already exists!");
+
+      active_profiler = this;
+   }
+
+   for (ProfileBuffer* buffer = profile_buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next)
+   {
+      buffer->head.store(buffer->tail.load(std::memory_order_acquire), std::memory_order_release);
+      buffer->dropped.store(0, std::memory_order_relaxed);
+   }
+
+   // Estimate the tick rate now so that the first frames can be measured.
+   // calibrate_() refines the estimate as more time passes.
+   origin_time_ = std::chrono::steady_clock::now();
+   origin_ticks_ = detail::getProfileTicks();
+   frame_begin_ = origin_ticks_;
+
+   std::chrono::steady_clock::time_point time;
+   do
+   {
+      std::this_thread::yield();
+      time = std::chrono::steady_clock::now();
+   } while (time - origin_time_ < std::chrono::milliseconds(10));
+
+   uint64_t ticks = detail::getProfileTicks();
+   ticks_per_ms_ = (ticks - origin_ticks_) / std::chrono::duration<double, std::milli>(time - origin_time_).count();
+
+   detail::profiler_active.store(true);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Stops recording profiling zones.
+Profiler::~Profiler()
+{
+   detail::profiler_active.store(false);
+
+   std::lock_guard<std::mutex> lock(getActiveProfilerMutex());
+   active_profiler = nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Removes recorded events from every thread's buffer.
+/// \details Statistics are calculated for each frame that has ended.  This
+///         is called automatically by #BE_PROFILE_FRAME.
+void Profiler::collect()
+{
+   std::lock_guard<std::mutex> lock(mutex_);
+
+   for (ProfileBuffer* buffer = profile_buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next)
+   {
+      uint32_t head = buffer->head.load(std::memory_order_relaxed);
+      uint32_t tail = buffer->tail.load(std::memory_order_acquire);
+
+      for (; head != tail; ++head)
+      {
+         const detail::ProfileEvent& event = buffer->events[head % profile_buffer_capacity];
+         if (event.begin < origin_ticks_)
+            continue;   // zone entered before this Profiler was created
+
+         if (event.name)
+            pending_.push_back(event);
+         else
+            frame_marks_.push_back(event.begin);
+
+         events_.push_back(event);
+      }
+
+      buffer->head.store(head, std::memory_order_release);
+      dropped_ += buffer->dropped.exchange(0, std::memory_order_relaxed);
+
+      // a reused buffer's name is cleared before its thread number changes,
+      // so a new number is never paired with the exited thread's name.
+      uint32_t thread = buffer->thread.load(std::memory_order_acquire);
+      const char* name = buffer->name.load(std::memory_order_relaxed);
+      if (name)
+      {
+         auto i(thread_names_.begin()), end(thread_names_.end());
+         while (i != end && i->first != thread)
+            ++i;
+
+         if (i == end)
+            thread_names_.push_back(std::make_pair(thread, std::string(name)));
+         else
+            i->second = name;
+      }
+   }
+
+   while (events_.size() > max_events_)
+      events_.pop_front();
+
+   calibrate_();
+
+   std::sort(frame_marks_.begin(), frame_marks_.end());
+   for (auto i(frame_marks_.begin()), end(frame_marks_.end()); i != end; ++i)
+      closeFrame_(*i);
+
+   frame_marks_.clear();
+
+   // If no frame boundary is ever recorded, discard the oldest zones rather
+   // than letting pending_ grow without limit.
+   if (pending_.size() > max_events_)
+   {
+      size_t excess = pending_.size() - max_events_;
+      std::stable_sort(pending_.begin(), pending_.end(), compareEventEnd);
+      pending_.erase(pending_.begin(), pending_.begin() + excess);
+      dropped_ += excess;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the number of frames whose statistics are retained.
+size_t Profiler::getFrameCount() const
+{
+   return frames_.size();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the statistics for a retained frame.
+/// \param  index The frame to retrieve; 0 is the oldest retained frame and
+///         getFrameCount() - 1 is the most recent.
+const ProfileFrameStats& Profiler::getFrame(size_t index) const
+{
+   return frames_[index];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the number of zones that were dropped because a
+///         thread's buffer was full.
+uint64_t Profiler::getDroppedCount() const
+{
+   return dropped_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Writes the retained zones in the Chrome trace event format.
+/// \details Zones are written as complete (\c "X") events, frame boundaries
+///         as global instant events, and thread names as metadata events.
+///         Times are in microseconds since the Profiler was created.
+/// \param  os The stream to write the JSON document to.
+void Profiler::writeChromeTrace(std::ostream& os)
+{
+   collect();
+
+   std::lock_guard<std::mutex> lock(mutex_);
+
+   std::vector<detail::ProfileEvent> events(events_.begin(), events_.end());
+   std::stable_sort(events.begin(), events.end(), compareEventBegin);
+
+   std::ios_base::fmtflags flags = os.flags();
+   std::streamsize precision = os.precision();
+   os.setf(std::ios_base::fixed, std::ios_base::floatfield);
+   os.precision(3);
+
+   os << "{\"traceEvents\":[";
+
+   bool first = true;
+   for (auto i(thread_names_.begin()), end(thread_names_.end()); i != end; ++i)
+   {
+      os << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i->first << ",\"args\":{\"name\":";
+      writeJsonString(os, i->second.c_str());
+      os << "}}";
+      first = false;
+   }
+
+   for (auto i(events.begin()), end(events.end()); i != end; ++i)
+   {
+      double ts = ticksToMs_(i->begin - origin_ticks_) * 1000.0;
+      os << (first ? "\n" : ",\n");
+      first = false;
+
+      if (i->name)
+      {
+         os << "{\"name\":";
+         writeJsonString(os, i->name);
+         os << ",\"cat\":\"be\",\"ph\":\"X\",\"ts\":" << ts
+            << ",\"dur\":" << ticksToMs_(i->end - i->begin) * 1000.0
+            << ",\"pid\":1,\"tid\":" << i->thread << '}';
+      }
+      else
+      {
+         os << "{\"name\":\"Frame\",\"cat\":\"be\",\"ph\":\"i\",\"s\":\"g\",\"ts\":" << ts
+            << ",\"pid\":1,\"tid\":" << i->thread << '}';
+      }
+   }
+
+   os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+   os.flags(flags);
+   os.precision(precision);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Summarizes the pending zones which ended before a frame boundary.
+/// \param  end The tick count of the frame boundary.
+void Profiler::closeFrame_(uint64_t end)
+{
+   ProfileFrameStats frame;
+   frame.index = frame_count_++;
+   frame.duration_ms = ticksToMs_(end - frame_begin_);
+   frame_begin_ = end;
+
+   auto remaining(pending_.begin());
+   for (auto i(pending_.begin()), last(pending_.end()); i != last; ++i)
+   {
+      if (i->end > end)
+      {
+         *remaining++ = *i;
+         continue;
+      }
+
+      auto stats(frame.zones.begin()), stats_end(frame.zones.end());
+      while (stats != stats_end && stats->name != i->name && strcmp(stats->name, i->name) != 0)
+         ++stats;
+
+      double ms = ticksToMs_(i->end - i->begin);
+      if (stats == stats_end)
+      {
+         ProfileZoneStats zone;
+         zone.name = i->name;
+         zone.calls = 1;
+         zone.total_ms = ms;
+         zone.max_ms = ms;
+         frame.zones.push_back(zone);
+      }
+      else
+      {
+         ++stats->calls;
+         stats->total_ms += ms;
+         stats->max_ms = std::max(stats->max_ms, ms);
+      }
+   }
+   pending_.erase(remaining, pending_.end());
+
+   frames_.push_back(frame);
+   while (frames_.size() > max_frames_)
+      frames_.pop_front();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Converts a number of ticks to milliseconds.
+double Profiler::ticksToMs_(uint64_t ticks) const
+{
+   return ticks / ticks_per_ms_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Refines the tick rate estimate once enough time has passed for
+///         it to be more accurate than the initial estimate.
+void Profiler::calibrate_()
+{
+   std::chrono::duration<double, std::milli> elapsed(std::chrono::steady_clock::now() - origin_time_);
+   uint64_t ticks = detail::getProfileTicks();
+
+   if (elapsed.count() >= 1000.0)
+      ticks_per_ms_ = (ticks - origin_ticks_) / elapsed.count();
+}
+
+} // namespace be
@@ -30,28 +30,29 @@
 #include <ctime>
 
 namespace be {
-namespace {
+namespace detail {
 
-int& getVerbosityRef()
-{
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  The current verbosity level.
+/// \details Read by checkVerbosity() for every #BE_LOG statement which is not
+///         removed by #BE_MIN_VERBOSITY.
 #ifdef DEBUG
-   static int v = -1;
+std::atomic<int> current_verbosity(-1);
 #else
-   static int v = VWarning;
+std::atomic<int> current_verbosity(VWarning);
 #endif
 
-   return v;
-}
-
-} // namespace be::(anon)
+} // namespace be::detail
 
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  Sets the current verbosity level to the value provided.
+/// \details May be called from any thread.  Levels which are not included in
+///         #BE_MIN_VERBOSITY will still not be logged.
 /// \param  verbosity The verbbosity level to use from now on.
 /// \sa     Verbosity
 void setVerbosity(int verbosity)
 {
-   getVerbosityRef() = verbosity;
+   detail::current_verbosity.store(verbosity, std::memory_order_relaxed);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -59,20 +60,7 @@ void setVerbosity(int verbosity)
 /// \sa     Verbosity
 int getVerbosity()
 {
-   return getVerbosityRef();
-}
-
-///////////////////////////////////////////////////////////////////////////////
-/// \brief  Checks if the provided verbosity level should result in a message
-///         being logged given the current verbosity level.
-///
-/// \param  verbosity The verbosity level to check against the current level.
-/// \return \c true if getVerbosity() & verbosity == verbosity.
-/// \sa     Verbosity
-/// \sa     setVerbosity()
-bool checkVerbosity(int verbosity)
-{
-   return (getVerbosityRef() & verbosity) == verbosity;
+   return detail::current_verbosity.load(std::memory_order_relaxed);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
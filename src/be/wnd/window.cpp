@@ -29,6 +29,7 @@
 #include "be/wnd/window_event.h"
 #include "be/wnd/window_settings.h"
 #include "be/bsc/scene.h"
+#include "be/profiler.h"
 
 #include <vector>
 
@@ -100,6 +101,8 @@ const WindowSettings& Window::getWindowSettings() const
 ///         indices will not be rendered at all.
 void Window::render()
 {
+   BE_PROFILE_FUNCTION();
+
    makeContextCurrent();
    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
@@ -49,6 +49,9 @@
 #else
 
 #include "pbj/engine.h"
+#include "be/async_log.h"
+#include "be/profiler.h"
+#include "be/bed/sql_profiler.h"
 
 #include "pbj/gfx/built_ins.h"
 #include "pbj/gfx/texture_font_text.h"
@@ -56,7 +59,9 @@
 #include "pbj/gfx/built_ins.h"
 
 #include <iostream>
+#include <cstring>
 #include <fstream>
+#include <memory>
 #include <random>
 
 #if defined(_WIN32) && !defined(DEBUG)
@@ -90,11 +95,20 @@ int main(int argc, char* argv[])
    std::ofstream cerr_log_file;
    std::string cerr_log("pbjed.log");
 
-   if (argc != 1)
+   bool binary_log = false;
+
+   // --binary-log writes the log file in the binary format (see logdecode)
+   for (int i = 1; i < argc; ++i)
    {
-      std::cout << "PBJgame " << PBJ_VERSION_MAJOR << '.' << PBJ_VERSION_MINOR << " (" << __DATE__ " " __TIME__ << ')' << std::endl
-                << PBJ_COPYRIGHT << std::endl;
-      return 1;
+      if (std::strcmp(argv[i], "--binary-log") == 0)
+         binary_log = true;
+      else
+      {
+         std::cout << "PBJgame " << PBJ_VERSION_MAJOR << '.' << PBJ_VERSION_MINOR << " (" << __DATE__ " " __TIME__ << ')' << std::endl
+                   << PBJ_COPYRIGHT << std::endl
+                   << "Usage: " << argv[0] << " [--binary-log]" << std::endl;
+         return 1;
+      }
    }
    
    // Set the appropriate verbosity level
@@ -105,13 +119,32 @@ int main(int argc, char* argv[])
    if (cerr_log.length() > 0)
    {
       PBJ_LOG(pbj::VNotice) << "Redirecting log to " << cerr_log << PBJ_LOG_END;
-      cerr_log_file.open(cerr_log, std::ofstream::trunc);
+      cerr_log_file.open(cerr_log, binary_log ? std::ofstream::trunc | std::ofstream::binary : std::ofstream::trunc);
       PBJ_LOG_STREAM.rdbuf(cerr_log_file.rdbuf());
+   }
+#endif
 
+   // Write log messages from a background thread until main() returns.
+   // Binary log files must be decoded with logdecode.
+   be::AsyncLog async_log(binary_log && cerr_log_file.is_open() ? be::AsyncLog::Binary : be::AsyncLog::Text);
+
+   if (cerr_log_file.is_open())
+   {
       PBJ_LOG(pbj::VInfo) << "Starting Editor..." << PBJ_LOG_NL
                           << " PBJgame Version: " << PBJ_VERSION_MAJOR << '.' << PBJ_VERSION_MINOR << PBJ_LOG_NL
                           << " Build Date: " <<  __DATE__ " " __TIME__ << PBJ_LOG_END;
    }
+
+#ifdef BE_PROFILE_ENABLED
+   // Record profiling zones; a Chrome trace is written when the editor exits
+   be::Profiler profiler;
+
+   // Log the most expensive SQL statements every minute and on exit.  The
+   // reports are logged at VInfo, so when BE_MIN_VERBOSITY compiles that out
+   // (or it is disabled at startup), don't pay for the instrumentation.
+   std::unique_ptr<be::bed::SqlProfiler> sql_profiler;
+   if ((be::VInfo & (BE_MIN_VERBOSITY)) == be::VInfo && be::checkVerbosity(be::VInfo))
+      sql_profiler.reset(new be::bed::SqlProfiler(std::chrono::seconds(60)));
 #endif
 
    // Initialize game engine
@@ -132,12 +165,27 @@ int main(int argc, char* argv[])
         if (!wnd || wnd->isClosePending())
             break;
 
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        {
+            BE_PROFILE_ZONE("Update resources");
+
+            // Upload resources which have finished loading in the background,
+            // without stalling the frame for more than a couple milliseconds.
+            engine.getResourceLoader().update(std::chrono::milliseconds(2));
+            engine.getResourceCache().update();
+        }
 
+        {
+            BE_PROFILE_ZONE("Render");
 
-        text.draw(transform);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        glfwSwapBuffers(wnd->getGlfwHandle());
+            text.draw(transform);
+        }
+
+        {
+            BE_PROFILE_ZONE("Swap buffers");
+            glfwSwapBuffers(wnd->getGlfwHandle());
+        }
 
         GLenum gl_error;
         while ((gl_error = glGetError()) != GL_NO_ERROR)
@@ -146,7 +194,14 @@ int main(int argc, char* argv[])
                                    << "Error Code: " << gl_error << PBJ_LOG_NL
                                    << "     Error: " << pbj::getGlErrorString(gl_error) << PBJ_LOG_END;
         }
+
+        BE_PROFILE_FRAME();
     }
+
+#ifdef BE_PROFILE_ENABLED
+    std::ofstream trace_file("pbjed_trace.json", std::ofstream::trunc);
+    profiler.writeChromeTrace(trace_file);
+#endif
 };
 
 #endif
@@ -27,6 +27,7 @@
 #include "pbj/engine.h"
 #include "pbj/_gl.h"
 #include "pbj/sw/sandwich_open.h"
+#include "be/profiler.h"
 
 #include <thread>
 #include <cassert>
@@ -54,6 +55,8 @@ void glfwError(int error, const char* description)
 ///         local variable in main().
 Engine::Engine()
 {
+    BE_PROFILE_FUNCTION();
+
     if (process_engine_)
         throw std::runtime_error("Engine already initialized!");
 
@@ -92,6 +95,14 @@ Engine::Engine()
 
     built_ins_.reset(new gfx::BuiltIns());
 
+    // Resources are finalized on this thread, since it owns the GL context.
+    resource_loader_.reset(new sw::ResourceLoader());
+    resource_cache_.reset(new sw::ResourceCache(*resource_loader_,
+        PBJ_SW_RESOURCE_CACHE_DEFAULT_CPU_BUDGET,
+        PBJ_SW_RESOURCE_CACHE_DEFAULT_GPU_BUDGET));
+    content_resolver_.reset(new sw::ContentResolver());
+    resource_cache_->setResolver(content_resolver_.get());
+
     wnd->setTitle(window_title);
     
     PBJ_LOG(VInfo) << glGetString(GL_VERSION) << PBJ_LOG_END;
@@ -103,8 +114,12 @@ Engine::Engine()
 /// \brief  Destructor.
 Engine::~Engine()
 {
+    resource_cache_.reset();
+    content_resolver_.reset();
+    resource_loader_.reset();
     window_.reset();
     built_ins_.reset();
+    sw::closeWriteQueues();
     glfwTerminate();
 }
 
@@ -118,6 +133,35 @@ const gfx::BuiltIns& Engine::getBuiltIns() const
     return *built_ins_;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the loader used to load resources from sandwiches in the
+///         background.
+/// \details ResourceLoader::update() should be called once per frame from
+///         the main thread.
+sw::ResourceLoader& Engine::getResourceLoader() const
+{
+    return *resource_loader_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the cache which shares resources between scenes.
+/// \details ResourceCache::update() should be called once per frame from
+///         the main thread, after ResourceLoader::update().
+sw::ResourceCache& Engine::getResourceCache() const
+{
+    return *resource_cache_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the resolver which lets the ResourceCache share
+///         resources with identical data.
+/// \details ContentResolver::clear() should be called after the editor
+///         changes resources in a sandwich.
+sw::ContentResolver& Engine::getContentResolver() const
+{
+    return *content_resolver_;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  Retrieves the engine object.
 ///
@@ -98,7 +98,7 @@ BuiltIns::BuiltIns()
     id.resource = Id("Shader.TextureFontText.vertex");
     try
     {
-        Shader* shader = new Shader(id, Shader::TVertex,
+        be::Handle<Shader> shader = shader_pool_.create(id, Shader::TVertex,
             "#version 330\n\n"
             "uniform mat4 transform;\n\n"
             "layout(location = 0) in vec2 in_position;\n"
@@ -109,7 +109,7 @@ BuiltIns::BuiltIns()
             "   texcoord = in_texcoord;\n"
             "   gl_Position = transform * vec4(in_position, 0.0, 1.0);\n"
             "}\n");
-        shaders_.insert(std::make_pair(shader->getId().resource, std::unique_ptr<Shader>(shader)));
+        shaders_.insert(std::make_pair(shader->getId().resource, shader));
     }
     catch (const std::exception& err)
     {
@@ -119,7 +119,7 @@ BuiltIns::BuiltIns()
     id.resource = Id("Shader.TextureFontText.fragment");
     try
     {
-        Shader* shader = new Shader(id, Shader::TFragment,
+        be::Handle<Shader> shader = shader_pool_.create(id, Shader::TFragment,
             "#version 330\n\n"
             "uniform vec4 color;\n"
             "uniform sampler2D texsampler;\n\n"
@@ -129,7 +129,7 @@ BuiltIns::BuiltIns()
             "{\n"
             "   out_fragcolor = vec4(color.rgb, color.a * texture(texsampler, texcoord).r);\n"
             "}\n");
-        shaders_.insert(std::make_pair(shader->getId().resource, std::unique_ptr<Shader>(shader)));
+        shaders_.insert(std::make_pair(shader->getId().resource, shader));
     }
     catch (const std::exception& err)
     {
@@ -139,10 +139,10 @@ BuiltIns::BuiltIns()
     id.resource = Id("ShaderProgram.TextureFontText");
     try
     {
-        ShaderProgram* program = new ShaderProgram(id,
+        be::Handle<ShaderProgram> program = program_pool_.create(id,
             getShader(Id("Shader.TextureFontText.vertex")), 
             getShader(Id("Shader.TextureFontText.fragment")));
-        programs_.insert(std::make_pair(program->getId().resource, std::unique_ptr<ShaderProgram>(program)));
+        programs_.insert(std::make_pair(program->getId().resource, program));
     }
     catch (const std::exception& err)
     {
@@ -306,8 +306,8 @@ BuiltIns::BuiltIns()
             "\xB3\xE3\x97\x00\x03\x00\xDA\x70\x0D\x25\xB0\xD3\xC3\xB0\x00\x00"
             "\x00\x00\x49\x45\x4E\x44\xAE\x42\x60\x82");
         size_t size = 0x9DE;
-        Texture* texture = new Texture(id, data, size, Texture::IF_R, false, Texture::FM_Nearest, Texture::FM_Nearest);
-        textures_.insert(std::make_pair(texture->getId().resource, std::unique_ptr<Texture>(texture)));
+        be::Handle<Texture> texture = texture_pool_.create(id, data, size, Texture::IF_R, false, Texture::FM_Nearest, Texture::FM_Nearest);
+        textures_.insert(std::make_pair(texture->getId().resource, texture));
     }
     catch (const std::exception& err)
     {
@@ -352,12 +352,12 @@ BuiltIns::BuiltIns()
         c.tex_offset = vec2(40, 48);
         chars.push_back(c);
 
-        TextureFont* texture_font = new TextureFont(id,
+        be::Handle<TextureFont> texture_font = texture_font_pool_.create(id,
             tex.getHandle(),
             ivec2(128, 128),
             12, 10,
             chars.begin(), chars.end());
-        texture_fonts_.insert(std::make_pair(texture_font->getId().resource, std::unique_ptr<TextureFont>(texture_font)));
+        texture_fonts_.insert(std::make_pair(texture_font->getId().resource, texture_font));
     }
     catch (const std::exception& err)
     {
@@ -26,6 +26,8 @@
 
 #include "pbj/gfx/shader.h"
 
+#include "be/profiler.h"
+
 #include <cassert>
 #include <iostream>
 
@@ -179,6 +181,8 @@ std::string& Shader::nullString_() const
 
 void Shader::compile_(const std::string& source)
 {
+    BE_PROFILE_FUNCTION();
+
     invalidate_();
 
     GLuint gl_type;
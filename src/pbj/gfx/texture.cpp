@@ -26,6 +26,8 @@
 
 #include "pbj/gfx/texture.h"
 
+#include "be/profiler.h"
+
 #include "stb_image.h"
 
 #include <cassert>
@@ -33,6 +35,93 @@
 
 namespace pbj {
 namespace gfx {
+namespace {
+
+// The number of components stb_image should decode for each internal format.
+int getComponents(Texture::InternalFormat format)
+{
+    switch (format)
+    {
+        case Texture::IF_R:     return 1;
+        case Texture::IF_RG:    return 2;
+        case Texture::IF_RGB:   return 3;
+        default:                return 4;
+    }
+}
+
+// Logs and throws if stb_image could not decode an image.
+stbi_uc* checkDecoded(stbi_uc* data, const sw::ResourceId& id)
+{
+    if (data == nullptr)
+    {
+        PBJ_LOG(VWarning) << "OpenGL error while parsing texture data!" << PBJ_LOG_NL
+                          << "   Sandwich ID: " << id.sandwich << PBJ_LOG_NL
+                          << "    Texture ID: " << id.resource << PBJ_LOG_NL
+                          << "    STBI Error: " << stbi_failure_reason() << PBJ_LOG_END;
+
+        throw std::runtime_error("Failed to upload texture data to GPU!");
+    }
+
+    return data;
+}
+
+} // namespace pbj::gfx::(anon)
+
+Texture::Pixels::Pixels()
+    : data(nullptr)
+{
+}
+
+Texture::Pixels::Pixels(Pixels&& other)
+    : dimensions(other.dimensions),
+      data(other.data)
+#ifdef PBJ_EDITOR
+      , source(std::move(other.source))
+#endif
+{
+    other.data = nullptr;
+}
+
+Texture::Pixels& Texture::Pixels::operator=(Pixels&& other)
+{
+    std::swap(dimensions, other.dimensions);
+    std::swap(data, other.data);
+#ifdef PBJ_EDITOR
+    source.swap(other.source);
+#endif
+    return *this;
+}
+
+Texture::Pixels::~Pixels()
+{
+    if (data)
+        stbi_image_free(data);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Decodes an encoded image without uploading it.
+/// \details Does not use OpenGL, so it may be called on any thread.  The
+///         result can be uploaded later by constructing a Texture from it.
+/// \param  id The ResourceId of the texture, used when logging errors.
+/// \param  data The encoded image.
+/// \param  size The size of the encoded image in bytes.
+/// \param  format The internal format the texture will use, which determines
+///         how many components are decoded.
+/// \throws std::runtime_error if the image can't be decoded.
+Texture::Pixels Texture::decode(const sw::ResourceId& id, const GLubyte* data, size_t size, InternalFormat format)
+{
+    BE_PROFILE_FUNCTION();
+
+    Pixels pixels;
+    int components;
+    pixels.data = checkDecoded(stbi_load_from_memory(data, size, &pixels.dimensions.x, &pixels.dimensions.y, &components, getComponents(format)), id);
+
+#ifdef PBJ_EDITOR
+    pixels.source.assign(data, data + size);
+#endif
+
+    return pixels;
+}
 
 Texture::Texture(const sw::ResourceId& id, const GLubyte* data, size_t size, InternalFormat format, bool srgb_color, FilterMode mag_mode, FilterMode min_mode)
     : resource_id_(id),
@@ -51,6 +140,27 @@ Texture::Texture(const sw::ResourceId& id, const GLubyte* data, size_t size, Int
     upload_(data, size, format, srgb_color, mag_mode, min_mode);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a texture from an image which has already been decoded
+///         by decode(), so that only the upload happens on this thread.
+Texture::Texture(const sw::ResourceId& id, Pixels&& pixels, InternalFormat format, bool srgb_color, FilterMode mag_mode, FilterMode min_mode)
+    : resource_id_(id),
+      gl_id_(0)
+{
+    handle_.associate(this);
+
+#ifdef PBJ_EDITOR
+    data_.swap(pixels.source);
+
+    setInternalFormat(format);
+    setSrgbColorspace(srgb_color);
+    setMagFilterMode(mag_mode);
+    setMinFilterMode(min_mode);
+#endif
+
+    upload_(pixels, format, srgb_color, mag_mode, min_mode);
+}
+
 Texture::~Texture()
 {
     invalidate_();
@@ -76,6 +186,11 @@ GLuint Texture::getGlId() const
     return gl_id_;
 }
 
+const ivec2& Texture::getDimensions() const
+{
+    return dimensions_;
+}
+
 #ifdef PBJ_EDITOR
 Texture::Texture()
 {
@@ -213,6 +328,25 @@ std::string& Texture::nullString_() const
 
 void Texture::upload_(const GLubyte* data, size_t size, InternalFormat format, bool srgb_color, FilterMode mag_mode, FilterMode min_mode)
 {
+    upload_([=](ivec2& dimensions, int required_components) -> GLubyte*
+    {
+        int components;
+        return stbi_load_from_memory(data, size, &dimensions.x, &dimensions.y, &components, required_components);
+    }, format, srgb_color, mag_mode, min_mode);
+}
+
+void Texture::upload_(const std::function<GLubyte*(ivec2&, int)>& decode, InternalFormat format, bool srgb_color, FilterMode mag_mode, FilterMode min_mode)
+{
+    Pixels pixels;
+    pixels.data = checkDecoded(decode(pixels.dimensions, getComponents(format)), resource_id_);
+
+    upload_(pixels, format, srgb_color, mag_mode, min_mode);
+}
+
+void Texture::upload_(const Pixels& pixels, InternalFormat format, bool srgb_color, FilterMode mag_mode, FilterMode min_mode)
+{
+    BE_PROFILE_FUNCTION();
+
     invalidate_();
 
     GLenum error_status;
@@ -223,8 +357,6 @@ void Texture::upload_(const GLubyte* data, size_t size, InternalFormat format, b
                          << "         Error: " << pbj::getGlErrorString(error_status) << PBJ_LOG_END;
     }
 
-    int required_components = 4;
-
     GLenum internal_format;
     GLenum source_format;
     switch (format)
@@ -232,40 +364,25 @@ void Texture::upload_(const GLubyte* data, size_t size, InternalFormat format, b
         case IF_R:
             internal_format = GL_RED;
             source_format = GL_RED;
-            required_components = 1;
             break;
 
         case IF_RG:
             internal_format = GL_RG;
             source_format = GL_RG;
-            required_components = 2;
             break;
 
         case IF_RGB:
             internal_format = srgb_color ? GL_SRGB : GL_RGB;
             source_format = GL_RGB;
-            required_components = 3;
             break;
 
         default: //case IF_RGBA:
             internal_format = srgb_color ? GL_SRGB_ALPHA : GL_RGBA;
             source_format = GL_RGBA;
-            required_components = 4;
             break;
     }
 
-    int components;
-    stbi_uc* stbi_data = stbi_load_from_memory(data, size, &dimensions_.x, &dimensions_.y, &components, required_components);
-
-    if (stbi_data == nullptr)
-    {
-        PBJ_LOG(VWarning) << "OpenGL error while parsing texture data!" << PBJ_LOG_NL
-                          << "   Sandwich ID: " << resource_id_.sandwich << PBJ_LOG_NL
-                          << "    Texture ID: " << resource_id_.resource << PBJ_LOG_NL
-                          << "    STBI Error: " << stbi_failure_reason() << PBJ_LOG_END;
-
-        throw std::runtime_error("Failed to upload texture data to GPU!");
-    }
+    dimensions_ = pixels.dimensions;
 
     GLenum mag_filter;
     GLenum min_filter;
@@ -292,9 +409,7 @@ void Texture::upload_(const GLubyte* data, size_t size, InternalFormat format, b
     glGenTextures(1, &gl_id_);
     glBindTexture(GL_TEXTURE_2D, gl_id_);
 
-    glTexImage2D(GL_TEXTURE_2D, 0, internal_format, dimensions_.x, dimensions_.y, 0, source_format, GL_UNSIGNED_BYTE, stbi_data);
-
-    stbi_image_free(stbi_data);
+    glTexImage2D(GL_TEXTURE_2D, 0, internal_format, dimensions_.x, dimensions_.y, 0, source_format, GL_UNSIGNED_BYTE, pixels.data);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
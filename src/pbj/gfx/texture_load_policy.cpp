@@ -0,0 +1,131 @@
+// Copyright (c) 2013 PBJ^2 Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   pbj/gfx/texture_load_policy.cpp
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of pbj::gfx::TextureLoadPolicy functions.
+
+#include "pbj/gfx/texture_load_policy.h"
+
+#include "be/bed/blob_reader.h"
+
+namespace pbj {
+namespace gfx {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a policy for loading textures with the same settings.
+///
+/// \param  table The table containing the textures' encoded images.
+/// \param  column The column containing the textures' encoded images.
+/// \param  format The internal format of the textures.
+/// \param  srgb_color Whether the textures are in the sRGB color space.
+/// \param  mag_mode The magnification filter mode of the textures.
+/// \param  min_mode The minification filter mode of the textures.
+TextureLoadPolicy::TextureLoadPolicy(const std::string& table, const std::string& column, Texture::InternalFormat format, bool srgb_color, Texture::FilterMode mag_mode, Texture::FilterMode min_mode)
+    : table_(table),
+      column_(column),
+      format_(format),
+      srgb_color_(srgb_color),
+      mag_mode_(mag_mode),
+      min_mode_(min_mode)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads the encoded image.  Called on an I/O thread.
+/// \details The image is copied straight from the database pages into
+///         \c data.encoded.
+/// \throws db::Db::error if the texture doesn't exist.
+void TextureLoadPolicy::read(sw::Sandwich& sandwich, const sw::ResourceId& id, data_type& data) const
+{
+    db::BlobReader reader(sandwich.getDb(), table_, column_, static_cast<sqlite3_int64>(id.resource.value()));
+
+    data.encoded.resize(reader.getSize());
+    reader.read(data.encoded.data(), reader.getSize());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Decodes the image read by read().  Called on a CPU thread.
+void TextureLoadPolicy::decode(const sw::ResourceId& id, data_type& data) const
+{
+    data.pixels = Texture::decode(id, data.encoded.data(), data.encoded.size(), format_);
+    std::vector<GLubyte>().swap(data.encoded);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Uploads the decoded image to a new texture.  Called on the thread
+///         which owns the GL context.
+Texture* TextureLoadPolicy::finalize(const sw::ResourceId& id, data_type& data) const
+{
+    return new Texture(id, std::move(data.pixels), format_, srgb_color_, mag_mode_, min_mode_);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Estimates the memory used by a texture, for sw::ResourceCache.
+/// \details Video memory is estimated from the texture's dimensions and
+///         internal format.  Only the editor keeps a copy of the encoded
+///         image in main memory.
+void TextureLoadPolicy::measure(const Texture& texture, size_t& cpu_bytes, size_t& gpu_bytes) const
+{
+    size_t components;
+    switch (format_)
+    {
+        case Texture::IF_R:     components = 1; break;
+        case Texture::IF_RG:    components = 2; break;
+        case Texture::IF_RGB:   components = 3; break;
+        default:                components = 4; break;
+    }
+
+    const ivec2& dimensions = texture.getDimensions();
+    gpu_bytes = size_t(dimensions.x) * size_t(dimensions.y) * components;
+
+#ifdef PBJ_EDITOR
+    const GLubyte* data;
+    cpu_bytes = texture.getData(data);
+#else
+    cpu_bytes = 0;
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Identifies the format and filtering textures are loaded with, so
+///         that a sw::ResourceCache only shares identical images between
+///         ResourceIds when they would be uploaded the same way.
+Id TextureLoadPolicy::getVariant() const
+{
+    return Id(uint64_t(format_) |
+              (uint64_t(srgb_color_ ? 1 : 0) << 8) |
+              (uint64_t(mag_mode_) << 16) |
+              (uint64_t(min_mode_) << 24));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Identifies textures among the content hashes stored in a
+///         sandwich; importers should pass the same Id to
+///         sw::storeContentHash().
+Id TextureLoadPolicy::getContentType() const
+{
+    return Id("pbj::gfx::Texture");
+}
+
+} // namespace pbj::gfx
+} // namespace pbj
@@ -0,0 +1,211 @@
+// Copyright (c) 2013 PBJ^2 Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   pbj/sw/content_resolver.cpp
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of pbj::sw::ContentResolver functions.
+
+#include "pbj/sw/content_resolver.h"
+
+#include "be/bed/cached_stmt.h"
+#include "be/bed/row_reader.h"
+#include "pbj/sw/sandwich_open.h"
+#include "pbj/sql_ids.h"
+
+#include <tuple>
+
+namespace pbj {
+namespace sw {
+
+bool ContentHash::operator==(const ContentHash& other) const
+{
+    return hash == other.hash && size == other.size;
+}
+
+bool ContentHash::operator!=(const ContentHash& other) const
+{
+    return !(*this == other);
+}
+
+bool ContentHash::operator<(const ContentHash& other) const
+{
+    return std::tie(hash, size) < std::tie(other.hash, other.size);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Calculates the ContentHash of a resource's stored data.
+///
+/// \param  data The data, exactly as it is stored in the sandwich.
+/// \param  size The length of the data in bytes.
+/// \return The hash and size of the data.
+ContentHash hashContent(const void* data, size_t size)
+{
+    const uint8_t* ptr = static_cast<const uint8_t*>(data);
+    const uint8_t* end = ptr + size;
+
+    uint64_t hash = BE_ID_FNV_OFFSET_BASIS;
+    for (; ptr != end; ++ptr)
+        hash = (hash ^ *ptr) * BE_ID_FNV_PRIME;
+
+    ContentHash content;
+    content.hash = hash;
+    content.size = size;
+    return content;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Records the ContentHash of a resource which is being imported
+///         into a sandwich.
+///
+/// \details Should be called whenever an importer writes a resource's data,
+///         ideally in the same transaction, so that ContentResolver can
+///         recognize resources with identical data.  The
+///         \c pbj_sandwich_content table is created if necessary.
+///
+/// \param  sandwich A writable sandwich.
+/// \param  type Identifies the type of the resource; the same Id must be
+///         returned by the \c getContentType() of policies which load it.
+/// \param  resource The resource portion of the resource's ResourceId.
+/// \param  hash The result of hashContent() for the data that was stored.
+/// \throws db::Db::error if the hash can't be written.
+void storeContentHash(Sandwich& sandwich, const Id& type, const Id& resource, const ContentHash& hash)
+{
+    db::StmtCache& cache = sandwich.getStmtCache();
+
+    db::CachedStmt create(cache.hold(Id(PBJ_SW_CONTENT_SQLID_CREATE_TABLE), PBJ_SW_CONTENT_SQL_CREATE_TABLE));
+    create.step();
+
+    db::CachedStmt save(cache.hold(Id(PBJ_SW_CONTENT_SQLID_SAVE), PBJ_SW_CONTENT_SQL_SAVE));
+    save.bindAll(type, resource, hash.hash, hash.size);
+    save.step();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a resolver which hasn't read any hashes yet.
+ContentResolver::ContentResolver()
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Finds the canonical ResourceId for a resource's data.
+///
+/// \details The first time a resource from a sandwich is resolved, the
+///         sandwich's content hashes are read (if readDirectory() found a
+///         \c pbj_sandwich_content table in it).  That happens on the calling
+///         thread, but it is a single query per sandwich.
+///
+/// \param  id The ResourceId of the resource.
+/// \param  type The type Id the resource's hash was stored with (see
+///         storeContentHash()).
+/// \param  variant Identifies the settings the resource will be loaded with.
+///         Resources loaded with different settings are never shared.
+/// \return The ResourceId of the first resource resolved with the same type,
+///         variant, and data, or \c id if there is none or its hash isn't
+///         known.
+ResourceId ContentResolver::resolve(const ResourceId& id, const Id& type, const Id& variant)
+{
+    if (loaded_.find(id.sandwich) == loaded_.end())
+        load_(id.sandwich);
+
+    auto i(hashes_.find(hash_key_t(type, id)));
+    if (i == hashes_.end())
+        return id;
+
+    Key key;
+    key.type = type;
+    key.variant = variant;
+    key.content = i->second;
+
+    return canonical_.insert(std::make_pair(key, id)).first->second;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Forgets all content hashes, so they will be read again as they
+///         are needed.
+/// \details Must be called after the data or hashes of resources in any
+///         sandwich the resolver has read are changed.  Resources which are
+///         already loaded under their old canonical ResourceId are not
+///         affected.
+///
+///         Sandwiches are only read if readDirectory() found a
+///         \c pbj_sandwich_content table in them, so call readDirectory()
+///         first if any sandwich may have gained that table since it was
+///         last scanned.
+void ContentResolver::clear()
+{
+    loaded_.clear();
+    hashes_.clear();
+    canonical_.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the number of resources whose content hash has been read.
+size_t ContentResolver::getHashCount() const
+{
+    return hashes_.size();
+}
+
+bool ContentResolver::Key::operator<(const Key& other) const
+{
+    return std::tie(type, variant, content) < std::tie(other.type, other.variant, other.content);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads the content hashes stored in a sandwich.
+/// \details If the sandwich can't be read, its resources resolve to
+///         themselves.  Either way it isn't read again until clear() is
+///         called.
+void ContentResolver::load_(const Id& sandwich_id)
+{
+    loaded_[sandwich_id] = true;
+
+    if (!hasTable(sandwich_id, "pbj_sandwich_content"))
+        return;
+
+    try
+    {
+        std::shared_ptr<Sandwich> sandwich(open(sandwich_id));
+        if (!sandwich)
+            return;
+
+        db::CachedStmt load(sandwich->getStmtCache().hold(Id(PBJ_SW_CONTENT_SQLID_LOAD), PBJ_SW_CONTENT_SQL_LOAD));
+        while (load.step())
+        {
+            hash_key_t key(Id(), ResourceId(sandwich_id, Id()));
+            ContentHash hash;
+            db::RowReader row(load);
+            row >> key.first >> key.second.resource >> hash.hash >> hash.size;
+
+            hashes_[key] = hash;
+        }
+    }
+    catch (const db::Db::error& e)
+    {
+        PBJ_LOG(VWarning) << "Database error while reading content hashes!" << PBJ_LOG_NL
+                          << "Sandwich ID: " << sandwich_id << PBJ_LOG_NL
+                          << "  Exception: " << e.what() << PBJ_LOG_NL
+                          << "        SQL: " << e.sql() << PBJ_LOG_END;
+    }
+}
+
+} // namespace pbj::sw
+} // namespace pbj
@@ -0,0 +1,290 @@
+// Copyright (c) 2013 PBJ^2 Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   pbj/sw/resource_cache.cpp
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of pbj::sw::ResourceCache functions.
+
+#include "pbj/sw/resource_cache.h"
+
+#include <cassert>
+#include <chrono>
+
+namespace pbj {
+namespace sw {
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Creates an entry for a resource which is just starting to load.
+ResourceCacheEntry::ResourceCacheEntry()
+   : state(SLoading),
+     references(0),
+     cpu_bytes(0),
+     gpu_bytes(0),
+     unreferenced(false)
+{
+}
+
+} // namespace pbj::sw::detail
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs an empty cache.
+///
+/// \param  loader The loader used to load resources.  It must outlive the
+///         cache.
+/// \param  cpu_budget The number of bytes of main memory which resident
+///         resources may use before unreferenced ones are evicted.
+/// \param  gpu_budget The number of bytes of video memory which resident
+///         resources may use before unreferenced ones are evicted.
+ResourceCache::ResourceCache(ResourceLoader& loader, size_t cpu_budget, size_t gpu_budget)
+   : loader_(loader),
+     resolver_(nullptr),
+     cpu_budget_(cpu_budget),
+     gpu_budget_(gpu_budget)
+{
+    stats_.hits = 0;
+    stats_.misses = 0;
+    stats_.evictions = 0;
+    stats_.deduplicated = 0;
+    stats_.loading = 0;
+    stats_.resident = 0;
+    stats_.unreferenced = 0;
+    stats_.cpu_bytes = 0;
+    stats_.gpu_bytes = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Unloads every resource in the cache.
+/// \details All CachedResources must have been released already.
+ResourceCache::~ResourceCache()
+{
+    for (auto i(entries_.begin()), end(entries_.end()); i != end; ++i)
+    {
+        assert(i->second.references == 0);
+        i->second.unload();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Accounts for resources which have finished loading, and evicts
+///         unreferenced resources if the cache is over budget.
+/// \details Should be called once per frame, after ResourceLoader::update().
+void ResourceCache::update()
+{
+    for (auto i(loading_.begin()); i != loading_.end(); )
+    {
+        detail::ResourceCacheEntry& entry = **i;
+        if (entry.ready.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            ++i;
+            continue;
+        }
+
+        i = loading_.erase(i);
+        --stats_.loading;
+
+        try
+        {
+            entry.ready.get();
+        }
+        catch (...)
+        {
+            // The loader has already logged the failure.
+            entry.state = detail::ResourceCacheEntry::SFailed;
+            if (entry.references == 0)
+                remove_(entry);
+
+            continue;
+        }
+
+        entry.state = detail::ResourceCacheEntry::SResident;
+        entry.measure(entry.cpu_bytes, entry.gpu_bytes);
+
+        ++stats_.resident;
+        stats_.cpu_bytes += entry.cpu_bytes;
+        stats_.gpu_bytes += entry.gpu_bytes;
+
+        if (entry.references == 0)
+        {
+            lru_.push_front(&entry);
+            entry.lru = lru_.begin();
+            entry.unreferenced = true;
+            ++stats_.unreferenced;
+        }
+    }
+
+    evict_();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Sets the ContentResolver used to find resources with identical
+///         data.
+///
+/// \details Only affects resources held afterwards.  Resources already in
+///         the cache stay under the ResourceId they were loaded with.
+///
+/// \param  resolver The resolver to use, or \c nullptr to cache resources
+///         by their own ResourceIds.  It must outlive the cache, or be
+///         replaced before it is destroyed.
+void ResourceCache::setResolver(ContentResolver* resolver)
+{
+    resolver_ = resolver;
+}
+
+ContentResolver* ResourceCache::getResolver() const
+{
+    return resolver_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Changes the cache's budgets, evicting resources if necessary.
+///
+/// \param  cpu_budget The number of bytes of main memory which resident
+///         resources may use before unreferenced ones are evicted.
+/// \param  gpu_budget The number of bytes of video memory which resident
+///         resources may use before unreferenced ones are evicted.
+void ResourceCache::setBudget(size_t cpu_budget, size_t gpu_budget)
+{
+    cpu_budget_ = cpu_budget;
+    gpu_budget_ = gpu_budget;
+    evict_();
+}
+
+size_t ResourceCache::getCpuBudget() const
+{
+    return cpu_budget_;
+}
+
+size_t ResourceCache::getGpuBudget() const
+{
+    return gpu_budget_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the cache's hit and miss counts and the amount of memory
+///         used by resident resources.
+const ResourceCacheStats& ResourceCache::getStats() const
+{
+    return stats_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Looks up the entry for a resource.
+detail::ResourceCacheEntry* ResourceCache::find_(const key_t& key)
+{
+    auto i(entries_.find(key));
+    if (i == entries_.end())
+        return nullptr;
+
+    return &i->second;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Creates the entry for a resource which has just been requested.
+detail::ResourceCacheEntry& ResourceCache::insert_(const key_t& key)
+{
+    detail::ResourceCacheEntry& entry = entries_[key];
+    entry.key = key;
+
+    loading_.push_back(&entry);
+    ++stats_.loading;
+
+    return entry;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Counts a new CachedResource referring to an entry.
+void ResourceCache::addRef_(detail::ResourceCacheEntry& entry)
+{
+    if (entry.references++ == 0 && entry.unreferenced)
+    {
+        lru_.erase(entry.lru);
+        entry.unreferenced = false;
+        --stats_.unreferenced;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Counts the destruction of a CachedResource referring to an entry.
+/// \details When a resident resource is no longer referenced, it becomes the
+///         most recently used candidate for eviction.  Resources which failed
+///         to load are forgotten, so they will be retried the next time they
+///         are held.
+void ResourceCache::release_(detail::ResourceCacheEntry& entry)
+{
+    assert(entry.references > 0);
+
+    if (--entry.references > 0)
+        return;
+
+    if (entry.state == detail::ResourceCacheEntry::SResident)
+    {
+        lru_.push_front(&entry);
+        entry.lru = lru_.begin();
+        entry.unreferenced = true;
+        ++stats_.unreferenced;
+
+        evict_();
+    }
+    else if (entry.state == detail::ResourceCacheEntry::SFailed)
+    {
+        remove_(entry);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Unloads a resource and forgets about it.
+void ResourceCache::remove_(detail::ResourceCacheEntry& entry)
+{
+    if (entry.unreferenced)
+    {
+        lru_.erase(entry.lru);
+        --stats_.unreferenced;
+    }
+
+    if (entry.state == detail::ResourceCacheEntry::SResident)
+    {
+        --stats_.resident;
+        stats_.cpu_bytes -= entry.cpu_bytes;
+        stats_.gpu_bytes -= entry.gpu_bytes;
+    }
+
+    key_t key(entry.key);
+    entry.unload();
+    entries_.erase(key);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Evicts the least recently released resources until the resident
+///         resources fit within both budgets, or there are no unreferenced
+///         resources left.
+void ResourceCache::evict_()
+{
+    while ((stats_.cpu_bytes > cpu_budget_ || stats_.gpu_bytes > gpu_budget_) && !lru_.empty())
+    {
+        remove_(*lru_.back());
+        ++stats_.evictions;
+    }
+}
+
+} // namespace pbj::sw
+} // namespace pbj
@@ -0,0 +1,446 @@
+// Copyright (c) 2013 PBJ^2 Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   pbj/sw/resource_loader.cpp
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of pbj::sw::ResourceLoader functions.
+
+#include "pbj/sw/resource_loader.h"
+
+#include "pbj/sw/sandwich_open.h"
+#include "be/profiler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace pbj {
+namespace sw {
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Creates a job which has not yet been submitted.
+ResourceJob::ResourceJob(const ResourceId& id, int priority)
+   : id(id),
+     priority(priority),
+     sequence(0),
+     cancelled(false),
+     finished(false),
+     future(promise.get_future().share())
+{
+}
+
+ResourceJob::~ResourceJob()
+{
+}
+
+} // namespace pbj::sw::detail
+namespace {
+
+// Orders the job queues so that the front of the heap is the job with the
+// highest priority which was submitted first.
+struct JobOrder
+{
+   bool operator()(const std::shared_ptr<detail::ResourceJob>& a,
+                   const std::shared_ptr<detail::ResourceJob>& b) const
+   {
+      return a->priority < b->priority ||
+             (a->priority == b->priority && a->sequence > b->sequence);
+   }
+};
+
+} // namespace pbj::sw::(anon)
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Starts a loader with #PBJ_SW_RESOURCE_LOADER_DEFAULT_IO_THREADS
+///         I/O threads, and one CPU thread for each core except the one used
+///         by the calling thread.
+ResourceLoader::ResourceLoader()
+{
+    unsigned int cores = std::thread::hardware_concurrency();
+    start_(PBJ_SW_RESOURCE_LOADER_DEFAULT_IO_THREADS, cores > 1 ? cores - 1 : 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Starts a loader with a specific number of threads.
+///
+/// \param  io_threads The number of threads to read from sandwiches with.
+///         At least one is always used.
+/// \param  cpu_threads The number of threads to decode resources with.  At
+///         least one is always used.
+ResourceLoader::ResourceLoader(size_t io_threads, size_t cpu_threads)
+{
+    start_(io_threads, cpu_threads);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Stops the loader's threads and destroys all of its resources.
+/// \details Requests which haven't been finalized are abandoned.
+ResourceLoader::~ResourceLoader()
+{
+    assert(std::this_thread::get_id() == owner_);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+
+    io_ready_.notify_all();
+    cpu_ready_.notify_all();
+
+    for (auto i(threads_.begin()), end(threads_.end()); i != end; ++i)
+        i->join();
+
+    io_queue_.clear();
+    cpu_queue_.clear();
+    finalize_queue_.clear();
+    jobs_.clear();
+    pools_.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Finalizes resources which have been read and decoded, in order of
+///         priority, until there are none left or the time budget runs out.
+///
+/// \details Resources which failed to load are logged here.  At least one
+///         resource is finalized if any are ready, regardless of the budget.
+///
+/// \param  budget The approximate amount of time to spend finalizing
+///         resources.
+/// \return The number of requests which were finalized or failed.
+size_t ResourceLoader::update(const std::chrono::duration<double>& budget)
+{
+    BE_PROFILE_FUNCTION();
+    assert(std::this_thread::get_id() == owner_);
+
+    std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+    size_t finished = 0;
+
+    while (true)
+    {
+        job_ptr job;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (finalize_queue_.empty())
+                break;
+
+            job = pop_(finalize_queue_);
+            if (job->cancelled)
+                continue;
+
+            --pending_count_;
+        }
+
+        finalize_(*job);
+        ++finished;
+
+        if (std::chrono::steady_clock::now() - start >= budget)
+            break;
+    }
+
+    return finished;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Blocks until every outstanding request has been finalized (or
+///         has failed).
+void ResourceLoader::flush()
+{
+    assert(std::this_thread::get_id() == owner_);
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (pending_count_ > 0 && finalize_queue_.empty())
+                finalize_ready_.wait(lock);
+
+            if (pending_count_ == 0)
+                return;
+        }
+
+        update(std::chrono::duration<double>::max());
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the number of requests which have been made but not
+///         finalized or unloaded yet.
+size_t ResourceLoader::getPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_count_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Initializes the loader and starts its threads.
+void ResourceLoader::start_(size_t io_threads, size_t cpu_threads)
+{
+    owner_ = std::this_thread::get_id();
+    pending_count_ = 0;
+    next_sequence_ = 0;
+    stopping_ = false;
+
+    io_threads = std::max(io_threads, size_t(1));
+    cpu_threads = std::max(cpu_threads, size_t(1));
+
+    threads_.reserve(io_threads + cpu_threads);
+
+    for (size_t i = 0; i < io_threads; ++i)
+        threads_.push_back(std::thread(&ResourceLoader::runIo_, this));
+
+    for (size_t i = 0; i < cpu_threads; ++i)
+        threads_.push_back(std::thread(&ResourceLoader::runCpu_, this));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Looks for an existing request, raising its priority if necessary.
+///
+/// \return The existing job, or an empty pointer if there isn't one.
+ResourceLoader::job_ptr ResourceLoader::find_(const key_t& key, int priority)
+{
+    assert(std::this_thread::get_id() == owner_);
+
+    auto i(jobs_.find(key));
+    if (i == jobs_.end())
+        return job_ptr();
+
+    job_ptr job(i->second);
+    if (!job->finished && priority > job->priority)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job->priority = priority;
+
+        std::make_heap(io_queue_.begin(), io_queue_.end(), JobOrder());
+        std::make_heap(cpu_queue_.begin(), cpu_queue_.end(), JobOrder());
+        std::make_heap(finalize_queue_.begin(), finalize_queue_.end(), JobOrder());
+    }
+
+    return job;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Records a new request and queues it to be read.
+void ResourceLoader::submit_(const key_t& key, const job_ptr& job)
+{
+    assert(std::this_thread::get_id() == owner_);
+
+    jobs_[key] = job;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job->sequence = next_sequence_++;
+        ++pending_count_;
+        push_(io_queue_, job);
+    }
+
+    io_ready_.notify_one();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Forgets a request, cancelling it if it is still in progress.
+/// \details If the resource has been finalized, it is destroyed here, since
+///         no other thread has a reference to its job anymore.
+bool ResourceLoader::unload_(const key_t& key)
+{
+    assert(std::this_thread::get_id() == owner_);
+
+    auto i(jobs_.find(key));
+    if (i == jobs_.end())
+        return false;
+
+    job_ptr job(i->second);
+    jobs_.erase(i);
+
+    if (!job->finished)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!job->cancelled)
+        {
+            job->cancelled = true;
+            --pending_count_;
+        }
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Completes a request on the owning thread, logging it if any stage
+///         failed.
+void ResourceLoader::finalize_(detail::ResourceJob& job)
+{
+    job.finished = true;
+
+    try
+    {
+        if (job.error)
+            std::rethrow_exception(job.error);
+
+        job.finalize();
+        job.promise.set_value();
+    }
+    catch (const std::exception& e)
+    {
+        PBJ_LOG(VWarning) << "Failed to load resource!" << PBJ_LOG_NL
+                          << "Resource ID: " << job.id << PBJ_LOG_NL
+                          << "  Exception: " << e.what() << PBJ_LOG_END;
+
+        job.promise.set_exception(std::current_exception());
+    }
+    catch (...)
+    {
+        PBJ_LOG(VWarning) << "Failed to load resource!" << PBJ_LOG_NL
+                          << "Resource ID: " << job.id << PBJ_LOG_END;
+
+        job.promise.set_exception(std::current_exception());
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the connection pool for a sandwich, opening it the first
+///         time it is needed.  Called on I/O threads.
+std::shared_ptr<db::ConnectionPool<Sandwich> > ResourceLoader::getPool_(const Id& sandwich)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto i(pools_.find(sandwich));
+        if (i != pools_.end())
+            return i->second;
+    }
+
+    std::shared_ptr<db::ConnectionPool<Sandwich> > pool(openPool(sandwich));
+    if (!pool)
+        throw std::runtime_error("Sandwich not found!");
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    pools_[sandwich] = pool;
+    return pool;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Adds a job to one of the queues.  mutex_ must be locked.
+void ResourceLoader::push_(std::vector<job_ptr>& queue, const job_ptr& job)
+{
+    queue.push_back(job);
+    std::push_heap(queue.begin(), queue.end(), JobOrder());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Removes the most important job from one of the queues.  mutex_
+///         must be locked.
+ResourceLoader::job_ptr ResourceLoader::pop_(std::vector<job_ptr>& queue)
+{
+    std::pop_heap(queue.begin(), queue.end(), JobOrder());
+    job_ptr job(std::move(queue.back()));
+    queue.pop_back();
+    return job;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads queued jobs from their sandwiches until the loader is
+///         destroyed.
+void ResourceLoader::runIo_()
+{
+    while (true)
+    {
+        job_ptr job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!stopping_ && io_queue_.empty())
+                io_ready_.wait(lock);
+
+            if (stopping_)
+                return;
+
+            job = pop_(io_queue_);
+            if (job->cancelled)
+                continue;
+        }
+
+        try
+        {
+            std::shared_ptr<db::ConnectionPool<Sandwich> > pool(getPool_(job->id.sandwich));
+            db::PooledConnection<Sandwich> sandwich(pool->hold());
+            job->read(*sandwich);
+        }
+        catch (...)
+        {
+            job->error = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (job->error)
+        {
+            push_(finalize_queue_, job);
+            finalize_ready_.notify_one();
+        }
+        else
+        {
+            push_(cpu_queue_, job);
+            cpu_ready_.notify_one();
+        }
+
+        // Release the job before unlocking, so that a finalized resource is
+        // never destroyed on this thread.
+        job.reset();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Decodes jobs which have been read until the loader is destroyed.
+void ResourceLoader::runCpu_()
+{
+    while (true)
+    {
+        job_ptr job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!stopping_ && cpu_queue_.empty())
+                cpu_ready_.wait(lock);
+
+            if (stopping_)
+                return;
+
+            job = pop_(cpu_queue_);
+            if (job->cancelled)
+                continue;
+        }
+
+        try
+        {
+            job->decode();
+        }
+        catch (...)
+        {
+            job->error = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        push_(finalize_queue_, job);
+        finalize_ready_.notify_one();
+        job.reset();
+    }
+}
+
+} // namespace pbj::sw
+} // namespace pbj
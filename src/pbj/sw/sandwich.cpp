@@ -26,28 +26,51 @@
 
 #include "pbj/sw/sandwich.h"
 
-///////////////////////////////////////////////////////////////////////////////
-/// \brief  SQL statement to get the Id of a DbFile.
-/// \details The Id is stored in the 'id' property of the
-///         'pbj_sandwich_properties' table.
-#define PBJ_SW_SANDWICH_SQL_GET_ID "SELECT value FROM pbj_sandwich_properties WHERE property = 'id' LIMIT 1"
+#include "pbj/sql_ids.h"
 
-#ifdef BE_ID_NAMES_ENABLED
-#define PBJ_SW_SANDWICH_SQLID_GET_ID     PBJ_SW_SANDWICH_SQL_GET_ID
-#else
-// TODO: precalculate SQLID using idgen.exe
-#define PBJ_SW_SANDWICH_SQLID_GET_ID     PBJ_SW_SANDWICH_SQL_GET_ID
-#endif
 namespace pbj {
 namespace sw {
+namespace {
 
+db::DbConfig getWritableConfig()
+{
+#ifdef PBJ_EDITOR
+   return db::DbConfig::editor();
+#else
+   return db::DbConfig::writable();
+#endif
+}
+
+} // namespace pbj::sw::(anon)
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Opens a sandwich, configuring the connection with
+///         DbConfig::readOnly() if \c read_only is true.
+/// \details Writable connections use DbConfig::editor() in the editor
+///         (#PBJ_EDITOR), or DbConfig::writable() otherwise, so that only
+///         the editor switches sandwiches to WAL.
+///
+/// \param  path The location of the sandwich's SQLite database.
+/// \param  read_only Whether or not the sandwich should be modifiable.
 Sandwich::Sandwich(const std::string& path, bool read_only)
-   : db_(path, read_only ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE),
+   : db_(path, read_only ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+         read_only ? db::DbConfig::readOnly() : getWritableConfig()),
      stmt_cache_(db_)
 {
-    db::CachedStmt& get_id(stmt_cache_.hold(Id(PBJ_SW_SANDWICH_SQLID_GET_ID), PBJ_SW_SANDWICH_SQL_GET_ID));
-    if (get_id.step())
-        id_ = Id(get_id.getUInt64(0));
+    readId_();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Opens a sandwich using a specific connection configuration.
+///
+/// \param  path The location of the sandwich's SQLite database.
+/// \param  read_only Whether or not the sandwich should be modifiable.
+/// \param  config The PRAGMA settings to apply to the database connection.
+Sandwich::Sandwich(const std::string& path, bool read_only, const db::DbConfig& config)
+   : db_(path, read_only ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, config),
+     stmt_cache_(db_)
+{
+    readId_();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -79,5 +102,14 @@ db::StmtCache& Sandwich::getStmtCache()
    return stmt_cache_;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads the sandwich's Id from its properties table.
+void Sandwich::readId_()
+{
+    db::CachedStmt get_id(stmt_cache_.hold(Id(PBJ_SW_SANDWICH_SQLID_GET_ID), PBJ_SW_SANDWICH_SQL_GET_ID));
+    if (get_id.step())
+        id_ = Id(get_id.getUInt64(0));
+}
+
 } // namespace pbj::sw
 } // namespace pbj
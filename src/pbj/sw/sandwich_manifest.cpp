@@ -0,0 +1,260 @@
+// Copyright (c) 2013 PBJ^2 Productions
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   pbj/sw/sandwich_manifest.cpp
+/// \author Benjamin Crist
+///
+/// \brief  Implementations of pbj::sw::SandwichManifest functions.
+
+#include "pbj/sw/sandwich_manifest.h"
+
+#include "be/bed/row_reader.h"
+#include "be/bed/transaction.h"
+#include "pbj/sw/sandwich.h"
+#include "pbj/sql_ids.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <ctime>
+#include <stdexcept>
+
+namespace pbj {
+namespace sw {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Loads a manifest file, if it exists.
+///
+/// \param  path The location of the manifest's SQLite database.  It will be
+///         created by save() if necessary.
+SandwichManifest::SandwichManifest(const std::string& path)
+   : path_(path),
+     outdated_(false),
+     opened_(0)
+{
+    load_();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the manifest entry for a sandwich, opening the sandwich
+///         to update the entry if it has changed.
+///
+/// \details A sandwich is considered unchanged if its modification time and
+///         size match the entry, and it does not have a write-ahead log
+///         (changes in the log aren't reflected in the main file's size or
+///         modification time).
+///
+///         This may be called from several threads at once, as long as each
+///         thread refreshes different sandwiches.  The manifest is only
+///         locked while looking up or storing the entry, not while the
+///         sandwich is open.
+///
+/// \param  sandwich_path The location of the sandwich.
+/// \return The up-to-date entry for the sandwich.
+/// \throws std::runtime_error if the file does not exist.
+/// \throws db::Db::error if the sandwich must be opened, but can't be.
+SandwichManifestEntry SandwichManifest::refresh(const std::string& sandwich_path)
+{
+    struct stat st;
+    if (stat(sandwich_path.c_str(), &st) != 0)
+        throw std::runtime_error("Could not read sandwich file status!");
+
+    struct stat wal_st;
+    bool has_wal = stat((sandwich_path + "-wal").c_str(), &wal_st) == 0 && wal_st.st_size > 0;
+
+    if (!has_wal)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto i(records_.find(sandwich_path));
+        if (i != records_.end() &&
+            i->second.entry.mtime == int64_t(st.st_mtime) &&
+            i->second.entry.size == int64_t(st.st_size))
+        {
+            i->second.seen = true;
+            return i->second.entry;
+        }
+    }
+
+    Record record;
+    record.seen = true;
+    record.changed = true;
+
+    {
+        Sandwich sandwich(sandwich_path, true);
+        db::StmtCache& cache = sandwich.getStmtCache();
+
+        record.entry.id = sandwich.getId();
+        record.entry.schema_version = 0;
+
+        db::CachedStmt get_version(cache.hold(Id(PBJ_SW_SANDWICH_SQLID_GET_SCHEMA_VERSION), PBJ_SW_SANDWICH_SQL_GET_SCHEMA_VERSION));
+        if (get_version.step())
+            record.entry.schema_version = get_version.getUInt(0);
+
+        db::CachedStmt get_tables(cache.hold(Id(PBJ_SW_SANDWICH_SQLID_TABLES), PBJ_SW_SANDWICH_SQL_TABLES));
+        while (get_tables.step())
+            record.entry.tables.append(get_tables.getText(0)).append(1, '\n');
+    }
+
+    record.entry.size = st.st_size;
+
+    // Files modified in the last second could be modified again without
+    // their mtime changing, so don't trust the cached entry next time.
+    if (int64_t(st.st_mtime) >= int64_t(time(nullptr)) - 1)
+        record.entry.mtime = -1;
+    else
+        record.entry.mtime = st.st_mtime;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++opened_;
+    records_[sandwich_path] = record;
+    return record.entry;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Writes any entries updated by refresh() to the manifest file, and
+///         removes entries for sandwiches which were not refreshed.
+///
+/// \details If nothing has changed, the manifest file is not touched.
+///         Errors are logged rather than thrown, since the manifest is only
+///         a cache.
+///
+///         Entries for sandwiches which could not be opened are removed, so
+///         they will be tried again next time.
+void SandwichManifest::save()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    bool dirty = outdated_;
+    for (auto i(records_.begin()), end(records_.end()); i != end && !dirty; ++i)
+        dirty = i->second.changed || !i->second.seen;
+
+    if (!dirty)
+        return;
+
+    try
+    {
+        db::Db db(path_, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+
+        bool rewrite = db.getInt(PBJ_SW_MANIFEST_SQL_GET_VERSION, 0) != PBJ_SW_MANIFEST_VERSION;
+        db::Transaction transaction(db, db::Transaction::Immediate);
+        if (rewrite)
+        {
+            db.exec(PBJ_SW_MANIFEST_SQL_DROP_TABLE);
+            db.exec(PBJ_SW_MANIFEST_SQL_SET_VERSION);
+        }
+        db.exec(PBJ_SW_MANIFEST_SQL_CREATE_TABLE);
+
+        db::Stmt save(db, Id(PBJ_SW_MANIFEST_SQLID_SAVE), PBJ_SW_MANIFEST_SQL_SAVE);
+        db::Stmt remove(db, Id(PBJ_SW_MANIFEST_SQLID_REMOVE), PBJ_SW_MANIFEST_SQL_REMOVE);
+
+        for (auto i(records_.begin()); i != records_.end(); )
+        {
+            Record& record = i->second;
+            if (!record.seen)
+            {
+                remove.bind(1, i->first);
+                remove.step();
+                remove.reset();
+                i = records_.erase(i);
+                continue;
+            }
+
+            if (record.changed || rewrite)
+            {
+                save.bindAll(i->first, record.entry.mtime, record.entry.size,
+                             record.entry.id, record.entry.schema_version,
+                             record.entry.tables);
+                save.step();
+                save.reset();
+            }
+            ++i;
+        }
+
+        transaction.commit();
+
+        outdated_ = false;
+        for (auto i(records_.begin()), end(records_.end()); i != end; ++i)
+            i->second.changed = false;
+    }
+    catch (const db::Db::error& e)
+    {
+        PBJ_LOG(VWarning) << "Database error while saving sandwich manifest!" << PBJ_LOG_NL
+                          << "     Path: " << path_ << PBJ_LOG_NL
+                          << "Exception: " << e.what() << PBJ_LOG_NL
+                          << "      SQL: " << e.sql() << PBJ_LOG_END;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the number of sandwiches which refresh() has had to
+///         open because they were not in the manifest or had changed.
+///
+/// \return The number of sandwiches opened.
+size_t SandwichManifest::getOpenedCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return opened_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads every entry from the manifest file.
+///
+/// \details If the file doesn't exist, can't be read, or was written with a
+///         different #PBJ_SW_MANIFEST_VERSION, the manifest starts out empty.
+void SandwichManifest::load_()
+{
+    struct stat st;
+    if (stat(path_.c_str(), &st) != 0)
+        return;
+
+    try
+    {
+        db::Db db(path_, SQLITE_OPEN_READONLY);
+        if (db.getInt(PBJ_SW_MANIFEST_SQL_GET_VERSION, 0) != PBJ_SW_MANIFEST_VERSION)
+        {
+            outdated_ = true;
+            return;
+        }
+
+        db::Stmt load(db, Id(PBJ_SW_MANIFEST_SQLID_LOAD), PBJ_SW_MANIFEST_SQL_LOAD);
+        while (load.step())
+        {
+            Record record;
+            db::RowReader row(load, 1);
+            row >> record.entry.mtime >> record.entry.size >> record.entry.id
+                >> record.entry.schema_version >> record.entry.tables;
+            record.seen = false;
+            record.changed = false;
+            records_[load.getText(0)] = record;
+        }
+    }
+    catch (const db::Db::error& e)
+    {
+        records_.clear();
+        outdated_ = true;
+        PBJ_LOG(VWarning) << "Database error while loading sandwich manifest!" << PBJ_LOG_NL
+                          << "     Path: " << path_ << PBJ_LOG_NL
+                          << "Exception: " << e.what() << PBJ_LOG_NL
+                          << "      SQL: " << e.sql() << PBJ_LOG_END;
+    }
+}
+
+} // namespace pbj::sw
+} // namespace pbj
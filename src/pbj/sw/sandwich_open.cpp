@@ -27,10 +27,19 @@
 
 #include "pbj/sw/sandwich_open.h"
 
+#include "pbj/sw/sandwich_manifest.h"
+#include "be/id_map.h"
+#include "be/profiler.h"
+
 #include <dirent.h>
 
 #include <iostream>
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace pbj {
 namespace sw {
@@ -39,26 +48,139 @@ namespace {
 struct SandwichInfo
 {
    std::string path;
+   std::string tables;  ///< Table names from the SandwichManifest, each followed by '\n'.
    std::weak_ptr<Sandwich> sandwich;
+   std::weak_ptr<db::ConnectionPool<Sandwich> > pool;
+   std::shared_ptr<db::WriteQueue<Sandwich> > write_queue;
 };
 
-typedef std::unordered_map<Id, SandwichInfo> sw_map_t;
+// IdMap may move its values when it grows, so each SandwichInfo is
+// allocated separately to keep pointers to it valid across rescans.
+typedef be::IdMap<std::unique_ptr<SandwichInfo> > sw_map_t;
 
 sw_map_t sandwiches;
+std::mutex open_mutex;  ///< Guards sandwiches and every SandwichInfo in it.
 
+// open_mutex must be held by the caller.
 SandwichInfo* getSWI(const Id& sandwich_id)
 {
    auto i(sandwiches.find(sandwich_id));
    if (i == sandwiches.end())
       return nullptr;
 
-   return &i->second;
+   return i->second.get();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  The outcome of reading one sandwich during readDirectory().
+struct ScanResult
+{
+   std::string path;
+   SandwichManifestEntry entry;
+   bool db_error;          ///< error came from a db::Db::error.
+   std::string error;      ///< Empty if the sandwich was read successfully.
+   std::string error_sql;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Checks whether a sandwich's packed schema version can be read by
+///         this build.
+bool isSchemaSupported(uint32_t version)
+{
+   if (version == 0)
+      return true;   // predates schema versioning
+
+   return (version >> 16) == (PBJ_SW_SCHEMA_VERSION >> 16) &&
+          (version & 0xFFFF) <= (PBJ_SW_SCHEMA_VERSION & 0xFFFF);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Refreshes the manifest entry of each sandwich in \c results,
+///         using several threads.
+/// \details Opening a sandwich is mostly waiting on the disk, so more threads
+///         than cores are used (up to #PBJ_SW_READ_DIRECTORY_MAX_THREADS)
+///         to keep several reads in flight.  Each thread claims the next
+///         unread result, and errors are recorded in the result rather than
+///         logged, so that readDirectory() can report them in order.
+void scanSandwiches(SandwichManifest& manifest, std::vector<ScanResult>& results)
+{
+   std::atomic<size_t> next(0);
+   auto work = [&]()
+   {
+      for (size_t i = next++; i < results.size(); i = next++)
+      {
+         ScanResult& result = results[i];
+         try
+         {
+            result.entry = manifest.refresh(result.path);
+         }
+         catch (const db::Db::error& e)
+         {
+            result.db_error = true;
+            result.error = e.what();
+            result.error_sql = e.sql();
+         }
+         catch (const std::exception& e)
+         {
+            result.error = e.what();
+         }
+      }
+   };
+
+   size_t thread_count = std::max(2u, std::thread::hardware_concurrency()) * 2;
+   thread_count = std::min(thread_count, size_t(PBJ_SW_READ_DIRECTORY_MAX_THREADS));
+   thread_count = std::min(thread_count, results.size());
+
+   std::vector<std::thread> threads;
+   for (size_t i = 1; i < thread_count; ++i)
+      threads.push_back(std::thread(work));
+
+   work();
+
+   for (auto i(threads.begin()), end(threads.end()); i != end; ++i)
+      i->join();
 }
 
 } // namespace pbj::sw::(anon)
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Finds all sandwiches in a directory so that they can be opened by
+///         Id.
+///
+/// \details Uses the manifest file #PBJ_SW_MANIFEST_FILENAME in the same
+///         directory, so only sandwiches which have changed since the last
+///         scan need to be opened.
+///
+/// \param  path The directory to scan, including a trailing slash.
 void readDirectory(const std::string& path)
 {
+    readDirectory(path, path + PBJ_SW_MANIFEST_FILENAME);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Finds all sandwiches in a directory so that they can be opened by
+///         Id, using a specific manifest file.
+///
+/// \details Sandwiches which aren't current in the manifest are opened and
+///         validated concurrently.  Sandwiches with no Id or an unsupported
+///         schema version (see #PBJ_SW_SCHEMA_VERSION) are skipped with a
+///         warning.  Results are merged in path order, so if two sandwiches
+///         have the same Id, the one whose path sorts first is used.
+///
+///         Rescanning a directory is safe while sandwiches are open on other
+///         threads: sandwiches which were already known keep their open
+///         instances, pools, and write queues, and only their paths and
+///         table lists are updated.
+///
+/// \param  path The directory to scan, including a trailing slash.
+/// \param  manifest_path The location of the SandwichManifest to use.  It
+///         will be created if it doesn't exist.
+void readDirectory(const std::string& path, const std::string& manifest_path)
+{
+    BE_PROFILE_FUNCTION();
+
+    std::vector<ScanResult> results;
+
     dirent *ent;
                 
     DIR* dir = opendir(path.c_str());
@@ -76,33 +198,10 @@ void readDirectory(const std::string& path)
 
                         if (extension == ".sw") // SW for sandwich (i.e. PB & J Sandwich)
                         {
-                            try
-                            {
-                                Sandwich sw(fullpath, true);
-                                Id swid = sw.getId();
-
-                                if (swid == Id())
-                                    throw std::runtime_error("Sandwich has no Id!");
-
-                                SandwichInfo swi;
-                                swi.path = fullpath;
-
-                                sandwiches[swid] = swi;
-                            }
-                            catch (const db::Db::error& e)
-                            {
-                                PBJ_LOG(VWarning) << "Database error while opening sandwich!"  << PBJ_LOG_NL
-                                                  << "     Path: " << fullpath << PBJ_LOG_NL
-                                                  << "Exception: " << e.what() << PBJ_LOG_NL
-                                                  << "      SQL: " << e.sql() << PBJ_LOG_END;
-                            }
-                            catch (const std::exception& e)
-                            {
-                                PBJ_LOG(VWarning) << "Exception while opening sandwich!"  << PBJ_LOG_NL
-                                                  << "     Path: " << fullpath << PBJ_LOG_NL
-                                                  << "Exception: " << e.what() << PBJ_LOG_END;
-                            }
-
+                            ScanResult result;
+                            result.path = fullpath;
+                            result.db_error = false;
+                            results.push_back(result);
                         }
                         break;
                     }
@@ -119,43 +218,292 @@ void readDirectory(const std::string& path)
         /* Could not open directory */
         PBJ_LOG(VWarning) << "Could not open directory!" << PBJ_LOG_NL
                           << "Path: " << path << PBJ_LOG_END;
+        return;
+    }
+
+    // readdir() order depends on the filesystem, so sort the results to make
+    // warnings and Id collisions resolve the same way everywhere.
+    std::sort(results.begin(), results.end(),
+              [](const ScanResult& a, const ScanResult& b) { return a.path < b.path; });
+
+    SandwichManifest manifest(manifest_path);
+    scanSandwiches(manifest, results);
+    manifest.save();
+
+    be::IdMap<std::string> found;
+    std::lock_guard<std::mutex> lock(open_mutex);
+    for (auto i(results.begin()), end(results.end()); i != end; ++i)
+    {
+        const ScanResult& result = *i;
+        if (result.db_error)
+        {
+            PBJ_LOG(VWarning) << "Database error while opening sandwich!"  << PBJ_LOG_NL
+                              << "     Path: " << result.path << PBJ_LOG_NL
+                              << "Exception: " << result.error << PBJ_LOG_NL
+                              << "      SQL: " << result.error_sql << PBJ_LOG_END;
+            continue;
+        }
+
+        if (!result.error.empty())
+        {
+            PBJ_LOG(VWarning) << "Exception while opening sandwich!"  << PBJ_LOG_NL
+                              << "     Path: " << result.path << PBJ_LOG_NL
+                              << "Exception: " << result.error << PBJ_LOG_END;
+            continue;
+        }
+
+        Id swid = result.entry.id;
+        if (swid == Id())
+        {
+            PBJ_LOG(VWarning) << "Exception while opening sandwich!"  << PBJ_LOG_NL
+                              << "     Path: " << result.path << PBJ_LOG_NL
+                              << "Exception: Sandwich has no Id!" << PBJ_LOG_END;
+            continue;
+        }
+
+        if (!isSchemaSupported(result.entry.schema_version))
+        {
+            PBJ_LOG(VWarning) << "Sandwich schema version is not supported!"  << PBJ_LOG_NL
+                              << "            Path: " << result.path << PBJ_LOG_NL
+                              << "Sandwich Version: " << (result.entry.schema_version >> 16) << '.' << (result.entry.schema_version & 0xFFFF) << PBJ_LOG_NL
+                              << "  Engine Version: " << BE_BED_SCHEMA_VERSION_MAJOR << '.' << BE_BED_SCHEMA_VERSION_MINOR << PBJ_LOG_END;
+            continue;
+        }
+
+        auto existing(found.find(swid));
+        if (existing != found.end())
+        {
+            PBJ_LOG(VWarning) << "Sandwich Id collision!"  << PBJ_LOG_NL
+                              << "          ID: " << swid << PBJ_LOG_NL
+                              << "   Used Path: " << existing->second << PBJ_LOG_NL
+                              << "Ignored Path: " << result.path << PBJ_LOG_END;
+            continue;
+        }
+        found[swid] = result.path;
+
+        std::unique_ptr<SandwichInfo>& swi = sandwiches[swid];
+        if (!swi)
+            swi.reset(new SandwichInfo());
+
+        swi->path = result.path;
+        swi->tables = result.entry.tables;
     }
 }
 
-std::shared_ptr<Sandwich> open(const Id& id)
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Checks whether a sandwich contained a table when readDirectory()
+///         last scanned it, without opening the sandwich.
+///
+/// \param  id The Id of a sandwich found by readDirectory().
+/// \param  table The name of the table to look for.
+/// \return \c true if the sandwich is known and contains the table.
+bool hasTable(const Id& id, const std::string& table)
 {
+    std::lock_guard<std::mutex> lock(open_mutex);
     SandwichInfo* swi = getSWI(id);
-   
     if (!swi)
+        return false;
+
+    std::string line(table);
+    line.append(1, '\n');
+
+    size_t pos = swi->tables.find(line);
+    while (pos != std::string::npos && pos != 0 && swi->tables[pos - 1] != '\n')
+        pos = swi->tables.find(line, pos + 1);
+
+    return pos != std::string::npos;
+}
+
+std::shared_ptr<Sandwich> open(const Id& id)
+{
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(open_mutex);
+        SandwichInfo* swi = getSWI(id);
+        if (swi)
+        {
+            std::shared_ptr<Sandwich> ptr(swi->sandwich.lock());
+            if (ptr)
+                return ptr;
+
+            // previous instance has already been destroyed
+            path = swi->path;
+        }
+    }
+
+    if (path.empty())
     {
         PBJ_LOG(VWarning) << "Attempted to open unknown sandwich!" << PBJ_LOG_NL
                           << "Sandwich ID: " << id << PBJ_LOG_END;
         return std::shared_ptr<Sandwich>();
     }
-   
-    std::shared_ptr<Sandwich> ptr(swi->sandwich.lock());
 
-    if (!ptr)   // previous instance has already been destroyed
+    // Open the sandwich without holding open_mutex, so other threads aren't
+    // blocked while the file is opened and configured.
+    std::shared_ptr<Sandwich> ptr(new Sandwich(path, true));
+
+    std::lock_guard<std::mutex> lock(open_mutex);
+    SandwichInfo* swi = getSWI(id);
+    if (swi)
     {
-        ptr.reset(new Sandwich(swi->path, true));
+        // another thread may have opened it in the meantime
+        std::shared_ptr<Sandwich> existing(swi->sandwich.lock());
+        if (existing)
+            return existing;
+
         swi->sandwich = std::weak_ptr<Sandwich>(ptr);
     }
 
-    return std::move(ptr);
+    return ptr;
 }
 
 std::shared_ptr<Sandwich> openWritable(const Id& id)
 {
-    SandwichInfo* swi = getSWI(id);
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(open_mutex);
+        SandwichInfo* swi = getSWI(id);
+        if (swi)
+            path = swi->path;
+    }
 
-    if (!swi)
+    if (path.empty())
     {
         PBJ_LOG(VWarning) << "Attempted to open unknown sandwich!" << PBJ_LOG_NL
                           << "Sandwich ID: " << id << PBJ_LOG_END;
         return std::shared_ptr<Sandwich>();
     }
    
-    return std::shared_ptr<Sandwich>(new Sandwich(swi->path, false));
+    return std::shared_ptr<Sandwich>(new Sandwich(path, false));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves a shared_ptr to a pool of read-only connections to a
+///         sandwich.
+/// \details Resource loaders running on several threads should use this
+///         instead of open(), so that each thread reads through its own
+///         connection and StmtCache.  Multiple calls with the same Id return
+///         the same pool as long as it hasn't been destroyed.
+///
+/// \param  id The Id of a sandwich found by readDirectory().
+/// \return A shared_ptr to the pool, or an empty shared_ptr if the sandwich
+///         is unknown.
+std::shared_ptr<db::ConnectionPool<Sandwich> > openPool(const Id& id)
+{
+    std::lock_guard<std::mutex> lock(open_mutex);
+    SandwichInfo* swi = getSWI(id);
+
+    if (!swi)
+    {
+        PBJ_LOG(VWarning) << "Attempted to open unknown sandwich!" << PBJ_LOG_NL
+                          << "Sandwich ID: " << id << PBJ_LOG_END;
+        return std::shared_ptr<db::ConnectionPool<Sandwich> >();
+    }
+
+    std::shared_ptr<db::ConnectionPool<Sandwich> > ptr(swi->pool.lock());
+
+    if (!ptr)   // previous instance has already been destroyed
+    {
+        std::string path(swi->path);
+        ptr.reset(new db::ConnectionPool<Sandwich>([=]() { return new Sandwich(path, true); }));
+        swi->pool = std::weak_ptr<db::ConnectionPool<Sandwich> >(ptr);
+    }
+
+    return ptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the write queue for a sandwich, opening a writable
+///         connection for it if necessary.
+/// \details Editor-side saves should push their changes onto this queue
+///         rather than opening their own writable sandwich and transaction,
+///         so that the calling thread never waits for the disk and many
+///         changes can be committed at once.
+///
+///         Unlike open() and openPool(), the queue stays open until
+///         closeWriteQueues() is called, so callers can push a change and
+///         immediately drop their reference to the queue.
+///
+/// \param  id The Id of a sandwich found by readDirectory().
+/// \return A shared_ptr to the write queue, or an empty shared_ptr if the
+///         sandwich is unknown or could not be opened for writing.
+std::shared_ptr<db::WriteQueue<Sandwich> > openWriteQueue(const Id& id)
+{
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(open_mutex);
+        SandwichInfo* swi = getSWI(id);
+        if (swi)
+        {
+            if (swi->write_queue)
+                return swi->write_queue;
+
+            path = swi->path;
+        }
+    }
+
+    if (path.empty())
+    {
+        PBJ_LOG(VWarning) << "Attempted to open unknown sandwich!" << PBJ_LOG_NL
+                          << "Sandwich ID: " << id << PBJ_LOG_END;
+        return std::shared_ptr<db::WriteQueue<Sandwich> >();
+    }
+
+    // Open the sandwich without holding open_mutex, so other threads aren't
+    // blocked while the file is opened and configured.
+    std::shared_ptr<db::WriteQueue<Sandwich> > queue;
+    try
+    {
+        std::shared_ptr<Sandwich> sandwich(new Sandwich(path, false));
+        queue.reset(new db::WriteQueue<Sandwich>(sandwich));
+    }
+    catch (const db::Db::error& e)
+    {
+        PBJ_LOG(VWarning) << "Database error while opening sandwich for writing!"  << PBJ_LOG_NL
+                          << "Sandwich ID: " << id << PBJ_LOG_NL
+                          << "       Path: " << path << PBJ_LOG_NL
+                          << "  Exception: " << e.what() << PBJ_LOG_END;
+        return queue;
+    }
+
+    std::lock_guard<std::mutex> lock(open_mutex);
+    SandwichInfo* swi = getSWI(id);
+    if (!swi)
+        return queue;
+
+    // another thread may have opened a queue in the meantime
+    if (!swi->write_queue)
+        swi->write_queue = queue;
+
+    return swi->write_queue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Commits all changes queued on any sandwich's write queue and
+///         closes the queues.
+/// \details This should be called before the engine shuts down, since the
+///         queues' writer threads can't safely be stopped during static
+///         destruction.  Queues which are still referenced elsewhere will
+///         remain open until those references are released.
+void closeWriteQueues()
+{
+    std::vector<std::shared_ptr<db::WriteQueue<Sandwich> > > queues;
+
+    {
+        std::lock_guard<std::mutex> lock(open_mutex);
+        for (auto i(sandwiches.begin()), end(sandwiches.end()); i != end; ++i)
+        {
+            if (i->second->write_queue)
+            {
+                queues.push_back(i->second->write_queue);
+                i->second->write_queue.reset();
+            }
+        }
+    }
+
+    // destroying the queues flushes them, which shouldn't block
+    // openWriteQueue() calls on other threads.
+    queues.clear();
 }
 
 } // namespace be::bed
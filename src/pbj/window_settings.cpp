@@ -26,204 +26,12 @@
 
 #include "pbj/window_settings.h"
 
+#include "be/bed/row_reader.h"
 #include "be/bed/transaction.h"
 #include "pbj/sw/sandwich_open.h"
+#include "pbj/sql_ids.h"
 #include <iostream>
 
-#pragma region SQL statements
-
-///////////////////////////////////////////////////////////////////////////////
-/// \brief  SQL statement to load a set of window settings from a sandwich.
-/// \param  1 The id of the winow settings stack to load.
-#define PBJ_WINDOW_SETTINGS_SQL_LOAD \
-      "SELECT window_mode, " \
-      "system_positioned, save_pos_on_close, position_x, position_y, " \
-      "size_x, size_y, monitor_index, refresh_rate, v_sync, " \
-      "msaa_level, red_bits, green_bits, blue_bits, alpha_bits, " \
-      "depth_bits, stencil_bits, " \
-      "srgb_capable, use_custom_gamma, custom_gamma " \
-      "FROM pbj_window_settings WHERE id = ? " \
-      "ORDER BY history_index DESC LIMIT 1"
-
-///////////////////////////////////////////////////////////////////////////////
-/// \brief  SQL statement to check if the pbj_window_settings table exists
-///         in a sandwich.
-#define PBJ_WINDOW_SETTINGS_SQL_TABLE_EXISTS \
-      "SELECT count(*) FROM sqlite_master " \
-      "WHERE type='table' AND name='pbj_window_settings'"
-
-///////////////////////////////////////////////////////////////////////////////
-/// \brief  SQL statement to get the active (highest) history_index for the
-///         requested window settings.
-/// \param  1 The id of the window settings stack to look at.
-#define PBJ_WINDOW_SETTINGS_SQL_LATEST_INDEX \
-      "SELECT max(history_index) " \
-      "FROM pbj_window_settings WHERE id = ?"
-
-///////////////////////////////////////////////////////////////////////////////
-/// \brief  SQL statement to create the pbj_window_settings table.
-#define PBJ_WINDOW_SETTINGS_SQL_CREATE_TABLE \
-      "CREATE TABLE IF NOT EXISTS pbj_window_settings (" \
-      "id INTEGER NOT NULL, " \
-      "history_index INTEGER NOT NULL, " \
-      "window_mode INTEGER NOT NULL, " \
-      "system_positioned INTEGER NOT NULL, " \
-      "save_pos_on_close INTEGER NOT NULL, " \
-      "position_x INTEGER NOT NULL, " \
-      "position_y INTEGER NOT NULL, " \
-      "size_x INTEGER NOT NULL, " \
-      "size_y INTEGER NOT NULL, " \
-      "monitor_index INTEGER NOT NULL, " \
-      "refresh_rate INTEGER NOT NULL, " \
-      "v_sync INTEGER NOT NULL, " \
-      "msaa_level INTEGER NOT NULL, " \
-      "red_bits INTEGER NOT NULL, " \
-      "green_bits INTEGER NOT NULL, " \
-      "blue_bits INTEGER NOT NULL, " \
-      "alpha_bits INTEGER NOT NULL, " \
-      "depth_bits INTEGER NOT NULL, " \
-      "stencil_bits INTEGER NOT NULL, " \
-      "srgb_capable INTEGER NOT NULL, " \
-      "use_custom_gamma INTEGER NOT NULL, " \
-      "custom_gamma REAL NOT NULL " \
-      "PRIMARY KEY (id, history_index) )"
-
-///////////////////////////////////////////////////////////////////////////////
-/// \brief  SQL statement to save a set of window settings using a specific id
-///         and history index.
-///
-/// \details The history_index should be incremented from te result of
-///         #PBJ_WINDOW_SETTINGS_SQL_LATEST_INDEX so that the settings can
-///         be reverted if desired.
-/// \param  1 The id of the window_settings stack to save to.
-/// \param  2 The history_index of the entry to save to.
-/// \param  3 The value of be::wnd::WindowSettings::mode.
-/// \param  4 The value of be::wnd::WindowSettings::system_positioned.
-/// \param  5 The value of be::wnd::WindowSettings::save_position_on_close.
-/// \param  6 The value of be::wnd::WindowSettings::position.x.
-/// \param  7 The value of be::wnd::WindowSettings::position.y.
-/// \param  8 The value of be::wnd::WindowSettings::size.x.
-/// \param  9 The value of be::wnd::WindowSettings::size.y.
-/// \param  10 The value of be::wnd::WindowSettings::monitor_index.
-/// \param  11 The value of be::wnd::WindowSettings::refresh_rate.
-/// \param  12 The value of be::wnd::WindowSettings::v_sync.
-/// \param  13 The value of be::wnd::WindowSettings::msaa_level.
-/// \param  14 The value of be::wnd::WindowSettings::red_bits.
-/// \param  15 The value of be::wnd::WindowSettings::green_bits.
-/// \param  16 The value of be::wnd::WindowSettings::blue_bits.
-/// \param  17 The value of be::wnd::WindowSettings::alpha_bits.
-/// \param  18 The value of be::wnd::WindowSettings::depth_bits.
-/// \param  19 The value of be::wnd::WindowSettings::stencil_bits.
-/// \param  20 The value of be::wnd::WindowSettings::srgb_capable.
-/// \param  21 The value of be::wnd::WindowSettings::use_custom_gamma.
-/// \param  22 The value of be::wnd::WindowSettings::custom_gamma.
-#define PBJ_WINDOW_SETTINGS_SQL_SAVE \
-      "INSERT INTO pbj_window_settings (" \
-      "id, history_index, window_mode, " \
-      "system_positioned, save_pos_on_close, position_x, position_y, " \
-      "size_x, size_y, monitor_index, refresh_rate, v_sync, " \
-      "msaa_level, red_bits, green_bits, blue_bits, alpha_bits, " \
-      "depth_bits, stencil_bits, " \
-      "srgb_capable, use_custom_gamma, custom_gamma" \
-      ") VALUES (" \
-      "?,?,?," \
-      "?,?,?,?," \
-      "?,?,?,?,?," \
-      "?,?,?,?,?," \
-      "?,?," \
-      "?,?,?)"
-
-///////////////////////////////////////////////////////////////////////////////
-/// \brief  SQL statement to update the position and size settings from a
-///         specific id and history_index.
-///
-/// \param  1 The new x position.
-/// \param  2 The new y position.
-/// \param  3 The new width.
-/// \param  4 The new height.
-/// \param  5 The id of the window settings stack to update.
-/// \param  6 The history_index to update.
-#define PBJ_WINDOW_SETTINGS_SQL_SAVE_POS \
-      "UPDATE pbj_window_settings " \
-      "SET position_x = ?, position_y = ?, " \
-      "size_x = ?, size_y = ? " \
-      "WHERE id = ? AND history_index = ?"
-
-///////////////////////////////////////////////////////////////////////////////
-/// \brief  SQL statement to remove any history entries with the id provided 
-///         and an history_index less than the provided minimum.
-///
-/// \param  1 The id of the window settings stack to truncate.
-/// \param  2 The minimum history_index that will remain untouched.
-#define PBJ_WINDOW_SETTINGS_SQL_TRUNCATE \
-      "DELETE FROM pbj_window_settings " \
-      "WHERE id = ? AND history_index < ?"
-
-///////////////////////////////////////////////////////////////////////////////
-/// \brief  SQL statement to remove a specific history_index from a window
-///         settings stack.
-///
-/// \details The history_index should almost always be retrieved using
-///         #PBJ_WINDOW_SETTINGS_SQL_LATEST_INDEX.
-///
-/// \param  1 The id of the window_settings stack to modify.
-/// \param  2 This history_index to delete.
-#define PBJ_WINDOW_SETTINGS_SQL_REVERT \
-      "DELETE FROM pbj_window_settings " \
-      "WHERE id = ? AND history_index = ?"
-
-///////////////////////////////////////////////////////////////////////////////
-/// \brief  SQL statement to compress history_index values by subtracting a
-///         constant value from all history_index values in a window settings
-///         stack.
-///
-/// \details This should generally only be done after
-///         #PBJ_WINDOW_SETTINGS_SQL_TRUNCATE.
-///
-/// \param  1 The value of the history_index which should become zero after
-///         this statement.
-/// \param  2 The id of the window_settings stack to modify.
-#define PBJ_WINDOW_SETTINGS_SQL_COMPRESS \
-      "UPDATE pbj_window_settings " \
-      "SET history_index = history_index - ? " \
-      "WHERE id = ?"
-
-#ifdef BE_ID_NAMES_ENABLED
-#define PBJ_WINDOW_SETTINGS_SQLID_LOAD         PBJ_WINDOW_SETTINGS_SQL_LOAD
-#define PBJ_WINDOW_SETTINGS_SQLID_TABLE_EXISTS PBJ_WINDOW_SETTINGS_SQL_TABLE_EXISTS
-#define PBJ_WINDOW_SETTINGS_SQLID_CREATE_TABLE PBJ_WINDOW_SETTINGS_SQL_CREATE_TABLE
-#define PBJ_WINDOW_SETTINGS_SQLID_LATEST_INDEX PBJ_WINDOW_SETTINGS_SQL_LATEST_INDEX
-#define PBJ_WINDOW_SETTINGS_SQLID_SAVE         PBJ_WINDOW_SETTINGS_SQL_SAVE
-#define PBJ_WINDOW_SETTINGS_SQLID_SAVE_POS     PBJ_WINDOW_SETTINGS_SQL_SAVE_POS
-#define PBJ_WINDOW_SETTINGS_SQLID_TRUNCATE     PBJ_WINDOW_SETTINGS_SQL_TRUNCATE
-#define PBJ_WINDOW_SETTINGS_SQLID_REVERT       PBJ_WINDOW_SETTINGS_SQL_REVERT
-#define PBJ_WINDOW_SETTINGS_SQLID_COMPRESS     PBJ_WINDOW_SETTINGS_SQL_COMPRESS
-#else
-// TODO: precalculate ids using idgen.exe
-#define PBJ_WINDOW_SETTINGS_SQLID_LOAD         PBJ_WINDOW_SETTINGS_SQL_LOAD
-#define PBJ_WINDOW_SETTINGS_SQLID_TABLE_EXISTS PBJ_WINDOW_SETTINGS_SQL_TABLE_EXISTS
-#define PBJ_WINDOW_SETTINGS_SQLID_CREATE_TABLE PBJ_WINDOW_SETTINGS_SQL_CREATE_TABLE
-#define PBJ_WINDOW_SETTINGS_SQLID_LATEST_INDEX PBJ_WINDOW_SETTINGS_SQL_LATEST_INDEX
-#define PBJ_WINDOW_SETTINGS_SQLID_SAVE         PBJ_WINDOW_SETTINGS_SQL_SAVE
-#define PBJ_WINDOW_SETTINGS_SQLID_SAVE_POS     PBJ_WINDOW_SETTINGS_SQL_SAVE_POS
-#define PBJ_WINDOW_SETTINGS_SQLID_TRUNCATE     PBJ_WINDOW_SETTINGS_SQL_TRUNCATE
-#define PBJ_WINDOW_SETTINGS_SQLID_REVERT       PBJ_WINDOW_SETTINGS_SQL_REVERT
-#define PBJ_WINDOW_SETTINGS_SQLID_COMPRESS     PBJ_WINDOW_SETTINGS_SQL_COMPRESS
-/* These are outdated:
-#define PBJ_WINDOW_SETTINGS_SQLID_LOAD         0xf87b0cbda9871ec2
-#define PBJ_WINDOW_SETTINGS_SQLID_TABLE_EXISTS 0x1f291c4330f2e631
-#define PBJ_WINDOW_SETTINGS_SQLID_CREATE_TABLE 0x5be45399e0383389
-#define PBJ_WINDOW_SETTINGS_SQLID_LATEST_INDEX 0xd76d8693b84a643c
-#define PBJ_WINDOW_SETTINGS_SQLID_SAVE         0x4a8f712d4305761c
-#define PBJ_WINDOW_SETTINGS_SQLID_SAVE_POS     0xf9e73cb74a980b0c
-#define PBJ_WINDOW_SETTINGS_SQLID_TRUNCATE     0xdacc0b7fdef69265
-#define PBJ_WINDOW_SETTINGS_SQLID_REVERT       0xe29c347fe32614fa
-#define PBJ_WINDOW_SETTINGS_SQLID_COMPRESS     0x7c719307914c91fb
-*/
-#endif
-
-#pragma endregion
-
 namespace pbj {
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -268,33 +76,20 @@ WindowSettings loadWindowSettings(sw::Sandwich& sandwich, const Id& id)
         db::StmtCache& cache = sandwich.getStmtCache();
         db::CachedStmt& stmt = cache.hold(Id(PBJ_WINDOW_SETTINGS_SQLID_LOAD), PBJ_WINDOW_SETTINGS_SQL_LOAD);
 
-        stmt.bind(1, id.value());
+        stmt.bindAll(id);
         if (stmt.step())
         {
             WindowSettings ws;
             ws.id.sandwich = sandwich.getId();
             ws.id.resource = id;
 
-            ws.mode = static_cast<WindowSettings::Mode>(stmt.getInt(0));
-            ws.system_positioned = stmt.getBool(1);
-            ws.save_position_on_close = stmt.getBool(2);
-            ws.position.x = stmt.getInt(3);
-            ws.position.y = stmt.getInt(4);
-            ws.size.x = stmt.getInt(5);
-            ws.size.y = stmt.getInt(6);
-            ws.monitor_index = stmt.getInt(7);
-            ws.refresh_rate = stmt.getUInt(8);
-            ws.v_sync = static_cast<WindowSettings::VSyncMode>(stmt.getInt(9));
-            ws.msaa_level = stmt.getUInt(10);
-            ws.red_bits = stmt.getUInt(11);
-            ws.green_bits = stmt.getUInt(12);
-            ws.blue_bits = stmt.getUInt(13);
-            ws.alpha_bits = stmt.getUInt(14);
-            ws.depth_bits = stmt.getUInt(15);
-            ws.stencil_bits = stmt.getUInt(16);
-            ws.srgb_capable = stmt.getBool(17);
-            ws.use_custom_gamma = stmt.getBool(18);
-            ws.custom_gamma = float(stmt.getDouble(19));
+            db::RowReader row(stmt);
+            row >> ws.mode >> ws.system_positioned >> ws.save_position_on_close
+                >> ws.position.x >> ws.position.y >> ws.size.x >> ws.size.y
+                >> ws.monitor_index >> ws.refresh_rate >> ws.v_sync
+                >> ws.msaa_level >> ws.red_bits >> ws.green_bits >> ws.blue_bits
+                >> ws.alpha_bits >> ws.depth_bits >> ws.stencil_bits
+                >> ws.srgb_capable >> ws.use_custom_gamma >> ws.custom_gamma;
 
             return ws;
         }
@@ -320,6 +115,20 @@ WindowSettings loadWindowSettings(sw::Sandwich& sandwich, const Id& id)
     return WindowSettings();
 }
 
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Creates a future holding an exception, for writes which could not
+///         be queued.
+std::future<void> failedWrite(const char* what)
+{
+    std::promise<void> promise;
+    promise.set_exception(std::make_exception_ptr(std::runtime_error(what)));
+    return promise.get_future();
+}
+
+} // namespace pbj::(anon)
+
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  Saves a set of WindowSettings to a sandwich.
 ///
@@ -327,84 +136,84 @@ WindowSettings loadWindowSettings(sw::Sandwich& sandwich, const Id& id)
 ///         of the WindowSettings object passed in.  If the WindowSettings 
 ///         already exist in the sandwich, a new history index will be created.
 ///
-///         If there is a problem saving the WindowSettings, a warning will
-///         be emitted, and false will be returned.
+///         The save is queued on the sandwich's write queue, so this returns
+///         without waiting for the database.  If there is a problem saving the
+///         WindowSettings, a warning will be emitted, and the returned future
+///         will hold the exception.
 ///
 /// \param  window_settings The WindowSettings to save.
-/// \return \c true if the WindowSettings were saved successfully.
+/// \return A future which becomes ready when the WindowSettings have been
+///         saved.
 ///
 /// \ingroup loading
-bool saveWindowSettings(const WindowSettings& window_settings)
+std::future<void> saveWindowSettings(const WindowSettings& window_settings)
 {
-    try
+    std::shared_ptr<db::WriteQueue<sw::Sandwich> > queue = sw::openWriteQueue(window_settings.id.sandwich);
+    if (!queue)
     {
-        std::shared_ptr<sw::Sandwich> sandwich = sw::openWritable(window_settings.id.sandwich);
-        if (!sandwich)
-            throw std::runtime_error("Could not open sandwich for writing!");
-
-        db::Db& db = sandwich->getDb();
+        PBJ_LOG(VWarning) << "Exception while saving window settings!" << PBJ_LOG_NL
+                          << "      Sandwich ID: " << window_settings.id.sandwich << PBJ_LOG_NL
+                          << "WindowSettings ID: " << window_settings.id.resource << PBJ_LOG_NL
+                          << "        Exception: Could not open sandwich for writing!" << PBJ_LOG_END;
+        return failedWrite("Could not open sandwich for writing!");
+    }
 
-        db::Transaction transaction(db, db::Transaction::Immediate);
+    return queue->push([=](sw::Sandwich& sandwich)
+    {
+        try
+        {
+            db::Db& db = sandwich.getDb();
 
-        int history_index = 0;
+            int history_index = 0;
    
-        if (db.getInt(PBJ_WINDOW_SETTINGS_SQL_TABLE_EXISTS, 0) == 0)
-        {
-            db.exec(PBJ_WINDOW_SETTINGS_SQL_CREATE_TABLE);
+            if (db.getInt(PBJ_WINDOW_SETTINGS_SQL_TABLE_EXISTS, 0) == 0)
+            {
+                db.exec(PBJ_WINDOW_SETTINGS_SQL_CREATE_TABLE);
+            }
+            else
+            {
+                db::Stmt latest(db, Id(PBJ_WINDOW_SETTINGS_SQLID_LATEST_INDEX), PBJ_WINDOW_SETTINGS_SQL_LATEST_INDEX);
+                latest.bind(1, window_settings.id.resource.value());
+                if (latest.step())
+                    history_index = latest.getInt(0);
+            }
+
+            db::Stmt save(db, Id(PBJ_WINDOW_SETTINGS_SQLID_SAVE), PBJ_WINDOW_SETTINGS_SQL_SAVE);
+            save.bind(1, window_settings.id.resource.value());
+            save.bind(2, history_index + 1);
+            save.bind(3, static_cast<int>(window_settings.mode));
+            save.bind(4, window_settings.system_positioned);
+            save.bind(5, window_settings.save_position_on_close);
+            save.bind(6, window_settings.position.x);
+            save.bind(7, window_settings.position.y);
+            save.bind(8, window_settings.size.x);
+            save.bind(9, window_settings.size.y);
+            save.bind(10, window_settings.monitor_index);
+            save.bind(11, window_settings.refresh_rate);
+            save.bind(12, static_cast<int>(window_settings.v_sync));
+            save.bind(13, window_settings.msaa_level);
+            save.bind(14, window_settings.red_bits);
+            save.bind(15, window_settings.green_bits);
+            save.bind(16, window_settings.blue_bits);
+            save.bind(17, window_settings.alpha_bits);
+            save.bind(18, window_settings.depth_bits);
+            save.bind(19, window_settings.stencil_bits);
+            save.bind(20, window_settings.srgb_capable);
+            save.bind(21, window_settings.use_custom_gamma);
+            save.bind(22, window_settings.custom_gamma);
+      
+            save.step();
         }
-        else
+        catch (const db::Db::error& err)
         {
-            db::Stmt latest(db, Id(PBJ_WINDOW_SETTINGS_SQLID_LATEST_INDEX), PBJ_WINDOW_SETTINGS_SQL_LATEST_INDEX);
-            latest.bind(1, window_settings.id.resource.value());
-            if (latest.step())
-                history_index = latest.getInt(0);
+            PBJ_LOG(VWarning) << "Database error while saving window settings!" << PBJ_LOG_NL
+                              << "      Sandwich ID: " << window_settings.id.sandwich << PBJ_LOG_NL
+                              << "WindowSettings ID: " << window_settings.id.resource << PBJ_LOG_NL
+                              << "        Exception: " << err.what() << PBJ_LOG_NL
+                              << "              SQL: " << err.sql() << PBJ_LOG_END;
+            throw;
         }
-
-        db::Stmt save(db, Id(PBJ_WINDOW_SETTINGS_SQLID_SAVE), PBJ_WINDOW_SETTINGS_SQL_SAVE);
-        save.bind(1, window_settings.id.resource.value());
-        save.bind(2, history_index + 1);
-        save.bind(3, static_cast<int>(window_settings.mode));
-        save.bind(4, window_settings.system_positioned);
-        save.bind(5, window_settings.save_position_on_close);
-        save.bind(6, window_settings.position.x);
-        save.bind(7, window_settings.position.y);
-        save.bind(8, window_settings.size.x);
-        save.bind(9, window_settings.size.y);
-        save.bind(10, window_settings.monitor_index);
-        save.bind(11, window_settings.refresh_rate);
-        save.bind(12, static_cast<int>(window_settings.v_sync));
-        save.bind(13, window_settings.msaa_level);
-        save.bind(14, window_settings.red_bits);
-        save.bind(15, window_settings.green_bits);
-        save.bind(16, window_settings.blue_bits);
-        save.bind(17, window_settings.alpha_bits);
-        save.bind(18, window_settings.depth_bits);
-        save.bind(19, window_settings.stencil_bits);
-        save.bind(20, window_settings.srgb_capable);
-        save.bind(21, window_settings.use_custom_gamma);
-        save.bind(22, window_settings.custom_gamma);
-      
-        save.step();
-        transaction.commit();
-        return true;
-    }
-    catch (const db::Db::error& err)
-    {
-        PBJ_LOG(VWarning) << "Database error while saving window settings!" << PBJ_LOG_NL
-                          << "      Sandwich ID: " << window_settings.id.sandwich << PBJ_LOG_NL
-                          << "WindowSettings ID: " << window_settings.id.resource << PBJ_LOG_NL
-                          << "        Exception: " << err.what() << PBJ_LOG_NL
-                          << "              SQL: " << err.sql() << PBJ_LOG_END;
-    }
-    catch (const std::runtime_error& err)
-    {
-        PBJ_LOG(VWarning) << "Exception while saving window settings!" << PBJ_LOG_NL
-                          << "      Sandwich ID: " << window_settings.id.sandwich << PBJ_LOG_NL
-                          << "WindowSettings ID: " << window_settings.id.resource << PBJ_LOG_NL
-                          << "        Exception: " << err.what() << PBJ_LOG_END;
-    }
-
-    return false;
+    });
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -417,64 +226,71 @@ bool saveWindowSettings(const WindowSettings& window_settings)
 ///         be updated, and only if window_settings.save_position_on_close
 ///         is true.
 ///
+///         Like saveWindowSettings(), the update is queued on the sandwich's
+///         write queue.
+///
 /// \param  window_settings Determines where the WindowSettings are saved and
 ///         the new position/size values to update.
-/// \return \c true if the size and position were updated successfully.
+/// \return A future which becomes ready when the size and position have been
+///         updated, or an invalid future if
+///         window_settings.save_position_on_close is false.
 ///
 /// \ingroup loading
-bool updateSavedPosition(const WindowSettings& window_settings)
+std::future<void> updateSavedPosition(const WindowSettings& window_settings)
 {
     if (!window_settings.save_position_on_close)
-        return false;
-
-    try
-    {
-        std::shared_ptr<sw::Sandwich> sandwich = sw::openWritable(window_settings.id.sandwich);
-        if (!sandwich)
-            throw std::runtime_error("Could not open sandwich for writing!");
-
-        db::Db& db = sandwich->getDb();
-  
-        if (db.getInt(PBJ_WINDOW_SETTINGS_SQL_TABLE_EXISTS, 0) == 0)
-            throw std::runtime_error("WindowSettings table does not exist!");
-
-        db::Transaction transaction(db, db::Transaction::Immediate);
-
-        int history_index = 0;
-        db::Stmt latest(db, Id(PBJ_WINDOW_SETTINGS_SQLID_LATEST_INDEX), PBJ_WINDOW_SETTINGS_SQL_LATEST_INDEX);
-        latest.bind(1, window_settings.id.resource.value());
-        if (latest.step())
-            history_index = latest.getInt(0);
+        return std::future<void>();
 
-        db::Stmt save(db, Id(PBJ_WINDOW_SETTINGS_SQLID_SAVE_POS), PBJ_WINDOW_SETTINGS_SQL_SAVE_POS);
-        save.bind(1, window_settings.position.x);
-        save.bind(2, window_settings.position.y);
-        save.bind(3, window_settings.size.x);
-        save.bind(4, window_settings.size.y);
-        save.bind(5, window_settings.id.resource.value());
-        save.bind(6, history_index);
-
-        save.step();
-        transaction.commit();
-        return true;
-    }
-    catch (const db::Db::error& err)
-    {
-        PBJ_LOG(VWarning) << "Database error while saving window position!" << PBJ_LOG_NL
-                          << "      Sandwich ID: " << window_settings.id.sandwich << PBJ_LOG_NL
-                          << "WindowSettings ID: " << window_settings.id.resource << PBJ_LOG_NL
-                          << "        Exception: " << err.what() << PBJ_LOG_NL
-                          << "              SQL: " << err.sql() << PBJ_LOG_END;
-    }
-    catch (const std::runtime_error& err)
+    std::shared_ptr<db::WriteQueue<sw::Sandwich> > queue = sw::openWriteQueue(window_settings.id.sandwich);
+    if (!queue)
     {
         PBJ_LOG(VWarning) << "Exception while saving window position!" << PBJ_LOG_NL
                           << "      Sandwich ID: " << window_settings.id.sandwich << PBJ_LOG_NL
                           << "WindowSettings ID: " << window_settings.id.resource << PBJ_LOG_NL
-                          << "        Exception: " << err.what() << PBJ_LOG_END;
+                          << "        Exception: Could not open sandwich for writing!" << PBJ_LOG_END;
+        return failedWrite("Could not open sandwich for writing!");
     }
 
-    return false;
+    return queue->push([=](sw::Sandwich& sandwich)
+    {
+        try
+        {
+            db::Db& db = sandwich.getDb();
+  
+            if (db.getInt(PBJ_WINDOW_SETTINGS_SQL_TABLE_EXISTS, 0) == 0)
+                throw std::runtime_error("WindowSettings table does not exist!");
+
+            int history_index = 0;
+            db::Stmt latest(db, Id(PBJ_WINDOW_SETTINGS_SQLID_LATEST_INDEX), PBJ_WINDOW_SETTINGS_SQL_LATEST_INDEX);
+            latest.bind(1, window_settings.id.resource.value());
+            if (latest.step())
+                history_index = latest.getInt(0);
+
+            db::Stmt save(db, Id(PBJ_WINDOW_SETTINGS_SQLID_SAVE_POS), PBJ_WINDOW_SETTINGS_SQL_SAVE_POS);
+            save.bindAll(window_settings.position.x, window_settings.position.y,
+                         window_settings.size.x, window_settings.size.y,
+                         window_settings.id.resource, history_index);
+
+            save.step();
+        }
+        catch (const db::Db::error& err)
+        {
+            PBJ_LOG(VWarning) << "Database error while saving window position!" << PBJ_LOG_NL
+                              << "      Sandwich ID: " << window_settings.id.sandwich << PBJ_LOG_NL
+                              << "WindowSettings ID: " << window_settings.id.resource << PBJ_LOG_NL
+                              << "        Exception: " << err.what() << PBJ_LOG_NL
+                              << "              SQL: " << err.sql() << PBJ_LOG_END;
+            throw;
+        }
+        catch (const std::runtime_error& err)
+        {
+            PBJ_LOG(VWarning) << "Exception while saving window position!" << PBJ_LOG_NL
+                              << "      Sandwich ID: " << window_settings.id.sandwich << PBJ_LOG_NL
+                              << "WindowSettings ID: " << window_settings.id.resource << PBJ_LOG_NL
+                              << "        Exception: " << err.what() << PBJ_LOG_END;
+            throw;
+        }
+    });
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -492,6 +308,12 @@ WindowSettings revertWindowSettings(const sw::ResourceId& id)
 {
     try
     {
+        // make sure any queued saves are reverted, not just the ones which
+        // happen to have been committed already.
+        std::shared_ptr<db::WriteQueue<sw::Sandwich> > queue = sw::openWriteQueue(id.sandwich);
+        if (queue)
+            queue->flush();
+
         std::shared_ptr<sw::Sandwich> sandwich = sw::openWritable(id.sandwich);
         if (!sandwich)
             throw std::runtime_error("Could not open sandwich for writing!");
@@ -504,12 +326,12 @@ WindowSettings revertWindowSettings(const sw::ResourceId& id)
         db::Transaction transaction(db, db::Transaction::Immediate);
 
         int history_index = 0;
-        db::Stmt latest(db, PBJ_WINDOW_SETTINGS_SQLID_LATEST_INDEX);
+        db::Stmt latest(db, Id(PBJ_WINDOW_SETTINGS_SQLID_LATEST_INDEX), PBJ_WINDOW_SETTINGS_SQL_LATEST_INDEX);
         latest.bind(1, id.resource.value());
         if (latest.step())
             history_index = latest.getInt(0);
 
-        db::Stmt remove(db, PBJ_WINDOW_SETTINGS_SQLID_REVERT);
+        db::Stmt remove(db, Id(PBJ_WINDOW_SETTINGS_SQLID_REVERT), PBJ_WINDOW_SETTINGS_SQL_REVERT);
         remove.bind(1, id.resource.value());
         remove.bind(2, history_index);
         remove.step();
@@ -543,65 +365,75 @@ WindowSettings revertWindowSettings(const sw::ResourceId& id)
 /// \details If history entires are removed, the remaining entries are
 ///         compressed so that their indices start at 0 for the oldest entry.
 ///
+///         The truncation is queued on the sandwich's write queue.
+///
 /// \param  id The ResourceId of the WindowSettings stack to truncate.
 /// \param  max_history_entries The number of entries to leave in the database.
+/// \return A future which becomes ready when the history has been truncated.
 ///
 /// \ingroup loading
-void truncateWindowSettingsHistory(const sw::ResourceId& id, int max_history_entries)
+std::future<void> truncateWindowSettingsHistory(const sw::ResourceId& id, int max_history_entries)
 {
-    try
+    std::shared_ptr<db::WriteQueue<sw::Sandwich> > queue = sw::openWriteQueue(id.sandwich);
+    if (!queue)
     {
-        std::shared_ptr<sw::Sandwich> sandwich = sw::openWritable(id.sandwich);
-        if (!sandwich)
-            throw std::runtime_error("Could not open sandwich for writing!");
+        PBJ_LOG(VWarning) << "Exception while truncating window settings history!" << PBJ_LOG_NL
+                          << "      Sandwich ID: " << id.sandwich << PBJ_LOG_NL
+                          << "WindowSettings ID: " << id.resource << PBJ_LOG_NL
+                          << "        Exception: Could not open sandwich for writing!" << PBJ_LOG_END;
+        return failedWrite("Could not open sandwich for writing!");
+    }
 
-        db::Db& db = sandwich->getDb();
+    return queue->push([=](sw::Sandwich& sandwich)
+    {
+        try
+        {
+            db::Db& db = sandwich.getDb();
   
-        if (db.getInt(PBJ_WINDOW_SETTINGS_SQL_TABLE_EXISTS, 0) == 0)
-            throw std::runtime_error("WindowSettings table does not exist!");
-
-        db::Transaction transaction(db, db::Transaction::Immediate);
+            if (db.getInt(PBJ_WINDOW_SETTINGS_SQL_TABLE_EXISTS, 0) == 0)
+                throw std::runtime_error("WindowSettings table does not exist!");
 
-        int history_index = 0;
-        db::Stmt latest(db, Id(PBJ_WINDOW_SETTINGS_SQLID_LATEST_INDEX), PBJ_WINDOW_SETTINGS_SQL_LATEST_INDEX);
-        latest.bind(1, id.resource.value());
-        if (latest.step())
-            history_index = latest.getInt(0);
-
-        history_index -= max_history_entries - 1;
-
-        // remove old history entries
-        db::Stmt remove(db, Id(PBJ_WINDOW_SETTINGS_SQLID_TRUNCATE), PBJ_WINDOW_SETTINGS_SQL_TRUNCATE);
-        remove.bind(1, id.resource.value());
-        remove.bind(2, history_index);
-        remove.step();
+            int history_index = 0;
+            db::Stmt latest(db, Id(PBJ_WINDOW_SETTINGS_SQLID_LATEST_INDEX), PBJ_WINDOW_SETTINGS_SQL_LATEST_INDEX);
+            latest.bind(1, id.resource.value());
+            if (latest.step())
+                history_index = latest.getInt(0);
 
-        // compress remaining history indices closer to 0
-        if (history_index > 1)
+            history_index -= max_history_entries - 1;
+
+            // remove old history entries
+            db::Stmt remove(db, Id(PBJ_WINDOW_SETTINGS_SQLID_TRUNCATE), PBJ_WINDOW_SETTINGS_SQL_TRUNCATE);
+            remove.bind(1, id.resource.value());
+            remove.bind(2, history_index);
+            remove.step();
+
+            // compress remaining history indices closer to 0
+            if (history_index > 1)
+            {
+                db::Stmt compress(db, Id(PBJ_WINDOW_SETTINGS_SQLID_COMPRESS), PBJ_WINDOW_SETTINGS_SQL_COMPRESS);
+                compress.bind(2, id.resource.value());
+                compress.bind(1, history_index - 1);
+                compress.step();
+            }
+        }
+        catch (const db::Db::error& err)
         {
-            db::Stmt compress(db, Id(PBJ_WINDOW_SETTINGS_SQLID_COMPRESS), PBJ_WINDOW_SETTINGS_SQL_COMPRESS);
-            compress.bind(2, id.resource.value());
-            compress.bind(1, history_index - 1);
-            compress.step();
+            PBJ_LOG(VWarning) << "Database error while truncating window settings history!" << PBJ_LOG_NL
+                              << "      Sandwich ID: " << id.sandwich << PBJ_LOG_NL
+                              << "WindowSettings ID: " << id.resource << PBJ_LOG_NL
+                              << "        Exception: " << err.what() << PBJ_LOG_NL
+                              << "              SQL: " << err.sql() << PBJ_LOG_END;
+            throw;
         }
-
-        transaction.commit();
-    }
-    catch (const db::Db::error& err)
-    {
-        PBJ_LOG(VWarning) << "Database error while truncating window settings history!" << PBJ_LOG_NL
-                          << "      Sandwich ID: " << id.sandwich << PBJ_LOG_NL
-                          << "WindowSettings ID: " << id.resource << PBJ_LOG_NL
-                          << "        Exception: " << err.what() << PBJ_LOG_NL
-                          << "              SQL: " << err.sql() << PBJ_LOG_END;
-    }
-    catch (const std::runtime_error& err)
-    {
-        PBJ_LOG(VWarning) << "Exception while truncating window settings history!" << PBJ_LOG_NL
-                          << "      Sandwich ID: " << id.sandwich << PBJ_LOG_NL
-                          << "WindowSettings ID: " << id.resource << PBJ_LOG_NL
-                          << "        Exception: " << err.what() << PBJ_LOG_END;
-    }
+        catch (const std::runtime_error& err)
+        {
+            PBJ_LOG(VWarning) << "Exception while truncating window settings history!" << PBJ_LOG_NL
+                              << "      Sandwich ID: " << id.sandwich << PBJ_LOG_NL
+                              << "WindowSettings ID: " << id.resource << PBJ_LOG_NL
+                              << "        Exception: " << err.what() << PBJ_LOG_END;
+            throw;
+        }
+    });
 }
 
 } // namespace pbj
@@ -47,8 +47,10 @@
 #else
 
 #include "pbj/engine.h"
+#include "be/async_log.h"
 
 #include <iostream>
+#include <cstring>
 #include <fstream>
 #include <random>
 
@@ -83,11 +85,20 @@ int main(int argc, char* argv[])
    std::ofstream cerr_log_file;
    std::string cerr_log("pbjed.log");
 
-   if (argc != 1)
+   bool binary_log = false;
+
+   // --binary-log writes the log file in the binary format (see logdecode)
+   for (int i = 1; i < argc; ++i)
    {
-      std::cout << "PBJgame " << PBJ_VERSION_MAJOR << '.' << PBJ_VERSION_MINOR << " (" << __DATE__ " " __TIME__ << ')' << std::endl
-                << PBJ_COPYRIGHT << std::endl;
-      return 1;
+      if (std::strcmp(argv[i], "--binary-log") == 0)
+         binary_log = true;
+      else
+      {
+         std::cout << "PBJgame " << PBJ_VERSION_MAJOR << '.' << PBJ_VERSION_MINOR << " (" << __DATE__ " " __TIME__ << ')' << std::endl
+                   << PBJ_COPYRIGHT << std::endl
+                   << "Usage: " << argv[0] << " [--binary-log]" << std::endl;
+         return 1;
+      }
    }
    
    // Set the appropriate verbosity level
@@ -98,11 +109,15 @@ int main(int argc, char* argv[])
    if (cerr_log.length() > 0)
    {
       PBJ_LOG(pbj::VNotice) << "Redirecting log to " << cerr_log << PBJ_LOG_END;
-      cerr_log_file.open(cerr_log, std::ofstream::trunc);
+      cerr_log_file.open(cerr_log, binary_log ? std::ofstream::trunc | std::ofstream::binary : std::ofstream::trunc);
       PBJ_LOG_STREAM.rdbuf(cerr_log_file.rdbuf());
    }
 #endif
 
+   // Write log messages from a background thread until main() returns.
+   // Binary log files must be decoded with logdecode.
+   be::AsyncLog async_log(binary_log && cerr_log_file.is_open() ? be::AsyncLog::Binary : be::AsyncLog::Text);
+
    // Initialize game engine
    pbj::Engine engine;
 
@@ -0,0 +1,78 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef BE_TESTS_BENCH_H_
+#define BE_TESTS_BENCH_H_
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Helpers for benchmarks.  Benchmark test cases are tagged [hide] so that
+// they only run when requested by name, eg: pbjgame "bengine/Id/Benchmark/*"
+namespace bench {
+
+// Measures elapsed wall-clock time.
+class Stopwatch
+{
+public:
+   Stopwatch()
+      : start_(std::chrono::high_resolution_clock::now())
+   {
+   }
+
+   void restart()
+   {
+      start_ = std::chrono::high_resolution_clock::now();
+   }
+
+   // Returns the number of seconds since construction or the last restart().
+   double seconds() const
+   {
+      auto elapsed(std::chrono::high_resolution_clock::now() - start_);
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() * 1e-9;
+   }
+
+private:
+   std::chrono::high_resolution_clock::time_point start_;
+};
+
+// Writes a heading for a table of benchmark results.
+inline void heading(const std::string& title)
+{
+   std::cout << std::endl << title << std::endl
+             << std::string(title.length(), '-') << std::endl;
+}
+
+// Writes one row of a benchmark result table.
+inline void report(const std::string& label, double seconds, double operations)
+{
+   std::cout << std::left << std::setw(32) << label << std::right
+             << std::fixed << std::setprecision(3)
+             << std::setw(12) << seconds * 1000.0 << " ms"
+             << std::setw(12) << (seconds > 0 ? operations / seconds / 1e6 : 0.0) << " Mops/s"
+             << std::setw(12) << (operations > 0 ? seconds * 1e9 / operations : 0.0) << " ns/op"
+             << std::endl;
+}
+
+} // namespace bench
+
+#endif
@@ -0,0 +1,152 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "be/bed/batch_writer.h"
+#include "be/bed/db.h"
+#include "be/bed/stmt.h"
+#include "be/bed/transaction.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+#include "bench.h"
+
+#include <cstdio>
+#include <string>
+
+namespace {
+
+const char* bench_path = "bench_batch_writer.bed";
+
+// Creates a table shaped like a typical sandwich asset table, with two
+// secondary indexes.
+void createAssetTable(be::bed::Db& db)
+{
+   db.exec("CREATE TABLE assets (id INTEGER PRIMARY KEY, name TEXT, path TEXT, size INTEGER, data BLOB);"
+           "CREATE INDEX assets_name ON assets (name);"
+           "CREATE INDEX assets_size ON assets (size);");
+}
+
+// Generates names in a scattered order so that index inserts are random.
+std::string assetName(int i)
+{
+   unsigned int h = static_cast<unsigned int>(i) * 2654435761u;
+   char buf[32];
+   sprintf(buf, "asset_%08x", h);
+   return buf;
+}
+
+const char* insert_sql = "INSERT INTO assets (name, path, size, data) VALUES (?, ?, ?, ?)";
+const char blob[64] = { 0 };
+
+} // namespace (anon)
+
+TEST_CASE("bengine/BatchWriter/Benchmark", "[hide] Bulk insert with and without BatchWriter")
+{
+   const int rows = 200000;
+   const int autocommit_rows = 2000;
+
+   bench::heading("Inserting rows into an indexed table (file database)");
+
+   // one implicit transaction per row, as a naive import would do
+   std::remove(bench_path);
+   {
+      be::bed::Db db(bench_path);
+      createAssetTable(db);
+      be::bed::Stmt insert(db, insert_sql);
+
+      bench::Stopwatch sw;
+      for (int i = 0; i < autocommit_rows; ++i)
+      {
+         std::string name(assetName(i));
+         insert.bind(1, name);
+         insert.bind(2, "textures/" + name + ".png");
+         insert.bind(3, i % 1000);
+         insert.bindBlob(4, blob, sizeof(blob));
+         insert.step();
+         insert.reset();
+      }
+      bench::report("step() per row, autocommit", sw.seconds(), autocommit_rows);
+   }
+
+   // a single hand-written transaction
+   std::remove(bench_path);
+   {
+      be::bed::Db db(bench_path);
+      createAssetTable(db);
+      be::bed::Stmt insert(db, insert_sql);
+
+      bench::Stopwatch sw;
+      be::bed::Transaction transaction(db, be::bed::Transaction::Immediate);
+      for (int i = 0; i < rows; ++i)
+      {
+         std::string name(assetName(i));
+         insert.bind(1, name);
+         insert.bind(2, "textures/" + name + ".png");
+         insert.bind(3, i % 1000);
+         insert.bindBlob(4, blob, sizeof(blob));
+         insert.step();
+         insert.reset();
+      }
+      transaction.commit();
+      bench::report("step() per row, 1 transaction", sw.seconds(), rows);
+   }
+
+   const size_t chunk_sizes[] = { 1000, 10000, 100000 };
+   for (size_t c = 0; c < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); ++c)
+   {
+      for (int drop = 0; drop < 2; ++drop)
+      {
+         std::remove(bench_path);
+         be::bed::Db db(bench_path);
+         createAssetTable(db);
+
+         bench::Stopwatch sw;
+         {
+            be::bed::BatchWriter writer(db, insert_sql, chunk_sizes[c]);
+            if (drop)
+               writer.dropIndexes("assets");
+
+            for (int i = 0; i < rows; ++i)
+            {
+               std::string name(assetName(i));
+               writer << name << "textures/" + name + ".png" << i % 1000;
+               writer.bindBlob(blob, sizeof(blob));
+               writer.next();
+            }
+            writer.finish();
+         }
+         double seconds = sw.seconds();
+
+         std::string label("BatchWriter, chunk ");
+         label.append(std::to_string(static_cast<long long>(chunk_sizes[c])));
+         if (drop)
+            label.append(", rebuild");
+         bench::report(label, seconds, rows);
+
+         REQUIRE(db.getInt("SELECT count(*) FROM sqlite_master WHERE type = 'index'", 0) == 2);
+         REQUIRE(db.getInt("SELECT count(*) FROM assets", 0) == rows);
+      }
+   }
+
+   std::remove(bench_path);
+}
+
+#endif
@@ -0,0 +1,125 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "be/bed/blob_reader.h"
+#include "be/bed/stmt.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+#include "bench.h"
+
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* bench_path = "bench_blob_reader.sw";
+const int asset_size = 16 * 1024 * 1024;
+const int chunk_size = 64 * 1024;
+const int iterations = 20;
+
+// Reports throughput (each byte read is one "op") and the peak memory used
+// while loading: SQLite's high-water mark plus whatever the loader allocated
+// itself.
+void reportPeak(const std::string& label, double seconds, sqlite3_int64 sqlite_peak, size_t loader_bytes)
+{
+   bench::report(label, seconds, double(iterations) * asset_size);
+   std::cout << "    peak memory: " << std::fixed << std::setprecision(2)
+             << (sqlite_peak + loader_bytes) / (1024.0 * 1024.0) << " MiB ("
+             << sqlite_peak / (1024.0 * 1024.0) << " MiB in SQLite)" << std::endl;
+}
+
+} // namespace (anon)
+
+TEST_CASE("bengine/BlobReader/Benchmark", "[hide] Peak memory and time to read a large blob")
+{
+   std::remove(bench_path);
+   {
+      be::bed::Db db(bench_path, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+      db.exec("CREATE TABLE assets (id INTEGER PRIMARY KEY, data BLOB)");
+      be::bed::Stmt insert(db, "INSERT INTO assets (id, data) VALUES (1, ?)");
+      insert.bindBlob(1, std::string(asset_size, 'x'));
+      insert.step();
+   }
+
+   std::ostringstream title;
+   title << "Read one " << asset_size / (1024 * 1024) << " MiB asset (Mops/s = MB/s)";
+   bench::heading(title.str());
+
+   be::bed::Db db(bench_path, SQLITE_OPEN_READONLY, be::bed::DbConfig::readOnly());
+   size_t checksum = 0;
+
+   {
+      be::bed::Stmt select(db, "SELECT data FROM assets WHERE id = 1");
+      sqlite3_memory_highwater(1);
+      sqlite3_int64 base = sqlite3_memory_used();
+      bench::Stopwatch sw;
+      for (int i = 0; i < iterations; ++i)
+      {
+         select.step();
+         std::string data(select.getBlob(0));
+         checksum += data[data.length() / 2];
+         select.reset();
+      }
+      reportPeak("Stmt::getBlob() -> std::string", sw.seconds(), sqlite3_memory_highwater(0) - base, asset_size);
+   }
+
+   {
+      be::bed::Stmt select(db, "SELECT data FROM assets WHERE id = 1");
+      sqlite3_memory_highwater(1);
+      sqlite3_int64 base = sqlite3_memory_used();
+      bench::Stopwatch sw;
+      for (int i = 0; i < iterations; ++i)
+      {
+         select.step();
+         const void* data;
+         int size = select.getBlob(0, data);
+         checksum += static_cast<const char*>(data)[size / 2];
+         select.reset();
+      }
+      reportPeak("Stmt::getBlob() -> const void*", sw.seconds(), sqlite3_memory_highwater(0) - base, 0);
+   }
+
+   {
+      std::vector<char> buffer(chunk_size);
+      sqlite3_memory_highwater(1);
+      sqlite3_int64 base = sqlite3_memory_used();
+      bench::Stopwatch sw;
+      for (int i = 0; i < iterations; ++i)
+      {
+         be::bed::BlobReader reader(db, "assets", "data", 1);
+         while (!reader.isEof())
+         {
+            int bytes = reader.read(&buffer[0], chunk_size);
+            checksum += buffer[bytes / 2];
+         }
+      }
+      reportPeak("BlobReader, 64 KiB chunks", sw.seconds(), sqlite3_memory_highwater(0) - base, chunk_size);
+   }
+
+   REQUIRE(checksum > 0);
+   std::remove(bench_path);
+}
+
+#endif
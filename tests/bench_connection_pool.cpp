@@ -0,0 +1,170 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "be/bed/connection_pool.h"
+#include "be/bed/bed.h"
+#include "be/bed/transaction.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+#include "bench.h"
+
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const char* bench_path = "bench_connection_pool.bed";
+const int resource_count = 1024;   // small enough to stay in each connection's page cache
+const char* select_sql = "SELECT data FROM resources WHERE id = ?";
+
+void createBenchBed()
+{
+   std::remove(bench_path);
+
+   be::bed::Db db(bench_path, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+   db.exec("CREATE TABLE resources (id INTEGER PRIMARY KEY, data BLOB)");
+
+   be::bed::Transaction transaction(db);
+   be::bed::Stmt insert(db, "INSERT INTO resources (id, data) VALUES (?, ?)");
+   std::string data(1024, 'x');
+   for (int i = 0; i < resource_count; ++i)
+   {
+      insert.bind(1, i);
+      insert.bindBlob(2, data);
+      insert.step();
+      insert.reset();
+   }
+   transaction.commit();
+}
+
+// Loads 'loads' resources using the bed returned by get_bed for each one.
+template <class F>
+size_t loadResources(F get_bed, int thread_index, int loads)
+{
+   size_t bytes = 0;
+   for (int i = 0; i < loads; ++i)
+   {
+      auto bed(get_bed());
+      be::bed::CachedStmt stmt = bed->getStmtCache().hold(select_sql);
+      stmt.bind(1, (thread_index * 7919 + i * 31) % resource_count);
+      if (stmt.step())
+         bytes += stmt.getBlob(0).length();
+   }
+   return bytes;
+}
+
+template <class F>
+double runThreads(int thread_count, int loads_per_thread, F get_bed, size_t& bytes)
+{
+   std::vector<std::thread> threads;
+   std::vector<size_t> thread_bytes(thread_count);
+   size_t* results = &thread_bytes[0];
+
+   bench::Stopwatch sw;
+   for (int t = 0; t < thread_count; ++t)
+      threads.push_back(std::thread([=]() { results[t] = loadResources(get_bed, t, loads_per_thread); }));
+
+   for (auto i(threads.begin()), end(threads.end()); i != end; ++i)
+      i->join();
+
+   double seconds = sw.seconds();
+
+   bytes = 0;
+   for (auto i(thread_bytes.begin()), end(thread_bytes.end()); i != end; ++i)
+      bytes += *i;
+
+   return seconds;
+}
+
+} // namespace (anon)
+
+TEST_CASE("bengine/ConnectionPool/Benchmark", "[hide] Read throughput from one bed file with a shared connection vs. a connection pool")
+{
+   const int thread_counts[] = { 1, 2, 4, 8 };
+   const int loads = 100000;
+
+   createBenchBed();
+   std::cout << std::endl << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+
+   for (std::size_t c = 0; c < sizeof(thread_counts) / sizeof(thread_counts[0]); ++c)
+   {
+      int threads = thread_counts[c];
+      std::ostringstream title;
+      title << "Load 1 KB resources, " << threads << " thread(s)";
+      bench::heading(title.str());
+
+      {
+         be::bed::Bed shared(be::Id(), bench_path, true);
+         be::bed::Bed* bed = &shared;
+         size_t bytes;
+         double seconds = runThreads(threads, loads / threads, [=]() { return bed; }, bytes);
+         bench::report("shared connection", seconds, loads);
+         REQUIRE(bytes == std::size_t(loads / threads) * threads * 1024);
+      }
+
+      {
+         // one connection per thread without a pool, to separate the cost
+         // of the pool's bookkeeping from the cost of separate connections.
+         std::vector<std::unique_ptr<be::bed::Bed> > beds;
+         for (int t = 0; t < threads; ++t)
+            beds.push_back(std::unique_ptr<be::bed::Bed>(new be::bed::Bed(be::Id(), bench_path, true)));
+
+         std::vector<std::thread> workers;
+         std::vector<size_t> thread_bytes(threads);
+         size_t* results = &thread_bytes[0];
+
+         bench::Stopwatch sw;
+         for (int t = 0; t < threads; ++t)
+         {
+            be::bed::Bed* bed = beds[t].get();
+            workers.push_back(std::thread([=]() { results[t] = loadResources([=]() { return bed; }, t, loads / threads); }));
+         }
+
+         for (auto i(workers.begin()), end(workers.end()); i != end; ++i)
+            i->join();
+
+         bench::report("connection per thread", sw.seconds(), loads);
+
+         size_t bytes = 0;
+         for (auto i(thread_bytes.begin()), end(thread_bytes.end()); i != end; ++i)
+            bytes += *i;
+         REQUIRE(bytes == std::size_t(loads / threads) * threads * 1024);
+      }
+
+      {
+         be::bed::ConnectionPool<be::bed::Bed> pool([]() { return new be::bed::Bed(be::Id(), bench_path, true); }, threads);
+         be::bed::ConnectionPool<be::bed::Bed>* p = &pool;
+         size_t bytes;
+         double seconds = runThreads(threads, loads / threads, [=]() { return p->hold(); }, bytes);
+         bench::report("connection pool", seconds, loads);
+         REQUIRE(bytes == std::size_t(loads / threads) * threads * 1024);
+      }
+   }
+
+   std::remove(bench_path);
+}
+
+#endif
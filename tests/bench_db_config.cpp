@@ -0,0 +1,133 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "be/bed/db.h"
+#include "be/bed/stmt.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+#include "bench.h"
+
+#include <cstdio>
+#include <string>
+
+namespace {
+
+const char* bench_path = "bench_db_config.sw";
+const int resource_count = 8192;
+const int resource_size = 4096;
+
+void removeBenchDb()
+{
+   std::remove(bench_path);
+   std::remove((std::string(bench_path) + "-wal").c_str());
+   std::remove((std::string(bench_path) + "-shm").c_str());
+   std::remove((std::string(bench_path) + "-journal").c_str());
+}
+
+// Creates a 32 MiB sandwich-like database, then times many small
+// transactions, like the editor saving individual resources.
+double writeResources(const be::bed::DbConfig& config, int transactions)
+{
+   removeBenchDb();
+   be::bed::Db db(bench_path, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, config);
+   db.exec("CREATE TABLE resources (id INTEGER PRIMARY KEY, data BLOB)");
+
+   std::string data(resource_size, 'x');
+   {
+      be::bed::Stmt insert(db, be::Id(), "INSERT INTO resources (id, data) VALUES (?, ?)");
+      db.begin();
+      for (int i = 0; i < resource_count; ++i)
+      {
+         insert.bind(1, i);
+         insert.bindBlob(2, data);
+         insert.step();
+         insert.reset();
+      }
+      db.commit();
+   }
+
+   be::bed::Stmt update(db, be::Id(), "UPDATE resources SET data = ? WHERE id = ?");
+   bench::Stopwatch sw;
+   for (int i = 0; i < transactions; ++i)
+   {
+      db.begin();
+      for (int n = 0; n < 4; ++n)
+      {
+         update.bindBlob(1, data);
+         update.bind(2, (i * 4 + n) * 37 % resource_count);
+         update.step();
+         update.reset();
+      }
+      db.commit();
+   }
+   return sw.seconds();
+}
+
+// Times random reads of whole resources through a new read-only connection.
+double readResources(const be::bed::DbConfig& config, int reads)
+{
+   be::bed::Db db(bench_path, SQLITE_OPEN_READONLY, config);
+   be::bed::Stmt select(db, be::Id(), "SELECT data FROM resources WHERE id = ?");
+
+   size_t bytes = 0;
+   bench::Stopwatch sw;
+   for (int i = 0; i < reads; ++i)
+   {
+      select.bind(1, i * 7919 % resource_count);
+      if (select.step())
+      {
+         const void* data;
+         bytes += select.getBlob(0, data);
+      }
+      select.reset();
+   }
+   double seconds = sw.seconds();
+
+   REQUIRE(bytes == size_t(reads) * resource_size);
+   return seconds;
+}
+
+} // namespace (anon)
+
+TEST_CASE("bengine/DbConfig/Benchmark", "[hide] I/O throughput of DbConfig profiles on a large database")
+{
+   const int transactions = 2000;
+   const int reads = 200000;
+
+   bench::heading("Small write transactions (4 x 4 KiB updates each)");
+   bench::report("default", writeResources(be::bed::DbConfig(), transactions), transactions);
+   bench::report("DbConfig::editor()", writeResources(be::bed::DbConfig::editor(), transactions), transactions);
+
+   // the last write left the file in WAL mode
+   {
+      be::bed::Db db(bench_path, SQLITE_OPEN_READWRITE);
+      db.exec("PRAGMA journal_mode = DELETE");
+   }
+
+   bench::heading("Random 4 KiB resource reads");
+   bench::report("default", readResources(be::bed::DbConfig(), reads), reads);
+   bench::report("DbConfig::readOnly()", readResources(be::bed::DbConfig::readOnly(), reads), reads);
+
+   removeBenchDb();
+}
+
+#endif
@@ -0,0 +1,112 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "be/source_handle.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+#include "bench.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct BenchHandleObject
+{
+   BenchHandleObject(int value)
+      : value(value)
+   {
+      handle.associate(this);
+   }
+
+   be::SourceHandle<BenchHandleObject> handle;
+   int value;
+};
+
+void benchResolve(const char* name, const std::vector<be::ConstHandle<BenchHandleObject> >& handles, int passes)
+{
+   std::vector<const BenchHandleObject*> out(handles.size());
+   double operations = double(handles.size()) * passes;
+   int64_t checksum = 0;
+
+   bench::Stopwatch sw;
+   for (int p = 0; p < passes; ++p)
+   {
+      for (size_t i = 0; i < handles.size(); ++i)
+         out[i] = handles[i].get();
+      checksum += out[p % out.size()] ? out[p % out.size()]->value : 0;
+   }
+   double get_time = sw.seconds();
+
+   sw.restart();
+   for (int p = 0; p < passes; ++p)
+   {
+      be::ConstHandle<BenchHandleObject>::resolve(handles.data(), handles.size(), out.data());
+      checksum -= out[p % out.size()] ? out[p % out.size()]->value : 0;
+   }
+   double resolve_time = sw.seconds();
+
+   std::string prefix(name);
+   bench::report(prefix + " get()", get_time, operations);
+   bench::report(prefix + " resolve()", resolve_time, operations);
+
+   REQUIRE(checksum == 0);
+}
+
+} // namespace (anon)
+
+TEST_CASE("bengine/Handle/Benchmark", "[hide] Resolving 100k handles one at a time vs. in a batch")
+{
+   const size_t count = 100000;
+   const int passes = 100;
+   std::mt19937 rng(306);
+
+   std::vector<BenchHandleObject*> objects;
+   objects.reserve(count);
+   for (size_t i = 0; i < count; ++i)
+      objects.push_back(new BenchHandleObject(int(i)));
+
+   std::vector<be::ConstHandle<BenchHandleObject> > handles;
+   handles.reserve(count);
+   for (size_t i = 0; i < count; ++i)
+      handles.push_back(objects[i]->handle);
+
+   bench::heading("100000 handles");
+   benchResolve("sequential", handles, passes);
+
+   std::shuffle(handles.begin(), handles.end(), rng);
+   benchResolve("shuffled", handles, passes);
+
+   // invalidate a quarter of the targets
+   for (size_t i = 0; i < count; i += 4)
+   {
+      delete objects[i];
+      objects[i] = nullptr;
+   }
+   benchResolve("shuffled, 25% stale", handles, passes);
+
+   for (size_t i = 0; i < count; ++i)
+      delete objects[i];
+}
+
+#endif
@@ -0,0 +1,93 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "be/id.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+#include "bench.h"
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+TEST_CASE("bengine/Id/Benchmark/Registry", "[hide] Id construction and to_string() throughput as thread count increases")
+{
+#ifndef BE_ID_NAMES_ENABLED
+   std::cout << "Note: BE_ID_NAMES_ENABLED is not defined; the name registry is not being exercised." << std::endl;
+#endif
+
+   const int names_per_thread = 20000;
+   const int passes = 5;
+
+   bench::heading("Id name registry (first pass inserts, later passes look up)");
+
+   for (int thread_count = 1; thread_count <= 16; thread_count *= 2)
+   {
+      // generate unique names for this run so the first pass always inserts.
+      std::vector<std::vector<std::string> > names(thread_count);
+      for (int t = 0; t < thread_count; ++t)
+      {
+         names[t].reserve(names_per_thread);
+         for (int i = 0; i < names_per_thread; ++i)
+         {
+            std::ostringstream oss;
+            oss << "bench.registry." << thread_count << '.' << t << '.' << i;
+            names[t].push_back(oss.str());
+         }
+      }
+
+      std::vector<uint64_t> checksums(thread_count, 0);
+      std::vector<std::thread> threads;
+
+      bench::Stopwatch sw;
+      for (int t = 0; t < thread_count; ++t)
+      {
+         threads.push_back(std::thread([&names, &checksums, t]()
+         {
+            uint64_t checksum = 0;
+            const std::vector<std::string>& my_names = names[t];
+            for (int pass = 0; pass < passes; ++pass)
+            {
+               for (auto i(my_names.begin()), end(my_names.end()); i != end; ++i)
+               {
+                  be::Id id(*i);
+                  checksum ^= id.value();
+                  if ((id.value() & 0xF) == 0)
+                     checksum += id.to_string().length();
+               }
+            }
+            checksums[t] = checksum;
+         }));
+      }
+      for (auto i(threads.begin()), end(threads.end()); i != end; ++i)
+         i->join();
+      double seconds = sw.seconds();
+
+      std::ostringstream label;
+      label << thread_count << " thread(s)";
+      bench::report(label.str(), seconds, double(thread_count) * names_per_thread * passes);
+
+      REQUIRE(be::Id(names[0][0]).to_string().length() >= 17);
+   }
+}
+
+#endif
@@ -0,0 +1,99 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "be/id_map.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+#include "bench.h"
+
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+template <typename M>
+void benchMap(const char* name, const std::vector<be::Id>& keys, const std::vector<be::Id>& misses, size_t lookups)
+{
+   uint64_t checksum = 0;
+   bench::Stopwatch sw;
+
+   M map;
+   for (size_t i = 0; i < keys.size(); ++i)
+      map[keys[i]] = i;
+   double insert_time = sw.seconds();
+
+   sw.restart();
+   for (size_t i = 0; i < lookups; ++i)
+      checksum += map.find(keys[i % keys.size()])->second;
+   double hit_time = sw.seconds();
+
+   sw.restart();
+   for (size_t i = 0; i < lookups; ++i)
+      checksum += map.count(misses[i % misses.size()]);
+   double miss_time = sw.seconds();
+
+   sw.restart();
+   for (auto i(map.begin()), end(map.end()); i != end; ++i)
+      checksum += i->second;
+   double iterate_time = sw.seconds();
+
+   std::string prefix(name);
+   bench::report(prefix + " insert", insert_time, double(keys.size()));
+   bench::report(prefix + " find (hit)", hit_time, double(lookups));
+   bench::report(prefix + " find (miss)", miss_time, double(lookups));
+   bench::report(prefix + " iterate", iterate_time, double(keys.size()));
+
+   REQUIRE(checksum > 0);
+}
+
+} // namespace (anon)
+
+TEST_CASE("bengine/IdMap/Benchmark", "[hide] be::IdMap vs. std::unordered_map with hashed Id keys")
+{
+   std::mt19937 rng(306);
+
+   for (size_t size = 1000; size <= 1000000; size *= 10)
+   {
+      std::vector<be::Id> keys, misses;
+      keys.reserve(size);
+      misses.reserve(size);
+      for (size_t i = 0; i < size; ++i)
+      {
+         keys.push_back(be::Id((uint64_t(rng()) << 32) | rng()));
+         misses.push_back(be::Id((uint64_t(rng()) << 32) | rng()));
+      }
+      std::shuffle(keys.begin(), keys.end(), rng);
+
+      std::ostringstream oss;
+      oss << size << " entries";
+      bench::heading(oss.str());
+
+      const size_t lookups = 2000000;
+      benchMap<std::unordered_map<be::Id, size_t> >("unordered_map", keys, misses, lookups);
+      benchMap<be::IdMap<size_t> >("IdMap", keys, misses, lookups);
+   }
+}
+
+#endif
@@ -0,0 +1,139 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// Only errors are compiled into this file, so that statements removed at
+// compile time can be compared with statements disabled at runtime.  If
+// be/_be.h has already been included (e.g. through a precompiled header) or
+// BE_MIN_VERBOSITY is set on the command line, that setting is used instead,
+// and the benchmark reports whether VInfo was actually removed.
+#ifndef BE_MIN_VERBOSITY
+#define BE_MIN_VERBOSITY be::VErrors
+#endif
+
+#include "be/_be.h"
+#include "be/async_log.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+#include "bench.h"
+
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+// Defined out of line and called through a volatile pointer so that the
+// compiler can't optimize the benchmark loops away.
+void consume(uint64_t value);
+void (* volatile consume_ptr)(uint64_t) = consume;
+uint64_t consumed = 0;
+
+void consume(uint64_t value)
+{
+   consumed += value;
+}
+
+} // namespace (anon)
+
+TEST_CASE("bengine/Log/Benchmark/Disabled", "[hide] Cost of BE_LOG statements which are disabled at compile time vs. runtime")
+{
+   const uint64_t iterations = 50000000;
+   int old_verbosity = be::getVerbosity();
+   be::setVerbosity(0);
+
+   void (*sink)(uint64_t) = consume_ptr;
+   uint64_t evaluated = 0;
+
+   // the same test BE_LOG() uses to remove a statement at compile time
+   const bool info_compiled_out = (be::VInfo & (BE_MIN_VERBOSITY)) != be::VInfo;
+
+   bench::heading("Disabled BE_LOG statements");
+
+   bench::Stopwatch sw;
+   for (uint64_t i = 0; i < iterations; ++i)
+      sink(i);
+   double baseline_time = sw.seconds();
+
+   sw.restart();
+   for (uint64_t i = 0; i < iterations; ++i)
+   {
+      BE_LOG(be::VInfo) << "excluded by BE_MIN_VERBOSITY " << ++evaluated << BE_LOG_END;
+      sink(i);
+   }
+   double compiled_out_time = sw.seconds();
+
+   sw.restart();
+   for (uint64_t i = 0; i < iterations; ++i)
+   {
+      BE_LOG(be::VError) << "disabled at runtime " << ++evaluated << BE_LOG_END;
+      sink(i);
+   }
+   double runtime_time = sw.seconds();
+
+   bench::report("no log statement", baseline_time, double(iterations));
+   bench::report(info_compiled_out ? "BE_MIN_VERBOSITY excludes level" : "BE_MIN_VERBOSITY includes level (not removed)", compiled_out_time, double(iterations));
+   bench::report("setVerbosity() excludes level", runtime_time, double(iterations));
+
+   be::setVerbosity(old_verbosity);
+
+   REQUIRE(evaluated == 0);
+   REQUIRE(consumed > 0);
+}
+
+TEST_CASE("bengine/Log/Benchmark/Format", "[hide] Cost and size of text vs. binary logs")
+{
+   const int iterations = 200000;
+   int old_verbosity = be::getVerbosity();
+   be::setVerbosity(be::VAll);
+
+   bench::heading("BE_LOG output formats");
+
+   double times[2];
+   size_t sizes[2];
+   for (int f = 0; f < 2; ++f)
+   {
+      std::ostringstream out;
+      std::streambuf* old_buf = BE_LOG_STREAM.rdbuf(out.rdbuf());
+
+      bench::Stopwatch sw;
+      {
+         be::AsyncLog async_log(f == 0 ? be::AsyncLog::Text : be::AsyncLog::Binary);
+         for (int i = 0; i < iterations; ++i)
+            BE_LOG(be::VError) << "Frame " << i << " took " << (i * 0.001) << " ms; "
+                               << (i & 0xFF) << " objects visible" << BE_LOG_END;
+      }
+      times[f] = sw.seconds();
+      sizes[f] = out.str().size();
+
+      BE_LOG_STREAM.rdbuf(old_buf);
+   }
+
+   bench::report("text", times[0], double(iterations));
+   bench::report("binary", times[1], double(iterations));
+   std::cout << "   text bytes/message:   " << double(sizes[0]) / iterations << std::endl
+             << "   binary bytes/message: " << double(sizes[1]) / iterations << std::endl;
+
+   be::setVerbosity(old_verbosity);
+
+   REQUIRE(sizes[1] < sizes[0]);
+}
+
+#endif
@@ -0,0 +1,93 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#define BE_PROFILE_ENABLED
+
+#include "be/profiler.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+#include "bench.h"
+
+namespace {
+
+// Defined out of line and called through a volatile pointer so that the
+// compiler can't optimize the benchmark loops away.
+void consume(uint64_t value);
+void (* volatile consume_ptr)(uint64_t) = consume;
+uint64_t consumed = 0;
+
+void consume(uint64_t value)
+{
+   consumed += value;
+}
+
+} // namespace (anon)
+
+TEST_CASE("bengine/Profiler/Benchmark", "[hide] Cost of BE_PROFILE_ZONE with and without a Profiler")
+{
+   const uint64_t iterations = 10000000;
+   const uint64_t zones_per_frame = 1000;   // well under the per-thread buffer capacity
+
+   void (*sink)(uint64_t) = consume_ptr;
+
+   bench::heading("BE_PROFILE_ZONE overhead");
+
+   bench::Stopwatch sw;
+   for (uint64_t i = 0; i < iterations; ++i)
+      sink(i);
+   double baseline_time = sw.seconds();
+
+   sw.restart();
+   for (uint64_t i = 0; i < iterations; ++i)
+   {
+      BE_PROFILE_ZONE("inactive");
+      sink(i);
+   }
+   double inactive_time = sw.seconds();
+
+   uint64_t dropped;
+   double active_time;
+   {
+      be::Profiler profiler;
+      sw.restart();
+      for (uint64_t i = 0; i < iterations; ++i)
+      {
+         {
+            BE_PROFILE_ZONE("active");
+            sink(i);
+         }
+         if (i % zones_per_frame == zones_per_frame - 1)
+            BE_PROFILE_FRAME();
+      }
+      active_time = sw.seconds();
+      dropped = profiler.getDroppedCount();
+   }
+
+   bench::report("no zone", baseline_time, double(iterations));
+   bench::report("zone, no Profiler", inactive_time, double(iterations));
+   bench::report("zone + frame collection", active_time, double(iterations));
+
+   REQUIRE(dropped == 0);
+   REQUIRE(consumed > 0);
+}
+
+#endif
@@ -0,0 +1,163 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "pbj/sw/resource_cache.h"
+#include "pbj/sw/sandwich_open.h"
+#include "be/bed/cached_stmt.h"
+#include "be/bed/stmt.h"
+#include "be/bed/db.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+#include "bench.h"
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int resource_count = 200;
+const int scene_count = 20;
+
+struct BenchResource
+{
+   explicit BenchResource(std::string& data)
+   {
+      this->data.swap(data);
+   }
+
+   std::string data;
+};
+
+struct BenchPolicy
+{
+   typedef BenchResource resource_type;
+   typedef std::string data_type;
+
+   void read(pbj::sw::Sandwich& sandwich, const pbj::sw::ResourceId& id, data_type& data) const
+   {
+      be::bed::CachedStmt stmt(sandwich.getStmtCache().hold("SELECT data FROM bench_resources WHERE id = ?"));
+      stmt.bindAll(id.resource);
+      if (stmt.step())
+         data = stmt.getBlob(0);
+   }
+
+   void decode(const pbj::sw::ResourceId& /*id*/, data_type& /*data*/) const
+   {
+   }
+
+   BenchResource* finalize(const pbj::sw::ResourceId& /*id*/, data_type& data) const
+   {
+      return new BenchResource(data);
+   }
+
+   void measure(const BenchResource& resource, size_t& cpu_bytes, size_t& gpu_bytes) const
+   {
+      cpu_bytes = resource.data.size();
+      gpu_bytes = 0;
+   }
+
+   be::Id getVariant() const
+   {
+      return be::Id();
+   }
+
+   be::Id getContentType() const
+   {
+      return be::Id();
+   }
+};
+
+} // namespace (anon)
+
+TEST_CASE("pbj/sw/ResourceCache/Benchmark", "[hide] Scenes sharing resources through a ResourceCache")
+{
+   const std::string manifest_path("bench_resource_cache.manifest");
+   const std::string path("bench_resource_cache.sw");
+   const be::Id sandwich_id("bench_resource_cache");
+   std::remove(path.c_str());
+   std::remove(manifest_path.c_str());
+
+   {
+      be::bed::Db db(path);
+      db.exec("CREATE TABLE pbj_sandwich_properties (property TEXT PRIMARY KEY, value)");
+      db.exec("CREATE TABLE bench_resources (id INTEGER PRIMARY KEY, data BLOB)");
+
+      be::bed::Stmt insert_property(db, "INSERT INTO pbj_sandwich_properties VALUES ('id', ?)");
+      insert_property.bindAll(sandwich_id);
+      insert_property.step();
+
+      db.exec("BEGIN");
+      be::bed::Stmt insert(db, "INSERT INTO bench_resources VALUES (?, ?)");
+      std::string blob(16384, 'x');
+      for (int i = 0; i < resource_count; ++i)
+      {
+         insert.reset();
+         insert.bindAll(be::Id(uint64_t(i + 1)));
+         insert.bindBlob(2, blob);
+         insert.step();
+      }
+      db.exec("COMMIT");
+   }
+
+   pbj::sw::readDirectory("./", manifest_path);
+
+   {
+      pbj::sw::ResourceLoader loader;
+      pbj::sw::ResourceCache cache(loader, resource_count * 16384, 0);
+      BenchPolicy policy;
+
+      std::vector<std::vector<pbj::sw::CachedResource<BenchResource> > > scenes(scene_count);
+
+      std::ostringstream oss;
+      oss << scene_count << " scenes sharing " << resource_count << " 16 KB resources";
+      bench::heading(oss.str());
+
+      bench::Stopwatch sw;
+      for (int i = 0; i < resource_count; ++i)
+         scenes[0].push_back(cache.hold(pbj::sw::ResourceId(sandwich_id, be::Id(uint64_t(i + 1))), 0, policy));
+      loader.flush();
+      cache.update();
+      bench::report("first scene (misses)", sw.seconds(), resource_count);
+
+      sw.restart();
+      for (int s = 1; s < scene_count; ++s)
+         for (int i = 0; i < resource_count; ++i)
+            scenes[s].push_back(cache.hold(pbj::sw::ResourceId(sandwich_id, be::Id(uint64_t(i + 1))), 0, policy));
+      cache.update();
+      bench::report("other scenes (hits)", sw.seconds(), double(resource_count) * (scene_count - 1));
+
+      const pbj::sw::ResourceCacheStats& stats = cache.getStats();
+      REQUIRE(stats.misses == resource_count);
+      REQUIRE(stats.resident == resource_count);
+      REQUIRE(stats.cpu_bytes == resource_count * 16384);
+
+      scenes.clear();
+      cache.setBudget(resource_count * 16384 / 2, 0);
+      REQUIRE(stats.resident == resource_count / 2);
+   }
+
+   std::remove(path.c_str());
+   std::remove(manifest_path.c_str());
+}
+
+#endif
@@ -0,0 +1,238 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "be/bed/row_reader.h"
+#include "be/bed/stmt.h"
+#include "be/bed/db.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+#include "bench.h"
+
+namespace {
+
+// Has the same shape as a row of the window_settings table.
+struct WideRow
+{
+   int mode;
+   bool system_positioned;
+   bool save_position_on_close;
+   int x, y, width, height;
+   int monitor_index;
+   unsigned int refresh_rate;
+   int v_sync;
+   unsigned int msaa_level;
+   unsigned int red_bits, green_bits, blue_bits, alpha_bits, depth_bits, stencil_bits;
+   bool srgb_capable;
+   bool use_custom_gamma;
+   float custom_gamma;
+};
+
+be::bed::RowReader& operator>>(be::bed::RowReader& row, WideRow& r)
+{
+   return row >> r.mode >> r.system_positioned >> r.save_position_on_close
+              >> r.x >> r.y >> r.width >> r.height >> r.monitor_index
+              >> r.refresh_rate >> r.v_sync >> r.msaa_level
+              >> r.red_bits >> r.green_bits >> r.blue_bits >> r.alpha_bits
+              >> r.depth_bits >> r.stencil_bits
+              >> r.srgb_capable >> r.use_custom_gamma >> r.custom_gamma;
+}
+
+} // namespace (anon)
+
+TEST_CASE("bengine/Stmt/Benchmark", "[hide] Reading wide rows with the per-column and typed APIs")
+{
+   const int rows = 100000;
+   const int passes = 5;
+   const char* select_sql = "SELECT * FROM t";
+
+   be::bed::Db db;
+   db.exec("CREATE TABLE t (c0, c1, c2, c3, c4, c5, c6, c7, c8, c9, c10, c11, c12, c13, c14, c15, c16, c17, c18, c19)");
+   db.begin();
+   {
+      be::bed::Stmt insert(db, "INSERT INTO t VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+      for (int i = 0; i < rows; ++i)
+      {
+         for (int c = 1; c <= 19; ++c)
+            insert.bind(c, i + c);
+         insert.bind(20, 2.2);
+         insert.step();
+         insert.reset();
+      }
+   }
+   db.commit();
+
+   be::bed::Stmt select(db, select_sql);
+   uint64_t checksum = 0;
+   uint64_t expected = 0;
+
+   bench::heading("Reading 20-column rows");
+
+   // everything except stepping, so that the row-reading cost can be seen
+   bench::Stopwatch sw;
+   for (int p = 0; p < passes; ++p)
+   {
+      while (select.step())
+         ++expected;
+      select.reset();
+   }
+   double step_seconds = sw.seconds();
+   bench::report("step() only", step_seconds, double(rows) * passes);
+
+   sw.restart();
+   for (int p = 0; p < passes; ++p)
+   {
+      while (select.step())
+      {
+         WideRow r;
+         r.mode = select.getInt(0);
+         r.system_positioned = select.getBool(1);
+         r.save_position_on_close = select.getBool(2);
+         r.x = select.getInt(3);
+         r.y = select.getInt(4);
+         r.width = select.getInt(5);
+         r.height = select.getInt(6);
+         r.monitor_index = select.getInt(7);
+         r.refresh_rate = select.getUInt(8);
+         r.v_sync = select.getInt(9);
+         r.msaa_level = select.getUInt(10);
+         r.red_bits = select.getUInt(11);
+         r.green_bits = select.getUInt(12);
+         r.blue_bits = select.getUInt(13);
+         r.alpha_bits = select.getUInt(14);
+         r.depth_bits = select.getUInt(15);
+         r.stencil_bits = select.getUInt(16);
+         r.srgb_capable = select.getBool(17);
+         r.use_custom_gamma = select.getBool(18);
+         r.custom_gamma = float(select.getDouble(19));
+         checksum += r.stencil_bits;
+      }
+      select.reset();
+   }
+   double seconds = sw.seconds();
+   bench::report("getInt() etc. per column", seconds, double(rows) * passes);
+   bench::report("  (excluding step())", seconds - step_seconds, double(rows) * passes);
+
+   uint64_t untyped_checksum = checksum;
+   checksum = 0;
+
+   sw.restart();
+   for (int p = 0; p < passes; ++p)
+   {
+      while (select.step())
+      {
+         WideRow r;
+         select.readInto(r);
+         checksum += r.stencil_bits;
+      }
+      select.reset();
+   }
+   seconds = sw.seconds();
+   bench::report("readInto() + RowReader", seconds, double(rows) * passes);
+   bench::report("  (excluding step())", seconds - step_seconds, double(rows) * passes);
+
+   REQUIRE(checksum == untyped_checksum);
+   REQUIRE(expected == uint64_t(rows) * passes);
+}
+
+TEST_CASE("bengine/Stmt/ColumnNames/Benchmark", "[hide] Reading columns by name in a row loop")
+{
+   const int rows = 100000;
+
+   be::bed::Db db;
+   db.exec("CREATE TABLE t (mode, position_x, position_y, size_x, size_y, monitor_index, refresh_rate, v_sync, custom_gamma)");
+   db.begin();
+   {
+      be::bed::Stmt insert(db, "INSERT INTO t VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)");
+      for (int i = 0; i < rows; ++i)
+      {
+         for (int c = 1; c <= 9; ++c)
+            insert.bind(c, i + c);
+         insert.step();
+         insert.reset();
+      }
+   }
+   db.commit();
+
+   be::bed::Stmt select(db, "SELECT * FROM t");
+
+   const std::string size_x("size_x");
+   const std::string size_y("size_y");
+   const std::string refresh_rate("refresh_rate");
+   const be::Id size_x_id(size_x);
+   const be::Id size_y_id(size_y);
+   const be::Id refresh_rate_id(refresh_rate);
+
+   bench::heading("Reading 3 of 9 columns by name in each row");
+
+   uint64_t expected = 0;
+   bench::Stopwatch sw;
+   while (select.step())
+      expected += select.getInt(3) + select.getInt(4) + select.getInt(6);
+   select.reset();
+   bench::report("column indices", sw.seconds(), rows);
+
+   uint64_t checksum = 0;
+   sw.restart();
+   while (select.step())
+      checksum += select.getInt(select.column(size_x)) + select.getInt(select.column(size_y)) + select.getInt(select.column(refresh_rate));
+   select.reset();
+   bench::report("column(const std::string&)", sw.seconds(), rows);
+   REQUIRE(checksum == expected);
+
+   checksum = 0;
+   sw.restart();
+   while (select.step())
+      checksum += select.getInt(select.column(size_x_id)) + select.getInt(select.column(size_y_id)) + select.getInt(select.column(refresh_rate_id));
+   select.reset();
+   bench::report("column(const Id&)", sw.seconds(), rows);
+   REQUIRE(checksum == expected);
+
+   // like a cached statement which is held, executed for one row, and reset
+   be::bed::Stmt select_one(db, "SELECT * FROM t WHERE rowid = ?");
+
+   bench::heading("Reading 3 of 9 columns by name, one row per execution");
+
+   expected = 0;
+   sw.restart();
+   for (int i = 1; i <= rows; ++i)
+   {
+      select_one.bind(1, i);
+      if (select_one.step())
+         expected += select_one.getInt(3) + select_one.getInt(4) + select_one.getInt(6);
+      select_one.reset();
+   }
+   bench::report("column indices", sw.seconds(), rows);
+
+   checksum = 0;
+   sw.restart();
+   for (int i = 1; i <= rows; ++i)
+   {
+      select_one.bind(1, i);
+      if (select_one.step())
+         checksum += select_one.getInt(select_one.column(size_x_id)) + select_one.getInt(select_one.column(size_y_id)) + select_one.getInt(select_one.column(refresh_rate_id));
+      select_one.reset();
+   }
+   bench::report("column(const Id&)", sw.seconds(), rows);
+   REQUIRE(checksum == expected);
+}
+
+#endif
@@ -0,0 +1,119 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "pbj/sw/sandwich_manifest.h"
+#include "pbj/sw/sandwich_open.h"
+#include "be/bed/stmt.h"
+#include "be/bed/db.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+#include "bench.h"
+
+#include <cstdio>
+#include <ctime>
+#include <sstream>
+#include <string>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#include <sys/utime.h>
+#define BE_BENCH_MKDIR(path) _mkdir(path)
+#define BE_BENCH_RMDIR(path) _rmdir(path)
+#define BE_BENCH_UTIME _utime
+typedef struct _utimbuf be_bench_utimbuf;
+#else
+#include <utime.h>
+#include <unistd.h>
+#define BE_BENCH_MKDIR(path) mkdir(path, 0777)
+#define BE_BENCH_RMDIR(path) rmdir(path)
+#define BE_BENCH_UTIME utime
+typedef struct utimbuf be_bench_utimbuf;
+#endif
+
+namespace {
+
+const char* bench_dir = "bench_sandwich_manifest/";
+const int sandwich_count = 300;
+
+std::string sandwichPath(int index)
+{
+   std::ostringstream oss;
+   oss << bench_dir << "sandwich" << index << ".sw";
+   return oss.str();
+}
+
+void createBenchSandwiches()
+{
+   BE_BENCH_MKDIR(bench_dir);
+
+   be_bench_utimbuf times;
+   times.actime = time(nullptr) - 10;
+   times.modtime = times.actime;
+
+   for (int i = 0; i < sandwich_count; ++i)
+   {
+      std::string path(sandwichPath(i));
+      std::remove(path.c_str());
+      {
+         be::bed::Db db(path);
+         db.exec("CREATE TABLE pbj_sandwich_properties (property TEXT PRIMARY KEY, value)");
+         db.exec("CREATE TABLE textures (id INTEGER PRIMARY KEY, data BLOB)");
+         db.exec("CREATE TABLE meshes (id INTEGER PRIMARY KEY, data BLOB)");
+         be::bed::Stmt insert(db, "INSERT INTO pbj_sandwich_properties VALUES ('id', ?)");
+         insert.bindAll(be::Id(path));
+         insert.step();
+      }
+      BE_BENCH_UTIME(path.c_str(), &times);
+   }
+}
+
+} // namespace (anon)
+
+TEST_CASE("pbj/sw/SandwichManifest/Benchmark", "[hide] Scanning a directory of sandwiches with and without a current manifest")
+{
+   createBenchSandwiches();
+
+   std::string manifest_path(std::string(bench_dir) + PBJ_SW_MANIFEST_FILENAME);
+   std::remove(manifest_path.c_str());
+
+   bench::heading("readDirectory() with 300 sandwiches");
+
+   bench::Stopwatch sw;
+   pbj::sw::readDirectory(bench_dir);
+   bench::report("cold (no manifest)", sw.seconds(), sandwich_count);
+
+   const int passes = 10;
+   sw.restart();
+   for (int p = 0; p < passes; ++p)
+      pbj::sw::readDirectory(bench_dir);
+   bench::report("warm (manifest current)", sw.seconds(), double(sandwich_count) * passes);
+
+   REQUIRE(pbj::sw::hasTable(be::Id(sandwichPath(sandwich_count - 1)), "meshes"));
+
+   for (int i = 0; i < sandwich_count; ++i)
+      std::remove(sandwichPath(i).c_str());
+   std::remove(manifest_path.c_str());
+   BE_BENCH_RMDIR(bench_dir);
+}
+
+#endif
@@ -0,0 +1,80 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "be/bed/sql_profiler.h"
+#include "be/bed/stmt_cache.h"
+#include "be/bed/db.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+#include "bench.h"
+
+#include <iostream>
+
+namespace {
+
+// Looks up single rows by rowid, the most common query in beds.
+void lookupRows(be::bed::StmtCache& cache, int operations)
+{
+   be::Id id("SqlProfiler benchmark");
+   for (int i = 0; i < operations; ++i)
+   {
+      be::bed::CachedStmt stmt = cache.hold(id, "SELECT x FROM t WHERE rowid = ?");
+      stmt.bind(1, i % 1000 + 1);
+      stmt.step();
+   }
+}
+
+} // namespace (anon)
+
+TEST_CASE("bengine/SqlProfiler/Benchmark", "[hide] Cost of profiling cached single-row lookups")
+{
+   const int operations = 200000;
+
+   be::bed::Db db;
+   db.exec("CREATE TABLE t (x INTEGER)");
+   db.begin();
+   for (int i = 0; i < 1000; ++i)
+      db.exec("INSERT INTO t VALUES (42)");
+   db.commit();
+
+   be::bed::StmtCache cache(db);
+   lookupRows(cache, 1000);
+
+   bench::heading("StmtCache hold + bind + step + release");
+
+   bench::Stopwatch sw;
+   lookupRows(cache, operations);
+   bench::report("no SqlProfiler", sw.seconds(), operations);
+
+   be::bed::SqlProfiler profiler;
+   sw.restart();
+   lookupRows(cache, operations);
+   bench::report("SqlProfiler active", sw.seconds(), operations);
+
+   std::cout << std::endl;
+   profiler.writeReport(std::cout, 5);
+   std::cout << std::endl;
+
+   REQUIRE(profiler.getStats(be::Id("SqlProfiler benchmark")).executions == operations);
+}
+
+#endif
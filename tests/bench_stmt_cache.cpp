@@ -0,0 +1,118 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "be/bed/stmt_cache.h"
+#include "be/bed/db.h"
+#include "be/id.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+#include "bench.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST_CASE("bengine/StmtCache/Benchmark", "[hide] StmtCache hold/release throughput at various capacities")
+{
+   const size_t capacities[] = { 24, 64, 256, 1024, 4096 };
+   const size_t operations = 1000000;
+
+   bench::heading("StmtCache hold + release (cache hits)");
+
+   for (size_t c = 0; c < sizeof(capacities) / sizeof(capacities[0]); ++c)
+   {
+      size_t capacity = capacities[c];
+
+      be::bed::Db db(":memory:");
+      be::bed::StmtCache cache(db, capacity);
+
+      std::vector<std::string> sql;
+      std::vector<be::Id> ids;
+      for (size_t i = 0; i < capacity; ++i)
+      {
+         std::ostringstream oss;
+         oss << "SELECT " << i;
+         sql.push_back(oss.str());
+         ids.push_back(be::Id(sql.back()));
+         cache.hold(ids.back(), sql.back());
+      }
+
+      // visit statements in a scattered order so that each one is usually
+      // released long after it was last held.
+      size_t stride = capacity / 2 + 1;
+      size_t index = 0;
+
+      bench::Stopwatch sw;
+      for (size_t i = 0; i < operations; ++i)
+      {
+         index = (index + stride) % capacity;
+         cache.hold(ids[index], sql[index]);
+      }
+      double seconds = sw.seconds();
+
+      std::ostringstream label;
+      label << "capacity " << capacity;
+      bench::report(label.str(), seconds, double(operations));
+
+      REQUIRE(cache.getSize() == capacity);
+   }
+
+   bench::heading("StmtCache hold + release (cache misses with eviction)");
+
+   for (size_t c = 0; c < sizeof(capacities) / sizeof(capacities[0]); ++c)
+   {
+      size_t capacity = capacities[c];
+      size_t misses = 20000;
+
+      be::bed::Db db(":memory:");
+      be::bed::StmtCache cache(db, capacity);
+
+      // cycling through one more statement than the cache can hold means
+      // every hold compiles a statement and every release evicts one.
+      std::vector<std::string> sql;
+      std::vector<be::Id> ids;
+      for (size_t i = 0; i <= capacity; ++i)
+      {
+         std::ostringstream oss;
+         oss << "SELECT " << i;
+         sql.push_back(oss.str());
+         ids.push_back(be::Id(sql.back()));
+         cache.hold(ids.back(), sql.back());
+      }
+
+      bench::Stopwatch sw;
+      for (size_t i = 0; i < misses; ++i)
+      {
+         size_t index = i % (capacity + 1);
+         cache.hold(ids[index], sql[index]);
+      }
+      double seconds = sw.seconds();
+
+      std::ostringstream label;
+      label << "capacity " << capacity;
+      bench::report(label.str(), seconds, double(misses));
+
+      REQUIRE(cache.getSize() == capacity);
+   }
+}
+
+#endif
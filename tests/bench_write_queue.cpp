@@ -0,0 +1,116 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "be/bed/write_queue.h"
+#include "be/bed/db.h"
+#include "be/bed/stmt.h"
+#include "be/bed/transaction.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+#include "bench.h"
+
+#include <cstdio>
+#include <string>
+
+namespace {
+
+const char* bench_path = "bench_write_queue.bed";
+const int edits = 2000;
+
+void removeBenchDb()
+{
+   std::remove(bench_path);
+   std::remove((std::string(bench_path) + "-wal").c_str());
+   std::remove((std::string(bench_path) + "-shm").c_str());
+   std::remove((std::string(bench_path) + "-journal").c_str());
+}
+
+struct Connection
+{
+   explicit Connection(const be::bed::DbConfig& config)
+      : db(bench_path, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, config)
+   {
+      db.exec("CREATE TABLE IF NOT EXISTS settings (id INTEGER PRIMARY KEY, value TEXT)");
+   }
+
+   be::bed::Db& getDb()
+   {
+      return db;
+   }
+
+   be::bed::Db db;
+};
+
+void edit(be::bed::Db& db, int i)
+{
+   be::bed::Stmt stmt(db, "INSERT OR REPLACE INTO settings (id, value) VALUES (?, 'some setting value')");
+   stmt.bind(1, i % 100);
+   stmt.step();
+}
+
+// Each edit in its own transaction on the calling thread, like the old
+// saveWindowSettings().
+double editSynchronously(const be::bed::DbConfig& config)
+{
+   removeBenchDb();
+   Connection c(config);
+
+   bench::Stopwatch sw;
+   for (int i = 0; i < edits; ++i)
+   {
+      be::bed::Transaction transaction(c.db, be::bed::Transaction::Immediate);
+      edit(c.db, i);
+      transaction.commit();
+   }
+   return sw.seconds();
+}
+
+} // namespace (anon)
+
+TEST_CASE("bengine/WriteQueue/Benchmark", "[hide] Synchronous transactions vs. group commit through a WriteQueue")
+{
+   bench::heading("Mass edits (one row each)");
+
+   bench::report("sync, default config", editSynchronously(be::bed::DbConfig()), edits);
+   bench::report("sync, DbConfig::editor()", editSynchronously(be::bed::DbConfig::editor()), edits);
+
+   removeBenchDb();
+   {
+      std::shared_ptr<Connection> connection(new Connection(be::bed::DbConfig::editor()));
+      be::bed::WriteQueue<Connection> queue(connection);
+
+      bench::Stopwatch sw;
+      for (int i = 0; i < edits; ++i)
+         queue.push([=](Connection& c) { edit(c.db, i); });
+      double push_seconds = sw.seconds();
+      queue.flush();
+      double total_seconds = sw.seconds();
+
+      bench::report("WriteQueue push (caller)", push_seconds, edits);
+      bench::report("WriteQueue push + flush", total_seconds, edits);
+
+      REQUIRE(connection->db.getInt("SELECT count(*) FROM settings", 0) == 100);
+   }
+   removeBenchDb();
+}
+
+#endif
@@ -0,0 +1,153 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "be/bed/batch_writer.h"
+#include "be/bed/db.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+
+#include <cstdio>
+#include <string>
+
+namespace {
+
+int countIndexes(be::bed::Db& db)
+{
+   return db.getInt("SELECT count(*) FROM sqlite_master WHERE type = 'index' AND sql IS NOT NULL", -1);
+}
+
+} // namespace (anon)
+
+TEST_CASE("bengine/BatchWriter/Insert", "Rows are bound and written in chunks")
+{
+   be::bed::Db db;
+   db.exec("CREATE TABLE t (i INTEGER, d REAL, s TEXT, b BLOB)");
+
+   {
+      be::bed::BatchWriter writer(db, "INSERT INTO t VALUES (?, ?, ?, ?)", 3);
+      REQUIRE(writer.getChunkSize() == 3);
+
+      for (int i = 0; i < 10; ++i)
+      {
+         std::string text(i, 'x');
+         writer << i << i * 0.5 << text;
+         writer.bindBlob(text.c_str(), i);
+         writer.next();
+      }
+
+      // 3 full chunks have been committed, so the rows in the 4th chunk are
+      // visible from this connection but haven't been committed yet.
+      REQUIRE(writer.getRowCount() == 10);
+      REQUIRE(db.getInt("SELECT count(*) FROM t", 0) == 10);
+
+      writer.insert(10, 5.0, "literal", std::string());
+      writer.insert(11, 5.5, static_cast<const char*>(nullptr), std::string("y"));
+      writer.finish();
+   }
+
+   REQUIRE(db.getInt("SELECT count(*) FROM t", 0) == 12);
+   REQUIRE(db.getInt("SELECT sum(i) FROM t", 0) == 66);
+   REQUIRE(db.getInt("SELECT count(*) FROM t WHERE length(s) = i AND typeof(s) = 'text'", 0) == 10);
+   REQUIRE(db.getInt("SELECT count(*) FROM t WHERE length(b) = i AND typeof(b) = 'blob'", 0) == 10);
+   REQUIRE(db.getInt("SELECT count(*) FROM t WHERE s = 'literal' AND s IS NOT NULL", 0) == 1);
+   REQUIRE(db.getInt("SELECT count(*) FROM t WHERE s IS NULL", 0) == 1);
+   REQUIRE(db.getInt("SELECT count(*) FROM t WHERE d * 2 = i", 0) == 12);
+}
+
+TEST_CASE("bengine/BatchWriter/Rollback", "Uncommitted rows are rolled back if finish() isn't called")
+{
+   be::bed::Db db;
+   db.exec("CREATE TABLE t (i INTEGER UNIQUE)");
+
+   {
+      be::bed::BatchWriter writer(db, "INSERT INTO t VALUES (?)", 4);
+      for (int i = 0; i < 6; ++i)
+         writer.insert(i);
+
+      // a failed row can be skipped without losing the chunk
+      REQUIRE_THROWS_AS(writer.insert(0), be::bed::Db::error);
+      writer.insert(6);
+      REQUIRE(writer.getRowCount() == 7);
+   }
+
+   REQUIRE(db.getInt("SELECT count(*) FROM t", 0) == 4);
+}
+
+TEST_CASE("bengine/BatchWriter/Indexes", "Indexes are dropped and rebuilt around the load")
+{
+   const char* path = "test_batch_writer.bed";
+   std::remove(path);
+   {
+      be::bed::Db db(path);
+      db.exec("CREATE TABLE t (id INTEGER PRIMARY KEY, name TEXT UNIQUE, size INTEGER);"
+              "CREATE INDEX t_size ON t (size);"
+              "CREATE INDEX \"t \"\"quoted\"\"\" ON t (size, name);"
+              "CREATE TABLE other (x INTEGER);"
+              "CREATE INDEX other_x ON other (x);");
+      REQUIRE(countIndexes(db) == 3);
+
+      {
+         be::bed::BatchWriter writer(db, "INSERT INTO t (name, size) VALUES (?, ?)", 100);
+         writer.dropIndexes("t");
+         REQUIRE(countIndexes(db) == 1);
+
+         for (int i = 0; i < 1000; ++i)
+            writer.insert(std::to_string(static_cast<long long>(i)), i % 7);
+
+         writer.finish();
+         REQUIRE(countIndexes(db) == 3);
+
+         // the destructor also rebuilds indexes (but rolls back the row)
+         writer.dropIndexes("t");
+         writer.insert("last", 3);
+         REQUIRE(countIndexes(db) == 1);
+      }
+
+      REQUIRE(countIndexes(db) == 3);
+      REQUIRE(db.getInt("SELECT count(*) FROM t WHERE size = 3", 0) == 143);
+      REQUIRE(db.getInt("SELECT count(*) FROM t INDEXED BY t_size WHERE size = 3", 0) == 143);
+   }
+   std::remove(path);
+}
+
+TEST_CASE("bengine/BatchWriter/UniqueIndexes", "Unique indexes are not dropped, so duplicates are still rejected during the load")
+{
+   be::bed::Db db;
+   db.exec("CREATE TABLE u (k INTEGER, v INTEGER);"
+           "CREATE UNIQUE INDEX u_k ON u (k);"
+           "CREATE INDEX u_v ON u (v);");
+   REQUIRE(countIndexes(db) == 2);
+
+   be::bed::BatchWriter writer(db, "INSERT INTO u (k, v) VALUES (?, ?)");
+   writer.dropIndexes("u");
+   REQUIRE(countIndexes(db) == 1);
+
+   writer.insert(1, 1);
+   REQUIRE_THROWS_AS(writer.insert(1, 2), be::bed::Db::error);
+   writer.insert(2, 2);
+
+   writer.finish();
+   REQUIRE(countIndexes(db) == 2);
+   REQUIRE(db.getInt("SELECT count(*) FROM u", 0) == 2);
+}
+
+#endif
@@ -0,0 +1,108 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "be/bed/blob_reader.h"
+#include "be/bed/stmt.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+
+#include <string>
+
+namespace {
+
+std::string makeData(int size, int seed)
+{
+   std::string data(size, '\0');
+   for (int i = 0; i < size; ++i)
+      data[i] = static_cast<char>((i * 31 + seed) & 0xFF);
+   return data;
+}
+
+void insertBlob(be::bed::Db& db, sqlite3_int64 rowid, const std::string& data)
+{
+   be::bed::Stmt insert(db, "INSERT INTO assets (id, data) VALUES (?, ?)");
+   insert.bind(1, rowid);
+   insert.bindBlob(2, data);
+   insert.step();
+}
+
+} // namespace (anon)
+
+TEST_CASE("bengine/BlobReader/Read", "Blobs can be read in pieces")
+{
+   be::bed::Db db(":memory:");
+   db.exec("CREATE TABLE assets (id INTEGER PRIMARY KEY, data BLOB)");
+
+   std::string data1(makeData(100000, 1));
+   std::string data2(makeData(1000, 2));
+   insertBlob(db, 1, data1);
+   insertBlob(db, 2, data2);
+
+   be::bed::BlobReader reader(db, "assets", "data", 1);
+   REQUIRE(reader.getSize() == 100000);
+   REQUIRE(reader.getPosition() == 0);
+   REQUIRE(!reader.isEof());
+
+   std::string read;
+   char buf[4096];
+   while (!reader.isEof())
+   {
+      int bytes = reader.read(buf, sizeof(buf));
+      REQUIRE(bytes > 0);
+      read.append(buf, bytes);
+   }
+   REQUIRE(read == data1);
+   REQUIRE(reader.read(buf, sizeof(buf)) == 0);
+
+   reader.seek(10);
+   REQUIRE(reader.read(buf, 5) == 5);
+   REQUIRE(std::string(buf, 5) == data1.substr(10, 5));
+
+   reader.skip(-10);
+   REQUIRE(reader.getPosition() == 5);
+   reader.skip(1000000);
+   REQUIRE(reader.isEof());
+
+   reader.reopen(2);
+   REQUIRE(reader.getSize() == 1000);
+   REQUIRE(reader.getPosition() == 0);
+   REQUIRE(reader.read(buf, sizeof(buf)) == 1000);
+   REQUIRE(std::string(buf, 1000) == data2);
+
+   REQUIRE_THROWS_AS(reader.reopen(3), be::bed::Db::error);
+   REQUIRE_THROWS_AS(be::bed::BlobReader(db, "assets", "data", 3), be::bed::Db::error);
+}
+
+TEST_CASE("bengine/BlobReader/Modified", "Reading a blob whose row has changed throws")
+{
+   be::bed::Db db(":memory:");
+   db.exec("CREATE TABLE assets (id INTEGER PRIMARY KEY, data BLOB)");
+   insertBlob(db, 1, makeData(100, 1));
+
+   be::bed::BlobReader reader(db, "assets", "data", 1);
+   db.exec("UPDATE assets SET data = x'00' WHERE id = 1");
+
+   char buf[16];
+   REQUIRE_THROWS_AS(reader.read(buf, sizeof(buf)), be::bed::Db::error);
+}
+
+#endif
@@ -0,0 +1,190 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "be/bed/connection_pool.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Connection
+{
+   Connection(int serial)
+      : serial(serial),
+        users(0)
+   {
+   }
+
+   int serial;
+   std::atomic<int> users;
+};
+
+// Opens connections numbered 1, 2, 3...  Throws instead if fail is set.
+struct ConnectionFactory
+{
+   ConnectionFactory()
+      : opened(0),
+        fail(false)
+   {
+   }
+
+   Connection* operator()()
+   {
+      if (fail)
+         throw std::runtime_error("Could not open connection!");
+
+      return new Connection(++opened);
+   }
+
+   std::atomic<int> opened;
+   std::atomic<bool> fail;
+};
+
+} // namespace (anon)
+
+TEST_CASE("bengine/ConnectionPool/Hold", "Connections are opened lazily and reused")
+{
+   ConnectionFactory factory;
+   be::bed::ConnectionPool<Connection> pool(std::ref(factory), 4);
+   REQUIRE(pool.getCapacity() == 4);
+   REQUIRE(pool.getSize() == 0);
+
+   {
+      be::bed::PooledConnection<Connection> c1 = pool.hold();
+      REQUIRE(c1->serial == 1);
+      REQUIRE(pool.getSize() == 1);
+
+      // nested holds on the same thread get the same connection
+      be::bed::PooledConnection<Connection> c2 = pool.hold();
+      REQUIRE(c2.get() == c1.get());
+
+      be::bed::PooledConnection<Connection> moved(std::move(c2));
+      REQUIRE(!c2.get());
+      REQUIRE(&*moved == c1.get());
+   }
+   REQUIRE(pool.getSize() == 1);
+
+   {
+      be::bed::PooledConnection<Connection> c = pool.hold();
+      REQUIRE(c->serial == 1);
+   }
+   REQUIRE(factory.opened.load() == 1);
+
+   // a failed open leaves the slot available
+   factory.fail = true;
+   {
+      be::bed::PooledConnection<Connection> c = pool.hold();
+      bool threw = false;
+      std::thread t([&]()
+      {
+         try
+         {
+            pool.hold();
+         }
+         catch (const std::runtime_error&)
+         {
+            threw = true;
+         }
+      });
+      t.join();
+      REQUIRE(threw);
+   }
+   factory.fail = false;
+   REQUIRE(pool.getSize() == 1);
+
+   {
+      be::bed::PooledConnection<Connection> c = pool.hold();
+      int serial = 0;
+      std::thread t([&]()
+      {
+         be::bed::PooledConnection<Connection> c2 = pool.hold();
+         serial = c2->serial;
+      });
+      t.join();
+      REQUIRE(serial == 2);
+   }
+   REQUIRE(pool.getSize() == 2);
+}
+
+TEST_CASE("bengine/ConnectionPool/Blocking", "hold() blocks when every connection is held by another thread")
+{
+   ConnectionFactory factory;
+   be::bed::ConnectionPool<Connection> pool(std::ref(factory), 1);
+
+   std::atomic<bool> acquired(false);
+   std::thread t;
+   {
+      be::bed::PooledConnection<Connection> c = pool.hold();
+
+      t = std::thread([&]()
+      {
+         be::bed::PooledConnection<Connection> c2 = pool.hold();
+         acquired = true;
+      });
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      REQUIRE(!acquired.load());
+   }
+   t.join();
+
+   REQUIRE(acquired.load());
+   REQUIRE(pool.getSize() == 1);
+}
+
+TEST_CASE("bengine/ConnectionPool/Threads", "Each connection is used by at most one thread at a time")
+{
+   ConnectionFactory factory;
+   be::bed::ConnectionPool<Connection> pool(std::ref(factory), 3);
+
+   std::atomic<int> violations(0);
+   std::vector<std::thread> threads;
+   for (int i = 0; i < 8; ++i)
+   {
+      threads.push_back(std::thread([&]()
+      {
+         for (int n = 0; n < 1000; ++n)
+         {
+            be::bed::PooledConnection<Connection> c = pool.hold();
+            if (c->users++ != 0)
+               ++violations;
+
+            std::this_thread::yield();
+            --c->users;
+         }
+      }));
+   }
+
+   for (auto i(threads.begin()), end(threads.end()); i != end; ++i)
+      i->join();
+
+   REQUIRE(violations.load() == 0);
+   REQUIRE(pool.getSize() <= 3);
+   REQUIRE(factory.opened.load() <= 3);
+}
+
+#endif
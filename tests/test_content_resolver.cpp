@@ -0,0 +1,296 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "pbj/sw/content_resolver.h"
+#include "pbj/sw/resource_cache.h"
+#include "pbj/sw/sandwich_open.h"
+#include "be/bed/cached_stmt.h"
+#include "be/bed/stmt.h"
+#include "be/bed/db.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+struct TestContentResource
+{
+   explicit TestContentResource(const std::string& text)
+      : text(text)
+   {
+   }
+
+   std::string text;
+};
+
+struct TestContentPolicy
+{
+   typedef TestContentResource resource_type;
+   typedef std::string data_type;
+
+   explicit TestContentPolicy(const be::Id& variant)
+      : finalized(std::make_shared<int>(0)),
+        variant(variant)
+   {
+   }
+
+   void read(pbj::sw::Sandwich& sandwich, const pbj::sw::ResourceId& id, data_type& data) const
+   {
+      be::bed::CachedStmt stmt(sandwich.getStmtCache().hold("SELECT data FROM test_resources WHERE id = ?"));
+      stmt.bindAll(id.resource);
+      if (!stmt.step())
+         throw std::runtime_error("Resource not found!");
+
+      data = stmt.getText(0);
+   }
+
+   void decode(const pbj::sw::ResourceId& /*id*/, data_type& /*data*/) const
+   {
+   }
+
+   TestContentResource* finalize(const pbj::sw::ResourceId& /*id*/, data_type& data) const
+   {
+      ++*finalized;
+      return new TestContentResource(data);
+   }
+
+   void measure(const TestContentResource& resource, size_t& cpu_bytes, size_t& gpu_bytes) const
+   {
+      cpu_bytes = resource.text.size();
+      gpu_bytes = 0;
+   }
+
+   be::Id getVariant() const
+   {
+      return variant;
+   }
+
+   be::Id getContentType() const
+   {
+      return be::Id("test_resources");
+   }
+
+   std::shared_ptr<int> finalized;
+   be::Id variant;
+};
+
+// Creates a sandwich containing two resources, storing their content hashes
+// the way an importer would.
+void createContentSandwich(const std::string& path, const be::Id& sandwich_id, const char* names[2], const char* data[2])
+{
+   std::remove(path.c_str());
+
+   {
+      be::bed::Db db(path);
+      db.exec("CREATE TABLE pbj_sandwich_properties (property TEXT PRIMARY KEY, value)");
+      db.exec("CREATE TABLE test_resources (id INTEGER PRIMARY KEY, data TEXT)");
+
+      be::bed::Stmt insert_property(db, "INSERT INTO pbj_sandwich_properties VALUES (?, ?)");
+      insert_property.bindAll("id", sandwich_id);
+      insert_property.step();
+   }
+
+   pbj::sw::Sandwich sandwich(path, false);
+   be::bed::Stmt insert(sandwich.getDb(), "INSERT INTO test_resources VALUES (?, ?)");
+   for (int i = 0; i < 2; ++i)
+   {
+      std::string text(data[i]);
+      insert.reset();
+      insert.bindAll(be::Id(names[i]), text);
+      insert.step();
+
+      pbj::sw::storeContentHash(sandwich, be::Id("test_resources"), be::Id(names[i]), pbj::sw::hashContent(text.data(), text.size()));
+   }
+}
+
+} // namespace (anon)
+
+TEST_CASE("pbj/sw/ContentResolver", "Resources with identical data in different sandwiches are only loaded once")
+{
+   const std::string manifest_path("be_test_content.manifest");
+   const std::string path_a("be_test_content_a.sw");
+   const std::string path_b("be_test_content_b.sw");
+   const be::Id sandwich_a("be_test_content_a");
+   const be::Id sandwich_b("be_test_content_b");
+   std::remove(manifest_path.c_str());
+
+   const char* names_a[] = { "atlas", "font" };
+   const char* data_a[] = { "shared ui atlas", "font a" };
+   const char* names_b[] = { "ui_atlas", "font" };
+   const char* data_b[] = { "shared ui atlas", "font b" };
+   createContentSandwich(path_a, sandwich_a, names_a, data_a);
+   createContentSandwich(path_b, sandwich_b, names_b, data_b);
+
+   pbj::sw::readDirectory("./", manifest_path);
+
+   pbj::sw::ResourceId atlas_a(sandwich_a, be::Id("atlas"));
+   pbj::sw::ResourceId atlas_b(sandwich_b, be::Id("ui_atlas"));
+   pbj::sw::ResourceId font_a(sandwich_a, be::Id("font"));
+   pbj::sw::ResourceId font_b(sandwich_b, be::Id("font"));
+
+   SECTION("hash", "Content hashes depend only on the data")
+   {
+      std::string a("shared ui atlas");
+      std::string b("shared ui atlas");
+      std::string c("shared ui atlaz");
+      REQUIRE(pbj::sw::hashContent(a.data(), a.size()) == pbj::sw::hashContent(b.data(), b.size()));
+      REQUIRE(pbj::sw::hashContent(a.data(), a.size()) != pbj::sw::hashContent(c.data(), c.size()));
+      REQUIRE(pbj::sw::hashContent(a.data(), a.size()) != pbj::sw::hashContent(a.data(), a.size() - 1));
+   }
+
+   SECTION("resolve", "Identical data resolves to the first ResourceId seen with it")
+   {
+      be::Id type("test_resources");
+      be::Id variant("linear");
+
+      pbj::sw::ContentResolver resolver;
+      REQUIRE(resolver.resolve(atlas_a, type, variant) == atlas_a);
+      REQUIRE(resolver.resolve(atlas_b, type, variant) == atlas_a);
+      REQUIRE(resolver.resolve(font_a, type, variant) == font_a);
+      REQUIRE(resolver.resolve(font_b, type, variant) == font_b);
+      REQUIRE(resolver.getHashCount() == 4);
+
+      pbj::sw::ResourceId unknown(be::Id("be_test_content_missing"), be::Id("atlas"));
+      REQUIRE(resolver.resolve(unknown, type, variant) == unknown);
+
+      resolver.clear();
+      REQUIRE(resolver.getHashCount() == 0);
+      REQUIRE(resolver.resolve(atlas_b, type, variant) == atlas_b);
+      REQUIRE(resolver.resolve(atlas_a, type, variant) == atlas_b);
+   }
+
+   SECTION("variants", "Identical data is not shared between different types or load settings")
+   {
+      be::Id type("test_resources");
+      be::Id linear("linear");
+      be::Id nearest("nearest");
+
+      // the other type's resources share the test resources' Ids
+      const be::Id other("other_resources");
+      std::string other_data("font b");
+      {
+         pbj::sw::Sandwich sandwich(path_a, false);
+         pbj::sw::storeContentHash(sandwich, other, be::Id("atlas"), pbj::sw::hashContent(other_data.data(), other_data.size()));
+      }
+      {
+         pbj::sw::Sandwich sandwich(path_b, false);
+         pbj::sw::storeContentHash(sandwich, other, be::Id("ui_atlas"), pbj::sw::hashContent(other_data.data(), other_data.size()));
+      }
+
+      pbj::sw::ContentResolver resolver;
+      REQUIRE(resolver.resolve(atlas_a, type, linear) == atlas_a);
+      REQUIRE(resolver.resolve(atlas_b, type, nearest) == atlas_b);
+      REQUIRE(resolver.resolve(atlas_b, other, linear) == atlas_b);
+      REQUIRE(resolver.resolve(atlas_a, type, nearest) == atlas_b);
+      REQUIRE(resolver.resolve(atlas_b, type, linear) == atlas_a);
+      REQUIRE(resolver.resolve(atlas_a, other, linear) == atlas_b);
+      REQUIRE(resolver.resolve(font_b, other, linear) == font_b);
+      REQUIRE(resolver.getHashCount() == 6);
+   }
+
+   SECTION("cache", "A ResourceCache with a resolver shares resources with identical data")
+   {
+      pbj::sw::ContentResolver resolver;
+      pbj::sw::ResourceLoader loader(1, 1);
+      pbj::sw::ResourceCache cache(loader, 1000, 1000);
+      cache.setResolver(&resolver);
+      TestContentPolicy policy(be::Id("linear"));
+      const pbj::sw::ResourceCacheStats& stats = cache.getStats();
+
+      pbj::sw::CachedResource<TestContentResource> a = cache.hold(atlas_a, 0, policy);
+      pbj::sw::CachedResource<TestContentResource> b = cache.hold(atlas_b, 0, policy);
+      pbj::sw::CachedResource<TestContentResource> c = cache.hold(font_a, 0, policy);
+      pbj::sw::CachedResource<TestContentResource> d = cache.hold(font_b, 0, policy);
+      REQUIRE(stats.misses == 3);
+      REQUIRE(stats.hits == 1);
+      REQUIRE(stats.deduplicated == 1);
+
+      loader.flush();
+      cache.update();
+
+      REQUIRE(*policy.finalized == 3);
+      REQUIRE(stats.resident == 3);
+      REQUIRE(stats.cpu_bytes == 27);
+
+      bool same_resource = a.get() == b.get() && a.get() != 0;
+      REQUIRE(same_resource);
+      REQUIRE(b->text == "shared ui atlas");
+      REQUIRE(c->text == "font a");
+      REQUIRE(d->text == "font b");
+
+      // different settings load their own copy
+      TestContentPolicy nearest(be::Id("nearest"));
+      pbj::sw::CachedResource<TestContentResource> e = cache.hold(atlas_b, 0, nearest);
+      REQUIRE(stats.misses == 4);
+      REQUIRE(stats.deduplicated == 1);
+
+      loader.flush();
+      cache.update();
+      REQUIRE(*nearest.finalized == 1);
+      bool separate_resource = e.get() != a.get() && e.get() != 0;
+      REQUIRE(separate_resource);
+
+      a.release();
+      b.release();
+      c.release();
+      d.release();
+      e.release();
+   }
+
+   SECTION("cache variants", "Resources resolved to a ResourceId cached with another variant are not shared")
+   {
+      pbj::sw::ContentResolver resolver;
+      pbj::sw::ResourceLoader loader(1, 1);
+      pbj::sw::ResourceCache cache(loader, 1000, 1000);
+      cache.setResolver(&resolver);
+      TestContentPolicy nearest(be::Id("nearest"));
+      TestContentPolicy linear(be::Id("linear"));
+
+      pbj::sw::CachedResource<TestContentResource> x = cache.hold(atlas_a, 0, nearest);
+      pbj::sw::CachedResource<TestContentResource> y = cache.hold(atlas_a, 0, linear);
+      pbj::sw::CachedResource<TestContentResource> z = cache.hold(atlas_b, 0, linear);
+
+      loader.flush();
+      cache.update();
+
+      // atlas_b resolves to atlas_a, but only the linear copy may be shared
+      REQUIRE(*nearest.finalized == 1);
+      REQUIRE(*linear.finalized == 1);
+      bool separate_resource = x.get() != y.get() && x.get() != 0;
+      REQUIRE(separate_resource);
+      bool same_resource = z.get() == y.get() && z.get() != 0;
+      REQUIRE(same_resource);
+
+      x.release();
+      y.release();
+      z.release();
+   }
+
+   std::remove(path_a.c_str());
+   std::remove(path_b.c_str());
+   std::remove(manifest_path.c_str());
+}
+
+#endif
@@ -0,0 +1,162 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "be/bed/db.h"
+#include "be/bed/stmt.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+
+#include <cstdio>
+#include <string>
+
+namespace {
+
+const char* test_path = "test_db_config.bed";
+
+void removeTestDb()
+{
+   std::remove(test_path);
+   std::remove((std::string(test_path) + "-wal").c_str());
+   std::remove((std::string(test_path) + "-shm").c_str());
+   std::remove((std::string(test_path) + "-journal").c_str());
+}
+
+std::string getText(be::bed::Db& db, const std::string& sql)
+{
+   be::bed::Stmt stmt(db, be::Id(), sql);
+   if (stmt.step())
+      return stmt.getText(0);
+
+   return std::string();
+}
+
+// Opens a writer with the provided configuration and a reader with
+// DbConfig::readOnly(), then tries to commit a write while the reader is in
+// the middle of a query.
+bool commitWhileReading(const be::bed::DbConfig& writer_config)
+{
+   removeTestDb();
+
+   bool committed = false;
+   {
+      be::bed::Db writer(test_path, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, writer_config);
+      writer.exec("CREATE TABLE t (x INTEGER); INSERT INTO t VALUES (1); INSERT INTO t VALUES (2);");
+
+      be::bed::DbConfig reader_config(be::bed::DbConfig::readOnly());
+      reader_config.busy_timeout = 0;
+      be::bed::Db reader(test_path, SQLITE_OPEN_READONLY, reader_config);
+
+      be::bed::Stmt read(reader, be::Id(), "SELECT x FROM t");
+      read.step();
+
+      // don't wait for the reader to finish
+      writer.exec("PRAGMA busy_timeout = 0");
+      try
+      {
+         writer.exec("BEGIN; INSERT INTO t VALUES (3); COMMIT;");
+         committed = true;
+      }
+      catch (const be::bed::Db::error&)
+      {
+         writer.exec("ROLLBACK");
+      }
+
+      read.reset();
+   }
+
+   removeTestDb();
+   return committed;
+}
+
+} // namespace (anon)
+
+TEST_CASE("bengine/DbConfig/Pragmas", "DbConfig settings are applied when a Db is opened")
+{
+   removeTestDb();
+   {
+      be::bed::Db db(test_path, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, be::bed::DbConfig());
+      REQUIRE(getText(db, "PRAGMA journal_mode") == "delete");
+   }
+   {
+      // writable() must not change the journal mode stored in the file.
+      be::bed::Db db(test_path, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, be::bed::DbConfig::writable());
+      REQUIRE(getText(db, "PRAGMA journal_mode") == "delete");
+      REQUIRE(db.getInt("PRAGMA temp_store", -1) == 2);
+   }
+   {
+      be::bed::Db db(test_path, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, be::bed::DbConfig::editor());
+      REQUIRE(getText(db, "PRAGMA journal_mode") == "wal");
+      REQUIRE(db.getInt("PRAGMA synchronous", -1) == 1);
+      REQUIRE(db.getInt("PRAGMA temp_store", -1) == 2);
+      REQUIRE(db.getInt("PRAGMA cache_size", 0) == -16 * 1024);
+   }
+   {
+      // WAL is persistent, so read-only connections use it too.
+      be::bed::Db db(test_path, SQLITE_OPEN_READONLY, be::bed::DbConfig::readOnly());
+      REQUIRE(getText(db, "PRAGMA journal_mode") == "wal");
+      REQUIRE(db.getInt("PRAGMA temp_store", -1) == 2);
+   }
+   removeTestDb();
+}
+
+TEST_CASE("bengine/DbConfig/Wal", "Readers don't block the writer in WAL mode")
+{
+   be::bed::DbConfig rollback_config;
+   rollback_config.journal_mode = be::bed::DbConfig::JournalDelete;
+   REQUIRE(!commitWhileReading(rollback_config));
+
+   REQUIRE(commitWhileReading(be::bed::DbConfig::editor()));
+}
+
+TEST_CASE("bengine/DbConfig/Locked", "A writable Db can still be opened if the journal mode can't be changed")
+{
+   removeTestDb();
+   {
+      be::bed::Db db(test_path, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, be::bed::DbConfig());
+      db.exec("CREATE TABLE t (x INTEGER); INSERT INTO t VALUES (1); INSERT INTO t VALUES (2);");
+   }
+   {
+      be::bed::Db reader(test_path, SQLITE_OPEN_READONLY, be::bed::DbConfig());
+      be::bed::Stmt read(reader, be::Id(), "SELECT x FROM t");
+      read.step();
+
+      be::bed::DbConfig config(be::bed::DbConfig::editor());
+      config.busy_timeout = 0;
+
+      bool opened = false;
+      try
+      {
+         be::bed::Db writer(test_path, SQLITE_OPEN_READWRITE, config);
+         opened = true;
+         REQUIRE(getText(writer, "PRAGMA journal_mode") == "delete");
+      }
+      catch (const be::bed::Db::error&)
+      {
+      }
+      REQUIRE(opened);
+
+      read.reset();
+   }
+   removeTestDb();
+}
+
+#endif
@@ -0,0 +1,173 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "be/source_handle.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct HandleTestObject
+{
+   HandleTestObject(int value)
+      : value(value)
+   {
+      handle.associate(this);
+   }
+
+   be::SourceHandle<HandleTestObject> handle;
+   int value;
+};
+
+} // namespace (anon)
+
+TEST_CASE("bengine/Handle", "Handles resolve to their target until the SourceHandle is destroyed")
+{
+   size_t count = be::getHandledObjectCount<HandleTestObject>();
+
+   be::Handle<HandleTestObject> empty;
+   REQUIRE(!empty);
+   REQUIRE(!empty.get());
+
+   be::Handle<HandleTestObject> stale;
+   {
+      HandleTestObject obj(1);
+      stale = obj.handle;
+      be::ConstHandle<HandleTestObject> chandle(obj.handle);
+
+      REQUIRE(be::getHandledObjectCount<HandleTestObject>() == count + 1);
+      REQUIRE(stale);
+      REQUIRE(stale.get() == &obj);
+      REQUIRE(chandle->value == 1);
+      REQUIRE(chandle == stale);
+   }
+   REQUIRE(be::getHandledObjectCount<HandleTestObject>() == count);
+   REQUIRE(!stale);
+   REQUIRE(!stale.get());
+
+   // the freed index is reused with a new check value
+   HandleTestObject obj2(2);
+   REQUIRE(!stale.get());
+   REQUIRE(be::Handle<HandleTestObject>(obj2.handle).get() == &obj2);
+}
+
+TEST_CASE("bengine/Handle/Resolve", "Batch resolution matches get() for valid, stale, and null handles")
+{
+   std::vector<HandleTestObject*> objects;
+   for (int i = 0; i < 100; ++i)
+      objects.push_back(new HandleTestObject(i));
+
+   std::vector<be::Handle<HandleTestObject> > handles;
+   for (size_t i = 0; i < objects.size(); ++i)
+   {
+      handles.push_back(objects[i]->handle);
+      if (i % 7 == 0)
+         handles.push_back(be::Handle<HandleTestObject>());
+   }
+
+   for (size_t i = 0; i < objects.size(); i += 3)
+   {
+      delete objects[i];
+      objects[i] = nullptr;
+   }
+
+   std::vector<HandleTestObject*> out(handles.size(), nullptr);
+   be::Handle<HandleTestObject>::resolve(handles.data(), handles.size(), out.data());
+
+   std::vector<const HandleTestObject*> const_out(handles.size(), nullptr);
+   std::vector<be::ConstHandle<HandleTestObject> > const_handles(handles.begin(), handles.end());
+   be::ConstHandle<HandleTestObject>::resolve(const_handles.data(), const_handles.size(), const_out.data());
+
+   for (size_t i = 0; i < handles.size(); ++i)
+   {
+      REQUIRE(out[i] == handles[i].get());
+      REQUIRE(const_out[i] == handles[i].get());
+   }
+
+   for (size_t i = 0; i < objects.size(); ++i)
+      delete objects[i];
+}
+
+TEST_CASE("bengine/Handle/Concurrent", "Handles can be created, resolved, and destroyed from many threads")
+{
+   const int thread_count = 8;
+   const int iterations = 20000;
+   const int live_count = 16;
+
+   size_t count = be::getHandledObjectCount<HandleTestObject>();
+   std::atomic<int> failures(0);
+   std::vector<std::vector<be::Handle<HandleTestObject> > > dead(thread_count);
+   std::vector<std::thread> threads;
+
+   for (int t = 0; t < thread_count; ++t)
+   {
+      threads.push_back(std::thread([&failures, &dead, t, iterations, live_count]()
+      {
+         std::vector<HandleTestObject*> live(live_count, nullptr);
+         std::vector<be::Handle<HandleTestObject> >& my_dead = dead[t];
+
+         for (int i = 0; i < iterations; ++i)
+         {
+            int slot = i % live_count;
+            if (live[slot])
+            {
+               be::Handle<HandleTestObject> h(live[slot]->handle);
+               if (h.get() != live[slot] || h->value != i - live_count)
+                  ++failures;
+
+               delete live[slot];
+               if (h.get() != nullptr)
+                  ++failures;
+
+               if (i % 64 == 0)
+                  my_dead.push_back(h);
+            }
+            live[slot] = new HandleTestObject(i);
+
+            // stale handles must never resolve, even after their index is reused.
+            if (i % 256 == 0)
+               for (auto it(my_dead.begin()), end(my_dead.end()); it != end; ++it)
+                  if (*it)
+                     ++failures;
+         }
+
+         for (int slot = 0; slot < live_count; ++slot)
+            delete live[slot];
+      }));
+   }
+
+   for (auto it(threads.begin()), end(threads.end()); it != end; ++it)
+      it->join();
+
+   REQUIRE(failures.load() == 0);
+   REQUIRE(be::getHandledObjectCount<HandleTestObject>() == count);
+
+   for (int t = 0; t < thread_count; ++t)
+      for (auto it(dead[t].begin()), end(dead[t].end()); it != end; ++it)
+         REQUIRE(!it->get());
+}
+
+#endif
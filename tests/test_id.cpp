@@ -81,6 +81,42 @@ TEST_CASE("bengine/Id", "Provides hashed string identifiers")
    REQUIRE(be::Id("bsc::Scene").value()     == 0xb9984bd1f4c69801);
 }
 
+TEST_CASE("bengine/Id/Literals", "Ids hashed from string literals match runtime hashes")
+{
+   REQUIRE(be::detail::fnv1a("") == BE_ID_FNV_OFFSET_BASIS);
+   REQUIRE(be::detail::fnv1aIterative("") == BE_ID_FNV_OFFSET_BASIS);
+   REQUIRE(be::detail::fnv1aIterative("Component") == be::detail::fnv1a("Component"));
+   REQUIRE(be::Id("").value() == 0xCBF29CE484222325);
+
+   REQUIRE(be::Id("Component") == be::Id(std::string("Component")));
+   REQUIRE(be::Id("bsc::Transform") == be::Id(std::string("bsc::Transform")));
+   REQUIRE(be::Id("ShaderProgram.TextureFontText") == be::Id(std::string("ShaderProgram.TextureFontText")));
+   REQUIRE(be::Id("Shader.TextureFontText.vertex").value() == 0xfe3e48aca5df71cd);
+
+   const char* name = "Shader.TextureFontText.fragment";
+   REQUIRE(be::Id("Shader.TextureFontText.fragment") == be::Id(name));
+   REQUIRE(be::Id("Shader.TextureFontText.fragment").value() == 0x831362c81badc58b);
+
+#ifdef BE_ID_NAMES_ENABLED
+   REQUIRE(be::Id("literal name").to_string() == be::Id(std::string("literal name")).to_string());
+   REQUIRE(be::Id(be::Id("literal name").value()).to_string().substr(17) == ":literal name");
+#endif
+
+#ifdef BE_CONSTEXPR_ENABLED
+   static_assert(be::detail::fnv1a("Component") == 0xa6d4361f17423080, "constexpr FNV-1a does not match runtime hash");
+   static_assert(be::detail::fnv1a("bsc::Scene") == 0xb9984bd1f4c69801, "constexpr FNV-1a does not match runtime hash");
+
+   using namespace be::literals;
+   REQUIRE("bsc::Camera"_id == be::Id(0x12b535f385b85c44));
+   REQUIRE("ShaderProgram.TextureFontText"_id == be::Id(std::string("ShaderProgram.TextureFontText")));
+#endif
+
+#ifdef BE_ID_CONSTEXPR_ENABLED
+   static_assert(be::Id("ShaderProgram.TextureFontText").value() == 0x7cb1e15a4d37d89b, "constexpr Id does not match runtime hash");
+   static_assert("Shader.TextureFontText.vertex"_id == be::Id(0xfe3e48aca5df71cd), "constexpr Id does not match runtime hash");
+#endif
+}
+
 TEST_CASE("bengine/Id/Comparisons", "Comparison based on numerical value of hash")
 {
    REQUIRE(  be::Id(0) == be::Id(0));
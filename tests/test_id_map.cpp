@@ -0,0 +1,141 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "be/id_map.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+
+#include <memory>
+#include <set>
+#include <sstream>
+
+TEST_CASE("bengine/IdMap", "Flat hash map keyed by Id")
+{
+   be::IdMap<int> map;
+   REQUIRE(map.empty());
+   REQUIRE(map.size() == 0);
+   REQUIRE(map.begin() == map.end());
+   REQUIRE(map.find(be::Id("missing")) == map.end());
+   REQUIRE(map.erase(be::Id("missing")) == 0);
+
+   auto result = map.insert(std::make_pair(be::Id("one"), 1));
+   REQUIRE(result.second);
+   REQUIRE(result.first->first == be::Id("one"));
+   REQUIRE(result.first->second == 1);
+
+   result = map.insert(std::make_pair(be::Id("one"), 2));
+   REQUIRE(!result.second);
+   REQUIRE(result.first->second == 1);
+
+   map[be::Id("two")] = 2;
+   REQUIRE(map.size() == 2);
+   REQUIRE(map.count(be::Id("two")) == 1);
+   REQUIRE(map[be::Id("two")] == 2);
+   REQUIRE(map[be::Id("three")] == 0);
+   REQUIRE(map.size() == 3);
+
+   REQUIRE(map.erase(be::Id("three")) == 1);
+   REQUIRE(map.count(be::Id("three")) == 0);
+   REQUIRE(map.size() == 2);
+
+   map.clear();
+   REQUIRE(map.empty());
+   REQUIRE(map.begin() == map.end());
+}
+
+TEST_CASE("bengine/IdMap/Growth", "IdMap keeps all values while growing and erasing")
+{
+   be::IdMap<uint64_t> map;
+   const uint64_t count = 10000;
+
+   // small sequential values have identical high bits, which is the worst
+   // case for the control bytes.
+   for (uint64_t i = 0; i < count; ++i)
+      REQUIRE(map.insert(std::make_pair(be::Id(i), i)).second);
+
+   REQUIRE(map.size() == count);
+   REQUIRE((map.capacity() - map.capacity() / 8 >= count));
+
+   for (uint64_t i = 0; i < count; i += 2)
+      REQUIRE(map.erase(be::Id(i)) == 1);
+
+   REQUIRE(map.size() == count / 2);
+
+   for (uint64_t i = 0; i < count; ++i)
+   {
+      auto it = map.find(be::Id(i));
+      if (i % 2 == 0)
+         REQUIRE(it == map.end());
+      else
+         REQUIRE((it != map.end() && it->second == i));
+   }
+
+   // reinserting reuses tombstones rather than growing forever
+   size_t capacity = map.capacity();
+   for (int pass = 0; pass < 8; ++pass)
+   {
+      for (uint64_t i = 0; i < count; i += 2)
+         map[be::Id(i)] = i;
+      for (uint64_t i = 0; i < count; i += 2)
+         map.erase(be::Id(i));
+   }
+   REQUIRE(map.capacity() == capacity);
+
+   std::set<uint64_t> seen;
+   for (auto i(map.begin()), end(map.end()); i != end; ++i)
+   {
+      REQUIRE(i->first.value() == i->second);
+      seen.insert(i->second);
+   }
+   REQUIRE(seen.size() == count / 2);
+
+   for (auto i(map.begin()); i != map.end(); )
+      i = map.erase(i);
+   REQUIRE(map.empty());
+}
+
+TEST_CASE("bengine/IdMap/MoveOnly", "IdMap supports move-only values")
+{
+   be::IdMap<std::unique_ptr<std::string> > map;
+
+   for (int i = 0; i < 100; ++i)
+   {
+      std::ostringstream oss;
+      oss << "value" << i;
+      map.insert(std::make_pair(be::Id(oss.str()), std::unique_ptr<std::string>(new std::string(oss.str()))));
+   }
+
+   auto it = map.find(be::Id("value42"));
+   REQUIRE(it != map.end());
+   REQUIRE(*it->second == "value42");
+
+   be::IdMap<std::unique_ptr<std::string> > moved(std::move(map));
+   REQUIRE(map.empty());
+   REQUIRE(moved.size() == 100);
+
+   const be::IdMap<std::unique_ptr<std::string> >& cmoved = moved;
+   be::IdMap<std::unique_ptr<std::string> >::const_iterator cit = cmoved.find(be::Id("value7"));
+   REQUIRE(cit != cmoved.end());
+   REQUIRE(*cit->second == "value7");
+}
+
+#endif
@@ -0,0 +1,288 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "be/async_log.h"
+#include "be/log_reader.h"
+#include "be/id.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Redirects BE_LOG_STREAM and enables all messages for the lifetime of the
+// object.
+class CaptureLog
+{
+public:
+   CaptureLog()
+      : old_buf_(BE_LOG_STREAM.rdbuf(out_.rdbuf())),
+        old_verbosity_(be::getVerbosity())
+   {
+      be::setVerbosity(be::VAll);
+   }
+
+   ~CaptureLog()
+   {
+      be::flushLog();
+      BE_LOG_STREAM.rdbuf(old_buf_);
+      be::setVerbosity(old_verbosity_);
+   }
+
+   std::string text()
+   {
+      be::flushLog();
+      return out_.str();
+   }
+
+   std::vector<std::string> lines()
+   {
+      be::flushLog();
+      std::vector<std::string> result;
+      std::istringstream iss(out_.str());
+      std::string line;
+      while (std::getline(iss, line))
+         result.push_back(line);
+      return result;
+   }
+
+private:
+   std::ostringstream out_;
+   std::streambuf* old_buf_;
+   int old_verbosity_;
+};
+
+bool endsWith(const std::string& str, const std::string& suffix)
+{
+   return str.length() >= suffix.length() &&
+      str.compare(str.length() - suffix.length(), suffix.length(), suffix) == 0;
+}
+
+// Logs the same messages regardless of format, so that text and binary
+// logs can be compared.
+void logSamples()
+{
+   BE_LOG(be::VWarning) << "ints " << -42 << ' ' << 42u << ' ' << 1234567890123LL << BE_LOG_END;
+   BE_LOG(be::VWarning) << "floats " << 0.1f << ' ' << 3.14159265 << ' ' << 1e100 << BE_LOG_END;
+   BE_LOG(be::VWarning) << "bools " << true << false << " chars " << 'x' << BE_LOG_NL << std::string("next line") << BE_LOG_END;
+   BE_LOG(be::VWarning) << "id " << be::Id("log sample") << " flags " << std::hex << 255 << std::setw(6) << "right" << BE_LOG_END;
+   BE_LOG(be::VWarning) << "defaults restored " << 255 << std::endl;
+   BE_LOG(be::VWarning) << "ints " << -42 << ' ' << 42u << ' ' << 1234567890123LL << BE_LOG_END;
+}
+
+// Removes the timestamp from each line of a log.
+std::string stripTimes(const std::string& log)
+{
+   std::istringstream iss(log);
+   std::string result;
+   std::string line;
+   while (std::getline(iss, line))
+   {
+      result.append(line.size() > 20 && line[0] != ' ' ? line.substr(20) : line);
+      result.push_back('\n');
+   }
+   return result;
+}
+
+} // namespace (anon)
+
+TEST_CASE("bengine/Log/Sync", "Without an AsyncLog, messages are written immediately")
+{
+   CaptureLog capture;
+
+   BE_LOG(be::VWarning) << "first " << 1 << BE_LOG_NL << "second" << BE_LOG_END;
+   BE_LOG(be::VWarning) << "no end";
+
+   std::vector<std::string> lines = capture.lines();
+   REQUIRE(lines.size() == 3);
+   REQUIRE(endsWith(lines[0], "Warning: first 1"));
+   REQUIRE(lines[0].find("test_log.cpp(") != std::string::npos);
+   REQUIRE(lines[1] == "                       second");
+   REQUIRE(endsWith(lines[2], "Warning: no end"));
+}
+
+TEST_CASE("bengine/Log/Async", "Messages from many threads are all written by the AsyncLog writer")
+{
+   const int thread_count = 4;
+   const int messages = 100;   // fewer than the per-thread buffer capacity, so none are dropped
+
+   CaptureLog capture;
+   {
+      be::AsyncLog async_log;
+
+      std::vector<std::thread> threads;
+      for (int t = 0; t < thread_count; ++t)
+      {
+         threads.push_back(std::thread([=]() {
+            for (int i = 0; i < messages; ++i)
+               BE_LOG(be::VWarning) << "thread " << t << " message " << i << BE_LOG_END;
+         }));
+      }
+
+      for (auto it(threads.begin()), end(threads.end()); it != end; ++it)
+         it->join();
+   }
+
+   std::vector<std::string> lines = capture.lines();
+   REQUIRE(lines.size() == thread_count * messages);
+
+   // messages from each thread stay in order
+   std::vector<int> next(thread_count, 0);
+   for (auto it(lines.begin()), end(lines.end()); it != end; ++it)
+   {
+      size_t pos = it->find("Warning: thread ");
+      REQUIRE(pos != std::string::npos);
+
+      int t, i;
+      std::string word;
+      std::istringstream iss(it->substr(pos + 16));
+      iss >> t >> word >> i;
+      REQUIRE(i == next[t]);
+      ++next[t];
+   }
+}
+
+TEST_CASE("bengine/Log/ThreadExit", "Messages from threads which exit before they are written are not lost")
+{
+   const int thread_count = 8;
+   const int messages = 10;
+
+   CaptureLog capture;
+   {
+      be::AsyncLog async_log;
+
+      // each thread exits (releasing its buffer for the next one to reuse)
+      // before the writer is likely to have drained it.
+      for (int t = 0; t < thread_count; ++t)
+      {
+         std::thread thread([=]() {
+            for (int i = 0; i < messages; ++i)
+               BE_LOG(be::VWarning) << "thread " << t << " message " << i << BE_LOG_END;
+         });
+         thread.join();
+      }
+   }
+
+   std::vector<std::string> lines = capture.lines();
+   REQUIRE(lines.size() == thread_count * messages);
+}
+
+TEST_CASE("bengine/Log/Drop", "Full buffers drop non-error messages and report how many were dropped")
+{
+   const int messages = 100000;
+
+   CaptureLog capture;
+   {
+      be::AsyncLog async_log;
+
+      for (int i = 0; i < messages; ++i)
+         BE_LOG(be::VWarning) << "flood " << i << BE_LOG_END;
+
+      BE_LOG(be::VError) << "error after flood" << BE_LOG_END;
+   }
+
+   std::vector<std::string> lines = capture.lines();
+   REQUIRE(!lines.empty());
+
+   size_t written = 0;
+   size_t dropped = 0;
+   bool error_written = false;
+   for (auto it(lines.begin()), end(lines.end()); it != end; ++it)
+   {
+      if (it->find("Warning: flood ") != std::string::npos)
+         ++written;
+      else if (endsWith(*it, "Error: error after flood"))
+         error_written = true;
+      else
+      {
+         size_t pos = it->find("Warning: ");
+         REQUIRE(pos != std::string::npos);
+         size_t count = 0;
+         std::istringstream(it->substr(pos + 9)) >> count;
+         dropped += count;
+      }
+   }
+
+   REQUIRE(error_written);
+   REQUIRE((written + dropped == messages));
+}
+
+TEST_CASE("bengine/Log/Binary", "Binary logs are decoded to the same text as text logs")
+{
+   std::string text_log;
+   {
+      CaptureLog capture;
+      be::AsyncLog async_log(be::AsyncLog::Text);
+      logSamples();
+      be::flushLog();
+      text_log = capture.text();
+   }
+
+   std::string binary_log;
+   {
+      CaptureLog capture;
+      be::AsyncLog async_log(be::AsyncLog::Binary);
+      logSamples();
+      be::flushLog();
+      binary_log = capture.text();
+   }
+
+   REQUIRE(binary_log.compare(0, 5, "BELOG") == 0);
+
+   std::istringstream iss(binary_log);
+   be::LogReader reader(iss);
+   std::string decoded;
+   std::string message;
+   while (reader.read(message))
+      decoded.append(message);
+
+   REQUIRE(stripTimes(decoded) == stripTimes(text_log));
+   REQUIRE(decoded.find("Warning: floats 0.1 3.14159 1e+100") != std::string::npos);
+   REQUIRE(decoded.find("Warning: defaults restored 255") != std::string::npos);
+
+   // the repeated string literal and file name are only stored once
+   size_t first = binary_log.find("ints ");
+   REQUIRE(first != std::string::npos);
+   REQUIRE(binary_log.find("ints ", first + 1) == std::string::npos);
+
+   // a truncated log ends at the last complete message
+   std::istringstream truncated(binary_log.substr(0, binary_log.size() - 3));
+   be::LogReader truncated_reader(truncated);
+   size_t count = 0;
+   while (truncated_reader.read(message))
+      ++count;
+   REQUIRE(count == 5);
+}
+
+TEST_CASE("bengine/Log/Binary/BadHeader", "LogReader rejects streams that aren't binary logs")
+{
+   std::istringstream iss("2013-01-01 00:00:00 not a binary log\n");
+   REQUIRE_THROWS_AS(be::LogReader reader(iss), std::runtime_error);
+}
+
+#endif
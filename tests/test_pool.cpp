@@ -0,0 +1,150 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "be/pool.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+int live_pool_objects = 0;
+
+class PoolTestObject
+{
+public:
+   PoolTestObject(int value, const std::string& name)
+      : value(value),
+        name(name)
+   {
+      if (value < 0)
+         throw std::invalid_argument("negative value");
+
+      handle_.associate(this);
+      ++live_pool_objects;
+   }
+
+   ~PoolTestObject()
+   {
+      --live_pool_objects;
+   }
+
+   be::Handle<PoolTestObject> getHandle()
+   {
+      return handle_;
+   }
+
+   int value;
+   std::string name;
+
+private:
+   be::SourceHandle<PoolTestObject> handle_;
+};
+
+} // namespace (anon)
+
+TEST_CASE("bengine/Pool", "Pools construct objects in place and hand out handles to them")
+{
+   {
+      be::Pool<PoolTestObject> pool;
+      REQUIRE(pool.size() == 0);
+      REQUIRE(pool.capacity() == 0);
+
+      std::vector<be::Handle<PoolTestObject> > handles;
+      for (int i = 0; i < 200; ++i)
+         handles.push_back(pool.create(i, std::string("object")));
+
+      REQUIRE(pool.size() == 200);
+      REQUIRE(live_pool_objects == 200);
+      REQUIRE(pool.capacity() >= 200);
+
+      for (int i = 0; i < 200; ++i)
+      {
+         REQUIRE(handles[i]);
+         REQUIRE(handles[i]->value == i);
+      }
+
+      // objects in the same chunk are contiguous
+      REQUIRE(handles[1].get() == handles[0].get() + 1);
+
+      REQUIRE(pool.destroy(handles[10]));
+      REQUIRE(!handles[10]);
+      REQUIRE(!pool.destroy(handles[10]));
+      REQUIRE(pool.size() == 199);
+
+      // objects which belong to another pool, or to no pool, are not destroyed
+      {
+         be::Pool<PoolTestObject> other;
+         be::Handle<PoolTestObject> foreign = other.create(2000, std::string("foreign"));
+         PoolTestObject loose(3000, std::string("loose"));
+         REQUIRE(!pool.destroy(foreign));
+         REQUIRE(!pool.destroy(loose.getHandle()));
+         REQUIRE(!other.destroy(handles[11]));
+         REQUIRE(pool.size() == 199);
+         REQUIRE(other.destroy(foreign));
+      }
+
+      // the freed slot is reused first
+      PoolTestObject* address = handles[11].get() - 1;
+      be::Handle<PoolTestObject> reused = pool.create(1000, std::string("reused"));
+      REQUIRE(reused.get() == address);
+      REQUIRE(!handles[10]);
+
+      // failed construction leaves the pool unchanged
+      size_t capacity = pool.capacity();
+      REQUIRE_THROWS_AS(pool.create(-1, std::string("invalid")), std::invalid_argument);
+      REQUIRE(pool.size() == 200);
+      REQUIRE(pool.capacity() == capacity);
+
+      // objects are visited in slot order; chunks are separate allocations,
+      // so their addresses need not increase, but creation order does
+      int sum = 0;
+      int previous = -1;
+      bool ordered = true;
+      pool.forEach([&](const PoolTestObject& obj) {
+         sum += obj.value;
+         if (obj.value == 1000)
+            return;
+         if (obj.value < previous)
+            ordered = false;
+         previous = obj.value;
+      });
+      REQUIRE(sum == 199 * 200 / 2 - 10 + 1000);
+      REQUIRE(ordered);
+
+      pool.clear();
+      REQUIRE(pool.size() == 0);
+      REQUIRE(live_pool_objects == 0);
+      REQUIRE(!handles[0]);
+      REQUIRE(!reused);
+
+      handles[0] = pool.create(5, std::string("after clear"));
+      REQUIRE(handles[0]->value == 5);
+   }
+
+   REQUIRE(live_pool_objects == 0);
+}
+
+#endif
@@ -0,0 +1,186 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#define BE_PROFILE_ENABLED
+
+#include "be/profiler.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace {
+
+const be::ProfileZoneStats* findZone(const be::ProfileFrameStats& frame, const char* name)
+{
+   for (auto i(frame.zones.begin()), end(frame.zones.end()); i != end; ++i)
+      if (strcmp(i->name, name) == 0)
+         return &*i;
+
+   return nullptr;
+}
+
+void sleepMs(int ms)
+{
+   std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+} // namespace (anon)
+
+TEST_CASE("bengine/Profiler/Inactive", "Zones are not recorded when no Profiler exists")
+{
+   {
+      BE_PROFILE_ZONE("before profiler");
+   }
+
+   be::Profiler profiler;
+   BE_PROFILE_FRAME();
+
+   REQUIRE(profiler.getFrameCount() == 1);
+   REQUIRE(profiler.getFrame(0).zones.empty());
+}
+
+TEST_CASE("bengine/Profiler/Frames", "Zones are summarized per frame")
+{
+   be::Profiler profiler;
+   REQUIRE_THROWS_AS(be::Profiler another, std::logic_error);
+
+   for (int frame = 0; frame < 3; ++frame)
+   {
+      BE_PROFILE_ZONE("outer");
+      for (int i = 0; i <= frame; ++i)
+      {
+         BE_PROFILE_ZONE("inner");
+         sleepMs(2);
+      }
+   }
+   BE_PROFILE_FRAME();
+
+   {
+      BE_PROFILE_ZONE("inner");
+   }
+   BE_PROFILE_FRAME();
+
+   REQUIRE(profiler.getFrameCount() == 2);
+
+   const be::ProfileFrameStats& first = profiler.getFrame(0);
+   REQUIRE(first.index == 0);
+   REQUIRE(first.zones.size() == 2);
+   REQUIRE(first.zones[0].name == std::string("inner"));   // inner zones exit first
+
+   const be::ProfileZoneStats* outer = findZone(first, "outer");
+   const be::ProfileZoneStats* inner = findZone(first, "inner");
+   REQUIRE(outer);
+   REQUIRE(inner);
+   REQUIRE(outer->calls == 3);
+   REQUIRE(inner->calls == 6);
+   REQUIRE(inner->total_ms >= 10.0);
+   REQUIRE(outer->total_ms >= inner->total_ms);
+   REQUIRE(outer->max_ms >= inner->max_ms);
+   REQUIRE(first.duration_ms >= outer->total_ms);
+
+   const be::ProfileFrameStats& second = profiler.getFrame(1);
+   REQUIRE(second.index == 1);
+   REQUIRE(second.zones.size() == 1);
+   REQUIRE(second.zones[0].calls == 1);
+   REQUIRE(profiler.getDroppedCount() == 0);
+}
+
+TEST_CASE("bengine/Profiler/NoFrames", "Zones waiting for a frame boundary are bounded")
+{
+   be::Profiler profiler(16);
+
+   for (int i = 0; i < 40; ++i)
+   {
+      BE_PROFILE_ZONE("zone");
+   }
+   profiler.collect();
+
+   REQUIRE(profiler.getFrameCount() == 0);
+   REQUIRE(profiler.getDroppedCount() == 24);
+
+   // the zones which were kept are assigned to the next frame
+   BE_PROFILE_FRAME();
+   REQUIRE(profiler.getFrameCount() == 1);
+   REQUIRE(profiler.getFrame(0).zones.size() == 1);
+   REQUIRE(profiler.getFrame(0).zones[0].calls == 16);
+}
+
+TEST_CASE("bengine/Profiler/ThreadExit", "Zones from threads which exit before they are collected are not lost")
+{
+   const int thread_count = 8;
+
+   be::Profiler profiler;
+
+   // each thread exits (releasing its buffer for a later thread to reuse)
+   // before the zones it recorded are collected.
+   for (int t = 0; t < thread_count; ++t)
+   {
+      std::thread thread([]() {
+         BE_PROFILE_ZONE("worker");
+      });
+      thread.join();
+
+      if (t % 2 == 1)
+         profiler.collect();
+   }
+   BE_PROFILE_FRAME();
+
+   REQUIRE(profiler.getFrameCount() == 1);
+   const be::ProfileZoneStats* worker = findZone(profiler.getFrame(0), "worker");
+   REQUIRE(worker);
+   REQUIRE(worker->calls == thread_count);
+   REQUIRE(profiler.getDroppedCount() == 0);
+}
+
+TEST_CASE("bengine/Profiler/ChromeTrace", "Zones from all threads are written as Chrome trace events")
+{
+   be::Profiler profiler;
+
+   std::thread worker([]() {
+      BE_PROFILE_THREAD("worker \"1\"");
+      BE_PROFILE_FUNCTION();
+      sleepMs(1);
+   });
+   worker.join();
+
+   {
+      BE_PROFILE_ZONE("main zone");
+   }
+   BE_PROFILE_FRAME();
+
+   std::ostringstream oss;
+   profiler.writeChromeTrace(oss);
+   std::string json = oss.str();
+
+   REQUIRE(json.compare(0, 15, "{\"traceEvents\":") == 0);
+   REQUIRE(json.find("\"name\":\"main zone\",\"cat\":\"be\",\"ph\":\"X\"") != std::string::npos);
+   REQUIRE(json.find("\"ph\":\"i\"") != std::string::npos);
+   REQUIRE(json.find("\"thread_name\"") != std::string::npos);
+   REQUIRE(json.find("\"worker \\\"1\\\"\"") != std::string::npos);
+   REQUIRE(json.find("\"displayTimeUnit\":\"ms\"}") != std::string::npos);
+}
+
+#endif
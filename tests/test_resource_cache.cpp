@@ -0,0 +1,258 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "pbj/sw/resource_cache.h"
+#include "pbj/sw/sandwich_open.h"
+#include "be/bed/cached_stmt.h"
+#include "be/bed/stmt.h"
+#include "be/bed/db.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+struct TestCachedResource
+{
+   explicit TestCachedResource(const std::string& text)
+      : text(text)
+   {
+   }
+
+   std::string text;
+};
+
+// Reads a row from the test_resources table.  Each resource uses one byte of
+// main memory and ten bytes of video memory per character.
+struct TestCachePolicy
+{
+   typedef TestCachedResource resource_type;
+   typedef std::string data_type;
+
+   TestCachePolicy()
+      : finalized(std::make_shared<int>(0))
+   {
+   }
+
+   void read(pbj::sw::Sandwich& sandwich, const pbj::sw::ResourceId& id, data_type& data) const
+   {
+      be::bed::CachedStmt stmt(sandwich.getStmtCache().hold("SELECT data FROM test_resources WHERE id = ?"));
+      stmt.bindAll(id.resource);
+      if (!stmt.step())
+         throw std::runtime_error("Resource not found!");
+
+      data = stmt.getText(0);
+   }
+
+   void decode(const pbj::sw::ResourceId& /*id*/, data_type& /*data*/) const
+   {
+   }
+
+   TestCachedResource* finalize(const pbj::sw::ResourceId& /*id*/, data_type& data) const
+   {
+      ++*finalized;
+      return new TestCachedResource(data);
+   }
+
+   void measure(const TestCachedResource& resource, size_t& cpu_bytes, size_t& gpu_bytes) const
+   {
+      cpu_bytes = resource.text.size();
+      gpu_bytes = resource.text.size() * 10;
+   }
+
+   be::Id getVariant() const
+   {
+      return be::Id();
+   }
+
+   be::Id getContentType() const
+   {
+      return be::Id();
+   }
+
+   std::shared_ptr<int> finalized;
+};
+
+} // namespace (anon)
+
+TEST_CASE("pbj/sw/ResourceCache", "Resources are shared between holders and unreferenced resources are evicted to stay within budget")
+{
+   const std::string manifest_path("be_test_cache.manifest");
+   const std::string path("be_test_cache.sw");
+   const be::Id sandwich_id("be_test_cache");
+   std::remove(path.c_str());
+   std::remove(manifest_path.c_str());
+
+   {
+      be::bed::Db db(path);
+      db.exec("CREATE TABLE pbj_sandwich_properties (property TEXT PRIMARY KEY, value)");
+      db.exec("CREATE TABLE test_resources (id INTEGER PRIMARY KEY, data TEXT)");
+
+      be::bed::Stmt insert_property(db, "INSERT INTO pbj_sandwich_properties VALUES (?, ?)");
+      insert_property.bindAll("id", sandwich_id);
+      insert_property.step();
+
+      be::bed::Stmt insert(db, "INSERT INTO test_resources VALUES (?, ?)");
+      const char* names[] = { "alpha", "beta", "gamma" };
+      for (int i = 0; i < 3; ++i)
+      {
+         insert.reset();
+         insert.bindAll(be::Id(names[i]), names[i]);
+         insert.step();
+      }
+   }
+
+   pbj::sw::readDirectory("./", manifest_path);
+
+   {
+      pbj::sw::ResourceLoader loader(1, 1);
+      pbj::sw::ResourceCache cache(loader, 10, 1000);
+      TestCachePolicy policy;
+      pbj::sw::ResourceId alpha(sandwich_id, be::Id("alpha"));
+      pbj::sw::ResourceId beta(sandwich_id, be::Id("beta"));
+      pbj::sw::ResourceId gamma(sandwich_id, be::Id("gamma"));
+      const pbj::sw::ResourceCacheStats& stats = cache.getStats();
+
+      SECTION("sharing", "Holding a resource again returns the same resource without loading it again")
+      {
+         pbj::sw::CachedResource<TestCachedResource> a = cache.hold(alpha, 0, policy);
+         pbj::sw::CachedResource<TestCachedResource> b = cache.hold(alpha, 0, policy);
+         REQUIRE(stats.misses == 1);
+         REQUIRE(stats.hits == 1);
+         REQUIRE(stats.loading == 1);
+
+         loader.flush();
+         cache.update();
+
+         REQUIRE(stats.loading == 0);
+         REQUIRE(stats.resident == 1);
+         REQUIRE(stats.cpu_bytes == 5);
+         REQUIRE(stats.gpu_bytes == 50);
+         REQUIRE(*policy.finalized == 1);
+
+         bool same_resource = a.get() == b.get() && a.get() != 0;
+         REQUIRE(same_resource);
+         REQUIRE(a->text == "alpha");
+
+         pbj::sw::CachedResource<TestCachedResource> c(a);
+         a.release();
+         b.release();
+         REQUIRE(stats.unreferenced == 0);
+         REQUIRE(c->text == "alpha");
+
+         c.release();
+         REQUIRE(stats.unreferenced == 1);
+         REQUIRE(stats.resident == 1);
+      }
+
+      SECTION("lru", "The least recently released resources are evicted first, and only when over budget")
+      {
+         pbj::sw::CachedResource<TestCachedResource> a = cache.hold(alpha, 0, policy);
+         pbj::sw::CachedResource<TestCachedResource> b = cache.hold(beta, 0, policy);
+         loader.flush();
+         cache.update();
+         REQUIRE(stats.cpu_bytes == 9);
+
+         a.release();
+         b.release();
+         REQUIRE(stats.unreferenced == 2);
+         REQUIRE(stats.evictions == 0);
+
+         pbj::sw::CachedResource<TestCachedResource> c = cache.hold(gamma, 0, policy);
+         loader.flush();
+         cache.update();
+
+         REQUIRE(stats.evictions == 1);
+         REQUIRE(stats.resident == 2);
+         REQUIRE(stats.cpu_bytes == 9);
+
+         b = cache.hold(beta, 0, policy);
+         REQUIRE(stats.hits == 1);
+         REQUIRE(b->text == "beta");
+
+         a = cache.hold(alpha, 0, policy);
+         REQUIRE(stats.misses == 4);
+         loader.flush();
+         cache.update();
+
+         // Nothing is unreferenced, so the cache stays over budget.
+         REQUIRE(stats.resident == 3);
+         REQUIRE(stats.cpu_bytes == 14);
+         REQUIRE(*policy.finalized == 4);
+
+         c.release();
+         REQUIRE(stats.evictions == 2);
+         REQUIRE(stats.cpu_bytes == 9);
+         REQUIRE(stats.unreferenced == 0);
+      }
+
+      SECTION("budget", "Lowering the budget evicts unreferenced resources")
+      {
+         pbj::sw::CachedResource<TestCachedResource> a = cache.hold(alpha, 0, policy);
+         pbj::sw::CachedResource<TestCachedResource> b = cache.hold(beta, 0, policy);
+         loader.flush();
+         cache.update();
+         b.release();
+
+         cache.setBudget(10, 40);
+         REQUIRE(stats.evictions == 1);
+         REQUIRE(stats.resident == 1);
+         REQUIRE(stats.gpu_bytes == 50);
+         REQUIRE(a->text == "alpha");
+      }
+
+      SECTION("failure", "Resources which fail to load are retried once they have been released")
+      {
+         pbj::sw::ResourceId missing(sandwich_id, be::Id("missing"));
+         pbj::sw::CachedResource<TestCachedResource> m = cache.hold(missing, 0, policy);
+         loader.flush();
+         cache.update();
+
+         REQUIRE(stats.loading == 0);
+         REQUIRE(stats.resident == 0);
+         REQUIRE(m.get() == 0);
+
+         bool failed = false;
+         try
+         {
+            m.getReady().get();
+         }
+         catch (const std::runtime_error&)
+         {
+            failed = true;
+         }
+         REQUIRE(failed);
+
+         m.release();
+         m = cache.hold(missing, 0, policy);
+         REQUIRE(stats.misses == 2);
+      }
+   }
+
+   std::remove(path.c_str());
+   std::remove(manifest_path.c_str());
+}
+
+#endif
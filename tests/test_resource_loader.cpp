@@ -0,0 +1,291 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "pbj/sw/resource_loader.h"
+#include "pbj/sw/sandwich_open.h"
+#include "be/bed/cached_stmt.h"
+#include "be/bed/stmt.h"
+#include "be/bed/db.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+
+#include <cctype>
+#include <cstdio>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct TestResource
+{
+   explicit TestResource(const std::string& text)
+      : text(text)
+   {
+   }
+
+   std::string text;
+};
+
+// Lets a test hold the I/O thread inside read() until the rest of its
+// requests have been queued.
+struct TestGate
+{
+   std::promise<void> entered;
+   std::promise<void> released;
+};
+
+// Reads a row from the test_resources table, converts it to upper case, and
+// records the order of reads and finalizations, and which thread performed
+// each stage.
+struct TestPolicy
+{
+   typedef TestResource resource_type;
+
+   struct data_type
+   {
+      std::string text;
+      std::thread::id read_thread;
+      std::thread::id decode_thread;
+   };
+
+   TestPolicy()
+      : reads(std::make_shared<std::vector<std::string> >()),
+        finalized(std::make_shared<std::vector<std::string> >())
+   {
+   }
+
+   void read(pbj::sw::Sandwich& sandwich, const pbj::sw::ResourceId& id, data_type& data) const
+   {
+      if (gate)
+      {
+         gate->entered.set_value();
+         gate->released.get_future().wait();
+      }
+
+      be::bed::CachedStmt stmt(sandwich.getStmtCache().hold("SELECT data FROM test_resources WHERE id = ?"));
+      stmt.bindAll(id.resource);
+      if (!stmt.step())
+         throw std::runtime_error("Resource not found!");
+
+      data.text = stmt.getText(0);
+      reads->push_back(data.text);
+      data.read_thread = std::this_thread::get_id();
+   }
+
+   void decode(const pbj::sw::ResourceId& /*id*/, data_type& data) const
+   {
+      if (data.text == "bad")
+         throw std::runtime_error("Could not decode resource!");
+
+      for (auto i(data.text.begin()), end(data.text.end()); i != end; ++i)
+         *i = char(toupper(*i));
+
+      data.decode_thread = std::this_thread::get_id();
+   }
+
+   TestResource* finalize(const pbj::sw::ResourceId& /*id*/, data_type& data) const
+   {
+      finalized->push_back(data.text);
+      bool off_thread = data.read_thread != std::this_thread::get_id() &&
+                        data.decode_thread != std::this_thread::get_id();
+      return new TestResource(off_thread ? data.text : "");
+   }
+
+   be::Id getVariant() const
+   {
+      return be::Id();
+   }
+
+   std::shared_ptr<TestGate> gate;
+   std::shared_ptr<std::vector<std::string> > reads;     // Only written by the loader's single I/O thread.
+   std::shared_ptr<std::vector<std::string> > finalized;
+};
+
+bool isReady(const std::shared_future<void>& future)
+{
+   return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+bool throwsRuntimeError(const std::shared_future<void>& future)
+{
+   try
+   {
+      future.get();
+   }
+   catch (const std::runtime_error&)
+   {
+      return true;
+   }
+   catch (...)
+   {
+   }
+
+   return false;
+}
+
+} // namespace (anon)
+
+TEST_CASE("pbj/sw/ResourceLoader", "Resources are read and decoded in the background and finalized by update()")
+{
+   const std::string manifest_path("be_test_loader.manifest");
+   const std::string path("be_test_loader.sw");
+   const be::Id sandwich_id("be_test_loader");
+   std::remove(path.c_str());
+   std::remove(manifest_path.c_str());
+
+   {
+      be::bed::Db db(path);
+      db.exec("CREATE TABLE pbj_sandwich_properties (property TEXT PRIMARY KEY, value)");
+      db.exec("CREATE TABLE test_resources (id INTEGER PRIMARY KEY, data TEXT)");
+
+      be::bed::Stmt insert_property(db, "INSERT INTO pbj_sandwich_properties VALUES (?, ?)");
+      insert_property.bindAll("id", sandwich_id);
+      insert_property.step();
+
+      be::bed::Stmt insert(db, "INSERT INTO test_resources VALUES (?, ?)");
+      const char* names[] = { "alpha", "beta", "gamma", "bad" };
+      for (int i = 0; i < 4; ++i)
+      {
+         insert.reset();
+         insert.bindAll(be::Id(names[i]), names[i]);
+         insert.step();
+      }
+   }
+
+   pbj::sw::readDirectory("./", manifest_path);
+
+   {
+      pbj::sw::ResourceLoader loader(1, 2);
+      TestPolicy policy;
+      pbj::sw::ResourceId alpha(sandwich_id, be::Id("alpha"));
+
+      SECTION("load", "Handles resolve once the resource has been finalized on the owning thread")
+      {
+         pbj::sw::ResourceRequest<TestResource> request = loader.load(alpha, 0, policy);
+         REQUIRE(request.handle.get() == 0);
+         REQUIRE(loader.getPendingCount() == 1);
+
+         loader.flush();
+
+         REQUIRE(isReady(request.ready));
+         REQUIRE(loader.getPendingCount() == 0);
+         bool resolved = request.handle.get() != nullptr;
+         REQUIRE(resolved);
+         REQUIRE(request.handle->text == "ALPHA");
+      }
+
+      SECTION("duplicate", "Requesting the same resource again returns the same request")
+      {
+         pbj::sw::ResourceRequest<TestResource> a = loader.load(alpha, 0, policy);
+         pbj::sw::ResourceRequest<TestResource> b = loader.load(alpha, 1, policy);
+         REQUIRE(loader.getPendingCount() == 1);
+         bool same_handle = a.handle == b.handle;
+         REQUIRE(same_handle);
+
+         loader.flush();
+         REQUIRE(policy.finalized->size() == 1);
+
+         pbj::sw::ResourceRequest<TestResource> c = loader.load(alpha, 0, policy);
+         same_handle = a.handle == c.handle;
+         REQUIRE(same_handle);
+         REQUIRE(isReady(c.ready));
+         REQUIRE(loader.getPendingCount() == 0);
+      }
+
+      SECTION("failure", "Failures in any stage are reported through the future")
+      {
+         pbj::sw::ResourceRequest<TestResource> missing = loader.load(pbj::sw::ResourceId(sandwich_id, be::Id("missing")), 0, policy);
+         pbj::sw::ResourceRequest<TestResource> bad = loader.load(pbj::sw::ResourceId(sandwich_id, be::Id("bad")), 0, policy);
+         pbj::sw::ResourceRequest<TestResource> unknown = loader.load(pbj::sw::ResourceId(be::Id("be_test_loader_unknown"), be::Id("alpha")), 0, policy);
+
+         loader.flush();
+
+         REQUIRE(throwsRuntimeError(missing.ready));
+         REQUIRE(throwsRuntimeError(bad.ready));
+         REQUIRE(throwsRuntimeError(unknown.ready));
+         REQUIRE(missing.handle.get() == 0);
+         REQUIRE(bad.handle.get() == 0);
+         REQUIRE(unknown.handle.get() == 0);
+         REQUIRE(policy.finalized->empty());
+      }
+
+      SECTION("priority", "Higher priority requests are read first")
+      {
+         TestPolicy gated(policy);
+         gated.gate = std::make_shared<TestGate>();
+
+         loader.load(alpha, 0, gated);
+         gated.gate->entered.get_future().wait();
+
+         loader.load(pbj::sw::ResourceId(sandwich_id, be::Id("beta")), 0, policy);
+         loader.load(pbj::sw::ResourceId(sandwich_id, be::Id("gamma")), 0, policy);
+         loader.load(pbj::sw::ResourceId(sandwich_id, be::Id("beta")), 5, policy);
+
+         gated.gate->released.set_value();
+         loader.flush();
+
+         REQUIRE(policy.finalized->size() == 3);
+         REQUIRE(policy.reads->size() == 3);
+         REQUIRE((*policy.reads)[0] == "alpha");
+         REQUIRE((*policy.reads)[1] == "beta");
+         REQUIRE((*policy.reads)[2] == "gamma");
+      }
+
+      SECTION("unload", "Unloading destroys finished resources and cancels unfinished ones")
+      {
+         pbj::sw::ResourceRequest<TestResource> request = loader.load(alpha, 0, policy);
+         loader.flush();
+         REQUIRE(loader.unload<TestResource>(alpha, policy.getVariant()));
+         REQUIRE(request.handle.get() == 0);
+         REQUIRE(!loader.unload<TestResource>(alpha, policy.getVariant()));
+
+         TestPolicy gated(policy);
+         gated.gate = std::make_shared<TestGate>();
+         request = loader.load(alpha, 0, gated);
+         gated.gate->entered.get_future().wait();
+
+         REQUIRE(loader.unload<TestResource>(alpha, policy.getVariant()));
+         REQUIRE(loader.getPendingCount() == 0);
+
+         gated.gate->released.set_value();
+         bool broken = false;
+         try
+         {
+            request.ready.get();
+         }
+         catch (const std::future_error&)
+         {
+            broken = true;
+         }
+         REQUIRE(broken);
+         REQUIRE(policy.finalized->size() == 1);
+      }
+   }
+
+   std::remove(path.c_str());
+   std::remove(manifest_path.c_str());
+}
+
+#endif
@@ -0,0 +1,208 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "be/bed/row_reader.h"
+#include "be/bed/stmt_cache.h"
+#include "be/bed/stmt.h"
+#include "be/bed/db.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+
+#include <string>
+
+namespace {
+
+enum Color
+{
+   Red = 1,
+   Green = 2,
+   Blue = 3
+};
+
+struct Vertex
+{
+   int x;
+   int y;
+   Color color;
+   std::string name;
+};
+
+// Found by argument-dependent lookup from Stmt::readInto().
+be::bed::RowReader& operator>>(be::bed::RowReader& row, Vertex& v)
+{
+   return row >> v.x >> v.y >> v.color >> v.name;
+}
+
+} // namespace (anon)
+
+TEST_CASE("bengine/Stmt/Typed", "bindAll() and readRow() choose column types at compile time")
+{
+   be::bed::Db db;
+   db.exec("CREATE TABLE t (b INTEGER, i INTEGER, u INTEGER, i64 INTEGER, d REAL, f REAL, s TEXT, c TEXT, id INTEGER, e INTEGER)");
+
+   be::bed::Stmt insert(db, "INSERT INTO t VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+   insert.bindAll(true, -7, 4000000000u, -(sqlite3_int64(1) << 40), 0.25, 1.5f,
+                  std::string("text"), "literal", be::Id(0xFFFFFFFFFFFFFFFFull), Blue);
+   REQUIRE(!insert.step());
+
+   be::bed::Stmt select(db, "SELECT b, i, u, i64, d, f, s, c, id, e FROM t");
+   REQUIRE(select.step());
+
+   bool b;
+   int i;
+   unsigned int u;
+   sqlite3_int64 i64;
+   double d;
+   float f;
+   std::string s;
+   const char* c;
+   be::Id id;
+   Color e;
+   select.readRow(b, i, u, i64, d, f, s, c, id, e);
+
+   REQUIRE(b);
+   REQUIRE(i == -7);
+   REQUIRE(u == 4000000000u);
+   REQUIRE(i64 == -(sqlite3_int64(1) << 40));
+   REQUIRE(d == 0.25);
+   REQUIRE(f == 1.5f);
+   REQUIRE(s == "text");
+   REQUIRE(std::string(c) == "literal");
+   REQUIRE(id == be::Id(0xFFFFFFFFFFFFFFFFull));
+   REQUIRE(e == Blue);
+
+   // the typed functions agree with the untyped ones
+   REQUIRE(select.get<unsigned int>(2) == select.getUInt(2));
+   REQUIRE(select.get<sqlite3_uint64>(8) == select.getUInt64(8));
+   REQUIRE(std::string(select.get<const char*>(6)) == select.getText(6));
+}
+
+TEST_CASE("bengine/Stmt/ReadInto", "readInto() reads structs with a user-defined operator>>")
+{
+   be::bed::Db db;
+   db.exec("CREATE TABLE vertices (x INTEGER, y INTEGER, color INTEGER, name TEXT)");
+   be::bed::StmtCache cache(db);
+
+   for (int n = 0; n < 3; ++n)
+   {
+      be::bed::CachedStmt insert = cache.hold("INSERT INTO vertices VALUES (?, ?, ?, ?)");
+      insert.bindAll(n, n * 10, Green, "vertex");
+      insert.step();
+   }
+
+   be::bed::CachedStmt select = cache.hold("SELECT x, y, color, name FROM vertices ORDER BY x");
+   int n = 0;
+   while (select.step())
+   {
+      Vertex v;
+      select.readInto(v);
+      REQUIRE(v.x == n);
+      REQUIRE(v.y == n * 10);
+      REQUIRE(v.color == Green);
+      REQUIRE(v.name == "vertex");
+      ++n;
+   }
+   REQUIRE(n == 3);
+
+   // RowReader can also start partway through a row and skip columns.
+   be::bed::CachedStmt last = cache.hold("SELECT x, y, color, name FROM vertices WHERE x = 2");
+   REQUIRE(last.step());
+   be::bed::RowReader row(last, 1);
+   int y;
+   row >> y;
+   row.skip(1);
+   REQUIRE(y == 20);
+   REQUIRE(row.read<std::string>() == "vertex");
+   REQUIRE(row.getColumn() == 4);
+}
+
+TEST_CASE("bengine/Stmt/ColumnNames", "column() finds result columns by name or by the Id of their name")
+{
+   be::bed::Db db;
+   db.exec("CREATE TABLE t (a INTEGER, b TEXT, c REAL)");
+   db.exec("INSERT INTO t VALUES (1, 'x', 2.5)");
+
+   be::bed::Stmt select(db, "SELECT c, a, b AS renamed, a FROM t");
+   REQUIRE(select.column(be::Id("c")) == 0);
+   REQUIRE(select.column(be::Id("a")) == 1);    // the first of two columns named 'a'
+   REQUIRE(select.column(be::Id("renamed")) == 2);
+   REQUIRE(select.column("renamed") == 2);
+   REQUIRE_THROWS_AS(select.column(be::Id("b")), be::bed::Db::error);
+   REQUIRE_THROWS_AS(select.column("b"), be::bed::Db::error);
+
+   // column lookups still work after steps and resets
+   REQUIRE(select.step());
+   REQUIRE(select.get<int>(select.column(be::Id("a"))) == 1);
+   REQUIRE(!select.step());
+   select.reset();
+   REQUIRE(select.step());
+   REQUIRE(select.get<double>(select.column(be::Id("c"))) == 2.5);
+
+   be::bed::StmtCache cache(db);
+   be::bed::CachedStmt cached(cache.hold(be::Id("SELECT a, b FROM t"), "SELECT a, b FROM t"));
+   REQUIRE(cached.column(be::Id("b")) == 1);
+   REQUIRE(cached.column("a") == 0);
+}
+
+TEST_CASE("bengine/Stmt/ColumnNamesSchemaChange", "column() follows result columns which change when a table is recreated")
+{
+   be::bed::Db db;
+   db.exec("CREATE TABLE t (a INTEGER, b TEXT)");
+   db.exec("INSERT INTO t VALUES (1, 'x')");
+
+   be::bed::Stmt select(db, "SELECT * FROM t");
+   REQUIRE(select.step());
+   REQUIRE(select.column(be::Id("b")) == 1);
+   select.reset();
+
+   db.exec("DROP TABLE t");
+   db.exec("CREATE TABLE t (b TEXT, c REAL, a INTEGER)");
+   db.exec("INSERT INTO t VALUES ('y', 2.5, 2)");
+
+   REQUIRE(select.step());
+   REQUIRE(select.column(be::Id("b")) == 0);
+   REQUIRE(select.column(be::Id("c")) == 1);
+   REQUIRE(select.get<int>(select.column(be::Id("a"))) == 2);
+   select.reset();
+
+   // same number of columns, different names
+   db.exec("DROP TABLE t");
+   db.exec("CREATE TABLE t (d TEXT, e REAL, b INTEGER)");
+   db.exec("INSERT INTO t VALUES ('z', 3.5, 3)");
+
+   REQUIRE(select.step());
+   REQUIRE(select.column(be::Id("e")) == 1);
+   REQUIRE(select.get<int>(select.column(be::Id("b"))) == 3);
+   select.reset();
+
+   // looked up before the step which re-prepares the statement
+   db.exec("DROP TABLE t");
+   db.exec("CREATE TABLE t (b INTEGER, f REAL, g TEXT)");
+   db.exec("INSERT INTO t VALUES (4, 4.5, 'w')");
+
+   REQUIRE(select.column(be::Id("e")) == 1);
+   REQUIRE(select.step());
+   REQUIRE(select.column(be::Id("f")) == 1);
+   REQUIRE(select.get<int>(select.column(be::Id("b"))) == 4);
+}
+
+#endif
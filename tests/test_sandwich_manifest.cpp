@@ -0,0 +1,226 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "pbj/sw/sandwich_manifest.h"
+#include "pbj/sw/sandwich_open.h"
+#include "be/bed/stmt.h"
+#include "be/bed/db.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+
+#include <cstdio>
+#include <ctime>
+#include <stdexcept>
+#include <string>
+#ifdef _WIN32
+#include <sys/utime.h>
+#define BE_TEST_UTIME _utime
+typedef struct _utimbuf be_test_utimbuf;
+#else
+#include <utime.h>
+#define BE_TEST_UTIME utime
+typedef struct utimbuf be_test_utimbuf;
+#endif
+
+namespace {
+
+void createSandwich(const std::string& path, const be::Id& id, uint32_t schema_version = 0)
+{
+   std::remove(path.c_str());
+   be::bed::Db db(path);
+   db.exec("CREATE TABLE pbj_sandwich_properties (property TEXT PRIMARY KEY, value)");
+   be::bed::Stmt insert(db, "INSERT INTO pbj_sandwich_properties VALUES (?, ?)");
+   insert.bindAll("id", id);
+   insert.step();
+   if (schema_version != 0)
+   {
+      insert.reset();
+      insert.bindAll("schema_version", schema_version);
+      insert.step();
+   }
+}
+
+// Moves a file's modification time into the past, so that the manifest
+// doesn't consider it too new to be cached.
+void backdate(const std::string& path, int seconds)
+{
+   be_test_utimbuf times;
+   times.actime = time(nullptr) - seconds;
+   times.modtime = times.actime;
+   BE_TEST_UTIME(path.c_str(), &times);
+}
+
+} // namespace (anon)
+
+TEST_CASE("pbj/sw/SandwichManifest", "Only sandwiches which have changed since the manifest was saved are opened")
+{
+   const std::string manifest_path("be_test_manifest.manifest");
+   const std::string a_path("be_test_manifest_a.sw");
+   const std::string b_path("be_test_manifest_b.sw");
+   std::remove(manifest_path.c_str());
+
+   createSandwich(a_path, be::Id("be_test_manifest_a"));
+   createSandwich(b_path, be::Id("be_test_manifest_b"));
+   backdate(a_path, 10);
+   backdate(b_path, 10);
+
+   {
+      pbj::sw::SandwichManifest manifest(manifest_path);
+      REQUIRE(manifest.refresh(a_path).id == be::Id("be_test_manifest_a"));
+      REQUIRE(manifest.refresh(b_path).id == be::Id("be_test_manifest_b"));
+      REQUIRE(manifest.refresh(b_path).tables == "pbj_sandwich_properties\n");
+      REQUIRE(manifest.getOpenedCount() == 2);
+      manifest.save();
+   }
+
+   {
+      pbj::sw::SandwichManifest manifest(manifest_path);
+      REQUIRE(manifest.refresh(a_path).id == be::Id("be_test_manifest_a"));
+      REQUIRE(manifest.refresh(b_path).id == be::Id("be_test_manifest_b"));
+      REQUIRE(manifest.refresh(b_path).tables == "pbj_sandwich_properties\n");
+      REQUIRE(manifest.getOpenedCount() == 0);
+      manifest.save();
+   }
+
+   SECTION("changed", "A sandwich whose size or mtime has changed is reopened")
+   {
+      {
+         be::bed::Db db(b_path);
+         db.exec("CREATE TABLE extra (x)");
+      }
+      backdate(b_path, 5);
+
+      pbj::sw::SandwichManifest manifest(manifest_path);
+      REQUIRE(manifest.refresh(a_path).id == be::Id("be_test_manifest_a"));
+      REQUIRE(manifest.refresh(b_path).tables == "extra\npbj_sandwich_properties\n");
+      REQUIRE(manifest.getOpenedCount() == 1);
+   }
+
+   SECTION("recent", "A sandwich modified in the last second is reopened on the next scan")
+   {
+      backdate(b_path, 0);
+      {
+         pbj::sw::SandwichManifest manifest(manifest_path);
+         manifest.refresh(b_path);
+         REQUIRE(manifest.getOpenedCount() == 1);
+         manifest.save();
+      }
+
+      pbj::sw::SandwichManifest manifest(manifest_path);
+      manifest.refresh(b_path);
+      REQUIRE(manifest.getOpenedCount() == 1);
+   }
+
+   SECTION("missing", "Sandwiches which no longer exist are removed from the manifest")
+   {
+      std::remove(b_path.c_str());
+      {
+         pbj::sw::SandwichManifest manifest(manifest_path);
+         REQUIRE_THROWS_AS(manifest.refresh(b_path), std::runtime_error);
+         manifest.refresh(a_path);
+         manifest.save();
+      }
+
+      createSandwich(b_path, be::Id("be_test_manifest_b2"));
+      backdate(b_path, 10);
+
+      pbj::sw::SandwichManifest manifest(manifest_path);
+      REQUIRE(manifest.refresh(b_path).id == be::Id("be_test_manifest_b2"));
+      REQUIRE(manifest.getOpenedCount() == 1);
+   }
+
+   SECTION("format", "Manifests written with a different format are rebuilt")
+   {
+      {
+         be::bed::Db db(manifest_path);
+         db.exec("PRAGMA user_version = 0");
+      }
+
+      {
+         pbj::sw::SandwichManifest manifest(manifest_path);
+         manifest.refresh(a_path);
+         REQUIRE(manifest.getOpenedCount() == 1);
+         manifest.save();
+      }
+
+      pbj::sw::SandwichManifest manifest(manifest_path);
+      manifest.refresh(a_path);
+      REQUIRE(manifest.getOpenedCount() == 0);
+   }
+
+   SECTION("readDirectory", "readDirectory() keeps each sandwich's table of contents")
+   {
+      pbj::sw::readDirectory("./", manifest_path);
+      REQUIRE(pbj::sw::hasTable(be::Id("be_test_manifest_a"), "pbj_sandwich_properties"));
+      REQUIRE(!pbj::sw::hasTable(be::Id("be_test_manifest_a"), "pbj_sandwich"));
+      REQUIRE(!pbj::sw::hasTable(be::Id("be_test_manifest_a"), "sandwich_properties"));
+      REQUIRE(!pbj::sw::hasTable(be::Id("be_test_manifest_none"), "pbj_sandwich_properties"));
+
+      std::shared_ptr<pbj::sw::Sandwich> sandwich(pbj::sw::open(be::Id("be_test_manifest_b")));
+      bool opened = sandwich.get() != 0;
+      REQUIRE(opened);
+      REQUIRE(sandwich->getId() == be::Id("be_test_manifest_b"));
+
+      // rescanning keeps sandwiches and pools which are already open
+      std::shared_ptr<pbj::db::ConnectionPool<pbj::sw::Sandwich> > pool(pbj::sw::openPool(be::Id("be_test_manifest_b")));
+      pbj::sw::readDirectory("./", manifest_path);
+      REQUIRE(pbj::sw::open(be::Id("be_test_manifest_b")) == sandwich);
+      REQUIRE(pbj::sw::openPool(be::Id("be_test_manifest_b")) == pool);
+      REQUIRE(pbj::sw::hasTable(be::Id("be_test_manifest_a"), "pbj_sandwich_properties"));
+   }
+
+   SECTION("validation", "readDirectory() skips unsupported schema versions and resolves Id collisions by path")
+   {
+      const std::string c_path("be_test_manifest_c.sw");
+      const std::string d_path("be_test_manifest_d.sw");
+      const std::string e_path("be_test_manifest_e.sw");
+      const std::string f_path("be_test_manifest_f.sw");
+      uint32_t newer_major = (uint32_t(BE_BED_SCHEMA_VERSION_MAJOR + 1) << 16);
+      createSandwich(c_path, be::Id("be_test_manifest_collision"), PBJ_SW_SCHEMA_VERSION);
+      createSandwich(d_path, be::Id("be_test_manifest_collision"));
+      createSandwich(e_path, be::Id("be_test_manifest_newer"), newer_major);
+      createSandwich(f_path, be::Id("be_test_manifest_newer_minor"), PBJ_SW_SCHEMA_VERSION + 1);
+
+      pbj::sw::readDirectory("./", manifest_path);
+
+      std::shared_ptr<pbj::sw::Sandwich> sandwich(pbj::sw::open(be::Id("be_test_manifest_collision")));
+      bool opened = sandwich.get() != 0;
+      REQUIRE(opened);
+      bool collision_uses_first_path = sandwich->getDb().getInt("SELECT count(*) FROM pbj_sandwich_properties", 0) == 2;
+      REQUIRE(collision_uses_first_path);
+      sandwich.reset();
+
+      REQUIRE(!pbj::sw::hasTable(be::Id("be_test_manifest_newer"), "pbj_sandwich_properties"));
+      REQUIRE(!pbj::sw::hasTable(be::Id("be_test_manifest_newer_minor"), "pbj_sandwich_properties"));
+
+      std::remove(c_path.c_str());
+      std::remove(d_path.c_str());
+      std::remove(e_path.c_str());
+      std::remove(f_path.c_str());
+   }
+
+   std::remove(a_path.c_str());
+   std::remove(b_path.c_str());
+   std::remove(manifest_path.c_str());
+}
+
+#endif
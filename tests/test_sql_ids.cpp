@@ -0,0 +1,66 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "be/id.h"
+#include "pbj/sql_ids.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+
+#include <string>
+
+namespace {
+
+struct SqlIdCheck
+{
+   const char* sql;
+   uint64_t id;
+};
+
+#define BE_TEST_SQL_ID_CHECK(sql, id) { sql, id },
+
+const SqlIdCheck sql_id_checks[] = { PBJ_SQL_IDS(BE_TEST_SQL_ID_CHECK) };
+
+#undef BE_TEST_SQL_ID_CHECK
+
+} // namespace
+
+TEST_CASE("pbj/sql_ids", "Precalculated SQL statement Ids match the statements they were generated from")
+{
+   size_t count = sizeof(sql_id_checks) / sizeof(sql_id_checks[0]);
+   REQUIRE(count > 0);
+
+   for (size_t i = 0; i < count; ++i)
+   {
+      // If this fails, a *_SQL_* statement was changed without running
+      // tools/generate.cmd to regenerate pbj/sql_ids.h.
+      std::string sql(sql_id_checks[i].sql);
+      uint64_t expected = be::Id(sql).value();
+      INFO(sql);
+      REQUIRE(sql_id_checks[i].id == expected);
+   }
+
+   REQUIRE(be::Id(PBJ_SW_SANDWICH_SQLID_GET_ID) == be::Id(PBJ_SW_SANDWICH_SQL_GET_ID));
+   REQUIRE(be::Id(PBJ_WINDOW_SETTINGS_SQLID_LOAD) == be::Id(PBJ_WINDOW_SETTINGS_SQL_LOAD));
+   REQUIRE(be::Id(PBJ_WINDOW_SETTINGS_SQLID_SAVE) == be::Id(PBJ_WINDOW_SETTINGS_SQL_SAVE));
+}
+
+#endif
@@ -0,0 +1,169 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "be/bed/sql_profiler.h"
+#include "be/bed/stmt_cache.h"
+#include "be/bed/db.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+void createTable(be::bed::Db& db, int rows)
+{
+   db.exec("CREATE TABLE t (x INTEGER)");
+   for (int i = 0; i < rows; ++i)
+      db.exec("INSERT INTO t VALUES (1)");
+}
+
+int countRows(be::bed::StmtCache& cache, const be::Id& id)
+{
+   be::bed::CachedStmt stmt = cache.hold(id, "SELECT x FROM t");
+   int rows = 0;
+   while (stmt.step())
+      ++rows;
+   return rows;
+}
+
+} // namespace (anon)
+
+TEST_CASE("bengine/SqlProfiler/Inactive", "Statements are not recorded when no SqlProfiler exists")
+{
+   be::bed::Db db;
+   be::bed::StmtCache cache(db);
+   createTable(db, 3);
+
+   be::Id id("SqlProfiler test");
+   countRows(cache, id);
+
+   be::bed::SqlProfiler profiler;
+   REQUIRE_THROWS_AS(be::bed::SqlProfiler another, std::logic_error);
+
+   be::bed::SqlStmtStats stats(profiler.getStats(id));
+   REQUIRE(stats.id == id);
+   REQUIRE(stats.executions == 0);
+   REQUIRE(stats.cache_misses == 0);
+
+   // the cache's own counters don't depend on the profiler
+   REQUIRE(cache.getMissCount() == 1);
+   REQUIRE(cache.getHitCount() == 0);
+}
+
+TEST_CASE("bengine/SqlProfiler/Executions", "Executions, rows, and cache activity are recorded per Id")
+{
+   be::bed::Db db;
+   createTable(db, 3);
+
+   be::bed::SqlProfiler profiler;
+   be::Id id("SqlProfiler test");
+
+   {
+      be::bed::StmtCache cache(db);
+
+      for (int i = 0; i < 5; ++i)
+         REQUIRE(countRows(cache, id) == 3);
+
+      // reading only the first row still counts as an execution
+      {
+         be::bed::CachedStmt stmt = cache.hold(id, "SELECT x FROM t");
+         REQUIRE(stmt.step());
+      }
+
+      REQUIRE(cache.getHitCount() == 5);
+      REQUIRE(cache.getMissCount() == 1);
+      REQUIRE(cache.getEvictionCount() == 0);
+
+      be::bed::SqlStmtStats stats(profiler.getStats(id));
+      REQUIRE(stats.sql == "SELECT x FROM t");
+      REQUIRE(stats.prepares == 1);
+      REQUIRE(stats.executions == 6);
+      REQUIRE(stats.errors == 0);
+      REQUIRE(stats.rows == 16);
+      REQUIRE(stats.cache_hits == 5);
+      REQUIRE(stats.cache_misses == 1);
+      REQUIRE(stats.total_ms > 0);
+      REQUIRE(stats.max_ms <= stats.total_ms);
+      REQUIRE(stats.p99_ms <= stats.max_ms);
+      REQUIRE(stats.p99_ms > 0);
+   }
+
+   profiler.reset();
+   REQUIRE(profiler.getStats().empty());
+}
+
+TEST_CASE("bengine/SqlProfiler/Evictions", "Evictions and errors are recorded")
+{
+   be::bed::Db db;
+   createTable(db, 1);
+
+   be::bed::SqlProfiler profiler;
+   be::bed::StmtCache cache(db, 1);
+
+   cache.hold(be::Id("first"), "SELECT 1");
+   cache.hold(be::Id("second"), "SELECT 2");
+
+   REQUIRE(cache.getEvictionCount() == 1);
+   REQUIRE(profiler.getStats(be::Id("first")).cache_evictions == 1);
+   REQUIRE(profiler.getStats(be::Id("second")).cache_evictions == 0);
+
+   {
+      be::bed::CachedStmt stmt = cache.hold(be::Id("insert"), "INSERT INTO t VALUES (?)");
+      db.exec("DROP TABLE t");
+      REQUIRE_THROWS_AS(stmt.step(), be::bed::Db::error);
+   }
+
+   be::bed::SqlStmtStats stats(profiler.getStats(be::Id("insert")));
+   REQUIRE(stats.executions == 1);
+   REQUIRE(stats.errors == 1);
+}
+
+TEST_CASE("bengine/SqlProfiler/Report", "The report lists the most expensive statements")
+{
+   be::bed::Db db;
+   createTable(db, 100);
+
+   be::bed::SqlProfiler profiler;
+   be::bed::StmtCache cache(db);
+
+   countRows(cache, be::Id("SqlProfiler test"));
+   cache.hold(be::Id("cheap"), "SELECT 1").step();
+
+   std::vector<be::bed::SqlStmtStats> stats(profiler.getStats());
+   REQUIRE(stats.size() == 2);
+   double first_ms = stats[0].total_ms + stats[0].prepare_ms;
+   double second_ms = stats[1].total_ms + stats[1].prepare_ms;
+   REQUIRE(first_ms >= second_ms);
+
+   std::ostringstream oss;
+   profiler.writeReport(oss, 1);
+   std::string report(oss.str());
+
+   REQUIRE(report.find("2 statements") != std::string::npos);
+   REQUIRE(report.find(stats[0].sql) != std::string::npos);
+   REQUIRE(report.find(stats[1].sql) == std::string::npos);
+}
+
+#endif
@@ -0,0 +1,140 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "be/bed/stmt_cache.h"
+#include "be/bed/db.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* table_names[] = { "a", "b", "c", "d" };
+
+std::string selectFrom(int table)
+{
+   return std::string("SELECT * FROM ") + table_names[table];
+}
+
+// Creates tables a through d, caches a statement for each, then drops the
+// tables, so holding a cached statement succeeds but compiling a new one
+// throws.
+void fillCache(be::bed::Db& db, be::bed::StmtCache& cache, int tables)
+{
+   for (int i = 0; i < tables; ++i)
+      db.exec(std::string("CREATE TABLE ") + table_names[i] + " (x INTEGER)");
+
+   for (int i = 0; i < tables; ++i)
+      cache.hold(selectFrom(i));
+
+   for (int i = 0; i < tables; ++i)
+      db.exec(std::string("DROP TABLE ") + table_names[i]);
+}
+
+bool isCached(be::bed::StmtCache& cache, int table)
+{
+   try
+   {
+      cache.hold(selectFrom(table));
+      return true;
+   }
+   catch (const be::bed::Db::error&)
+   {
+      return false;
+   }
+}
+
+} // namespace (anon)
+
+TEST_CASE("bengine/StmtCache/Hold", "Statements are reused after they are released")
+{
+   be::bed::Db db(":memory:");
+   be::bed::StmtCache cache(db, 4);
+
+   {
+      be::bed::CachedStmt s1 = cache.hold("SELECT 1");
+      be::bed::CachedStmt s2 = cache.hold("SELECT 1");
+      REQUIRE(cache.getSize() == 2);
+      REQUIRE(cache.getHeldSize() == 2);
+
+      REQUIRE(s1.step());
+      REQUIRE(s1.getInt(0) == 1);
+
+      be::bed::CachedStmt moved(std::move(s2));
+      REQUIRE(cache.getHeldSize() == 2);
+   }
+   REQUIRE(cache.getSize() == 2);
+   REQUIRE(cache.getHeldSize() == 0);
+
+   {
+      be::bed::CachedStmt s1 = cache.hold("SELECT 1");
+      be::bed::CachedStmt s2 = cache.hold("SELECT 1");
+      REQUIRE(cache.getSize() == 2);
+
+      // released statements have been reset
+      REQUIRE(s1.step());
+      REQUIRE(!s1.step());
+   }
+
+   // held statements are never evicted, even when over capacity
+   {
+      std::vector<be::bed::CachedStmt*> held;
+      for (int i = 0; i < 6; ++i)
+         held.push_back(new be::bed::CachedStmt(cache.hold("SELECT 2")));
+
+      REQUIRE(cache.getSize() == 6);
+      REQUIRE(cache.getHeldSize() == 6);
+
+      for (auto i(held.begin()), end(held.end()); i != end; ++i)
+         delete *i;
+   }
+   REQUIRE(cache.getSize() == 4);
+   REQUIRE(cache.getHeldSize() == 0);
+}
+
+TEST_CASE("bengine/StmtCache/Evict", "The least recently released statements are evicted first")
+{
+   be::bed::Db db(":memory:");
+   be::bed::StmtCache cache(db, 4);
+
+   // released in order a, b, c, d
+   fillCache(db, cache, 4);
+   REQUIRE(cache.getSize() == 4);
+
+   // re-holding b makes it the most recently released
+   REQUIRE(isCached(cache, 1));
+
+   cache.setCapacity(2);
+   REQUIRE(cache.getSize() == 2);
+   REQUIRE(!isCached(cache, 0));
+   REQUIRE(!isCached(cache, 2));
+   REQUIRE(isCached(cache, 3));
+   REQUIRE(isCached(cache, 1));
+
+   cache.setCapacity(0);
+   REQUIRE(cache.getSize() == 0);
+   REQUIRE(!isCached(cache, 1));
+}
+
+#endif
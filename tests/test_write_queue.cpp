@@ -0,0 +1,158 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "be/bed/write_queue.h"
+#include "be/bed/db.h"
+#include "be/bed/stmt.h"
+#include "pbj/_pbj.h"
+
+#ifdef BE_TEST
+#include "catch.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* test_path = "test_write_queue.bed";
+
+void removeTestDb()
+{
+   std::remove(test_path);
+   std::remove((std::string(test_path) + "-wal").c_str());
+   std::remove((std::string(test_path) + "-shm").c_str());
+   std::remove((std::string(test_path) + "-journal").c_str());
+}
+
+struct Connection
+{
+   Connection()
+      : db(test_path, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, be::bed::DbConfig::editor())
+   {
+      db.exec("CREATE TABLE IF NOT EXISTS t (x INTEGER)");
+   }
+
+   be::bed::Db& getDb()
+   {
+      return db;
+   }
+
+   be::bed::Db db;
+};
+
+void insert(Connection& c, int x)
+{
+   be::bed::Stmt stmt(c.db, "INSERT INTO t (x) VALUES (?)");
+   stmt.bind(1, x);
+   stmt.step();
+}
+
+int countRows(const std::string& where)
+{
+   be::bed::Db db(test_path, SQLITE_OPEN_READONLY);
+   return db.getInt("SELECT count(*) FROM t" + where, -1);
+}
+
+} // namespace (anon)
+
+TEST_CASE("bengine/WriteQueue/Push", "Mutations are applied in order and their futures become ready")
+{
+   removeTestDb();
+   {
+      std::shared_ptr<Connection> connection(new Connection());
+      be::bed::WriteQueue<Connection> queue(connection);
+
+      std::vector<std::future<void> > futures;
+      for (int i = 0; i < 100; ++i)
+         futures.push_back(queue.push([=](Connection& c) { insert(c, i); }));
+
+      for (auto i(futures.begin()), end(futures.end()); i != end; ++i)
+         i->get();
+
+      REQUIRE(countRows("") == 100);
+
+      // order is preserved
+      std::future<void> f = queue.push([](Connection& c)
+      {
+         if (c.db.getInt("SELECT x FROM t ORDER BY rowid DESC LIMIT 1", -1) != 99)
+            throw std::runtime_error("out of order");
+      });
+      REQUIRE_NOTHROW(f.get());
+   }
+   removeTestDb();
+}
+
+TEST_CASE("bengine/WriteQueue/Errors", "A failed mutation is rolled back without affecting the rest of its batch")
+{
+   removeTestDb();
+   {
+      std::shared_ptr<Connection> connection(new Connection());
+      be::bed::WriteQueue<Connection> queue(connection);
+
+      // hold up the writer so the following mutations are committed in one
+      // batch.
+      std::promise<void> gate;
+      std::shared_future<void> gate_future(gate.get_future().share());
+      queue.push([=](Connection&) { gate_future.wait(); });
+
+      std::future<void> f1 = queue.push([](Connection& c) { insert(c, 1); });
+      std::future<void> f2 = queue.push([](Connection& c)
+      {
+         insert(c, 2);
+         throw std::runtime_error("mutation failed");
+      });
+      std::future<void> f3 = queue.push([](Connection& c) { insert(c, 3); });
+      gate.set_value();
+
+      queue.flush();
+      REQUIRE(f1.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+      REQUIRE(f3.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+
+      REQUIRE_NOTHROW(f1.get());
+      REQUIRE_THROWS_AS(f2.get(), std::runtime_error);
+      REQUIRE_NOTHROW(f3.get());
+
+      REQUIRE(countRows(" WHERE x = 1") == 1);
+      REQUIRE(countRows(" WHERE x = 2") == 0);
+      REQUIRE(countRows(" WHERE x = 3") == 1);
+   }
+   removeTestDb();
+}
+
+TEST_CASE("bengine/WriteQueue/Destroy", "Queued mutations are committed when the queue is destroyed")
+{
+   removeTestDb();
+   {
+      std::shared_ptr<Connection> connection(new Connection());
+      be::bed::WriteQueue<Connection> queue(connection, 7);
+      REQUIRE(queue.getMaxBatchSize() == 7);
+
+      for (int i = 0; i < 50; ++i)
+         queue.push([=](Connection& c) { insert(c, i); });
+   }
+   REQUIRE(countRows("") == 50);
+   removeTestDb();
+}
+
+#endif
@@ -1 +1,2 @@
-@idgen < builtins.txt > ids.builtins.txt
\ No newline at end of file
+@idgen < builtins.txt > ids.builtins.txt
+@call ..\vc11\script\sqlids.cmd "%~dp0idgen.exe" ..\include
\ No newline at end of file
@@ -24,11 +24,213 @@
 ///
 /// \brief  Command-line utility for calculating be::Id values from strings
 
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include "be/id.h"
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  A SQL statement macro found by scanSqlMacros().
+struct SqlMacro
+{
+   std::string name;    ///< The name of the macro, e.g. PBJ_FOO_SQL_BAR
+   std::string id_name; ///< The name of the Id macro, e.g. PBJ_FOO_SQLID_BAR
+   std::string sql;     ///< The text of the statement, after concatenation
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Parses a sequence of adjacent C string literals.
+///
+/// \param  value The replacement text of a macro.
+/// \param  result Receives the concatenated, unescaped contents of the
+///         literals.
+/// \return \c false if \c value contains anything other than whitespace and
+///         string literals.
+bool parseStringLiterals(const std::string& value, std::string& result)
+{
+   bool found_literal = false;
+   size_t i = 0;
+   while (i < value.length())
+   {
+      char c = value[i++];
+      if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+         continue;
+
+      if (c != '"')
+         return false;
+
+      found_literal = true;
+      for (;;)
+      {
+         if (i >= value.length())
+            return false;
+
+         c = value[i++];
+         if (c == '"')
+            break;
+
+         if (c == '\\')
+         {
+            if (i >= value.length())
+               return false;
+
+            c = value[i++];
+            switch (c)
+            {
+               case 'n': c = '\n'; break;
+               case 't': c = '\t'; break;
+               case 'r': c = '\r'; break;
+               case '0': c = '\0'; break;
+               case '\\':
+               case '\'':
+               case '"':
+               case '?':
+                  break;
+               default:
+                  return false;
+            }
+         }
+         result.push_back(c);
+      }
+   }
+
+   return found_literal;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Finds all macros named <tt>*_SQL_*</tt> in a source file whose
+///         replacement text is a string literal (or several adjacent
+///         literals, possibly spread across continued lines).
+///
+/// \param  filename The file to scan.
+/// \param  macros Each statement found is appended to this vector.
+/// \return \c false if the file could not be opened.
+bool scanSqlMacros(const std::string& filename, std::vector<SqlMacro>& macros)
+{
+   std::ifstream ifs(filename);
+   if (!ifs)
+      return false;
+
+   std::string line;
+   while (std::getline(ifs, line))
+   {
+      // join continued lines
+      while (line.length() > 0 && (line.back() == '\\' || line.back() == '\r'))
+      {
+         if (line.back() == '\r')
+         {
+            line.pop_back();
+            continue;
+         }
+
+         line.pop_back();
+         std::string next;
+         if (!std::getline(ifs, next))
+            break;
+         line.append(next);
+      }
+
+      std::istringstream iss(line);
+      std::string directive, name;
+      iss >> directive >> name;
+      if (directive != "#define")
+         continue;
+
+      size_t sql_pos = name.find("_SQL_");
+      if (sql_pos == std::string::npos || name.find('(') != std::string::npos)
+         continue;
+
+      std::string value;
+      std::getline(iss, value);
+
+      SqlMacro macro;
+      if (!parseStringLiterals(value, macro.sql))
+         continue;
+
+      macro.name = name;
+      macro.id_name = name;
+      macro.id_name.replace(sql_pos, 5, "_SQLID_");
+      macros.push_back(macro);
+   }
+
+   return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Writes a header containing precalculated Ids for each SQL
+///         statement macro found in a set of headers.
+///
+/// \details For each macro <tt>X_SQL_Y</tt>, a macro <tt>X_SQLID_Y</tt> is
+///         defined.  If #BE_ID_NAMES_ENABLED is defined, it expands to the
+///         statement text, so that the Id's name is registered.  Otherwise
+///         it expands to the statement's hash value, so creating the Id
+///         does not require hashing the statement at runtime.
+///
+///         A table macro named \c name is also defined, which expands
+///         <tt>X(sql, id)</tt> for every statement.  This allows tests to
+///         verify that the generated Ids have not drifted from the
+///         statements they were generated from.
+///
+/// \param  name The name of the table macro.  The include guard is
+///         <tt>name_H_</tt>.
+/// \param  root The directory that \c headers are relative to.
+/// \param  headers The headers to scan.
+/// \return 0 on success, or 1 if a header could not be opened.
+int generateSqlIds(const std::string& name, const std::string& root, const std::vector<std::string>& headers)
+{
+   std::vector<SqlMacro> macros;
+   for (auto i(headers.begin()), end(headers.end()); i != end; ++i)
+   {
+      if (!scanSqlMacros(root + '/' + *i, macros))
+      {
+         std::cerr << "Could not open header: " << root << '/' << *i << std::endl;
+         return 1;
+      }
+   }
+
+   std::ostream& os = std::cout;
+   os << "// Generated by idgen --sql.  Do not edit this file directly; run\n"
+      << "// tools/generate.cmd after changing any *_SQL_* statement.\n\n"
+      << "#ifndef " << name << "_H_\n"
+      << "#define " << name << "_H_\n\n";
+
+   for (auto i(headers.begin()), end(headers.end()); i != end; ++i)
+   {
+      std::string include(*i);
+      for (auto c(include.begin()), cend(include.end()); c != cend; ++c)
+         if (*c == '\\')
+            *c = '/';
+
+      os << "#include \"" << include << "\"\n";
+   }
+
+   os << "\n#define " << name << "(X)";
+   for (auto i(macros.begin()), end(macros.end()); i != end; ++i)
+   {
+      os << " \\\n   X(" << i->name << ", 0x" << std::hex << std::setfill('0')
+         << std::setw(16) << be::Id(i->sql).value() << std::dec << "ULL)";
+   }
+   os << "\n\n#ifdef BE_ID_NAMES_ENABLED\n";
+
+   for (auto i(macros.begin()), end(macros.end()); i != end; ++i)
+      os << "#define " << i->id_name << ' ' << i->name << '\n';
+
+   os << "#else\n";
+
+   for (auto i(macros.begin()), end(macros.end()); i != end; ++i)
+   {
+      os << "#define " << i->id_name << " 0x" << std::hex << std::setfill('0')
+         << std::setw(16) << be::Id(i->sql).value() << std::dec << "ULL\n";
+   }
+
+   os << "#endif\n\n#endif\n";
+   return 0;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  Utility for generating FNV-1a hashes of arbitrary strings.
 ///
@@ -53,14 +255,31 @@
 ///         different, previously processed input string) a warning will be
 ///         output to STDERR.
 ///
+///         If the first argument is \c --sql, a header of precalculated SQL
+///         statement Ids is written to STDOUT instead (see generateSqlIds()):
+///
+/// \code
+///         idgen --sql NAME include_dir header...
+/// \endcode
+///
 /// \param  argc The number of command-line arguments (including the program
 ///         name).
 /// \param  argv An array of c-strings representing the command-line arguments
 ///
-/// \return Always returns 0 to the operating system.
+/// \return 0 on success, or 1 if a \c --sql header could not be read.
 int main(int argc, char** argv)
 {
-   if (argc > 1)
+   if (argc > 1 && std::string(argv[1]) == "--sql")
+   {
+      if (argc < 5)
+      {
+         std::cerr << "Usage: idgen --sql NAME include_dir header..." << std::endl;
+         return 1;
+      }
+
+      return generateSqlIds(argv[2], argv[3], std::vector<std::string>(argv + 4, argv + argc));
+   }
+   else if (argc > 1)
    {
       for (int i = 1; i < argc; ++i)
       {
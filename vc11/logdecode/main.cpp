@@ -0,0 +1,132 @@
+// Copyright (c) 2013 Benjamin Crist
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   main.cpp
+/// \author Benjamin Crist
+///
+/// \brief  Command-line utility for converting binary logs to text.
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "be/id.h"
+#include "be/log_reader.h"
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Registers each Id name in a file so that Ids in the log can be
+///         displayed by name.
+/// \details Each line may either be a plain name or the output of idgen
+///         (<tt>#0000000000000000:Name</tt>).
+/// \return \c false if the file could not be opened.
+bool readIdNames(const char* filename)
+{
+   std::ifstream ifs(filename);
+   if (!ifs)
+      return false;
+
+   std::string line;
+   while (std::getline(ifs, line))
+   {
+      if (line.length() > 18 && line[0] == '#' && line[17] == ':')
+         line.erase(0, 18);
+
+      if (line.length() > 0)
+         be::Id id(line);
+   }
+
+   return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Utility for converting binary logs written by be::AsyncLog to the
+///         text log format.
+///
+/// \details Usage:
+///
+/// \code
+///         logdecode [-n names.txt]... logfile
+/// \endcode
+///
+///         Each message in \c logfile is written to STDOUT exactly as it
+///         would have appeared in a text log.  Ids are logged by value only,
+///         so to see their names, pass one or more files containing the
+///         names with \c -n.  Each line of a names file should contain a
+///         single name, or a line of idgen output.
+///
+/// \param  argc The number of command-line arguments (including the program
+///         name).
+/// \param  argv An array of c-strings representing the command-line arguments
+///
+/// \return 0 if the whole log was decoded, 1 for usage errors, or 2 if the
+///         log could not be read.
+int main(int argc, char** argv)
+{
+   const char* log_filename = nullptr;
+   bool usage_error = false;
+
+   for (int i = 1; i < argc && !usage_error; ++i)
+   {
+      if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+      {
+         if (!readIdNames(argv[++i]))
+         {
+            std::cerr << "Could not open names file: " << argv[i] << std::endl;
+            return 1;
+         }
+      }
+      else if (!log_filename && argv[i][0] != '-')
+         log_filename = argv[i];
+      else
+         usage_error = true;
+   }
+
+   if (!log_filename || usage_error)
+   {
+      std::cerr << "Usage: logdecode [-n names.txt]... logfile" << std::endl;
+      return 1;
+   }
+
+   std::ifstream ifs(log_filename, std::ifstream::binary);
+   if (!ifs)
+   {
+      std::cerr << "Could not open log file: " << log_filename << std::endl;
+      return 2;
+   }
+
+   try
+   {
+      be::LogReader reader(ifs);
+      std::string message;
+      while (reader.read(message))
+         std::cout << message;
+   }
+   catch (const std::runtime_error& e)
+   {
+      std::cout.flush();
+      std::cerr << log_filename << ": " << e.what() << std::endl;
+      return 2;
+   }
+
+   return 0;
+}
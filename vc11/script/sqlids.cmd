@@ -0,0 +1,6 @@
+@echo off
+rem Regenerates include\pbj\sql_ids.h from the *_SQL_* statement headers.
+rem %1 is the idgen executable to use and %2 is the include directory.
+pushd %2
+%1 --sql PBJ_SQL_IDS . pbj\sw\sandwich_sql.h pbj\window_settings_sql.h > pbj\sql_ids.h
+popd